@@ -0,0 +1,223 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "approval_priority.h"
+
+#define PRIORITY_MAX_POINTS 1000000
+
+// Default policy: age alone, i.e. the oldest request first
+void priorityPolicyDefaults(PriorityPolicy *policy) {
+    policy->agePerDay = 1;
+    policy->zeroDues = 0;
+    policy->finalYear = 0;
+    policy->finalYearFirst = 0;
+    policy->finalYearLast = -1;
+}
+
+// Read key=value lines over the defaults; false if the file is missing
+bool priorityPolicyLoad(PriorityPolicy *policy, const char *path) {
+    priorityPolicyDefaults(policy);
+    FILE *file = fopen(path, "r");
+    if (file == NULL) {
+        return false;
+    }
+    char line[128];
+    char key[64];
+    long value;
+    while (fgets(line, sizeof(line), file) != NULL) {
+        if (line[0] == '#' || sscanf(line, " %63[^= ] = %ld", key, &value) != 2) {
+            continue;
+        }
+        bool isRoll = strcmp(key, "final_year_first") == 0 || strcmp(key, "final_year_last") == 0;
+        if (value < 0 || value > (isRoll ? 2147483647L : PRIORITY_MAX_POINTS)) {
+            printf("Warning: Bad value %ld for '%s' in %s ignored.\n", value, key, path);
+            continue;
+        }
+        if (strcmp(key, "age_per_day") == 0) {
+            policy->agePerDay = (int)value;
+        } else if (strcmp(key, "zero_dues") == 0) {
+            policy->zeroDues = (int)value;
+        } else if (strcmp(key, "final_year") == 0) {
+            policy->finalYear = (int)value;
+        } else if (strcmp(key, "final_year_first") == 0) {
+            policy->finalYearFirst = (int)value;
+        } else if (strcmp(key, "final_year_last") == 0) {
+            policy->finalYearLast = (int)value;
+        } else {
+            printf("Warning: Unknown setting '%s' in %s ignored.\n", key, path);
+        }
+    }
+    fclose(file);
+    return true;
+}
+
+// Points a student's request earns from the policy terms, before aging
+int priorityPoints(const PriorityPolicy *policy, const Student *s) {
+    int points = 0;
+    if (s != NULL && s->feesDue == 0 && s->hostelDue == 0 && s->libraryBooksDue == 0) {
+        points += policy->zeroDues;
+    }
+    if (s != NULL && s->rollNumber >= policy->finalYearFirst && s->rollNumber <= policy->finalYearLast) {
+        points += policy->finalYear;
+    }
+    return points;
+}
+
+// Every request ages at the same rate, so the order between two requests
+// never changes: points + agePerDay * (now - submitted) / day ranks them
+// like the fixed key points * day - agePerDay * submitted, and the heap
+// needs no rebuilding as time passes. Unstamped requests predate
+// stamping and count as the oldest.
+static int64_t priorityKey(const PriorityPolicy *policy, int points, int64_t submitted) {
+    return (int64_t)points * SECONDS_PER_DAY - (int64_t)policy->agePerDay * submitted;
+}
+
+// Priority of an entry at time `now`, in points
+int64_t priorityAt(const PriorityPolicy *policy, const PriorityEntry *entry, int64_t now) {
+    return (entry->key + (int64_t)policy->agePerDay * now) / SECONDS_PER_DAY;
+}
+
+// `a` is decided before `b`: higher key, then older, then earlier in the queue
+static bool comesFirst(const PriorityEntry *a, const PriorityEntry *b) {
+    if (a->key != b->key) {
+        return a->key > b->key;
+    }
+    if (a->submitted != b->submitted) {
+        return a->submitted < b->submitted;
+    }
+    return a->order < b->order;
+}
+
+static void siftDown(PriorityEntry *items, int count, int i) {
+    PriorityEntry entry = items[i];
+    for (;;) {
+        int child = 2 * i + 1;
+        if (child >= count) {
+            break;
+        }
+        if (child + 1 < count && comesFirst(&items[child + 1], &items[child])) {
+            child++;
+        }
+        if (!comesFirst(&items[child], &entry)) {
+            break;
+        }
+        items[i] = items[child];
+        i = child;
+    }
+    items[i] = entry;
+}
+
+// Place every live request of `queue` by the policy; students no longer on
+// record get no points. Built bottom-up in linear time.
+bool priorityHeapBuild(PriorityHeap *heap, const PriorityPolicy *policy, const ApprovalQueue *queue,
+                       const StudentStore *store) {
+    heap->count = 0;
+    heap->items = malloc(sizeof(PriorityEntry) * ((size_t)queue->pending + 1));
+    if (heap->items == NULL) {
+        return false;
+    }
+    int cursor = 0;
+    const ApprovalRequest *request;
+    while ((request = approvalQueueNext(queue, &cursor)) != NULL) {
+        const Student *s = storeFindByRoll(store, request->rollNumber);
+        PriorityEntry *entry = &heap->items[heap->count];
+        entry->key = priorityKey(policy, priorityPoints(policy, s), request->submitted);
+        entry->submitted = request->submitted;
+        entry->order = heap->count;
+        entry->rollNumber = request->rollNumber;
+        heap->count++;
+    }
+    for (int i = heap->count / 2 - 1; i >= 0; i--) {
+        siftDown(heap->items, heap->count, i);
+    }
+    return true;
+}
+
+// Take the request to decide next
+bool priorityHeapPop(PriorityHeap *heap, PriorityEntry *out) {
+    if (heap->count == 0) {
+        return false;
+    }
+    *out = heap->items[0];
+    heap->items[0] = heap->items[--heap->count];
+    if (heap->count > 0) {
+        siftDown(heap->items, heap->count, 0);
+    }
+    return true;
+}
+
+void priorityHeapFree(PriorityHeap *heap) {
+    free(heap->items);
+    heap->items = NULL;
+    heap->count = 0;
+}
+
+void waitTimesInit(WaitTimes *waits) {
+    waits->seconds = NULL;
+    waits->count = 0;
+    waits->capacity = 0;
+    waits->unstamped = 0;
+    waits->sorted = true;
+}
+
+void waitTimesFree(WaitTimes *waits) {
+    free(waits->seconds);
+    waitTimesInit(waits);
+}
+
+// Record one decision; requests without a submit time are only counted
+bool waitTimesAdd(WaitTimes *waits, int64_t submitted, int64_t decided) {
+    if (submitted <= 0) {
+        waits->unstamped++;
+        return true;
+    }
+    if (waits->count == waits->capacity) {
+        int grown = waits->capacity ? waits->capacity * 2 : 64;
+        int64_t *larger = realloc(waits->seconds, sizeof(int64_t) * (size_t)grown);
+        if (larger == NULL) {
+            return false;
+        }
+        waits->seconds = larger;
+        waits->capacity = grown;
+    }
+    waits->seconds[waits->count++] = decided > submitted ? decided - submitted : 0;
+    waits->sorted = false;
+    return true;
+}
+
+static int compareSeconds(const void *a, const void *b) {
+    int64_t x = *(const int64_t *)a;
+    int64_t y = *(const int64_t *)b;
+    return (x > y) - (x < y);
+}
+
+// Nearest-rank percentile (fraction 0.5 = median) of the recorded waits
+int64_t waitTimesPercentile(WaitTimes *waits, double fraction) {
+    if (waits->count == 0) {
+        return 0;
+    }
+    if (!waits->sorted) {
+        qsort(waits->seconds, (size_t)waits->count, sizeof(int64_t), compareSeconds);
+        waits->sorted = true;
+    }
+    int rank = (int)(fraction * waits->count + 0.999999);
+    if (rank < 1) {
+        rank = 1;
+    }
+    return waits->seconds[(rank > waits->count ? waits->count : rank) - 1];
+}
+
+// "42s", "7m 05s", "3h 20m" or "2d 04h"
+char *formatWait(int64_t seconds, char *out, size_t size) {
+    long long s = (long long)seconds;
+    if (s < 60) {
+        snprintf(out, size, "%llds", s);
+    } else if (s < 3600) {
+        snprintf(out, size, "%lldm %02llds", s / 60, s % 60);
+    } else if (s < SECONDS_PER_DAY) {
+        snprintf(out, size, "%lldh %02lldm", s / 3600, s % 3600 / 60);
+    } else {
+        snprintf(out, size, "%lldd %02lldh", s / SECONDS_PER_DAY, s % SECONDS_PER_DAY / 3600);
+    }
+    return out;
+}
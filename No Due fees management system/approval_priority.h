@@ -0,0 +1,63 @@
+#ifndef APPROVAL_PRIORITY_H
+#define APPROVAL_PRIORITY_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "student_store.h"
+#include "approval_queue.h"
+
+#define PRIORITY_RULES_FILENAME "approval_priority.txt"
+#define SECONDS_PER_DAY 86400
+
+// Order in which pending requests are decided. A request's priority is the
+// points of the policy terms it meets plus agePerDay points for every day
+// it has waited, so with agePerDay > 0 every request eventually outranks
+// newer ones however many points they carry. The default (age only) keeps
+// the old first-come, first-served order.
+typedef struct {
+    int agePerDay;          // aging: points per day waited
+    int zeroDues;           // nothing due to any department
+    int finalYear;          // roll number in [finalYearFirst, finalYearLast]
+    int finalYearFirst;
+    int finalYearLast;
+} PriorityPolicy;
+
+// A queued request placed by priority: higher keys are decided first
+typedef struct {
+    int64_t key;
+    int64_t submitted;
+    int order;              // position in the queue, the last tie-break
+    int rollNumber;
+} PriorityEntry;
+
+// Max-heap of the requests pending when it was built
+typedef struct {
+    PriorityEntry *items;
+    int count;
+} PriorityHeap;
+
+// Seconds from request to decision, for one processing session
+typedef struct {
+    int64_t *seconds;
+    int count;
+    int capacity;
+    int unstamped;          // decided requests without a submit time
+    bool sorted;
+} WaitTimes;
+
+void priorityPolicyDefaults(PriorityPolicy *policy);
+bool priorityPolicyLoad(PriorityPolicy *policy, const char *path);
+int priorityPoints(const PriorityPolicy *policy, const Student *s);
+bool priorityHeapBuild(PriorityHeap *heap, const PriorityPolicy *policy, const ApprovalQueue *queue,
+                       const StudentStore *store);
+bool priorityHeapPop(PriorityHeap *heap, PriorityEntry *out);
+void priorityHeapFree(PriorityHeap *heap);
+int64_t priorityAt(const PriorityPolicy *policy, const PriorityEntry *entry, int64_t now);
+
+void waitTimesInit(WaitTimes *waits);
+void waitTimesFree(WaitTimes *waits);
+bool waitTimesAdd(WaitTimes *waits, int64_t submitted, int64_t decided);
+int64_t waitTimesPercentile(WaitTimes *waits, double fraction);
+char *formatWait(int64_t seconds, char *out, size_t size);
+
+#endif
@@ -0,0 +1,197 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "approval_queue.h"
+#include "file_util.h"
+
+void approvalQueueInit(ApprovalQueue *queue) {
+    queue->items = NULL;
+    queue->head = 0;
+    queue->tail = 0;
+    queue->capacity = 0;
+    queue->pending = 0;
+    rollMapInit(&queue->positions);
+    nameArenaInit(&queue->names);
+}
+
+void approvalQueueFree(ApprovalQueue *queue) {
+    free(queue->items);
+    rollMapFree(&queue->positions);
+    nameArenaFree(&queue->names);
+    approvalQueueInit(queue);
+}
+
+// Slide live requests to the front of the array and re-point the index
+static void compact(ApprovalQueue *queue) {
+    int out = 0;
+    for (int i = queue->head; i < queue->tail; i++) {
+        if (!queue->items[i].removed) {
+            queue->items[out] = queue->items[i];
+            rollMapPut(&queue->positions, queue->items[out].rollNumber, out);
+            out++;
+        }
+    }
+    queue->head = 0;
+    queue->tail = out;
+}
+
+// Ensure there is room for one more request at the tail
+static bool makeRoom(ApprovalQueue *queue) {
+    if (queue->tail < queue->capacity) {
+        return true;
+    }
+    // Reclaim space first if at least half the array is dead
+    if (queue->pending <= queue->capacity / 2 && queue->capacity > 0) {
+        compact(queue);
+        return true;
+    }
+    int newCapacity = queue->capacity ? queue->capacity * 2 : 64;
+    ApprovalRequest *items = realloc(queue->items, sizeof(ApprovalRequest) * newCapacity);
+    if (items == NULL) {
+        return false;
+    }
+    queue->items = items;
+    queue->capacity = newCapacity;
+    return true;
+}
+
+bool approvalQueueContains(const ApprovalQueue *queue, int rollNumber) {
+    return rollMapGet(&queue->positions, rollNumber) != -1;
+}
+
+// Enqueue a request made now; false if the roll is already queued (or no memory)
+bool approvalQueuePush(ApprovalQueue *queue, int rollNumber, const char *name) {
+    return approvalQueuePushAt(queue, rollNumber, name, (int64_t)time(NULL));
+}
+
+// Enqueue a request made at `submitted` (Unix time, 0 if unknown)
+bool approvalQueuePushAt(ApprovalQueue *queue, int rollNumber, const char *name, int64_t submitted) {
+    if (approvalQueueContains(queue, rollNumber) || !makeRoom(queue)) {
+        return false;
+    }
+    uint32_t offset = nameArenaIntern(&queue->names, name, strnlen(name, MAX_NAME_LENGTH - 1));
+    if (offset == NAME_NONE) {
+        return false;
+    }
+    ApprovalRequest *request = &queue->items[queue->tail];
+    request->rollNumber = rollNumber;
+    request->name = offset;
+    request->submitted = submitted;
+    request->removed = false;
+    if (!rollMapPut(&queue->positions, rollNumber, queue->tail)) {
+        return false;
+    }
+    queue->tail++;
+    queue->pending++;
+    return true;
+}
+
+// Dequeue the oldest live request
+bool approvalQueuePop(ApprovalQueue *queue, ApprovalRequest *out) {
+    while (queue->head < queue->tail && queue->items[queue->head].removed) {
+        queue->head++;
+    }
+    if (queue->head == queue->tail) {
+        return false;
+    }
+    *out = queue->items[queue->head++];
+    rollMapRemove(&queue->positions, out->rollNumber);
+    queue->pending--;
+    return true;
+}
+
+// Drop the request for a roll number wherever it sits in the queue
+bool approvalQueueRemove(ApprovalQueue *queue, int rollNumber) {
+    int pos = rollMapGet(&queue->positions, rollNumber);
+    if (pos == -1) {
+        return false;
+    }
+    queue->items[pos].removed = true;
+    rollMapRemove(&queue->positions, rollNumber);
+    queue->pending--;
+    return true;
+}
+
+// The live request for a roll number, or NULL if none is queued
+const ApprovalRequest *approvalQueueFind(const ApprovalQueue *queue, int rollNumber) {
+    int pos = rollMapGet(&queue->positions, rollNumber);
+    return pos == -1 ? NULL : &queue->items[pos];
+}
+
+// Iterate live requests in FIFO order: start with *cursor = 0
+const ApprovalRequest *approvalQueueNext(const ApprovalQueue *queue, int *cursor) {
+    int i = queue->head + *cursor;
+    while (i < queue->tail && queue->items[i].removed) {
+        i++;
+    }
+    if (i >= queue->tail) {
+        return NULL;
+    }
+    *cursor = i - queue->head + 1;
+    return &queue->items[i];
+}
+
+// Read the approval file once; returns the number of duplicate lines dropped
+// or -1 if the file could not be opened
+int approvalQueueLoad(ApprovalQueue *queue, const char *path) {
+    FILE *file = fopen(path, "r");
+    if (file == NULL) {
+        return -1;
+    }
+    char line[MAX_NAME_LENGTH + 32];
+    int duplicates = 0;
+    while (fgets(line, sizeof(line), file) != NULL) {
+        line[strcspn(line, "\r\n")] = '\0';
+        int rollNumber;
+        int nameStart;
+        if (sscanf(line, "%d,%n", &rollNumber, &nameStart) != 1 || line[nameStart] == '\0') {
+            continue;
+        }
+        // The submit time is a trailing ",SECONDS"; lines written before
+        // requests were stamped end with the name
+        int64_t submitted = 0;
+        char *comma = strrchr(line + nameStart, ',');
+        if (comma != NULL && comma[1] != '\0' && strspn(comma + 1, "0123456789") == strlen(comma + 1)) {
+            submitted = strtoll(comma + 1, NULL, 10);
+            *comma = '\0';
+        }
+        if (!approvalQueuePushAt(queue, rollNumber, line + nameStart, submitted)) {
+            duplicates++;
+        }
+    }
+    fclose(file);
+    return duplicates;
+}
+
+// One approval file line; unstamped requests keep the old two-field form
+void approvalRequestWrite(FILE *file, const ApprovalQueue *queue, const ApprovalRequest *request) {
+    if (request->submitted > 0) {
+        fprintf(file, "%d,%s,%lld\n", request->rollNumber, approvalRequestName(queue, request),
+                (long long)request->submitted);
+    } else {
+        fprintf(file, "%d,%s\n", request->rollNumber, approvalRequestName(queue, request));
+    }
+}
+
+// Rewrite the approval file with exactly the live requests, atomically
+bool approvalQueueSave(const ApprovalQueue *queue, const char *path) {
+    char tempPath[512];
+    snprintf(tempPath, sizeof(tempPath), "%s.tmp", path);
+    FILE *file = fopen(tempPath, "w");
+    if (file == NULL) {
+        return false;
+    }
+    int cursor = 0;
+    const ApprovalRequest *request;
+    while ((request = approvalQueueNext(queue, &cursor)) != NULL) {
+        approvalRequestWrite(file, queue, request);
+    }
+    bool ok = flushAndSync(file);
+    ok = (fclose(file) == 0) && ok;
+    if (!ok || !replaceFileAtomically(tempPath, path)) {
+        remove(tempPath);
+        return false;
+    }
+    return true;
+}
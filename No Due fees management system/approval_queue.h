@@ -0,0 +1,52 @@
+#ifndef APPROVAL_QUEUE_H
+#define APPROVAL_QUEUE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "student_store.h"
+#include "roll_map.h"
+#include "name_arena.h"
+
+#define APPROVAL_FILENAME "approval_list.txt"
+
+// One pending request as stored in approval_list.txt (roll,name,submitted)
+typedef struct {
+    int rollNumber;
+    uint32_t name;              // offset in the queue's name arena
+    int64_t submitted;          // Unix time it was made; 0 = unknown (older files)
+    bool removed;               // tombstone left by approvalQueueRemove()
+} ApprovalRequest;
+
+// FIFO of pending requests plus a roll-number set for O(1) duplicate checks.
+// Items between head and tail keep file order; removed ones are tombstoned
+// and squeezed out when the array needs to grow.
+typedef struct {
+    ApprovalRequest *items;
+    int head;
+    int tail;
+    int capacity;
+    int pending;                // live (non-removed) requests
+    RollMap positions;          // rollNumber -> index in items
+    NameArena names;            // names of every request pushed
+} ApprovalQueue;
+
+void approvalQueueInit(ApprovalQueue *queue);
+void approvalQueueFree(ApprovalQueue *queue);
+int approvalQueueLoad(ApprovalQueue *queue, const char *path);
+bool approvalQueueSave(const ApprovalQueue *queue, const char *path);
+bool approvalQueueContains(const ApprovalQueue *queue, int rollNumber);
+bool approvalQueuePush(ApprovalQueue *queue, int rollNumber, const char *name);
+bool approvalQueuePushAt(ApprovalQueue *queue, int rollNumber, const char *name, int64_t submitted);
+bool approvalQueuePop(ApprovalQueue *queue, ApprovalRequest *out);
+bool approvalQueueRemove(ApprovalQueue *queue, int rollNumber);
+const ApprovalRequest *approvalQueueFind(const ApprovalQueue *queue, int rollNumber);
+const ApprovalRequest *approvalQueueNext(const ApprovalQueue *queue, int *cursor);
+void approvalRequestWrite(FILE *file, const ApprovalQueue *queue, const ApprovalRequest *request);
+
+// Name of a request taken from this queue (also after it was popped)
+static inline const char *approvalRequestName(const ApprovalQueue *queue, const ApprovalRequest *request) {
+    return nameArenaGet(&queue->names, request->name);
+}
+
+#endif
@@ -0,0 +1,324 @@
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "audit_log.h"
+#include "snapshot.h"
+#include "file_util.h"
+
+#define AUDIT_CHECKSUM_SEED 0x41554449ULL
+
+// Index file: the newest entry per roll as of `coveredEntries` log entries.
+// lastChecksum ties it to the log it was built from.
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t count;             // slots that follow
+    int64_t coveredEntries;
+    uint64_t lastChecksum;      // checksum of entry coveredEntries - 1
+} AuditIndexHeader;
+
+typedef struct {
+    int32_t rollNumber;
+    int32_t entry;
+} AuditIndexSlot;
+
+static const char *actionNames[] = {
+    "?", "applied", "approved", "rejected", "skipped",
+    "fees", "books", "hostel", "status", "added", "cleared"
+};
+
+static uint64_t entryChecksum(const AuditEntry *entry) {
+    return snapshotChecksum(AUDIT_CHECKSUM_SEED, entry, offsetof(AuditEntry, checksum));
+}
+
+static long entryOffset(int64_t entry) {
+    return (long)sizeof(AuditHeader) + (long)entry * (long)sizeof(AuditEntry);
+}
+
+static bool readEntry(AuditLog *log, int64_t entry, AuditEntry *out) {
+    return fseek(log->file, entryOffset(entry), SEEK_SET) == 0
+        && fread(out, sizeof(*out), 1, log->file) == 1
+        && out->checksum == entryChecksum(out);
+}
+
+// Index entries appended since this process last looked (by other
+// sessions, or everything when there is no usable index file). A torn
+// final entry from a crashed writer is cut off.
+static bool catchUp(AuditLog *log) {
+    if (fseek(log->file, 0, SEEK_END) != 0) {
+        return false;
+    }
+    long size = ftell(log->file);
+    if (size < entryOffset(log->entries) || fseek(log->file, entryOffset(log->entries), SEEK_SET) != 0) {
+        return false;
+    }
+    AuditEntry entry;
+    while (entryOffset(log->entries + 1) <= size
+            && fread(&entry, sizeof(entry), 1, log->file) == 1
+            && entry.checksum == entryChecksum(&entry)) {
+        rollMapPut(&log->latest, entry.rollNumber, (int)log->entries);
+        log->entries++;
+    }
+    if (entryOffset(log->entries) < size) {
+        return truncateFile(log->file, entryOffset(log->entries));
+    }
+    return true;
+}
+
+static bool loadIndex(AuditLog *log) {
+    FILE *file = fopen(log->indexPath, "rb");
+    if (file == NULL) {
+        return false;
+    }
+    AuditIndexHeader header;
+    AuditEntry last;
+    bool ok = fread(&header, sizeof(header), 1, file) == 1
+        && memcmp(header.magic, AUDIT_INDEX_MAGIC, sizeof(header.magic)) == 0
+        && header.version == AUDIT_VERSION
+        && header.coveredEntries >= 0
+        && (header.coveredEntries == 0
+            || (readEntry(log, header.coveredEntries - 1, &last) && last.checksum == header.lastChecksum))
+        && rollMapReserve(&log->latest, header.count);
+    AuditIndexSlot slot;
+    for (uint32_t i = 0; ok && i < header.count; i++) {
+        ok = fread(&slot, sizeof(slot), 1, file) == 1 && slot.entry >= 0
+            && slot.entry < header.coveredEntries
+            && rollMapPut(&log->latest, slot.rollNumber, slot.entry);
+    }
+    fclose(file);
+    if (!ok) {
+        rollMapClear(&log->latest);
+        return false;
+    }
+    log->entries = header.coveredEntries;
+    return true;
+}
+
+// Write the per-roll heads (temp file + atomic rename) so the next open
+// only has to scan entries added after this point
+static bool saveIndex(AuditLog *log) {
+    AuditIndexHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, AUDIT_INDEX_MAGIC, sizeof(header.magic));
+    header.version = AUDIT_VERSION;
+    header.count = log->latest.count;
+    header.coveredEntries = log->entries;
+    AuditEntry last;
+    if (log->entries > 0) {
+        if (!readEntry(log, log->entries - 1, &last)) {
+            return false;
+        }
+        header.lastChecksum = last.checksum;
+    }
+
+    char tempPath[512];
+    snprintf(tempPath, sizeof(tempPath), "%s.tmp", log->indexPath);
+    FILE *file = fopen(tempPath, "wb");
+    if (file == NULL) {
+        return false;
+    }
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+    for (unsigned int i = 0; ok && i < log->latest.capacity; i++) {
+        const RollMapSlot *mapSlot = &log->latest.slots[i];
+        if (mapSlot->value >= 0) {
+            AuditIndexSlot slot = { mapSlot->key, mapSlot->value };
+            ok = fwrite(&slot, sizeof(slot), 1, file) == 1;
+        }
+    }
+    ok = flushAndSync(file) && ok;
+    ok = (fclose(file) == 0) && ok;
+    if (!ok || !replaceFileAtomically(tempPath, log->indexPath)) {
+        remove(tempPath);
+        return false;
+    }
+    return true;
+}
+
+// Open (or create) the log. The per-roll heads come from the index file
+// when it matches the log, plus a scan of whatever was appended after it.
+bool auditOpen(AuditLog *log, const char *path, const char *indexPath) {
+    log->file = NULL;
+    log->entries = 0;
+    log->unsynced = 0;
+    log->buffered = 0;
+    rollMapInit(&log->latest);
+    snprintf(log->indexPath, sizeof(log->indexPath), "%s", indexPath);
+    log->buffer = malloc(sizeof(AuditEntry) * AUDIT_BUFFER_ENTRIES);
+    if (log->buffer == NULL) {
+        return false;
+    }
+
+    FILE *file = fopen(path, "r+b");
+    if (file == NULL) {
+        file = fopen(path, "w+b");
+    }
+    if (file == NULL) {
+        auditClose(log);
+        return false;
+    }
+    log->file = file;
+
+    AuditHeader header;
+    fseek(file, 0, SEEK_END);
+    if (ftell(file) < (long)sizeof(AuditHeader)) {
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, AUDIT_MAGIC, sizeof(header.magic));
+        header.version = AUDIT_VERSION;
+        header.entrySize = sizeof(AuditEntry);
+        if (!truncateFile(file, 0) || fseek(file, 0, SEEK_SET) != 0
+                || fwrite(&header, sizeof(header), 1, file) != 1 || !flushAndSync(file)) {
+            auditClose(log);
+            return false;
+        }
+    } else if (fseek(file, 0, SEEK_SET) != 0 || fread(&header, sizeof(header), 1, file) != 1
+            || memcmp(header.magic, AUDIT_MAGIC, sizeof(header.magic)) != 0
+            || header.version != AUDIT_VERSION || header.entrySize != sizeof(AuditEntry)) {
+        auditClose(log); // not ours: leave it alone
+        return false;
+    }
+
+    if (!loadIndex(log)) {
+        log->entries = 0;
+    }
+    if (!catchUp(log)) {
+        auditClose(log);
+        return false;
+    }
+    return true;
+}
+
+void auditClose(AuditLog *log) {
+    if (log->file != NULL) {
+        auditCommit(log);
+        saveIndex(log);
+        fclose(log->file);
+        log->file = NULL;
+    }
+    free(log->buffer);
+    log->buffer = NULL;
+    log->buffered = 0;
+    rollMapFree(&log->latest);
+}
+
+// Buffer one entry; written with the rest of its group by auditFlush.
+// A NULL or closed log records nothing.
+bool auditRecord(AuditLog *log, int rollNumber, AuditAction action,
+                 int64_t oldValue, int64_t newValue, const char *actor) {
+    if (log == NULL || log->file == NULL) {
+        return false;
+    }
+    AuditEntry *entry = &log->buffer[log->buffered++];
+    memset(entry, 0, sizeof(*entry));
+    entry->timestamp = (int64_t)time(NULL);
+    entry->rollNumber = rollNumber;
+    entry->action = action;
+    entry->oldValue = oldValue;
+    entry->newValue = newValue;
+    strncpy(entry->actor, actor, AUDIT_ACTOR_LENGTH - 1);
+    if (log->buffered == AUDIT_BUFFER_ENTRIES) {
+        return auditFlush(log);
+    }
+    return true;
+}
+
+// One entry per field that differs between the two versions of a record
+void auditRecordChanges(AuditLog *log, const Student *before, const Student *after, const char *actor) {
+    int rollNumber = after->rollNumber;
+    if (before->feesDue != after->feesDue) {
+        auditRecord(log, rollNumber, AUDIT_SET_FEES, before->feesDue, after->feesDue, actor);
+    }
+    if (before->libraryBooksDue != after->libraryBooksDue) {
+        auditRecord(log, rollNumber, AUDIT_SET_BOOKS, before->libraryBooksDue, after->libraryBooksDue, actor);
+    }
+    if (before->hostelDue != after->hostelDue) {
+        auditRecord(log, rollNumber, AUDIT_SET_HOSTEL, before->hostelDue, after->hostelDue, actor);
+    }
+    if (before->approvalStatus != after->approvalStatus) {
+        auditRecord(log, rollNumber, AUDIT_SET_APPROVAL, before->approvalStatus, after->approvalStatus, actor);
+    }
+}
+
+// Write the buffered entries in one go, chained to each roll's newest
+// entry (after indexing anything other sessions appended meanwhile)
+bool auditFlush(AuditLog *log) {
+    if (log == NULL || log->file == NULL || log->buffered == 0) {
+        return true;
+    }
+    bool ok = catchUp(log);
+    int64_t first = log->entries;
+    for (int i = 0; ok && i < log->buffered; i++) {
+        AuditEntry *entry = &log->buffer[i];
+        entry->previous = rollMapGet(&log->latest, entry->rollNumber);
+        entry->checksum = entryChecksum(entry);
+        ok = rollMapPut(&log->latest, entry->rollNumber, (int)(first + i));
+    }
+    ok = ok && fseek(log->file, entryOffset(first), SEEK_SET) == 0
+        && fwrite(log->buffer, sizeof(AuditEntry), (size_t)log->buffered, log->file) == (size_t)log->buffered
+        && fflush(log->file) == 0;
+    if (!ok) {
+        // Forget the heads set above and re-derive them from what is on disk
+        truncateFile(log->file, entryOffset(first));
+        rollMapClear(&log->latest);
+        log->entries = 0;
+        catchUp(log);
+        log->buffered = 0;
+        return false;
+    }
+    log->entries = first + log->buffered;
+    log->unsynced += log->buffered;
+    log->buffered = 0;
+    return true;
+}
+
+// Group commit: write what is buffered and fsync once for all of it
+bool auditCommit(AuditLog *log) {
+    if (!auditFlush(log)) {
+        return false;
+    }
+    if (log == NULL || log->file == NULL || log->unsynced == 0) {
+        return true;
+    }
+    log->unsynced = 0;
+    return syncFile(log->file);
+}
+
+// A student's entries, oldest first, by following the chain back from the
+// newest one. *entries is malloc'ed (NULL when there are none).
+bool auditHistory(AuditLog *log, int rollNumber, AuditEntry **entries, int *count) {
+    *entries = NULL;
+    *count = 0;
+    if (log == NULL || log->file == NULL || !auditFlush(log)) {
+        return false;
+    }
+    int capacity = 0;
+    int64_t next = rollMapGet(&log->latest, rollNumber);
+    AuditEntry entry;
+    while (next >= 0 && readEntry(log, next, &entry) && entry.rollNumber == rollNumber) {
+        if (*count == capacity) {
+            capacity = capacity ? capacity * 2 : 16;
+            AuditEntry *grown = realloc(*entries, sizeof(AuditEntry) * capacity);
+            if (grown == NULL) {
+                free(*entries);
+                *entries = NULL;
+                *count = 0;
+                return false;
+            }
+            *entries = grown;
+        }
+        (*entries)[(*count)++] = entry;
+        next = entry.previous < next ? entry.previous : -1; // chains only go backwards
+    }
+    for (int i = 0, j = *count - 1; i < j; i++, j--) {
+        AuditEntry swap = (*entries)[i];
+        (*entries)[i] = (*entries)[j];
+        (*entries)[j] = swap;
+    }
+    return true;
+}
+
+const char *auditActionName(AuditAction action) {
+    if (action < AUDIT_APPLIED || action > AUDIT_CLEARED) {
+        return actionNames[0];
+    }
+    return actionNames[action];
+}
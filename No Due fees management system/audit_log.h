@@ -0,0 +1,80 @@
+#ifndef AUDIT_LOG_H
+#define AUDIT_LOG_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "student_store.h"
+
+#define AUDIT_FILENAME "audit.log"
+#define AUDIT_INDEX_FILENAME "audit.idx"
+#define AUDIT_MAGIC "NODUEAUD"
+#define AUDIT_INDEX_MAGIC "NODUEAIX"
+#define AUDIT_VERSION 1
+#define AUDIT_ACTOR_LENGTH 16
+#define AUDIT_BUFFER_ENTRIES 256    // entries buffered in memory before a write
+
+// Actors shared by the console and the server
+#define STUDENT_ACTOR "student"
+#define PAYMENT_ACTOR "payments"
+#define CLEARANCE_ACTOR "clearance"
+
+// What happened to a student
+typedef enum {
+    AUDIT_APPLIED = 1,          // requested approval
+    AUDIT_APPROVED,             // request approved (old/new: approval status)
+    AUDIT_REJECTED,             // request rejected
+    AUDIT_SKIPPED,              // request left in the queue
+    AUDIT_SET_FEES,             // old/new: paise
+    AUDIT_SET_BOOKS,            // old/new: books
+    AUDIT_SET_HOSTEL,           // old/new: paise
+    AUDIT_SET_APPROVAL,         // old/new: 0 = Pending, 1 = Approved
+    AUDIT_ADDED,                // new record (new: fees + hostel due)
+    AUDIT_CLEARED               // a department signed off (actor: the department,
+                                // old/new: departments cleared, see clearance.h)
+} AuditAction;
+
+// File header, written once when the log is created
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t entrySize;
+} AuditHeader;
+
+// Fixed 64-byte entry. Each one points back at the previous entry for the
+// same roll number, so a student's history is a chain through the file.
+typedef struct {
+    int64_t timestamp;          // seconds since the epoch
+    int64_t previous;           // entry number of the roll's previous entry, -1 if none
+    int64_t oldValue;
+    int64_t newValue;
+    int32_t rollNumber;
+    uint32_t action;
+    char actor[AUDIT_ACTOR_LENGTH];
+    uint64_t checksum;
+} AuditEntry;
+
+// Append-only audit log. Entries are buffered and written in groups; the
+// newest entry per roll is kept in memory (and saved to the index file on
+// close), so a history lookup reads only that student's entries.
+typedef struct {
+    FILE *file;
+    char indexPath[256];
+    int64_t entries;            // entries in the file that this process has indexed
+    int unsynced;               // written since the last fsync
+    RollMap latest;             // rollNumber -> entry number of its newest entry
+    AuditEntry *buffer;         // recorded but not yet written
+    int buffered;
+} AuditLog;
+
+bool auditOpen(AuditLog *log, const char *path, const char *indexPath);
+void auditClose(AuditLog *log);
+bool auditRecord(AuditLog *log, int rollNumber, AuditAction action,
+                 int64_t oldValue, int64_t newValue, const char *actor);
+void auditRecordChanges(AuditLog *log, const Student *before, const Student *after, const char *actor);
+bool auditFlush(AuditLog *log);
+bool auditCommit(AuditLog *log);
+bool auditHistory(AuditLog *log, int rollNumber, AuditEntry **entries, int *count);
+const char *auditActionName(AuditAction action);
+
+#endif
@@ -0,0 +1,173 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include "auto_approval.h"
+#include "timing.h"
+
+#define AUTO_ACTOR "auto-rules"
+
+// Default policy: approve only when nothing at all is due; never auto-reject
+void autoRulesDefaults(AutoRules *rules) {
+    rules->approveMaxFees = 0;
+    rules->approveMaxBooks = 0;
+    rules->approveMaxHostel = 0;
+    rules->rejectMinFees = -1;
+    rules->rejectMinBooks = -1;
+    rules->rejectMinHostel = -1;
+}
+
+// Read key=value lines over the defaults; false if the file is missing
+bool autoRulesLoad(AutoRules *rules, const char *path) {
+    autoRulesDefaults(rules);
+    FILE *file = fopen(path, "r");
+    if (file == NULL) {
+        return false;
+    }
+    char line[128];
+    char key[64];
+    char text[32];
+    Money value;
+    while (fgets(line, sizeof(line), file) != NULL) {
+        if (line[0] == '#' || sscanf(line, " %63[^= ] = %31s", key, text) != 2) {
+            continue;
+        }
+        if (!moneyParseText(text, &value)) {
+            printf("Warning: Bad value '%s' for rule '%s' in %s ignored.\n", text, key, path);
+            continue;
+        }
+        // Book limits are counts; a fraction is dropped
+        int count = (int)(value / MONEY_SCALE);
+        if (strcmp(key, "approve_max_fees") == 0) {
+            rules->approveMaxFees = value;
+        } else if (strcmp(key, "approve_max_books") == 0) {
+            rules->approveMaxBooks = count;
+        } else if (strcmp(key, "approve_max_hostel") == 0) {
+            rules->approveMaxHostel = value;
+        } else if (strcmp(key, "reject_min_fees") == 0) {
+            rules->rejectMinFees = value;
+        } else if (strcmp(key, "reject_min_books") == 0) {
+            rules->rejectMinBooks = count;
+        } else if (strcmp(key, "reject_min_hostel") == 0) {
+            rules->rejectMinHostel = value;
+        } else {
+            printf("Warning: Unknown rule '%s' in %s ignored.\n", key, path);
+        }
+    }
+    fclose(file);
+    return true;
+}
+
+// Classify `count` requests from column arrays. The loop is branch-free so
+// the compiler can vectorize it.
+void autoEvaluate(const AutoRules *rules, const Money *fees, const int *books,
+                  const Money *hostel, int count, unsigned char *decisions) {
+    // Disabled reject limits become unreachable
+    const Money rejectFees = rules->rejectMinFees < 0 ? INT64_MAX : rules->rejectMinFees;
+    const int rejectBooks = rules->rejectMinBooks < 0 ? INT_MAX : rules->rejectMinBooks;
+    const Money rejectHostel = rules->rejectMinHostel < 0 ? INT64_MAX : rules->rejectMinHostel;
+    const Money approveFees = rules->approveMaxFees;
+    const int approveBooks = rules->approveMaxBooks;
+    const Money approveHostel = rules->approveMaxHostel;
+
+    for (int i = 0; i < count; i++) {
+        int approve = (fees[i] <= approveFees) & (books[i] <= approveBooks) & (hostel[i] <= approveHostel);
+        int reject = (fees[i] >= rejectFees) | (books[i] >= rejectBooks) | (hostel[i] >= rejectHostel);
+        decisions[i] = (unsigned char)(approve | ((reject & (approve ^ 1)) << 1));
+    }
+}
+
+// Resolve every pending request the rules can decide in one pass:
+// gather the dues of queued students into columns, classify them all,
+// then apply approvals (journaled) and drop decided requests from the queue
+// and from the department queues (clearance may be NULL). Each decision is
+// audited under the actor "auto-rules" (audit may be NULL).
+bool autoProcessQueue(const AutoRules *rules, StudentStore *store, ApprovalQueue *queue,
+                      ClearanceBoard *clearance, Journal *journal, AuditLog *audit, AutoReport *report) {
+    memset(report, 0, sizeof(*report));
+    double start = monotonicSeconds();
+
+    int capacity = queue->pending;
+    Money *fees = malloc(sizeof(Money) * (capacity + 1));
+    int *books = malloc(sizeof(int) * (capacity + 1));
+    Money *hostel = malloc(sizeof(Money) * (capacity + 1));
+    Student **records = malloc(sizeof(Student *) * (capacity + 1));
+    unsigned char *decisions = malloc(capacity + 1);
+    if (fees == NULL || books == NULL || hostel == NULL || records == NULL || decisions == NULL) {
+        free(fees);
+        free(books);
+        free(hostel);
+        free(records);
+        free(decisions);
+        return false;
+    }
+
+    // Gather: one hash lookup per request
+    int count = 0;
+    int cursor = 0;
+    const ApprovalRequest *request;
+    while ((request = approvalQueueNext(queue, &cursor)) != NULL) {
+        Student *s = storeFindByRoll(store, request->rollNumber);
+        if (s == NULL) {
+            report->invalid++;
+            continue;
+        }
+        records[count] = s;
+        fees[count] = s->feesDue;
+        books[count] = s->libraryBooksDue;
+        hostel[count] = s->hostelDue;
+        count++;
+    }
+    report->examined = count;
+
+    double evaluateStart = monotonicSeconds();
+    autoEvaluate(rules, fees, books, hostel, count, decisions);
+    report->evaluateSeconds = monotonicSeconds() - evaluateStart;
+
+    // Apply decisions; manual cases stay queued in their original order
+    for (int i = 0; i < count; i++) {
+        Student *s = records[i];
+        if (decisions[i] == AUTO_APPROVE) {
+            auditRecord(audit, s->rollNumber, AUDIT_APPROVED, s->approvalStatus, 1, AUTO_ACTOR);
+            s->approvalStatus = 1;
+            if (journal != NULL) {
+                journalAppend(journal, JOURNAL_SET_APPROVAL, s, NULL);
+            }
+            approvalQueueRemove(queue, s->rollNumber);
+            if (clearance != NULL) {
+                clearanceWithdraw(clearance, s->rollNumber);
+            }
+            report->approved++;
+        } else if (decisions[i] == AUTO_REJECT) {
+            auditRecord(audit, s->rollNumber, AUDIT_REJECTED, s->approvalStatus, s->approvalStatus, AUTO_ACTOR);
+            approvalQueueRemove(queue, s->rollNumber);
+            if (clearance != NULL) {
+                clearanceWithdraw(clearance, s->rollNumber);
+            }
+            report->rejected++;
+        } else {
+            report->manual++;
+        }
+    }
+
+    // Requests for unknown students are dropped, as in manual processing
+    if (report->invalid > 0) {
+        cursor = 0;
+        while ((request = approvalQueueNext(queue, &cursor)) != NULL) {
+            if (storeFindByRoll(store, request->rollNumber) == NULL) {
+                if (clearance != NULL) {
+                    clearanceWithdraw(clearance, request->rollNumber);
+                }
+                approvalQueueRemove(queue, request->rollNumber);
+            }
+        }
+    }
+
+    free(fees);
+    free(books);
+    free(hostel);
+    free(records);
+    free(decisions);
+    report->totalSeconds = monotonicSeconds() - start;
+    return true;
+}
@@ -0,0 +1,48 @@
+#ifndef AUTO_APPROVAL_H
+#define AUTO_APPROVAL_H
+
+#include <stdbool.h>
+#include "student_store.h"
+#include "approval_queue.h"
+#include "clearance.h"
+#include "journal.h"
+#include "audit_log.h"
+
+#define AUTO_RULES_FILENAME "auto_rules.txt"
+
+// Auto-clearance thresholds. A request is approved when every due is at or
+// below its approve limit, rejected when any due reaches its reject limit,
+// and left for manual review otherwise. A negative reject limit disables it.
+typedef struct {
+    Money approveMaxFees;
+    int approveMaxBooks;
+    Money approveMaxHostel;
+    Money rejectMinFees;
+    int rejectMinBooks;
+    Money rejectMinHostel;
+} AutoRules;
+
+typedef enum {
+    AUTO_MANUAL = 0,
+    AUTO_APPROVE = 1,
+    AUTO_REJECT = 2
+} AutoDecision;
+
+typedef struct {
+    int examined;
+    int approved;
+    int rejected;
+    int manual;
+    int invalid;            // requests for students no longer on record
+    double evaluateSeconds; // the rule pass alone
+    double totalSeconds;    // gather + evaluate + apply
+} AutoReport;
+
+void autoRulesDefaults(AutoRules *rules);
+bool autoRulesLoad(AutoRules *rules, const char *path);
+void autoEvaluate(const AutoRules *rules, const Money *fees, const int *books,
+                  const Money *hostel, int count, unsigned char *decisions);
+bool autoProcessQueue(const AutoRules *rules, StudentStore *store, ApprovalQueue *queue,
+                      ClearanceBoard *clearance, Journal *journal, AuditLog *audit, AutoReport *report);
+
+#endif
@@ -0,0 +1,188 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "batch.h"
+#include "csv_loader.h"
+#include "timing.h"
+
+#define BATCH_LINE_LENGTH (MAX_NAME_LENGTH + 128)
+#define BATCH_ACTOR "batch"
+
+// Supported operations, one per line:
+//   approve,ROLL
+//   reject,ROLL
+//   set-fees,ROLL,AMOUNT
+//   set-books,ROLL,COUNT
+//   set-hostel,ROLL,AMOUNT
+//   add-student,ROLL,NAME,FEES,BOOKS,HOSTEL,STATUS
+// Blank lines and lines starting with '#' are ignored.
+
+// A whole field as an int in [min, max]; "12abc" or "3x" is rejected
+static bool parseIntField(const char *text, long min, long max, int *out) {
+    char *end;
+    long value = strtol(text, &end, 10);
+    if (end == text || *end != '\0' || value < min || value > max) {
+        return false;
+    }
+    *out = (int)value;
+    return true;
+}
+
+// Apply one operation to memory; on failure *message says why
+static bool applyOperation(const char *op, const char *args, StudentStore *store, ApprovalQueue *queue,
+                           ClearanceBoard *clearance, AuditLog *audit, BatchReport *report,
+                           const char **message) {
+    if (strcmp(op, "add-student") == 0) {
+        Student record;
+        if (!parseStudentLine(args, args + strlen(args), store, &record, message)) {
+            return false;
+        }
+        if (record.rollNumber <= 0) {
+            *message = "bad roll number";
+            return false;
+        }
+        if (record.feesDue < 0 || record.libraryBooksDue < 0 || record.hostelDue < 0) {
+            *message = "negative dues";
+            return false;
+        }
+        if (record.approvalStatus != 0 && record.approvalStatus != 1) {
+            *message = "bad approval status";
+            return false;
+        }
+        if (storeFindByRoll(store, record.rollNumber) != NULL) {
+            *message = "roll number already exists";
+            return false;
+        }
+        if (storeAdd(store, &record) == NULL) {
+            *message = "out of memory";
+            return false;
+        }
+        auditRecord(audit, record.rollNumber, AUDIT_ADDED, 0, record.feesDue + record.hostelDue, BATCH_ACTOR);
+        report->studentsChanged = true;
+        return true;
+    }
+
+    // ROLL[,VALUE]: copy the roll out so each field is parsed whole
+    char roll[16];
+    size_t rollLength = strcspn(args, ",");
+    const char *value = args[rollLength] == ',' ? args + rollLength + 1 : NULL;
+    int rollNumber;
+    if (rollLength >= sizeof(roll)) {
+        *message = "bad roll number";
+        return false;
+    }
+    memcpy(roll, args, rollLength);
+    roll[rollLength] = '\0';
+    if (!parseIntField(roll, 1, 2147483647L, &rollNumber)) {
+        *message = "bad roll number";
+        return false;
+    }
+    bool decision = strcmp(op, "approve") == 0 || strcmp(op, "reject") == 0;
+    if (decision && value != NULL) {
+        *message = "unexpected trailing data";
+        return false;
+    }
+    Student *s = storeFindByRoll(store, rollNumber);
+    if (s == NULL && strcmp(op, "reject") != 0) {
+        *message = "student not found";
+        return false;
+    }
+
+    if (strcmp(op, "approve") == 0) {
+        auditRecord(audit, rollNumber, AUDIT_APPROVED, s->approvalStatus, 1, BATCH_ACTOR);
+        s->approvalStatus = 1;
+        report->studentsChanged = true;
+        report->queueChanged |= approvalQueueRemove(queue, rollNumber);
+        clearanceWithdraw(clearance, rollNumber);
+        return true;
+    }
+    if (strcmp(op, "reject") == 0) {
+        if (!approvalQueueRemove(queue, rollNumber)) {
+            *message = "no pending request";
+            return false;
+        }
+        int status = s != NULL ? s->approvalStatus : 0;
+        auditRecord(audit, rollNumber, AUDIT_REJECTED, status, status, BATCH_ACTOR);
+        report->queueChanged = true;
+        clearanceWithdraw(clearance, rollNumber);
+        return true;
+    }
+
+    if (strcmp(op, "set-books") == 0) {
+        int books;
+        if (value == NULL || !parseIntField(value, 0, 2147483647L, &books)) {
+            *message = "bad book count";
+            return false;
+        }
+        auditRecord(audit, rollNumber, AUDIT_SET_BOOKS, s->libraryBooksDue, books, BATCH_ACTOR);
+        s->libraryBooksDue = books;
+        report->studentsChanged = true;
+        return true;
+    }
+
+    bool fees = strcmp(op, "set-fees") == 0;
+    if (fees || strcmp(op, "set-hostel") == 0) {
+        Money amount;
+        if (value == NULL || !moneyParseText(value, &amount) || amount < 0) {
+            *message = "bad amount";
+            return false;
+        }
+        if (fees) {
+            auditRecord(audit, rollNumber, AUDIT_SET_FEES, s->feesDue, amount, BATCH_ACTOR);
+            s->feesDue = amount;
+        } else {
+            auditRecord(audit, rollNumber, AUDIT_SET_HOSTEL, s->hostelDue, amount, BATCH_ACTOR);
+            s->hostelDue = amount;
+        }
+        report->studentsChanged = true;
+        return true;
+    }
+
+    *message = "unknown operation";
+    return false;
+}
+
+// Apply every operation in the command file to memory in one pass and
+// print a result line per operation. Persisting (including the audit
+// entries, buffered in `audit`) is left to the caller so the whole batch
+// lands in a single write.
+bool runBatchFile(const char *path, StudentStore *store, ApprovalQueue *queue,
+                  ClearanceBoard *clearance, AuditLog *audit, FILE *out, BatchReport *report) {
+    memset(report, 0, sizeof(*report));
+    FILE *file = fopen(path, "r");
+    if (file == NULL) {
+        return false;
+    }
+
+    double start = monotonicSeconds();
+    char line[BATCH_LINE_LENGTH];
+    long lineNumber = 0;
+    while (fgets(line, sizeof(line), file) != NULL) {
+        lineNumber++;
+        line[strcspn(line, "\r\n")] = '\0';
+        if (line[0] == '\0' || line[0] == '#') {
+            continue;
+        }
+
+        // Split "op,args" in place
+        char *args = strchr(line, ',');
+        if (args != NULL) {
+            *args++ = '\0';
+        } else {
+            args = line + strlen(line);
+        }
+
+        report->operations++;
+        const char *message = NULL;
+        if (applyOperation(line, args, store, queue, clearance, audit, report, &message)) {
+            report->applied++;
+            fprintf(out, "line %ld: %s %s: ok\n", lineNumber, line, args);
+        } else {
+            report->failed++;
+            fprintf(out, "line %ld: %s %s: FAILED (%s)\n", lineNumber, line, args, message);
+        }
+    }
+    fclose(file);
+    report->seconds = monotonicSeconds() - start;
+    return true;
+}
@@ -0,0 +1,24 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <stdbool.h>
+#include <stdio.h>
+#include "student_store.h"
+#include "approval_queue.h"
+#include "clearance.h"
+#include "audit_log.h"
+
+// Outcome of one batch run
+typedef struct {
+    int operations;         // non-blank, non-comment lines
+    int applied;
+    int failed;
+    bool studentsChanged;   // store needs to be persisted
+    bool queueChanged;      // approval file needs to be rewritten
+    double seconds;
+} BatchReport;
+
+bool runBatchFile(const char *path, StudentStore *store, ApprovalQueue *queue,
+                  ClearanceBoard *clearance, AuditLog *audit, FILE *out, BatchReport *report);
+
+#endif
@@ -0,0 +1,107 @@
+// Certificate generation benchmark: one thread writing each certificate
+// with a series of fprintf calls versus the worker pool writing each
+// rendered certificate in one block.
+//
+// Build (from the project directory):
+//   gcc -O2 bench/bench_certificates.c certificates.c student_store.c name_arena.c money.c roll_map.c file_util.c timing.c -o bench_certificates -pthread
+// Run:
+//   ./bench_certificates [approvedCount] [directory]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../certificates.h"
+#include "../file_util.h"
+#include "../timing.h"
+
+#define DEFAULT_APPROVED 100000
+#define DEFAULT_DIR "bench_certificates"
+
+// Before: fprintf field by field, default stdio buffering
+static int writeNaive(const StudentStore *store, const char *directory) {
+    char path[512];
+    char fees[MONEY_TEXT_SIZE], hostel[MONEY_TEXT_SIZE];
+    int written = 0;
+    for (int i = 0; i < store->count; i++) {
+        const Student *s = storeAt(store, i);
+        if (s->approvalStatus != 1) {
+            continue;
+        }
+        snprintf(path, sizeof(path), "%s/%d.txt", directory, s->rollNumber);
+        FILE *file = fopen(path, "w");
+        if (file == NULL) {
+            continue;
+        }
+        fprintf(file, "NO DUES CERTIFICATE\n");
+        fprintf(file, "===================\n\n");
+        fprintf(file, "Certificate No. : ND/%d\n", s->rollNumber);
+        fprintf(file, "This is to certify that %s (Roll No. %d)\n", storeName(store, s), s->rollNumber);
+        fprintf(file, "has been granted no-dues clearance.\n\n");
+        fprintf(file, "Fees due        : Rs. %s\n", moneyText(s->feesDue, fees));
+        fprintf(file, "Library books   : %d\n", s->libraryBooksDue);
+        fprintf(file, "Hostel due      : Rs. %s\n", moneyText(s->hostelDue, hostel));
+        fclose(file);
+        written++;
+    }
+    return written;
+}
+
+static void printRun(const char *label, int written, double seconds) {
+    printf("  %-24s: %8.3f s (%.0f certificates/s)\n", label, seconds, written / seconds);
+}
+
+int main(int argc, char *argv[]) {
+    int approved = argc > 1 ? atoi(argv[1]) : DEFAULT_APPROVED;
+    const char *directory = argc > 2 ? argv[2] : DEFAULT_DIR;
+    if (approved <= 0) {
+        printf("Usage: %s [approvedCount] [directory]\n", argv[0]);
+        return 1;
+    }
+
+    // One pending student for every five approved
+    StudentStore store;
+    storeInit(&store);
+    int total = approved + approved / 5;
+    if (!storeReserve(&store, total)) {
+        printf("Error: Out of memory.\n");
+        return 1;
+    }
+    for (int i = 0; i < total; i++) {
+        Student s;
+        memset(&s, 0, sizeof(s));
+        s.rollNumber = 2100000 + i;
+        char name[MAX_NAME_LENGTH];
+        int length = snprintf(name, sizeof(name), "STUDENT %d", i);
+        s.name = storeInternName(&store, name, (size_t)length);
+        s.approvalStatus = i % 6 != 5;
+        storeAdd(&store, &s);
+    }
+    if (!makeDirectory(directory)) {
+        printf("Error: Could not create %s.\n", directory);
+        return 1;
+    }
+    printf("%d students, %d approved\n", store.count, approved);
+
+    double start = monotonicSeconds();
+    int written = writeNaive(&store, directory);
+    printRun("fprintf, one thread", written, monotonicSeconds() - start);
+
+    int threadCounts[] = { 1, defaultCertificateThreads() };
+    for (int r = 0; r < 2; r++) {
+        if (r == 1 && threadCounts[1] == 1) {
+            break;
+        }
+        CertificateReport report;
+        if (!generateCertificates(&store, directory, threadCounts[r], NULL, NULL, &report)) {
+            printf("Error: Generation failed.\n");
+            return 1;
+        }
+        char label[64];
+        snprintf(label, sizeof(label), "pool, %d thread%s", report.threads, report.threads == 1 ? "" : "s");
+        printRun(label, report.written, report.writeSeconds);
+    }
+    printf("Files are left in %s/.\n", directory);
+
+    storeFree(&store);
+    return 0;
+}
@@ -0,0 +1,260 @@
+// Concurrency stress test.
+//
+// Threads: readers look students up while writers add to their dues, under
+// the per-shard StoreLocks and under one store-wide lock for comparison.
+// Writers always change feesDue and hostelDue together, so a reader seeing
+// them differ has read a half-written record. At the end every student's
+// libraryBooksDue must equal the number of increments made to it.
+//
+// Processes: several processes increment the same students through the
+// journal, each taking the data lock and catching up on the others'
+// entries first; replaying the journal must show every increment. The same
+// run without the lock shows the updates that get lost.
+//
+// Build (from the project directory):
+//   gcc -O2 bench/bench_concurrency.c store_locks.c data_lock.c journal.c snapshot.c student_store.c name_arena.c money.c roll_map.c file_util.c timing.c -o bench_concurrency -pthread
+// Run:
+//   ./bench_concurrency [students] [threads] [opsPerThread] [processes] [opsPerProcess]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "../store_locks.h"
+#include "../data_lock.h"
+#include "../journal.h"
+#include "../timing.h"
+
+#define DEFAULT_STUDENTS 100000
+#define DEFAULT_THREADS 8
+#define DEFAULT_OPS 200000
+#define DEFAULT_PROCESSES 4
+#define DEFAULT_PROCESS_OPS 250
+#define WRITE_PERCENT 10
+#define FIRST_ROLL 1000
+#define JOURNAL_PATH "bench_concurrency.journal"
+#define LOCK_PATH "bench_concurrency.lock"
+
+typedef struct {
+    StudentStore *store;
+    StoreLocks *locks;
+    pthread_rwlock_t *globalLock;   // non-NULL: use it instead of the shards
+    int students;
+    int ops;
+    unsigned int seed;
+    long reads;
+    long writes;
+    long torn;
+    int *increments;                // per student, owned by this thread
+} Worker;
+
+static void fillStore(StudentStore *store, int students) {
+    Student s;
+    memset(&s, 0, sizeof(s));
+    for (int i = 0; i < students; i++) {
+        s.rollNumber = FIRST_ROLL + i;
+        char name[MAX_NAME_LENGTH];
+        int length = snprintf(name, sizeof(name), "STUDENT %d", i);
+        s.name = storeInternName(store, name, (size_t)length);
+        storeAdd(store, &s);
+    }
+}
+
+static void lockFor(Worker *w, int rollNumber, bool write) {
+    if (w->globalLock == NULL) {
+        storeLockRecord(w->locks, rollNumber, write);
+    } else if (write) {
+        pthread_rwlock_wrlock(w->globalLock);
+    } else {
+        pthread_rwlock_rdlock(w->globalLock);
+    }
+}
+
+static void unlockFor(Worker *w, int rollNumber) {
+    if (w->globalLock == NULL) {
+        storeUnlockRecord(w->locks, rollNumber);
+    } else {
+        pthread_rwlock_unlock(w->globalLock);
+    }
+}
+
+static void *runWorker(void *arg) {
+    Worker *w = arg;
+    unsigned int rng = w->seed;
+    for (int i = 0; i < w->ops; i++) {
+        rng = rng * 1103515245u + 12345u;
+        int index = (int)((rng >> 8) % (unsigned int)w->students);
+        int rollNumber = FIRST_ROLL + index;
+        bool write = (int)((rng >> 4) % 100) < WRITE_PERCENT;
+        lockFor(w, rollNumber, write);
+        Student *s = storeFindByRoll(w->store, rollNumber);
+        if (write) {
+            s->feesDue += MONEY_SCALE;
+            s->libraryBooksDue++;
+            s->hostelDue += MONEY_SCALE;
+            w->increments[index]++;
+            w->writes++;
+        } else {
+            if (s->feesDue != s->hostelDue) {
+                w->torn++;
+            }
+            w->reads++;
+        }
+        unlockFor(w, rollNumber);
+    }
+    return NULL;
+}
+
+// Run the mixed workload once; returns false if an update was lost
+static bool runThreads(const char *label, int students, int threads, int ops, bool global) {
+    StudentStore store;
+    StoreLocks locks;
+    pthread_rwlock_t globalLock;
+    storeInit(&store);
+    fillStore(&store, students);
+    storeLocksInit(&locks);
+    pthread_rwlock_init(&globalLock, NULL);
+
+    Worker *workers = calloc((size_t)threads, sizeof(Worker));
+    pthread_t *ids = malloc((size_t)threads * sizeof(pthread_t));
+    for (int t = 0; t < threads; t++) {
+        workers[t].store = &store;
+        workers[t].locks = &locks;
+        workers[t].globalLock = global ? &globalLock : NULL;
+        workers[t].students = students;
+        workers[t].ops = ops;
+        workers[t].seed = 2654435761u * (unsigned int)(t + 1);
+        workers[t].increments = calloc((size_t)students, sizeof(int));
+    }
+
+    double start = monotonicSeconds();
+    for (int t = 0; t < threads; t++) {
+        pthread_create(&ids[t], NULL, runWorker, &workers[t]);
+    }
+    for (int t = 0; t < threads; t++) {
+        pthread_join(ids[t], NULL);
+    }
+    double seconds = monotonicSeconds() - start;
+
+    long reads = 0, writes = 0, torn = 0, lost = 0;
+    for (int t = 0; t < threads; t++) {
+        reads += workers[t].reads;
+        writes += workers[t].writes;
+        torn += workers[t].torn;
+    }
+    for (int i = 0; i < students; i++) {
+        int expected = 0;
+        for (int t = 0; t < threads; t++) {
+            expected += workers[t].increments[i];
+        }
+        const Student *s = storeAt(&store, i);
+        if (s->libraryBooksDue != expected || s->feesDue != (Money)expected * MONEY_SCALE) {
+            lost += expected - s->libraryBooksDue;
+        }
+    }
+    printf("%-14s %ld reads, %ld writes in %.3f s: %.0f ops/s, torn reads %ld, lost updates %ld\n",
+           label, reads, writes, seconds, (reads + writes) / seconds, torn, lost);
+
+    for (int t = 0; t < threads; t++) {
+        free(workers[t].increments);
+    }
+    free(workers);
+    free(ids);
+    pthread_rwlock_destroy(&globalLock);
+    storeLocksFree(&locks);
+    storeFree(&store);
+    return torn == 0 && lost == 0;
+}
+
+// One process: increment random students' books through the journal
+static void runProcess(int students, int ops, unsigned int seed, bool locked) {
+    StudentStore store;
+    Journal journal;
+    DataLock lock;
+    DataGenerations generations;
+    storeInit(&store);
+    fillStore(&store, students);
+    journalReplay(JOURNAL_PATH, &store);
+    if (!journalOpen(&journal, JOURNAL_PATH) || !dataLockOpen(&lock, LOCK_PATH)) {
+        _exit(1);
+    }
+    unsigned int rng = seed;
+    for (int i = 0; i < ops; i++) {
+        rng = rng * 1103515245u + 12345u;
+        int rollNumber = FIRST_ROLL + (int)((rng >> 8) % (unsigned int)students);
+        if (locked) {
+            dataLockAcquire(&lock, true, true, &generations);
+            journalCatchUp(&journal, &store);
+        } else {
+            fseek(journal.file, 0, SEEK_END);
+        }
+        Student *s = storeFindByRoll(&store, rollNumber);
+        s->libraryBooksDue++;
+        journalAppend(&journal, JOURNAL_SET_BOOKS, s, NULL);
+        journalCommit(&journal);
+        if (locked) {
+            dataLockRelease(&lock, NULL);
+        }
+    }
+    journalClose(&journal);
+    dataLockClose(&lock);
+    storeFree(&store);
+    _exit(0);
+}
+
+// Returns the number of increments missing after all processes finish
+static long runProcesses(int students, int processes, int ops, bool locked) {
+    remove(JOURNAL_PATH);
+    double start = monotonicSeconds();
+    for (int p = 0; p < processes; p++) {
+        if (fork() == 0) {
+            runProcess(students, ops, 40503u * (unsigned int)(p + 1), locked);
+        }
+    }
+    for (int p = 0; p < processes; p++) {
+        wait(NULL);
+    }
+    double seconds = monotonicSeconds() - start;
+
+    StudentStore store;
+    storeInit(&store);
+    fillStore(&store, students);
+    journalReplay(JOURNAL_PATH, &store);
+    long total = 0;
+    for (int i = 0; i < store.count; i++) {
+        total += storeAt(&store, i)->libraryBooksDue;
+    }
+    storeFree(&store);
+    long expected = (long)processes * ops;
+    printf("%-14s %d processes x %d journaled updates in %.3f s: %.0f updates/s, lost updates %ld\n",
+           locked ? "data lock" : "no lock", processes, ops, seconds, expected / seconds, expected - total);
+    return expected - total;
+}
+
+int main(int argc, char *argv[]) {
+    int students = argc > 1 ? atoi(argv[1]) : DEFAULT_STUDENTS;
+    int threads = argc > 2 ? atoi(argv[2]) : DEFAULT_THREADS;
+    int ops = argc > 3 ? atoi(argv[3]) : DEFAULT_OPS;
+    int processes = argc > 4 ? atoi(argv[4]) : DEFAULT_PROCESSES;
+    int processOps = argc > 5 ? atoi(argv[5]) : DEFAULT_PROCESS_OPS;
+    if (students <= 0 || threads <= 0 || ops <= 0 || processes <= 0 || processOps <= 0) {
+        printf("Usage: %s [students] [threads] [opsPerThread] [processes] [opsPerProcess]\n", argv[0]);
+        return 1;
+    }
+
+    printf("%d threads x %d operations (%d%% writes) on %d students\n", threads, ops, WRITE_PERCENT, students);
+    bool ok = runThreads("shard locks", students, threads, ops, false);
+    ok = runThreads("one lock", students, threads, ops, true) && ok;
+
+    // Few students so the processes keep hitting the same records
+    int processStudents = 16;
+    ok = runProcesses(processStudents, processes, processOps, true) == 0 && ok;
+    runProcesses(processStudents, processes, processOps, false);
+
+    remove(JOURNAL_PATH);
+    remove(LOCK_PATH);
+    printf(ok ? "No lost updates with locking.\n" : "FAILED: updates were lost with locking.\n");
+    return ok ? 0 : 2;
+}
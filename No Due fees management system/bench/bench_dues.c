@@ -0,0 +1,101 @@
+// Dues summary benchmark: the per-record loop over Student structs versus
+// the branch-free loop over the dues columns. Both must give the same
+// totals. Build with -O3 so the column loop is vectorized.
+//
+// Build (from the project directory):
+//   gcc -O3 bench/bench_dues.c dues_columns.c student_store.c name_arena.c money.c roll_map.c timing.c -o bench_dues
+// Run:
+//   ./bench_dues [recordCount] [repeats]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../dues_columns.h"
+#include "../timing.h"
+
+#define DEFAULT_RECORDS 10000000
+#define DEFAULT_REPEATS 5
+
+static bool sameTotals(const DuesTotals *a, const DuesTotals *b) {
+    return a->students == b->students && a->owing == b->owing && a->feesDue == b->feesDue
+        && a->hostelDue == b->hostelDue && a->booksDue == b->booksDue;
+}
+
+int main(int argc, char *argv[]) {
+    int recordCount = argc > 1 ? atoi(argv[1]) : DEFAULT_RECORDS;
+    int repeats = argc > 2 ? atoi(argv[2]) : DEFAULT_REPEATS;
+    if (recordCount <= 0 || repeats <= 0) {
+        printf("Usage: %s [recordCount] [repeats]\n", argv[0]);
+        return 1;
+    }
+
+    StudentStore store;
+    storeInit(&store);
+    if (!storeReserve(&store, recordCount)) {
+        printf("Error: Out of memory.\n");
+        return 1;
+    }
+    unsigned int rng = 12345u;
+    Student s;
+    memset(&s, 0, sizeof(s));
+    for (int i = 0; i < recordCount; i++) {
+        rng = rng * 1103515245u + 12345u;
+        s.rollNumber = 2100000 + i;
+        char name[MAX_NAME_LENGTH];
+        int length = snprintf(name, sizeof(name), "STUDENT %d", i);
+        s.name = storeInternName(&store, name, (size_t)length);
+        int owes = (rng >> 4) % 4 != 0;
+        s.feesDue = owes ? (Money)((rng >> 8) % 5000000u) : 0;
+        s.hostelDue = owes ? (Money)((rng >> 12) % 3000000u) : 0;
+        s.libraryBooksDue = owes ? (int)((rng >> 24) % 4) : 0;
+        s.approvalStatus = (int)((rng >> 28) & 1);
+        storeAdd(&store, &s);
+    }
+
+    DuesColumns columns;
+    duesColumnsInit(&columns);
+    double start = monotonicSeconds();
+    if (!duesColumnsSync(&columns, &store)) {
+        printf("Error: Out of memory.\n");
+        return 1;
+    }
+    double buildSeconds = monotonicSeconds() - start;
+
+    DuesSummary records, columnar;
+    double recordBest = 0, columnBest = 0;
+    for (int r = 0; r < repeats; r++) {
+        start = monotonicSeconds();
+        duesSummarizeRecords(&store, &records);
+        double seconds = monotonicSeconds() - start;
+        if (r == 0 || seconds < recordBest) {
+            recordBest = seconds;
+        }
+
+        start = monotonicSeconds();
+        duesSummarize(&columns, &columnar);
+        seconds = monotonicSeconds() - start;
+        if (r == 0 || seconds < columnBest) {
+            columnBest = seconds;
+        }
+    }
+
+    double recordBytes = (double)recordCount * sizeof(Student);
+    double columnBytes = (double)recordCount * (sizeof(Money) * 2 + sizeof(int32_t) + sizeof(uint8_t));
+    printf("%d records, best of %d runs\n", recordCount, repeats);
+    printf("Records (AoS): %.3f ms, %.0f MB scanned (%.1f GB/s)\n",
+           recordBest * 1000, recordBytes / 1e6, recordBytes / recordBest / 1e9);
+    printf("Columns (SoA): %.3f ms, %.0f MB scanned (%.1f GB/s), %.1fx faster\n",
+           columnBest * 1000, columnBytes / 1e6, columnBytes / columnBest / 1e9, recordBest / columnBest);
+    printf("Building the columns: %.3f ms (once; then patched per change)\n", buildSeconds * 1000);
+
+    char amount[MONEY_TEXT_SIZE];
+    printf("Pending: %ld students, %ld owing, fees %s", columnar.pending.students, columnar.pending.owing,
+           moneyText(columnar.pending.feesDue, amount));
+    printf(", hostel %s, books %ld\n", moneyText(columnar.pending.hostelDue, amount), columnar.pending.booksDue);
+
+    bool same = sameTotals(&records.pending, &columnar.pending) && sameTotals(&records.approved, &columnar.approved);
+    printf(same ? "Both layouts give the same totals.\n" : "FAILED: the totals differ.\n");
+    duesColumnsFree(&columns);
+    storeFree(&store);
+    return same ? 0 : 2;
+}
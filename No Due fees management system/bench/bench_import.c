@@ -0,0 +1,117 @@
+// Roster import benchmark: merging a registrar roster one row at a time with
+// a linear roll search (the old addNewStudent check) versus the hash-joined
+// bulk import.
+//
+// Build (from the project directory):
+//   gcc -O2 bench/bench_import.c roster_import.c audit_log.c csv_loader.c student_store.c name_arena.c money.c roll_map.c snapshot.c file_util.c timing.c -o bench_import
+// Run:
+//   ./bench_import [rosterRows] [path]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "../roster_import.h"
+#include "../timing.h"
+
+#define DEFAULT_ROWS 500000
+#define DEFAULT_PATH "bench_roster.txt"
+#define LINEAR_SAMPLE 1000
+
+static const char *firstNames[] = { "AARAV", "ABHA", "ADITYA", "ANANYA", "ISHAAN", "KAVYA", "PREETI", "VIVEK" };
+static const char *lastNames[] = { "GUPTA", "NEGI", "PANDEY", "SAXENA", "CHAUHAN", "BHARDWAJ", "RAWAT" };
+
+static Money amount(unsigned int bits) {
+    return (Money)(bits % 5) * 500 * MONEY_SCALE;
+}
+
+// Store with rows*9/10 students; the roster keeps most of them, changes dues
+// for one in five and adds rows/10 new rolls
+static bool makeData(StudentStore *store, const char *path, int rows) {
+    int existing = rows - rows / 10;
+    if (!storeReserve(store, existing)) {
+        return false;
+    }
+    FILE *file = fopen(path, "w");
+    if (file == NULL) {
+        return false;
+    }
+    fprintf(file, "roll,name,fees,books,hostel\n");
+    unsigned int rng = 12345u;
+    for (int i = 0; i < rows; i++) {
+        rng = rng * 1103515245u + 12345u;
+        Student s;
+        s.rollNumber = 2100000 + i * 7;
+        char name[MAX_NAME_LENGTH];
+        int length = snprintf(name, sizeof(name), "%s %s", firstNames[(rng >> 8) % 8], lastNames[(rng >> 12) % 7]);
+        s.feesDue = amount(rng >> 16);
+        s.libraryBooksDue = (int)((rng >> 20) % 6);
+        s.hostelDue = amount(rng >> 24);
+        s.approvalStatus = 0;
+        if (i < existing) {
+            s.name = storeInternName(store, name, (size_t)length);
+            storeAdd(store, &s);
+            if (i % 5 == 0) {
+                s.feesDue += 250 * MONEY_SCALE;
+            }
+        }
+        char fees[MONEY_TEXT_SIZE], hostel[MONEY_TEXT_SIZE];
+        fprintf(file, "%d,%s,%s,%d,%s\n", s.rollNumber, name, moneyText(s.feesDue, fees),
+                s.libraryBooksDue, moneyText(s.hostelDue, hostel));
+    }
+    return fclose(file) == 0;
+}
+
+int main(int argc, char *argv[]) {
+    int rows = argc > 1 ? atoi(argv[1]) : DEFAULT_ROWS;
+    const char *path = argc > 2 ? argv[2] : DEFAULT_PATH;
+    if (rows <= 0) {
+        printf("Usage: %s [rosterRows] [path]\n", argv[0]);
+        return 1;
+    }
+
+    StudentStore store;
+    storeInit(&store);
+    if (!makeData(&store, path, rows)) {
+        printf("Error: Could not create %s.\n", path);
+        return 1;
+    }
+    printf("Store: %d students, roster: %d rows\n", store.count, rows);
+
+    // Before: every roster row searched the whole array for its roll.
+    // Only a sample is timed; the full run would take far too long.
+    long long found = 0;
+    double start = monotonicSeconds();
+    for (int q = 0; q < LINEAR_SAMPLE; q++) {
+        int roll = 2100000 + (int)(((long long)q * rows / LINEAR_SAMPLE) * 7);
+        for (int i = 0; i < store.count; i++) {
+            if (storeAt(&store, i)->rollNumber == roll) {
+                found++;
+                break;
+            }
+        }
+    }
+    double linearSeconds = (monotonicSeconds() - start) / LINEAR_SAMPLE * rows;
+    printf("  linear search per row : %10.3f s (estimated from %d rows, %lld found)\n",
+           linearSeconds, LINEAR_SAMPLE, found);
+
+    // After: one pass, hash join against the roll index
+    RosterReport report;
+    if (!rosterImport(path, &store, NULL, true, NULL, &report)) {
+        printf("Error: Dry run failed.\n");
+        return 1;
+    }
+    printf("  dry run (parse + join): %10.3f s (%.0f rows/s)\n",
+           report.parseSeconds, rows / report.parseSeconds);
+    if (!rosterImport(path, &store, NULL, false, NULL, &report)) {
+        printf("Error: Import failed.\n");
+        return 1;
+    }
+    printf("  import (join + apply) : %10.3f s (%d new, %d updated, %d unchanged)\n",
+           report.parseSeconds + report.applySeconds, report.inserted, report.updated, report.unchanged);
+    if (report.parseSeconds + report.applySeconds > 0) {
+        printf("  speedup               : %10.0fx\n", linearSeconds / (report.parseSeconds + report.applySeconds));
+    }
+
+    storeFree(&store);
+    remove(path);
+    return 0;
+}
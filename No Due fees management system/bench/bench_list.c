@@ -0,0 +1,118 @@
+// Student listing benchmark: the old printf-per-row table versus the
+// buffered listing engine, plus filtered selection with sorting.
+//
+// Build (from the project directory):
+//   gcc -O2 bench/bench_list.c student_list.c student_store.c name_arena.c money.c roll_map.c timing.c -o bench_list
+// Run:
+//   ./bench_list [recordCount]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../student_list.h"
+#include "../timing.h"
+
+#define DEFAULT_RECORDS 1000000
+
+#ifdef _WIN32
+#define NULL_DEVICE "NUL"
+#else
+#define NULL_DEVICE "/dev/null"
+#endif
+
+static const char *firstNames[] = { "AARAV", "ABHA", "ADITYA", "ANANYA", "ISHAAN", "KAVYA", "PREETI", "VIVEK" };
+static const char *lastNames[] = { "GUPTA", "NEGI", "PANDEY", "SAXENA", "CHAUHAN", "BHARDWAJ", "RAWAT" };
+
+// The table as displayAllStudents() used to print it
+static void printWithPrintf(FILE *out, const StudentStore *store) {
+    char fees[MONEY_TEXT_SIZE], hostel[MONEY_TEXT_SIZE];
+    for (int i = 0; i < store->count; i++) {
+        const Student *s = storeAt(store, i);
+        fprintf(out, "%d\t%-12s\t%s\t\t%d\t\t%s\t\t%s\n",
+                s->rollNumber, storeName(store, s), moneyText(s->feesDue, fees), s->libraryBooksDue,
+                moneyText(s->hostelDue, hostel),
+                s->approvalStatus ? "Approved" : "Pending");
+    }
+}
+
+static double timeQuery(const StudentStore *store, const ListQuery *query, int *matches) {
+    ListResult result;
+    double start = monotonicSeconds();
+    if (!listSelect(store, query, &result)) {
+        printf("Error: Out of memory.\n");
+        exit(1);
+    }
+    double seconds = monotonicSeconds() - start;
+    *matches = result.count;
+    listResultFree(&result);
+    return seconds;
+}
+
+int main(int argc, char *argv[]) {
+    int recordCount = argc > 1 ? atoi(argv[1]) : DEFAULT_RECORDS;
+    if (recordCount <= 0) {
+        printf("Usage: %s [recordCount]\n", argv[0]);
+        return 1;
+    }
+
+    StudentStore store;
+    storeInit(&store);
+    unsigned int rng = 12345u;
+    for (int i = 0; i < recordCount; i++) {
+        rng = rng * 1103515245u + 12345u;
+        Student s;
+        s.rollNumber = 2100000 + i * 7;
+        char name[MAX_NAME_LENGTH];
+        int length = snprintf(name, sizeof(name), "%s %s", firstNames[(rng >> 8) % 8], lastNames[(rng >> 12) % 7]);
+        s.name = storeInternName(&store, name, (size_t)length);
+        s.feesDue = (Money)((rng >> 16) % 5) * 500 * MONEY_SCALE;
+        s.libraryBooksDue = (int)((rng >> 20) % 6);
+        s.hostelDue = (Money)((rng >> 24) % 5) * 500 * MONEY_SCALE;
+        s.approvalStatus = (int)((rng >> 28) & 1);
+        storeAdd(&store, &s);
+    }
+
+    FILE *out = fopen(NULL_DEVICE, "w");
+    if (out == NULL) {
+        printf("Error: Could not open %s.\n", NULL_DEVICE);
+        return 1;
+    }
+
+    double start = monotonicSeconds();
+    printWithPrintf(out, &store);
+    fflush(out);
+    double printfSeconds = monotonicSeconds() - start;
+
+    ListQuery query;
+    listQueryDefaults(&query);
+    ListResult all;
+    start = monotonicSeconds();
+    listSelect(&store, &query, &all);
+    listWriteRows(out, &all, 0, all.count);
+    double engineSeconds = monotonicSeconds() - start;
+    listResultFree(&all);
+    fclose(out);
+
+    printf("Full table of %d rows: printf per row %.3f s, buffered engine %.3f s (incl. sort by roll)\n",
+           recordCount, printfSeconds, engineSeconds);
+
+    int matches;
+    double seconds;
+    listQueryDefaults(&query);
+    query.pendingOnly = true;
+    seconds = timeQuery(&store, &query, &matches);
+    printf("Pending only:        %.3f s, %d rows\n", seconds, matches);
+    listQueryDefaults(&query);
+    query.minDues = 2000.0f;
+    query.sort = LIST_SORT_DUES;
+    seconds = timeQuery(&store, &query, &matches);
+    printf("Dues > 2000 by dues: %.3f s, %d rows\n", seconds, matches);
+    listQueryDefaults(&query);
+    strcpy(query.namePrefix, "aditya");
+    query.sort = LIST_SORT_NAME;
+    seconds = timeQuery(&store, &query, &matches);
+    printf("Name prefix by name: %.3f s, %d rows\n", seconds, matches);
+
+    storeFree(&store);
+    return 0;
+}
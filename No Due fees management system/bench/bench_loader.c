@@ -0,0 +1,103 @@
+// student.txt parse benchmark: the old per-line fscanf loop versus the
+// memory-mapped bulk loader.
+//
+// Build (from the project directory):
+//   gcc -O2 bench/bench_loader.c csv_loader.c student_store.c name_arena.c money.c roll_map.c file_util.c timing.c -o bench_loader
+// Run:
+//   ./bench_loader [lineCount] [path]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../csv_loader.h"
+#include "../timing.h"
+
+#define DEFAULT_LINES 1000000
+#define DEFAULT_PATH "bench_students.txt"
+
+static const char *firstNames[] = { "AARAV", "ABHA", "ADITYA", "ANANYA", "ISHAAN", "KAVYA", "PREETI", "VIVEK" };
+static const char *lastNames[] = { "GUPTA", "NEGI", "PANDEY", "SAXENA", "CHAUHAN", "BHARDWAJ", "RAWAT" };
+
+static bool writeSyntheticFile(const char *path, int lines) {
+    FILE *file = fopen(path, "w");
+    if (file == NULL) {
+        return false;
+    }
+    unsigned int rng = 12345u;
+    for (int i = 0; i < lines; i++) {
+        rng = rng * 1103515245u + 12345u;
+        fprintf(file, "%d,%s %s,%.2f,%d,%.2f,%d\n",
+                i + 1,
+                firstNames[(rng >> 8) % 8],
+                lastNames[(rng >> 12) % 7],
+                (float)((rng >> 16) % 5) * 500.0f,
+                (int)((rng >> 20) % 6),
+                (float)((rng >> 24) % 5) * 500.0f,
+                (int)((rng >> 28) & 1));
+    }
+    fclose(file);
+    return true;
+}
+
+// The loader as it was: one fscanf per record
+static int loadWithFscanf(const char *path, StudentStore *store) {
+    FILE *file = fopen(path, "r");
+    if (file == NULL) {
+        return 0;
+    }
+    Student record;
+    char name[LEGACY_NAME_LENGTH];
+    float feesDue, hostelDue;
+    while (fscanf(file, "%d,%49[^,],%f,%d,%f,%d",
+                  &record.rollNumber, name, &feesDue,
+                  &record.libraryBooksDue, &hostelDue, &record.approvalStatus) == 6) {
+        if (!moneyFromDouble(feesDue, &record.feesDue) || !moneyFromDouble(hostelDue, &record.hostelDue)) {
+            continue;
+        }
+        record.name = storeInternName(store, name, strlen(name));
+        storeAdd(store, &record);
+    }
+    fclose(file);
+    return store->count;
+}
+
+int main(int argc, char *argv[]) {
+    int lines = argc > 1 ? atoi(argv[1]) : DEFAULT_LINES;
+    const char *path = argc > 2 ? argv[2] : DEFAULT_PATH;
+    if (lines <= 0) {
+        printf("Usage: %s [lineCount] [path]\n", argv[0]);
+        return 1;
+    }
+
+    if (!writeSyntheticFile(path, lines)) {
+        printf("Error: Could not write %s.\n", path);
+        return 1;
+    }
+
+    StudentStore store;
+    storeInit(&store);
+
+    double start = monotonicSeconds();
+    int loaded = loadWithFscanf(path, &store);
+    double fscanfSeconds = monotonicSeconds() - start;
+
+    storeFree(&store);
+    storeInit(&store);
+
+    CsvLoadStats stats;
+    if (!loadStudentsFromCsv(path, &store, &stats)) {
+        printf("Error: Could not read %s.\n", path);
+        return 1;
+    }
+
+    double megabytes = stats.bytes / (1024.0 * 1024.0);
+    printf("File: %s, %d lines, %.1f MB\n", path, lines, megabytes);
+    printf("fscanf loop: %d records in %.3f s (%.1f MB/s)\n",
+           loaded, fscanfSeconds, megabytes / fscanfSeconds);
+    printf("Bulk loader: %d records in %.3f s (%.1f MB/s), %d malformed\n",
+           stats.loaded, stats.seconds, megabytes / stats.seconds, stats.malformed);
+
+    storeFree(&store);
+    remove(path);
+    return 0;
+}
@@ -0,0 +1,134 @@
+// Money precision check: writes a roster with paise-level dues, loads it
+// back, and compares the summed dues with a reference total kept in integer
+// paise while generating. The same sums in float show the drift the old
+// representation had. Finally the roster is saved again and must come out
+// byte-identical to the generated file.
+//
+// Build (from the project directory):
+//   gcc -O2 bench/bench_money.c csv_loader.c student_store.c name_arena.c money.c roll_map.c file_util.c timing.c -o bench_money
+// Run:
+//   ./bench_money [recordCount] [path]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../csv_loader.h"
+#include "../timing.h"
+
+#define DEFAULT_RECORDS 1000000
+#define DEFAULT_PATH "bench_money.txt"
+#define COPY_SUFFIX ".out"
+
+// Dues up to 9,99,999.99 so that per-record floats are already inexact
+static bool writeRoster(const char *path, int records, Money *feesTotal, Money *hostelTotal) {
+    FILE *file = fopen(path, "w");
+    if (file == NULL) {
+        return false;
+    }
+    unsigned int rng = 12345u;
+    char fees[MONEY_TEXT_SIZE], hostel[MONEY_TEXT_SIZE];
+    *feesTotal = 0;
+    *hostelTotal = 0;
+    for (int i = 0; i < records; i++) {
+        rng = rng * 1103515245u + 12345u;
+        Money feesDue = (Money)(rng % 100000000u);
+        rng = rng * 1103515245u + 12345u;
+        Money hostelDue = (Money)(rng % 100000000u);
+        *feesTotal += feesDue;
+        *hostelTotal += hostelDue;
+        fprintf(file, "%d,STUDENT %d,%s,%d,%s,%d\n", 2100000 + i, i,
+                moneyText(feesDue, fees), (int)(rng >> 28) % 6, moneyText(hostelDue, hostel), i & 1);
+    }
+    fclose(file);
+    return true;
+}
+
+static bool sameFile(const char *a, const char *b) {
+    FILE *x = fopen(a, "rb");
+    FILE *y = fopen(b, "rb");
+    bool same = x != NULL && y != NULL;
+    char bufferX[65536], bufferY[65536];
+    while (same) {
+        size_t readX = fread(bufferX, 1, sizeof(bufferX), x);
+        size_t readY = fread(bufferY, 1, sizeof(bufferY), y);
+        if (readX != readY || memcmp(bufferX, bufferY, readX) != 0) {
+            same = false;
+        } else if (readX == 0) {
+            break;
+        }
+    }
+    if (x != NULL) {
+        fclose(x);
+    }
+    if (y != NULL) {
+        fclose(y);
+    }
+    return same;
+}
+
+int main(int argc, char *argv[]) {
+    int records = argc > 1 ? atoi(argv[1]) : DEFAULT_RECORDS;
+    const char *path = argc > 2 ? argv[2] : DEFAULT_PATH;
+    if (records <= 0) {
+        printf("Usage: %s [recordCount] [path]\n", argv[0]);
+        return 1;
+    }
+
+    Money expectedFees, expectedHostel;
+    if (!writeRoster(path, records, &expectedFees, &expectedHostel)) {
+        printf("Error: Could not write %s.\n", path);
+        return 1;
+    }
+
+    StudentStore store;
+    storeInit(&store);
+    CsvLoadStats stats;
+    if (!loadStudentsFromCsv(path, &store, &stats) || stats.loaded != records) {
+        printf("Error: Could not load %s.\n", path);
+        return 1;
+    }
+
+    double start = monotonicSeconds();
+    Money feesTotal = 0, hostelTotal = 0;
+    for (int i = 0; i < store.count; i++) {
+        const Student *s = storeAt(&store, i);
+        feesTotal += s->feesDue;
+        hostelTotal += s->hostelDue;
+    }
+    double moneySeconds = monotonicSeconds() - start;
+
+    // What the float fields and a float accumulator would have reported
+    start = monotonicSeconds();
+    float floatFees = 0.0f, floatHostel = 0.0f;
+    for (int i = 0; i < store.count; i++) {
+        const Student *s = storeAt(&store, i);
+        floatFees += (float)s->feesDue / MONEY_SCALE;
+        floatHostel += (float)s->hostelDue / MONEY_SCALE;
+    }
+    double floatSeconds = monotonicSeconds() - start;
+
+    char expected[MONEY_TEXT_SIZE], actual[MONEY_TEXT_SIZE];
+    printf("%d records loaded in %.3f s\n", stats.loaded, stats.seconds);
+    printf("Fees due:   reference %s, int64 sum %s, float sum %.2f\n",
+           moneyText(expectedFees, expected), moneyText(feesTotal, actual), floatFees);
+    printf("Hostel due: reference %s, int64 sum %s, float sum %.2f\n",
+           moneyText(expectedHostel, expected), moneyText(hostelTotal, actual), floatHostel);
+    printf("Summing: int64 %.3f ms, float %.3f ms\n", moneySeconds * 1000, floatSeconds * 1000);
+
+    bool exact = feesTotal == expectedFees && hostelTotal == expectedHostel;
+
+    char copyPath[512];
+    snprintf(copyPath, sizeof(copyPath), "%s%s", path, COPY_SUFFIX);
+    bool roundTrip = saveStudentsToCsv(copyPath, &store) && sameFile(path, copyPath);
+    printf("Save after load is %s the generated file.\n", roundTrip ? "byte-identical to" : "DIFFERENT from");
+
+    storeFree(&store);
+    remove(path);
+    remove(copyPath);
+    if (!exact || !roundTrip) {
+        printf("FAILED: %s\n", exact ? "CSV round trip changed the data." : "totals do not match the reference.");
+        return 2;
+    }
+    printf("Totals match the reference exactly.\n");
+    return 0;
+}
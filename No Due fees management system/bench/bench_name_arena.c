@@ -0,0 +1,155 @@
+// Name storage benchmark: records with a fixed 50-byte name field (the
+// version-2 layout) versus 32-byte records whose names are interned in the
+// store's arena. Reports memory for the records and names, a dues scan over
+// each layout, and how many names the fixed field would have cut short.
+//
+// Build (from the project directory):
+//   gcc -O2 bench/bench_name_arena.c student_store.c name_arena.c money.c roll_map.c timing.c -o bench_name_arena
+// Run:
+//   ./bench_name_arena [recordCount] [repeats]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../student_store.h"
+#include "../timing.h"
+
+#define DEFAULT_RECORDS 1000000
+#define DEFAULT_REPEATS 10
+
+static const char *firstNames[] = {
+    "AARAV", "ABHA", "ADITYA", "ANANYA", "ISHAAN", "KAVYA", "PREETI", "VIVEK",
+    "ROHAN", "MEERA", "ARJUN", "DIVYA", "KARAN", "NEHA", "SAURABH", "TANVI"
+};
+static const char *middleNames[] = {
+    "KUMAR", "PRASAD", "NATH", "LAL", "DEVI", "RANI", "CHANDRA", "MOHAN"
+};
+static const char *lastNames[] = {
+    "GUPTA", "NEGI", "PANDEY", "SAXENA", "CHAUHAN", "BHARDWAJ", "RAWAT", "DOBHAL",
+    "IYER", "REDDY", "MENON", "KULKARNI"
+};
+// Full given names as some registrars record them (well past 49 characters)
+static const char *longNames[] = {
+    "SRI VENKATA SATYA NARAYANA SUBRAHMANYA LAKSHMI PRASANNA KUMAR",
+    "KANAKADURGA VENKATA NAGA SAI SRINIVASA RAMACHANDRA MURTHY",
+    "MOHAMMED ABDUL RAHMAN SYED NIZAMUDDIN HUSSAINI QUADRI"
+};
+
+static unsigned int nextRandom(unsigned int *state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 17;
+    *state ^= *state << 5;
+    return *state;
+}
+
+// One in 50 names is a long one; a third have a middle name
+static int makeName(char *name, unsigned int *rng) {
+    unsigned int r = nextRandom(rng);
+    const char *last = lastNames[(r >> 8) % 12];
+    if (r % 50 == 0) {
+        return snprintf(name, MAX_NAME_LENGTH, "%s %s", longNames[(r >> 12) % 3], last);
+    }
+    const char *first = firstNames[(r >> 16) % 16];
+    if ((r >> 20) % 3 == 0) {
+        return snprintf(name, MAX_NAME_LENGTH, "%s %s %s", first, middleNames[(r >> 24) % 8], last);
+    }
+    return snprintf(name, MAX_NAME_LENGTH, "%s %s", first, last);
+}
+
+static double megabytes(size_t bytes) {
+    return bytes / (1024.0 * 1024.0);
+}
+
+int main(int argc, char *argv[]) {
+    int recordCount = argc > 1 ? atoi(argv[1]) : DEFAULT_RECORDS;
+    int repeats = argc > 2 ? atoi(argv[2]) : DEFAULT_REPEATS;
+    if (recordCount <= 0 || repeats <= 0) {
+        printf("Usage: %s [recordCount] [repeats]\n", argv[0]);
+        return 1;
+    }
+
+    StudentV2 *fixed = malloc(sizeof(StudentV2) * (size_t)recordCount);
+    StudentStore store;
+    storeInit(&store);
+    if (fixed == NULL || !storeReserve(&store, recordCount)) {
+        printf("Error: Out of memory.\n");
+        return 1;
+    }
+
+    // Same names into both layouts
+    unsigned int rng = 2463534242u;
+    int truncated = 0;
+    long long nameBytes = 0;
+    double fixedSeconds = 0;
+    double arenaSeconds = 0;
+    for (int i = 0; i < recordCount; i++) {
+        char name[MAX_NAME_LENGTH];
+        int length = makeName(name, &rng);
+        nameBytes += length + 1;
+        truncated += length >= LEGACY_NAME_LENGTH;
+
+        double start = monotonicSeconds();
+        StudentV2 *old = &fixed[i];
+        memset(old, 0, sizeof(*old));
+        old->rollNumber = 2100000 + i;
+        memcpy(old->name, name, length < LEGACY_NAME_LENGTH ? (size_t)length : LEGACY_NAME_LENGTH - 1);
+        old->feesDue = (Money)(i % 5) * 500 * MONEY_SCALE;
+        old->hostelDue = (Money)(i % 3) * 500 * MONEY_SCALE;
+        old->libraryBooksDue = i % 6;
+        fixedSeconds += monotonicSeconds() - start;
+
+        start = monotonicSeconds();
+        Student s;
+        s.rollNumber = old->rollNumber;
+        s.name = storeInternName(&store, name, (size_t)length);
+        s.feesDue = old->feesDue;
+        s.hostelDue = old->hostelDue;
+        s.libraryBooksDue = old->libraryBooksDue;
+        s.approvalStatus = 0;
+        if (s.name == NAME_NONE || storeAdd(&store, &s) == NULL) {
+            printf("Error: Out of memory.\n");
+            return 1;
+        }
+        arenaSeconds += monotonicSeconds() - start;
+    }
+
+    size_t fixedBytes = sizeof(StudentV2) * (size_t)recordCount;
+    size_t recordBytes = sizeof(Student) * (size_t)recordCount;
+    size_t arenaBytes = nameArenaMemory(&store.names);
+    printf("%d students, %u distinct names, %.1f bytes per name on average\n",
+           recordCount, store.names.tableCount, (double)nameBytes / recordCount);
+    printf("  fixed name[%d]: %zu-byte records       %8.1f MB\n",
+           LEGACY_NAME_LENGTH, sizeof(StudentV2), megabytes(fixedBytes));
+    printf("  arena         : %zu-byte records %6.1f MB + names %.1f MB = %.1f MB\n",
+           sizeof(Student), megabytes(recordBytes), megabytes(arenaBytes), megabytes(recordBytes + arenaBytes));
+    printf("  arena, no name repeated: about %.1f MB\n", megabytes(recordBytes + (size_t)nameBytes + sizeof(uint32_t) * 2 * (size_t)recordCount));
+    printf("  names cut short by the fixed field: %d (%.1f%%), by the arena: 0\n",
+           truncated, 100.0 * truncated / recordCount);
+    printf("  fill: fixed %.3f s, arena %.3f s (intern + add)\n", fixedSeconds, arenaSeconds);
+
+    // The dues scan reads every record; smaller records mean fewer cache lines
+    Money fixedTotal = 0;
+    double start = monotonicSeconds();
+    for (int r = 0; r < repeats; r++) {
+        for (int i = 0; i < recordCount; i++) {
+            fixedTotal += fixed[i].feesDue + fixed[i].hostelDue;
+        }
+    }
+    double fixedScan = (monotonicSeconds() - start) / repeats;
+
+    Money arenaTotal = 0;
+    start = monotonicSeconds();
+    for (int r = 0; r < repeats; r++) {
+        for (int i = 0; i < recordCount; i++) {
+            const Student *s = storeAt(&store, i);
+            arenaTotal += s->feesDue + s->hostelDue;
+        }
+    }
+    double arenaScan = (monotonicSeconds() - start) / repeats;
+    printf("  dues scan: fixed %.2f ms, arena %.2f ms (%.2fx)%s\n", fixedScan * 1e3, arenaScan * 1e3,
+           arenaScan > 0 ? fixedScan / arenaScan : 0.0, fixedTotal == arenaTotal ? "" : "  TOTALS DIFFER");
+
+    storeFree(&store);
+    free(fixed);
+    return 0;
+}
@@ -0,0 +1,138 @@
+// Name search benchmark: a case-insensitive scan of every record versus the
+// word/trigram name index, for prefix, substring and fuzzy queries.
+//
+// Build (from the project directory):
+//   gcc -O2 bench/bench_names.c name_index.c student_list.c student_store.c name_arena.c money.c roll_map.c timing.c -o bench_names
+// Run:
+//   ./bench_names [recordCount]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "../name_index.h"
+#include "../timing.h"
+
+#define DEFAULT_RECORDS 1000000
+#define QUERIES 200
+#define SCAN_QUERIES 5
+
+static const char *syllables[] = {
+    "a", "ab", "ad", "ak", "am", "an", "ar", "ash", "av", "bha", "bi", "chan", "de", "dev", "dh",
+    "ga", "gu", "ha", "i", "ja", "ka", "kh", "ku", "la", "ma", "me", "na", "ne", "ni", "pa",
+    "pra", "pu", "ra", "ri", "sa", "sax", "se", "sh", "si", "ta", "ti", "u", "va", "vi", "ya"
+};
+#define SYLLABLE_COUNT (int)(sizeof(syllables) / sizeof(syllables[0]))
+
+static void makeWord(char *out, unsigned int *rng) {
+    int parts = 2 + (int)(*rng % 3);
+    out[0] = '\0';
+    for (int i = 0; i < parts; i++) {
+        *rng = *rng * 1103515245u + 12345u;
+        strcat(out, syllables[(*rng >> 16) % SYLLABLE_COUNT]);
+    }
+}
+
+// Case-insensitive containment without an index
+static bool containsIgnoreCase(const char *name, const char *query) {
+    size_t length = strlen(query);
+    for (; *name != '\0'; name++) {
+        size_t i = 0;
+        while (i < length && tolower((unsigned char)name[i]) == query[i]) {
+            i++;
+        }
+        if (i == length) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static double timeIndex(NameIndex *index, const StudentStore *store, char queries[][MAX_NAME_LENGTH],
+                        NameSearchMode mode, long *matches) {
+    *matches = 0;
+    double start = monotonicSeconds();
+    for (int q = 0; q < QUERIES; q++) {
+        ListResult result;
+        if (!nameIndexSearch(index, store, queries[q], mode, &result)) {
+            printf("Error: Out of memory.\n");
+            exit(1);
+        }
+        *matches += result.count;
+        listResultFree(&result);
+    }
+    return (monotonicSeconds() - start) / QUERIES * 1e6;
+}
+
+int main(int argc, char *argv[]) {
+    int recordCount = argc > 1 ? atoi(argv[1]) : DEFAULT_RECORDS;
+    if (recordCount <= 0) {
+        printf("Usage: %s [recordCount]\n", argv[0]);
+        return 1;
+    }
+
+    StudentStore store;
+    storeInit(&store);
+    unsigned int rng = 12345u;
+    for (int i = 0; i < recordCount; i++) {
+        Student s;
+        char first[MAX_NAME_LENGTH / 2];
+        char last[MAX_NAME_LENGTH / 2];
+        makeWord(first, &rng);
+        makeWord(last, &rng);
+        memset(&s, 0, sizeof(s));
+        s.rollNumber = i + 1;
+        char name[MAX_NAME_LENGTH];
+        int length = snprintf(name, sizeof(name), "%s %s", first, last);
+        for (char *c = name; *c != '\0'; c++) {
+            *c = (char)toupper((unsigned char)*c);
+        }
+        s.name = storeInternName(&store, name, (size_t)length);
+        storeAdd(&store, &s);
+    }
+
+    NameIndex index;
+    nameIndexInit(&index);
+    double start = monotonicSeconds();
+    if (!nameIndexBuild(&index, &store)) {
+        printf("Error: Out of memory.\n");
+        return 1;
+    }
+    printf("Index over %d names: %d distinct words, %d trigrams, built in %.3f s\n",
+           recordCount, index.wordCount, index.trigramCount, monotonicSeconds() - start);
+
+    // Queries: word prefixes, inner substrings, and words with one letter dropped
+    static char prefixes[QUERIES][MAX_NAME_LENGTH];
+    static char substrings[QUERIES][MAX_NAME_LENGTH];
+    static char misspelt[QUERIES][MAX_NAME_LENGTH];
+    for (int q = 0; q < QUERIES; q++) {
+        char word[MAX_NAME_LENGTH];
+        makeWord(word, &rng);
+        size_t length = strlen(word);
+        snprintf(prefixes[q], MAX_NAME_LENGTH, "%.*s", (int)(length > 5 ? 5 : length), word);
+        snprintf(substrings[q], MAX_NAME_LENGTH, "%.*s", 4, length > 5 ? word + 1 : word);
+        size_t drop = length / 2;
+        snprintf(misspelt[q], MAX_NAME_LENGTH, "%.*s%s", (int)drop, word, word + drop + 1);
+    }
+
+    long matches = 0;
+    start = monotonicSeconds();
+    for (int q = 0; q < SCAN_QUERIES; q++) {
+        for (int i = 0; i < store.count; i++) {
+            matches += containsIgnoreCase(storeName(&store, storeAt(&store, i)), substrings[q]);
+        }
+    }
+    double scanMicros = (monotonicSeconds() - start) / SCAN_QUERIES * 1e6;
+    printf("Full scan substring:   %10.1f us/query\n", scanMicros);
+
+    double micros = timeIndex(&index, &store, prefixes, NAME_SEARCH_PREFIX, &matches);
+    printf("Index word prefix:     %10.1f us/query (%ld matches/query)\n", micros, matches / QUERIES);
+    micros = timeIndex(&index, &store, substrings, NAME_SEARCH_SUBSTRING, &matches);
+    printf("Index substring:       %10.1f us/query (%ld matches/query)\n", micros, matches / QUERIES);
+    micros = timeIndex(&index, &store, misspelt, NAME_SEARCH_FUZZY, &matches);
+    printf("Index fuzzy (1 edit):  %10.1f us/query (%ld matches/query)\n", micros, matches / QUERIES);
+
+    nameIndexFree(&index);
+    storeFree(&store);
+    return 0;
+}
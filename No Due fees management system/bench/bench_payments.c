@@ -0,0 +1,139 @@
+// payment_history.txt ingest benchmark: one thread versus all cores on a
+// synthetic log with the date spellings seen in the real file, then a full
+// keyed reconciliation versus an incremental run over newly appended lines.
+//
+// Build (from the project directory):
+//   gcc -O2 bench/bench_payments.c payment_ingest.c payment_checkpoint.c csv_loader.c student_store.c name_arena.c money.c roll_map.c journal.c snapshot.c file_util.c timing.c -o bench_payments -pthread
+// Run:
+//   ./bench_payments [lineCount] [threads] [path]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "../payment_ingest.h"
+
+#define DEFAULT_LINES 5000000
+#define DEFAULT_PATH "bench_payments.txt"
+#define ROLL_RANGE 1000000
+#define APPENDED_LINES 10000
+
+static const char *categories[] = { "Fees", "Hostel", "Both" };
+
+static bool writeSyntheticFile(const char *path, long lines, const char *mode, unsigned int seed) {
+    FILE *file = fopen(path, mode);
+    if (file == NULL) {
+        return false;
+    }
+    unsigned int rng = seed;
+    for (long i = 0; i < lines; i++) {
+        rng = rng * 1103515245u + 12345u;
+        int day = (int)((rng >> 8) % 28) + 1;
+        int month = (int)((rng >> 13) % 12) + 1;
+        fprintf(file, "%d,", (int)((rng >> 4) % ROLL_RANGE) + 1);
+        switch ((rng >> 17) % 4) {
+            case 0:
+                fprintf(file, "%02d%02d2025", day, month);
+                break;
+            case 1:
+                fprintf(file, "%d %d 2025", day, month);
+                break;
+            case 2:
+                fprintf(file, "2025%02d%02d", month, day);
+                break;
+            default:
+                fprintf(file, "00000000");
+        }
+        fprintf(file, ",%d.00,%s\n", (int)((rng >> 20) % 40 + 1) * 50, categories[(rng >> 27) % 3]);
+    }
+    fclose(file);
+    return true;
+}
+
+// Ingest once and return the checksum of all totals (must match across runs)
+static double runIngest(const char *path, int threads, PaymentIngestStats *stats, int *rolls) {
+    PaymentTotals totals;
+    paymentTotalsInit(&totals);
+    if (!ingestPayments(path, threads, NULL, NULL, &totals, stats)) {
+        printf("Error: Could not ingest %s.\n", path);
+        exit(1);
+    }
+    double sum = 0;
+    for (int i = 0; i < totals.count; i++) {
+        sum += totals.items[i].fees + totals.items[i].hostel + totals.items[i].both;
+    }
+    *rolls = totals.count;
+    paymentTotalsFree(&totals);
+    return sum;
+}
+
+int main(int argc, char *argv[]) {
+    long lines = argc > 1 ? atol(argv[1]) : DEFAULT_LINES;
+    int threads = argc > 2 ? atoi(argv[2]) : defaultPaymentThreads();
+    const char *path = argc > 3 ? argv[3] : DEFAULT_PATH;
+    if (lines <= 0 || threads <= 0) {
+        printf("Usage: %s [lineCount] [threads] [path]\n", argv[0]);
+        return 1;
+    }
+
+    printf("Writing %ld synthetic payments to %s...\n", lines, path);
+    if (!writeSyntheticFile(path, lines, "w", 12345u)) {
+        printf("Error: Could not write %s.\n", path);
+        return 1;
+    }
+
+    PaymentIngestStats single, parallel;
+    int singleRolls, parallelRolls;
+    double singleSum = runIngest(path, 1, &single, &singleRolls);
+    double parallelSum = runIngest(path, threads, &parallel, &parallelRolls);
+
+    double mb = single.bytes / (1024.0 * 1024.0);
+    printf("Payments: %ld (%ld undated, %ld malformed), %d roll numbers, %.1f MB\n",
+           single.payments, single.undatedPayments, single.malformed, singleRolls, mb);
+    printf("1 thread:   parse %.3f s, merge %.3f s (%.0f MB/s)\n",
+           single.parseSeconds, single.mergeSeconds,
+           mb / (single.parseSeconds + single.mergeSeconds));
+    printf("%d threads: parse %.3f s, merge %.3f s (%.0f MB/s)\n", parallel.threads,
+           parallel.parseSeconds, parallel.mergeSeconds,
+           mb / (parallel.parseSeconds + parallel.mergeSeconds));
+
+    if (singleRolls != parallelRolls || singleSum != parallelSum) {
+        printf("Error: Parallel totals differ from the single-threaded run.\n");
+        remove(path);
+        return 1;
+    }
+
+    // Reconciliation: a full keyed pass, then only the appended lines
+    PaymentCheckpoint checkpoint;
+    PaymentTotals totals;
+    PaymentIngestStats full, incremental, rescan;
+    paymentCheckpointInit(&checkpoint);
+    paymentTotalsInit(&totals);
+    bool ok = ingestPayments(path, threads, &checkpoint, &checkpoint.keys, &totals, &full);
+    checkpoint.offset = full.endOffset;
+    checkpoint.lines = full.endLines;
+    checkpoint.tailHash = full.endTailHash;
+    paymentTotalsFree(&totals);
+
+    ok = ok && writeSyntheticFile(path, APPENDED_LINES, "a", 777u);
+    ok = ok && ingestPayments(path, threads, &checkpoint, &checkpoint.keys, &totals, &incremental);
+    paymentTotalsFree(&totals);
+
+    // Rescanning everything must find nothing new
+    checkpoint.offset = 0;
+    checkpoint.lines = 0;
+    checkpoint.tailHash = paymentTailHash(NULL, 0);
+    ok = ok && ingestPayments(path, threads, &checkpoint, &checkpoint.keys, &totals, &rescan);
+    paymentTotalsFree(&totals);
+    paymentCheckpointFree(&checkpoint);
+    remove(path);
+
+    if (!ok) {
+        printf("Error: Reconciliation run failed.\n");
+        return 1;
+    }
+    printf("Full keyed pass:  %.3f s, %ld payments, %ld duplicate lines\n",
+           full.parseSeconds + full.mergeSeconds, full.payments, full.duplicates);
+    printf("Incremental pass: %.3f s over %zu new bytes, %ld payments\n",
+           incremental.parseSeconds + incremental.mergeSeconds, incremental.bytes, incremental.payments);
+    printf("Full rescan:      %ld new payments (expected 0)\n", rescan.payments);
+    return rescan.payments == 0 ? 0 : 1;
+}
@@ -0,0 +1,132 @@
+// Approval priority benchmark: ordering a queue of stamped requests by
+// sorting all of them versus building the priority heap and popping only
+// the requests one session decides, plus the wait-time percentiles.
+//
+// Build (from the project directory):
+//   gcc -O2 bench/bench_priority.c approval_priority.c approval_queue.c student_store.c name_arena.c money.c roll_map.c file_util.c timing.c -o bench_priority
+// Run:
+//   ./bench_priority [requestCount] [decisionsPerSession]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "../approval_priority.h"
+#include "../timing.h"
+
+#define DEFAULT_REQUESTS 1000000
+#define DEFAULT_DECISIONS 200
+#define NOW 1800000000LL
+#define SPREAD_DAYS 60
+
+// The heap's order, for qsort
+static int compareEntries(const void *a, const void *b) {
+    const PriorityEntry *x = a;
+    const PriorityEntry *y = b;
+    if (x->key != y->key) {
+        return x->key > y->key ? -1 : 1;
+    }
+    if (x->submitted != y->submitted) {
+        return x->submitted < y->submitted ? -1 : 1;
+    }
+    return (x->order > y->order) - (x->order < y->order);
+}
+
+int main(int argc, char *argv[]) {
+    int requestCount = argc > 1 ? atoi(argv[1]) : DEFAULT_REQUESTS;
+    int decisions = argc > 2 ? atoi(argv[2]) : DEFAULT_DECISIONS;
+    if (requestCount <= 0 || decisions <= 0 || decisions > requestCount) {
+        printf("Usage: %s [requestCount] [decisionsPerSession]\n", argv[0]);
+        return 1;
+    }
+
+    // Requests made over the last SPREAD_DAYS days; a third owe nothing and
+    // a quarter are final-year rolls
+    StudentStore store;
+    ApprovalQueue queue;
+    storeInit(&store);
+    approvalQueueInit(&queue);
+    unsigned int rng = 88172645u;
+    Student s;
+    for (int i = 0; i < requestCount; i++) {
+        rng ^= rng << 13;
+        rng ^= rng >> 17;
+        rng ^= rng << 5;
+        s.rollNumber = 2100000 + i;
+        char name[MAX_NAME_LENGTH];
+        int length = snprintf(name, sizeof(name), "STUDENT %d", i);
+        s.name = storeInternName(&store, name, (size_t)length);
+        int owes = rng % 3;
+        s.feesDue = owes ? (Money)(rng % 9) * 500 * MONEY_SCALE : 0;
+        s.libraryBooksDue = owes ? (int)((rng >> 8) % 4) : 0;
+        s.hostelDue = owes ? (Money)((rng >> 12) % 9) * 500 * MONEY_SCALE : 0;
+        s.approvalStatus = 0;
+        storeAdd(&store, &s);
+        int64_t submitted = NOW - (int64_t)((rng >> 4) % (SPREAD_DAYS * SECONDS_PER_DAY));
+        approvalQueuePushAt(&queue, s.rollNumber, name, submitted);
+    }
+
+    PriorityPolicy policy;
+    priorityPolicyDefaults(&policy);
+    policy.zeroDues = 5;
+    policy.finalYear = 10;
+    policy.finalYearFirst = 2100000;
+    policy.finalYearLast = 2100000 + requestCount / 4;
+
+    // Sort everything, then take the first `decisions`
+    double start = monotonicSeconds();
+    PriorityHeap sorted;
+    if (!priorityHeapBuild(&sorted, &policy, &queue, &store)) {
+        printf("Error: Out of memory.\n");
+        return 1;
+    }
+    qsort(sorted.items, (size_t)sorted.count, sizeof(PriorityEntry), compareEntries);
+    double sortSeconds = monotonicSeconds() - start;
+
+    // Heapify, then pop `decisions`
+    start = monotonicSeconds();
+    PriorityHeap heap;
+    if (!priorityHeapBuild(&heap, &policy, &queue, &store)) {
+        printf("Error: Out of memory.\n");
+        return 1;
+    }
+    double buildSeconds = monotonicSeconds() - start;
+    bool same = true;
+    PriorityEntry entry;
+    WaitTimes waits;
+    waitTimesInit(&waits);
+    for (int k = 0; k < decisions && priorityHeapPop(&heap, &entry); k++) {
+        same = same && entry.rollNumber == sorted.items[k].rollNumber;
+        waitTimesAdd(&waits, entry.submitted, NOW + k);
+    }
+    double heapSeconds = monotonicSeconds() - start;
+
+    // Popping the whole queue gives the sorted order too
+    start = monotonicSeconds();
+    for (int k = decisions; priorityHeapPop(&heap, &entry); k++) {
+        same = same && entry.rollNumber == sorted.items[k].rollNumber;
+        waitTimesAdd(&waits, entry.submitted, NOW + k);
+    }
+    double drainSeconds = monotonicSeconds() - start + heapSeconds;
+
+    start = monotonicSeconds();
+    int64_t p50 = waitTimesPercentile(&waits, 0.50);
+    int64_t p95 = waitTimesPercentile(&waits, 0.95);
+    int64_t p99 = waitTimesPercentile(&waits, 0.99);
+    double percentileSeconds = monotonicSeconds() - start;
+
+    char a[32], b[32], c[32];
+    printf("Requests: %d, decided per session: %d\n", requestCount, decisions);
+    printf("  sort all, take %-6d: %8.3f ms\n", decisions, sortSeconds * 1e3);
+    printf("  heap build + %d pops: %8.3f ms (build %.3f ms)\n", decisions, heapSeconds * 1e3, buildSeconds * 1e3);
+    printf("  heap, pop all        : %8.3f ms\n", drainSeconds * 1e3);
+    printf("  p50/p95/p99 of %d waits: %s / %s / %s in %.3f ms\n", waits.count,
+           formatWait(p50, a, sizeof(a)), formatWait(p95, b, sizeof(b)), formatWait(p99, c, sizeof(c)),
+           percentileSeconds * 1e3);
+    printf("  same order as the sort: %s\n", same ? "yes" : "NO");
+
+    waitTimesFree(&waits);
+    priorityHeapFree(&heap);
+    priorityHeapFree(&sorted);
+    approvalQueueFree(&queue);
+    storeFree(&store);
+    return 0;
+}
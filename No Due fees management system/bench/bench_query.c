@@ -0,0 +1,167 @@
+// Report query benchmark: compiled queries over the dues columns versus
+// the same filters hand-written as one loop over the Student records.
+// Both must find the same students. Build with -O3 so the block loops are
+// vectorized.
+//
+// Build (from the project directory):
+//   gcc -O3 bench/bench_query.c report_query.c dues_columns.c student_list.c student_store.c name_arena.c money.c roll_map.c timing.c -o bench_query
+// Run:
+//   ./bench_query [recordCount] [repeats]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include "../report_query.h"
+#include "../timing.h"
+
+#define DEFAULT_RECORDS 10000000
+#define DEFAULT_REPEATS 5
+#define TOP 10
+
+static const char *queries[] = {
+    "count where pending and books > 2 and dues >= 20000",
+    "sum fees, hostel where approved or books = 0",
+    "top 10 by dues where pending",
+    "count where name starts \"student 99\""
+};
+#define QUERY_COUNT_BENCH (int)(sizeof(queries) / sizeof(queries[0]))
+
+// The queries above, one record at a time: returns the matches and fills
+// sums[] (query 1) or top[] (query 2, roll numbers by dues then store order)
+static long recordLoop(int which, const StudentStore *store, int64_t *sums, int *top) {
+    long matched = 0;
+    Money topDue[TOP];
+    int topCount = 0;
+    for (int i = 0; i < store->count; i++) {
+        const Student *s = storeAt(store, i);
+        Money due = s->feesDue + s->hostelDue;
+        switch (which) {
+            case 0:
+                matched += s->approvalStatus == 0 && s->libraryBooksDue > 2 && due >= 2000000;
+                break;
+            case 1:
+                if (s->approvalStatus == 1 || s->libraryBooksDue == 0) {
+                    matched++;
+                    sums[0] += s->feesDue;
+                    sums[1] += s->hostelDue;
+                }
+                break;
+            case 2:
+                if (s->approvalStatus == 0) {
+                    matched++;
+                    int k = topCount < TOP ? topCount++ : TOP;
+                    while (k > 0 && topDue[k - 1] < due) {
+                        if (k < TOP) {
+                            topDue[k] = topDue[k - 1];
+                            top[k] = top[k - 1];
+                        }
+                        k--;
+                    }
+                    if (k < TOP) {
+                        topDue[k] = due;
+                        top[k] = s->rollNumber;
+                    }
+                }
+                break;
+            default:
+                matched += strncasecmp(storeName(store, s), "student 99", 10) == 0;
+                break;
+        }
+    }
+    return matched;
+}
+
+int main(int argc, char *argv[]) {
+    int recordCount = argc > 1 ? atoi(argv[1]) : DEFAULT_RECORDS;
+    int repeats = argc > 2 ? atoi(argv[2]) : DEFAULT_REPEATS;
+    if (recordCount <= 0 || repeats <= 0) {
+        printf("Usage: %s [recordCount] [repeats]\n", argv[0]);
+        return 1;
+    }
+
+    StudentStore store;
+    storeInit(&store);
+    if (!storeReserve(&store, recordCount)) {
+        printf("Error: Out of memory.\n");
+        return 1;
+    }
+    unsigned int rng = 12345u;
+    Student s;
+    memset(&s, 0, sizeof(s));
+    for (int i = 0; i < recordCount; i++) {
+        rng = rng * 1103515245u + 12345u;
+        s.rollNumber = 2100000 + i;
+        char name[MAX_NAME_LENGTH];
+        int length = snprintf(name, sizeof(name), "STUDENT %d", i);
+        s.name = storeInternName(&store, name, (size_t)length);
+        int owes = (rng >> 4) % 4 != 0;
+        s.feesDue = owes ? (Money)((rng >> 8) % 5000000u) : 0;
+        s.hostelDue = owes ? (Money)((rng >> 12) % 3000000u) : 0;
+        s.libraryBooksDue = owes ? (int)((rng >> 24) % 4) : 0;
+        s.approvalStatus = (int)((rng >> 28) & 1);
+        storeAdd(&store, &s);
+    }
+
+    DuesColumns columns;
+    duesColumnsInit(&columns);
+    double start = monotonicSeconds();
+    if (!duesColumnsSync(&columns, &store)) {
+        printf("Error: Out of memory.\n");
+        return 1;
+    }
+    printf("%d records, columns built in %.3f ms\n", recordCount, (monotonicSeconds() - start) * 1e3);
+
+    for (int q = 0; q < QUERY_COUNT_BENCH; q++) {
+        Query query;
+        int errorPosition;
+        const char *error;
+        start = monotonicSeconds();
+        if (!queryCompile(&query, queries[q], &errorPosition, &error)) {
+            printf("Error: %s at %d in %s\n", error, errorPosition, queries[q]);
+            return 1;
+        }
+        double compileSeconds = monotonicSeconds() - start;
+
+        double recordBest = 0, queryBest = 0;
+        bool same = true;
+        long matched = 0;
+        for (int r = 0; r < repeats; r++) {
+            int64_t sums[2] = { 0, 0 };
+            int top[TOP];
+            start = monotonicSeconds();
+            matched = recordLoop(q, &store, sums, top);
+            double seconds = monotonicSeconds() - start;
+            if (r == 0 || seconds < recordBest) {
+                recordBest = seconds;
+            }
+
+            QueryResult result;
+            if (!queryRun(&query, &columns, &store, &result)) {
+                printf("Error: Out of memory.\n");
+                return 1;
+            }
+            if (r == 0 || result.seconds < queryBest) {
+                queryBest = result.seconds;
+            }
+            same = same && result.matched == matched;
+            if (query.action == QUERY_SUM) {
+                same = same && result.sums[0] == sums[0] && result.sums[1] == sums[1];
+            }
+            if (query.action == QUERY_TOP) {
+                for (int k = 0; k < result.rows.count; k++) {
+                    same = same && result.rows.rows[k]->rollNumber == top[k];
+                }
+            }
+            queryResultFree(&result);
+        }
+        printf("%s\n", queries[q]);
+        printf("  %ld matches; record loop %8.3f ms, compiled query %8.3f ms (%.2fx), compiled in %.1f us%s\n",
+               matched, recordBest * 1e3, queryBest * 1e3, queryBest > 0 ? recordBest / queryBest : 0.0,
+               compileSeconds * 1e6, same ? "" : " -- RESULTS DIFFER");
+    }
+
+    duesColumnsFree(&columns);
+    storeFree(&store);
+    return 0;
+}
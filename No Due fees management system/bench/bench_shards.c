@@ -0,0 +1,150 @@
+// Campus shard benchmark: loading every shard of a data directory one after
+// another versus one thread per shard, the same for the cross-shard dues
+// summary and pending list, and routed roll lookups.
+//
+// Build (from the project directory):
+//   gcc -O2 bench/bench_shards.c shards.c csv_loader.c journal.c approval_queue.c dues_columns.c data_lock.c snapshot.c student_store.c name_arena.c money.c roll_map.c file_util.c timing.c -o bench_shards -pthread
+// Run:
+//   ./bench_shards [shardCount] [studentsPerShard] [directory]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../shards.h"
+#include "../csv_loader.h"
+#include "../file_util.h"
+#include "../timing.h"
+
+#define DEFAULT_SHARDS 8
+#define DEFAULT_STUDENTS 250000
+#define DEFAULT_DIR "bench_shards"
+#define ROLLS_PER_SHARD 10000000
+#define LOOKUPS 10000000
+
+static const char *firstNames[] = { "AARAV", "ABHA", "ADITYA", "ANANYA", "ISHAAN", "KAVYA", "PREETI", "VIVEK" };
+static const char *lastNames[] = { "GUPTA", "NEGI", "PANDEY", "SAXENA", "CHAUHAN", "BHARDWAJ", "RAWAT" };
+
+// DIRECTORY/campusN/{student.txt,approval_list.txt} plus the manifest
+static bool writeShards(const char *directory, int shards, int students) {
+    char path[SHARD_PATH_SIZE];
+    snprintf(path, sizeof(path), "%s/%s", directory, SHARD_MANIFEST_FILENAME);
+    FILE *manifest = fopen(path, "w");
+    if (manifest == NULL) {
+        return false;
+    }
+    unsigned int rng = 12345u;
+    for (int k = 0; k < shards; k++) {
+        int firstRoll = k * ROLLS_PER_SHARD + 1;
+        fprintf(manifest, "Campus %d,campus%d,%d,%d\n", k + 1, k + 1, firstRoll, firstRoll + ROLLS_PER_SHARD - 1);
+        snprintf(path, sizeof(path), "%s/campus%d", directory, k + 1);
+        if (!makeDirectory(path)) {
+            fclose(manifest);
+            return false;
+        }
+        snprintf(path, sizeof(path), "%s/campus%d/%s", directory, k + 1, STUDENT_FILENAME);
+        FILE *file = fopen(path, "w");
+        snprintf(path, sizeof(path), "%s/campus%d/%s", directory, k + 1, APPROVAL_FILENAME);
+        FILE *approvals = fopen(path, "w");
+        if (file == NULL || approvals == NULL) {
+            fclose(manifest);
+            return false;
+        }
+        for (int i = 0; i < students; i++) {
+            rng = rng * 1103515245u + 12345u;
+            const char *first = firstNames[(rng >> 8) % 8];
+            const char *last = lastNames[(rng >> 12) % 7];
+            int approved = (rng >> 28) % 4 == 0;
+            fprintf(file, "%d,%s %s,%u.00,%u,%u.00,%d\n", firstRoll + i * 3, first, last,
+                    (rng >> 16) % 5 * 500, (rng >> 20) % 6, (rng >> 24) % 5 * 500, approved);
+            if (!approved && i % 10 == 0) {
+                fprintf(approvals, "%d,%s %s\n", firstRoll + i * 3, first, last);
+            }
+        }
+        fclose(file);
+        fclose(approvals);
+    }
+    return fclose(manifest) == 0;
+}
+
+static void printRun(const char *label, double one, double all, int threads) {
+    printf("  %-22s: 1 thread %8.3f ms, %d threads %8.3f ms (%.2fx)\n",
+           label, one * 1e3, threads, all * 1e3, all > 0 ? one / all : 0.0);
+}
+
+int main(int argc, char *argv[]) {
+    int shardCount = argc > 1 ? atoi(argv[1]) : DEFAULT_SHARDS;
+    int students = argc > 2 ? atoi(argv[2]) : DEFAULT_STUDENTS;
+    const char *directory = argc > 3 ? argv[3] : DEFAULT_DIR;
+    if (shardCount <= 0 || shardCount > SHARD_MAX || students <= 0 || students > ROLLS_PER_SHARD / 3) {
+        printf("Usage: %s [shardCount (1-%d)] [studentsPerShard] [directory]\n", argv[0], SHARD_MAX);
+        return 1;
+    }
+    if (!makeDirectory(directory) || !writeShards(directory, shardCount, students)) {
+        printf("Error: Could not write the shards under %s.\n", directory);
+        return 1;
+    }
+
+    ShardSet set;
+    shardSetInit(&set);
+    int errorLine;
+    const char *error;
+    if (!shardSetOpen(&set, directory, &errorLine, &error)) {
+        printf("Error: %s (line %d).\n", error, errorLine);
+        return 1;
+    }
+    printf("%d shards x %d students\n", set.count, students);
+
+    double start = monotonicSeconds();
+    shardSetLoad(&set, 1);
+    double loadOne = monotonicSeconds() - start;
+    start = monotonicSeconds();
+    shardSetLoad(&set, set.count);
+    double loadAll = monotonicSeconds() - start;
+    printRun("load", loadOne, loadAll, set.count);
+
+    DuesSummary perShard[SHARD_MAX];
+    DuesSummary total;
+    start = monotonicSeconds();
+    shardSummarizeDues(&set, 1, perShard, &total); // builds the columns
+    double firstDues = monotonicSeconds() - start;
+    start = monotonicSeconds();
+    shardSummarizeDues(&set, 1, perShard, &total);
+    double duesOne = monotonicSeconds() - start;
+    start = monotonicSeconds();
+    shardSummarizeDues(&set, set.count, perShard, &total);
+    double duesAll = monotonicSeconds() - start;
+    printRun("dues summary", duesOne, duesAll, set.count);
+    printf("  %-22s: %.3f ms (column build included)\n", "first dues summary", firstDues * 1e3);
+
+    ShardPendingList list;
+    start = monotonicSeconds();
+    shardCollectPending(&set, 1, &list);
+    double pendingOne = monotonicSeconds() - start;
+    int pending = list.count;
+    shardPendingFree(&list);
+    start = monotonicSeconds();
+    shardCollectPending(&set, set.count, &list);
+    double pendingAll = monotonicSeconds() - start;
+    printRun("pending list", pendingOne, pendingAll, set.count);
+    printf("  %d pending requests, %ld students in total\n", pending,
+           total.pending.students + total.approved.students);
+    shardPendingFree(&list);
+
+    // Routed lookups, about 1 in 3 rolls unused
+    unsigned int rng = 2463534242u;
+    long found = 0;
+    start = monotonicSeconds();
+    for (int q = 0; q < LOOKUPS; q++) {
+        rng ^= rng << 13;
+        rng ^= rng >> 17;
+        rng ^= rng << 5;
+        int shard;
+        int roll = (int)(rng % (unsigned int)set.count) * ROLLS_PER_SHARD + 1 + (int)((rng >> 8) % (unsigned int)(students * 3));
+        found += shardFindByRoll(&set, roll, &shard) != NULL;
+    }
+    double lookupSeconds = monotonicSeconds() - start;
+    printf("  %-22s: %.0f lookups/s (%ld found)\n", "routed roll lookup", LOOKUPS / lookupSeconds, found);
+
+    shardSetFree(&set);
+    return 0;
+}
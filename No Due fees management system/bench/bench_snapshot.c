@@ -0,0 +1,100 @@
+// Startup benchmark: bulk CSV load versus mapping a binary snapshot.
+//
+// Build (from the project directory):
+//   gcc -O2 bench/bench_snapshot.c snapshot.c csv_loader.c student_store.c name_arena.c money.c roll_map.c file_util.c timing.c -o bench_snapshot
+// Run:
+//   ./bench_snapshot [recordCount]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "../csv_loader.h"
+#include "../snapshot.h"
+#include "../timing.h"
+
+#define DEFAULT_RECORDS 1000000
+#define CSV_PATH "bench_students.txt"
+#define SNAPSHOT_PATH "bench_students.snap"
+#define LOOKUPS 1000000
+
+int main(int argc, char *argv[]) {
+    int recordCount = argc > 1 ? atoi(argv[1]) : DEFAULT_RECORDS;
+    if (recordCount <= 0) {
+        printf("Usage: %s [recordCount]\n", argv[0]);
+        return 1;
+    }
+
+    // Build the data set once in memory and write both file formats
+    StudentStore store;
+    storeInit(&store);
+    Student s;
+    for (int i = 0; i < recordCount; i++) {
+        s.rollNumber = 2100000 + i;
+        char name[MAX_NAME_LENGTH];
+        int length = snprintf(name, sizeof(name), "STUDENT %d", i);
+        s.name = storeInternName(&store, name, (size_t)length);
+        s.feesDue = (Money)(i % 5) * 500 * MONEY_SCALE;
+        s.libraryBooksDue = i % 6;
+        s.hostelDue = (Money)(i % 3) * 500 * MONEY_SCALE;
+        s.approvalStatus = i % 2;
+        storeAdd(&store, &s);
+    }
+    double start = monotonicSeconds();
+    if (!saveStudentsToCsv(CSV_PATH, &store)) {
+        printf("Error: Could not write %s.\n", CSV_PATH);
+        return 1;
+    }
+    double csvWriteSeconds = monotonicSeconds() - start;
+    start = monotonicSeconds();
+    if (!snapshotWrite(SNAPSHOT_PATH, &store)) {
+        return 1;
+    }
+    double snapshotWriteSeconds = monotonicSeconds() - start;
+    storeFree(&store);
+
+    // Startup path 1: parse the CSV
+    storeInit(&store);
+    CsvLoadStats stats;
+    start = monotonicSeconds();
+    loadStudentsFromCsv(CSV_PATH, &store, &stats);
+    double csvLoadSeconds = monotonicSeconds() - start;
+    storeFree(&store);
+
+    // Startup path 2: map the snapshot (header check only, as at startup)
+    Snapshot snapshot;
+    storeInit(&store);
+    start = monotonicSeconds();
+    if (!snapshotLoad(SNAPSHOT_PATH, &snapshot, &store, false)) {
+        return 1;
+    }
+    double mapSeconds = monotonicSeconds() - start;
+
+    // Lookups straight against the mapped index prove it is usable as-is
+    long long hits = 0;
+    start = monotonicSeconds();
+    for (int i = 0; i < LOOKUPS; i++) {
+        hits += storeFindByRoll(&store, 2100000 + (int)((i * 7919LL) % recordCount)) != NULL;
+    }
+    double lookupSeconds = monotonicSeconds() - start;
+    storeFree(&store);
+    snapshotClose(&snapshot);
+
+    // Full checksum verification, for comparison
+    storeInit(&store);
+    start = monotonicSeconds();
+    snapshotLoad(SNAPSHOT_PATH, &snapshot, &store, true);
+    double verifySeconds = monotonicSeconds() - start;
+    storeFree(&store);
+    snapshotClose(&snapshot);
+
+    printf("Records: %d\n", recordCount);
+    printf("Write CSV:          %.3f s\n", csvWriteSeconds);
+    printf("Write snapshot:     %.3f s\n", snapshotWriteSeconds);
+    printf("Load CSV:           %.3f s (%d records)\n", csvLoadSeconds, stats.loaded);
+    printf("Map snapshot:       %.6f s\n", mapSeconds);
+    printf("Map + verify:       %.3f s\n", verifySeconds);
+    printf("First %d lookups on mapped index: %.3f s (%lld hits)\n", LOOKUPS, lookupSeconds, hits);
+
+    remove(CSV_PATH);
+    remove(SNAPSHOT_PATH);
+    return 0;
+}
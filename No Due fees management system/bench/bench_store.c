@@ -0,0 +1,99 @@
+// Roll-number lookup benchmark: linear scan over a flat array (the old
+// students[] approach) versus the hashed StudentStore index.
+//
+// Build (from the project directory):
+//   gcc -O2 bench/bench_store.c student_store.c name_arena.c money.c roll_map.c timing.c -o bench_store
+// Run:
+//   ./bench_store [recordCount]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../student_store.h"
+#include "../timing.h"
+
+#define DEFAULT_RECORDS 1000000
+#define LINEAR_LOOKUPS 2000
+#define HASH_LOOKUPS 10000000
+
+// Small deterministic PRNG so runs are comparable
+static unsigned int nextRandom(unsigned int *state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 17;
+    *state ^= *state << 5;
+    return *state;
+}
+
+static void makeStudent(StudentStore *store, Student *s, int rollNumber, unsigned int *rng) {
+    char name[MAX_NAME_LENGTH];
+    int length = snprintf(name, sizeof(name), "STUDENT %d", rollNumber);
+    s->rollNumber = rollNumber;
+    s->name = storeInternName(store, name, (size_t)length);
+    s->feesDue = (Money)(nextRandom(rng) % 5) * 500 * MONEY_SCALE;
+    s->libraryBooksDue = (int)(nextRandom(rng) % 6);
+    s->hostelDue = (Money)(nextRandom(rng) % 5) * 500 * MONEY_SCALE;
+    s->approvalStatus = (int)(nextRandom(rng) % 2);
+}
+
+int main(int argc, char *argv[]) {
+    int recordCount = argc > 1 ? atoi(argv[1]) : DEFAULT_RECORDS;
+    if (recordCount <= 0) {
+        printf("Usage: %s [recordCount]\n", argv[0]);
+        return 1;
+    }
+
+    unsigned int rng = 2463534242u;
+    Student *flat = malloc(sizeof(Student) * recordCount);
+    if (flat == NULL) {
+        printf("Error: Out of memory.\n");
+        return 1;
+    }
+
+    // Roll numbers are spread out (not 1..N) like real institutional rolls;
+    // names go into the store's arena up front
+    StudentStore store;
+    storeInit(&store);
+    for (int i = 0; i < recordCount; i++) {
+        makeStudent(&store, &flat[i], 2100000 + i * 7, &rng);
+    }
+
+    double start = monotonicSeconds();
+    for (int i = 0; i < recordCount; i++) {
+        storeAdd(&store, &flat[i]);
+    }
+    double loadSeconds = monotonicSeconds() - start;
+    printf("Loaded %d records into store in %.3f s (%.0f records/s)\n",
+           recordCount, loadSeconds, recordCount / loadSeconds);
+
+    // Before: linear scan per lookup
+    long long found = 0;
+    start = monotonicSeconds();
+    for (int q = 0; q < LINEAR_LOOKUPS; q++) {
+        int roll = flat[nextRandom(&rng) % recordCount].rollNumber;
+        for (int i = 0; i < recordCount; i++) {
+            if (flat[i].rollNumber == roll) {
+                found++;
+                break;
+            }
+        }
+    }
+    double linearSeconds = monotonicSeconds() - start;
+
+    // After: hashed lookups, including ~10% misses
+    start = monotonicSeconds();
+    for (int q = 0; q < HASH_LOOKUPS; q++) {
+        int roll = flat[nextRandom(&rng) % recordCount].rollNumber + (q % 10 == 0);
+        found += storeFindByRoll(&store, roll) != NULL;
+    }
+    double hashSeconds = monotonicSeconds() - start;
+
+    double linearRate = LINEAR_LOOKUPS / linearSeconds;
+    double hashRate = HASH_LOOKUPS / hashSeconds;
+    printf("Linear scan: %d lookups in %.3f s (%.0f lookups/s)\n", LINEAR_LOOKUPS, linearSeconds, linearRate);
+    printf("Hash index:  %d lookups in %.3f s (%.0f lookups/s)\n", HASH_LOOKUPS, hashSeconds, hashRate);
+    printf("Speedup: %.0fx (checksum %lld)\n", hashRate / linearRate, found);
+
+    storeFree(&store);
+    free(flat);
+    return 0;
+}
@@ -0,0 +1,532 @@
+// Benchmark suite and synthetic data generator.
+//
+// Writes student.txt, approval_list.txt and payment_history.txt of the
+// requested size and mix into a data directory (the same formats ./main
+// reads, so the files can also be copied next to it), then times the core
+// paths on them: loading and saving the student file, roll lookups, loading
+// the approval list and duplicate checks, processing every approval request
+// (approve, journal, rewrite the list), full and filtered listings, payment
+// ingest and the dues summary. Each benchmark runs several times and the
+// best run is kept. Results go to the console and, as JSON, to a file that
+// can be kept per version and compared.
+//
+// Build (from the project directory):
+//   gcc -O2 bench/bench_suite.c csv_loader.c approval_queue.c journal.c snapshot.c student_list.c dues_columns.c payment_ingest.c payment_checkpoint.c student_store.c name_arena.c money.c roll_map.c file_util.c timing.c -o bench_suite -pthread
+// Run:
+//   ./bench_suite [--students N] [--owing PCT] [--approved PCT] [--applied PCT]
+//                 [--payments N] [--seed N] [--repeat N] [--dir DIR]
+//                 [--output FILE] [--generate-only]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/stat.h>
+#ifdef _WIN32
+#include <direct.h>
+#define NULL_DEVICE "NUL"
+#else
+#define NULL_DEVICE "/dev/null"
+#endif
+#include "../csv_loader.h"
+#include "../approval_queue.h"
+#include "../journal.h"
+#include "../student_list.h"
+#include "../dues_columns.h"
+#include "../payment_ingest.h"
+#include "../timing.h"
+
+#define SUITE_FORMAT 1              // bump when result names or meanings change
+#define PATH_SIZE 512
+#define MAX_RESULTS 16
+
+static const char *firstNames[] = { "AARAV", "ABHA", "ADITYA", "ANANYA", "ISHAAN", "KAVYA", "PREETI", "VIVEK" };
+static const char *lastNames[] = { "GUPTA", "NEGI", "PANDEY", "SAXENA", "CHAUHAN", "BHARDWAJ", "RAWAT" };
+static const char *categories[] = { "Fees", "Hostel", "Both" };
+
+// Best run of one benchmark
+typedef struct {
+    const char *name;
+    long items;             // records, requests, lines or lookups handled per run
+    double seconds;
+    int runs;
+} SuiteResult;
+
+typedef struct {
+    // Data shape
+    int students;
+    int owingPercent;       // students with any dues
+    int approvedPercent;    // students already approved
+    int appliedPercent;     // pending students with a request in the approval list
+    int payments;           // payment_history.txt lines
+    unsigned int seed;
+    int repeats;
+    const char *dir;
+    const char *output;
+    bool generateOnly;
+
+    char studentPath[PATH_SIZE];
+    char approvalPath[PATH_SIZE];
+    char paymentPath[PATH_SIZE];
+    char savePath[PATH_SIZE];
+    char approvalSavePath[PATH_SIZE];
+    char journalPath[PATH_SIZE];
+
+    StudentStore store;
+    ApprovalQueue queue;
+    DuesColumns columns;
+    int *approvedRolls;     // what a process_approvals run changed, to undo it
+    int approvedCount;
+    long lookups;           // per lookup benchmark run
+    SuiteResult results[MAX_RESULTS];
+    int resultCount;
+} Suite;
+
+// One timed run: returns seconds spent in the measured part (negative on
+// failure) and the number of items it handled
+typedef double (*SuiteRun)(Suite *suite, long *items);
+
+static unsigned int nextRandom(unsigned int *state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 17;
+    *state ^= *state << 5;
+    return *state;
+}
+
+static void joinPath(char *out, const char *dir, const char *name) {
+    snprintf(out, PATH_SIZE, "%s/%s", dir, name);
+}
+
+static bool makeDirectory(const char *dir) {
+    struct stat info;
+    if (stat(dir, &info) == 0) {
+        return true;
+    }
+#ifdef _WIN32
+    return _mkdir(dir) == 0;
+#else
+    return mkdir(dir, 0755) == 0;
+#endif
+}
+
+// student.txt plus approval_list.txt, which only lists pending students
+static bool writeStudents(Suite *suite) {
+    FILE *students = fopen(suite->studentPath, "w");
+    FILE *approvals = fopen(suite->approvalPath, "w");
+    if (students == NULL || approvals == NULL) {
+        if (students != NULL) {
+            fclose(students);
+        }
+        if (approvals != NULL) {
+            fclose(approvals);
+        }
+        return false;
+    }
+    setvbuf(students, NULL, _IOFBF, 1 << 20);
+    unsigned int rng = suite->seed;
+    char name[MAX_NAME_LENGTH], fees[MONEY_TEXT_SIZE], hostel[MONEY_TEXT_SIZE];
+    for (int i = 0; i < suite->students; i++) {
+        int rollNumber = i + 1;
+        snprintf(name, sizeof(name), "%s %s", firstNames[nextRandom(&rng) % 8], lastNames[nextRandom(&rng) % 7]);
+        bool owes = (int)(nextRandom(&rng) % 100) < suite->owingPercent;
+        bool approved = (int)(nextRandom(&rng) % 100) < suite->approvedPercent;
+        Money feesDue = owes ? (Money)(nextRandom(&rng) % 100) * 500 * MONEY_SCALE / 10 : 0;
+        Money hostelDue = owes ? (Money)(nextRandom(&rng) % 60) * 500 * MONEY_SCALE / 10 : 0;
+        int books = owes ? (int)(nextRandom(&rng) % 6) : 0;
+        fprintf(students, "%d,%s,%s,%d,%s,%d\n", rollNumber, name,
+                moneyText(feesDue, fees), books, moneyText(hostelDue, hostel), approved ? 1 : 0);
+        if (!approved && (int)(nextRandom(&rng) % 100) < suite->appliedPercent) {
+            fprintf(approvals, "%d,%s\n", rollNumber, name);
+        }
+    }
+    bool ok = fclose(students) == 0;
+    return fclose(approvals) == 0 && ok;
+}
+
+// payment_history.txt in the date styles the ingest accepts
+static bool writePayments(Suite *suite) {
+    FILE *file = fopen(suite->paymentPath, "w");
+    if (file == NULL) {
+        return false;
+    }
+    setvbuf(file, NULL, _IOFBF, 1 << 20);
+    unsigned int rng = suite->seed ^ 0x9e3779b9u;
+    char amount[MONEY_TEXT_SIZE];
+    for (int i = 0; i < suite->payments; i++) {
+        int rollNumber = (int)(nextRandom(&rng) % (unsigned int)suite->students) + 1;
+        int day = (int)(nextRandom(&rng) % 28) + 1;
+        int month = (int)(nextRandom(&rng) % 12) + 1;
+        int year = 2023 + (int)(nextRandom(&rng) % 3);
+        moneyText((Money)(nextRandom(&rng) % 50 + 1) * 100 * MONEY_SCALE, amount);
+        const char *category = categories[nextRandom(&rng) % 3];
+        switch (nextRandom(&rng) % 4) {
+            case 0:
+                fprintf(file, "%d,%02d%02d%d,%s,%s\n", rollNumber, day, month, year, amount, category);
+                break;
+            case 1:
+                fprintf(file, "%d,%d%02d%02d,%s,%s\n", rollNumber, year, month, day, amount, category);
+                break;
+            case 2:
+                fprintf(file, "%d,%d/%d/%d,%s,%s\n", rollNumber, day, month, year, amount, category);
+                break;
+            default:
+                fprintf(file, "%d,%d-%02d-%02d,%s,%s\n", rollNumber, year, month, day, amount, category);
+        }
+    }
+    return fclose(file) == 0;
+}
+
+static double runLoadStudents(Suite *suite, long *items) {
+    storeFree(&suite->store);
+    storeInit(&suite->store);
+    CsvLoadStats stats;
+    double start = monotonicSeconds();
+    if (!loadStudentsFromCsv(suite->studentPath, &suite->store, &stats)) {
+        return -1;
+    }
+    double seconds = monotonicSeconds() - start;
+    *items = stats.loaded;
+    return seconds;
+}
+
+// What saveAllStudents() does for the CSV base file (temp file, fsync, rename)
+static double runSaveStudents(Suite *suite, long *items) {
+    double start = monotonicSeconds();
+    if (!saveStudentsToCsv(suite->savePath, &suite->store)) {
+        return -1;
+    }
+    *items = suite->store.count;
+    return monotonicSeconds() - start;
+}
+
+// Random roll numbers, about one in ten past the end of the roster
+static double runRollLookup(Suite *suite, long *items) {
+    unsigned int rng = suite->seed;
+    unsigned int range = (unsigned int)suite->students + (unsigned int)suite->students / 10 + 1;
+    long found = 0;
+    double start = monotonicSeconds();
+    for (long i = 0; i < suite->lookups; i++) {
+        found += storeFindByRoll(&suite->store, (int)(nextRandom(&rng) % range) + 1) != NULL;
+    }
+    double seconds = monotonicSeconds() - start;
+    *items = suite->lookups;
+    return found > 0 ? seconds : -1;
+}
+
+static double runLoadApprovals(Suite *suite, long *items) {
+    approvalQueueFree(&suite->queue);
+    approvalQueueInit(&suite->queue);
+    double start = monotonicSeconds();
+    if (approvalQueueLoad(&suite->queue, suite->approvalPath) < 0) {
+        return -1;
+    }
+    double seconds = monotonicSeconds() - start;
+    *items = suite->queue.pending;
+    return seconds;
+}
+
+// isDuplicateApproval() for random students
+static double runDuplicateCheck(Suite *suite, long *items) {
+    unsigned int rng = suite->seed;
+    double start = monotonicSeconds();
+    for (long i = 0; i < suite->lookups; i++) {
+        approvalQueueContains(&suite->queue, (int)(nextRandom(&rng) % (unsigned int)suite->students) + 1);
+    }
+    *items = suite->lookups;
+    return monotonicSeconds() - start;
+}
+
+// processApprovals() with every request approved: set the flag, journal it,
+// commit once, then rewrite the (now empty) approval list
+static double runProcessApprovals(Suite *suite, long *items) {
+    Journal journal;
+    remove(suite->journalPath);
+    if (runLoadApprovals(suite, items) < 0 || !journalOpen(&journal, suite->journalPath)) {
+        return -1;
+    }
+    int requests = suite->queue.pending;
+    suite->approvedCount = 0;
+
+    double start = monotonicSeconds();
+    ApprovalRequest request;
+    while (approvalQueuePop(&suite->queue, &request)) {
+        Student *s = storeFindByRoll(&suite->store, request.rollNumber);
+        if (s == NULL || s->approvalStatus != 0) {
+            continue;
+        }
+        s->approvalStatus = 1;
+        journalAppend(&journal, JOURNAL_SET_APPROVAL, s, NULL);
+        suite->approvedRolls[suite->approvedCount++] = request.rollNumber;
+    }
+    bool ok = journalCommit(&journal) && approvalQueueSave(&suite->queue, suite->approvalSavePath);
+    double seconds = monotonicSeconds() - start;
+
+    journalClose(&journal);
+    remove(suite->journalPath);
+    for (int i = 0; i < suite->approvedCount; i++) {
+        storeFindByRoll(&suite->store, suite->approvedRolls[i])->approvalStatus = 0;
+    }
+    *items = requests;
+    return ok ? seconds : -1;
+}
+
+static double runListing(Suite *suite, const ListQuery *query, long *items) {
+    FILE *out = fopen(NULL_DEVICE, "w");
+    if (out == NULL) {
+        return -1;
+    }
+    ListResult result;
+    double start = monotonicSeconds();
+    bool ok = listSelect(&suite->store, query, &result);
+    if (ok) {
+        listWriteRows(out, &result, 0, result.count);
+        fflush(out);
+    }
+    double seconds = monotonicSeconds() - start;
+    *items = ok ? result.count : 0;
+    if (ok) {
+        listResultFree(&result);
+    }
+    fclose(out);
+    return ok ? seconds : -1;
+}
+
+// View All Students with no filter, in roll order
+static double runListAll(Suite *suite, long *items) {
+    ListQuery query;
+    listQueryDefaults(&query);
+    return runListing(suite, &query, items);
+}
+
+// Pending students owing anything, highest dues first
+static double runListPendingByDues(Suite *suite, long *items) {
+    ListQuery query;
+    listQueryDefaults(&query);
+    query.pendingOnly = true;
+    query.minDues = 0;
+    query.sort = LIST_SORT_DUES;
+    return runListing(suite, &query, items);
+}
+
+// Apply Payment History from scratch: parallel parse, key checks, plan
+static double runPaymentIngest(Suite *suite, long *items) {
+    PaymentCheckpoint checkpoint;
+    PaymentTotals totals;
+    PaymentIngestStats stats;
+    PaymentPlan plan;
+    PaymentApplyReport report;
+    paymentCheckpointInit(&checkpoint);
+    paymentTotalsInit(&totals);
+    double start = monotonicSeconds();
+    bool ok = ingestPayments(suite->paymentPath, defaultPaymentThreads(), &checkpoint, &checkpoint.keys, &totals, &stats)
+        && planPaymentTotals(&totals, &suite->store, &plan, &report);
+    double seconds = monotonicSeconds() - start;
+    if (ok) {
+        free(plan.items);
+        *items = stats.lines;
+    }
+    paymentTotalsFree(&totals);
+    paymentCheckpointFree(&checkpoint);
+    return ok ? seconds : -1;
+}
+
+static double runDuesSummary(Suite *suite, long *items) {
+    if (!suite->columns.built && !duesColumnsSync(&suite->columns, &suite->store)) {
+        return -1;
+    }
+    DuesSummary summary;
+    double start = monotonicSeconds();
+    duesSummarize(&suite->columns, &summary);
+    double seconds = monotonicSeconds() - start;
+    *items = summary.pending.students + summary.approved.students;
+    return seconds;
+}
+
+static bool addResult(Suite *suite, const char *name, long items, double seconds, int runs) {
+    if (suite->resultCount == MAX_RESULTS) {
+        return false;
+    }
+    SuiteResult *result = &suite->results[suite->resultCount++];
+    result->name = name;
+    result->items = items;
+    result->seconds = seconds;
+    result->runs = runs;
+    printf("%-24s %10ld items %12.3f ms %14.0f items/s\n", name, items, seconds * 1000,
+           seconds > 0 ? items / seconds : 0.0);
+    fflush(stdout);
+    return true;
+}
+
+// Run one benchmark `repeats` times and keep the fastest run
+static bool runBenchmark(Suite *suite, const char *name, SuiteRun run) {
+    double best = -1;
+    long items = 0;
+    for (int r = 0; r < suite->repeats; r++) {
+        long runItems = 0;
+        double seconds = run(suite, &runItems);
+        if (seconds < 0) {
+            printf("Error: Benchmark %s failed.\n", name);
+            return false;
+        }
+        if (best < 0 || seconds < best) {
+            best = seconds;
+            items = runItems;
+        }
+    }
+    return addResult(suite, name, items, best, suite->repeats);
+}
+
+static bool writeResults(const Suite *suite) {
+    FILE *file = fopen(suite->output, "w");
+    if (file == NULL) {
+        return false;
+    }
+    char date[32];
+    time_t now = time(NULL);
+    strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", localtime(&now));
+    fprintf(file, "{\n  \"suite\": \"no-due-bench\",\n  \"format\": %d,\n  \"date\": \"%s\",\n", SUITE_FORMAT, date);
+#ifdef __VERSION__
+    fprintf(file, "  \"compiler\": \"%s\",\n", __VERSION__);
+#endif
+    fprintf(file, "  \"config\": {\"students\": %d, \"owingPercent\": %d, \"approvedPercent\": %d, "
+            "\"appliedPercent\": %d, \"payments\": %d, \"seed\": %u, \"repeat\": %d, \"paymentThreads\": %d},\n",
+            suite->students, suite->owingPercent, suite->approvedPercent, suite->appliedPercent,
+            suite->payments, suite->seed, suite->repeats, defaultPaymentThreads());
+    fprintf(file, "  \"results\": [\n");
+    for (int i = 0; i < suite->resultCount; i++) {
+        const SuiteResult *r = &suite->results[i];
+        fprintf(file, "    {\"name\": \"%s\", \"items\": %ld, \"seconds\": %.9f, \"itemsPerSecond\": %.1f, \"runs\": %d}%s\n",
+                r->name, r->items, r->seconds, r->seconds > 0 ? r->items / r->seconds : 0.0, r->runs,
+                i + 1 < suite->resultCount ? "," : "");
+    }
+    fprintf(file, "  ]\n}\n");
+    return fclose(file) == 0;
+}
+
+static void printUsage(const char *program) {
+    printf("Usage: %s [--students N] [--owing PCT] [--approved PCT] [--applied PCT]\n", program);
+    printf("          [--payments N] [--seed N] [--repeat N] [--dir DIR] [--output FILE] [--generate-only]\n");
+}
+
+static bool parseOptions(Suite *suite, int argc, char *argv[]) {
+    suite->students = 1000000;
+    suite->owingPercent = 60;
+    suite->approvedPercent = 30;
+    suite->appliedPercent = 40;
+    suite->payments = -1;               // default: one per student
+    suite->seed = 12345u;
+    suite->repeats = 3;
+    suite->dir = "bench_data";
+    suite->output = "bench_results.json";
+    suite->generateOnly = false;
+    for (int i = 1; i < argc; i++) {
+        const char *option = argv[i];
+        if (strcmp(option, "--generate-only") == 0) {
+            suite->generateOnly = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            return false;
+        }
+        const char *value = argv[++i];
+        if (strcmp(option, "--students") == 0) {
+            suite->students = atoi(value);
+        } else if (strcmp(option, "--owing") == 0) {
+            suite->owingPercent = atoi(value);
+        } else if (strcmp(option, "--approved") == 0) {
+            suite->approvedPercent = atoi(value);
+        } else if (strcmp(option, "--applied") == 0) {
+            suite->appliedPercent = atoi(value);
+        } else if (strcmp(option, "--payments") == 0) {
+            suite->payments = atoi(value);
+        } else if (strcmp(option, "--seed") == 0) {
+            suite->seed = (unsigned int)strtoul(value, NULL, 10);
+        } else if (strcmp(option, "--repeat") == 0) {
+            suite->repeats = atoi(value);
+        } else if (strcmp(option, "--dir") == 0) {
+            suite->dir = value;
+        } else if (strcmp(option, "--output") == 0) {
+            suite->output = value;
+        } else {
+            return false;
+        }
+    }
+    if (suite->payments < 0) {
+        suite->payments = suite->students;
+    }
+    if (suite->seed == 0) {
+        suite->seed = 1; // xorshift state must not be zero
+    }
+    return suite->students > 0 && suite->repeats > 0
+        && suite->owingPercent >= 0 && suite->owingPercent <= 100
+        && suite->approvedPercent >= 0 && suite->approvedPercent <= 100
+        && suite->appliedPercent >= 0 && suite->appliedPercent <= 100;
+}
+
+int main(int argc, char *argv[]) {
+    static Suite suite;
+    if (!parseOptions(&suite, argc, argv)) {
+        printUsage(argv[0]);
+        return 1;
+    }
+    if (!makeDirectory(suite.dir)) {
+        printf("Error: Could not create %s.\n", suite.dir);
+        return 1;
+    }
+    joinPath(suite.studentPath, suite.dir, "student.txt");
+    joinPath(suite.approvalPath, suite.dir, "approval_list.txt");
+    joinPath(suite.paymentPath, suite.dir, "payment_history.txt");
+    joinPath(suite.savePath, suite.dir, "student_saved.txt");
+    joinPath(suite.approvalSavePath, suite.dir, "approval_saved.txt");
+    joinPath(suite.journalPath, suite.dir, "bench.journal");
+
+    printf("%d students (%d%% owing, %d%% approved, %d%% of pending applied), %d payments, seed %u\n",
+           suite.students, suite.owingPercent, suite.approvedPercent, suite.appliedPercent,
+           suite.payments, suite.seed);
+    double start = monotonicSeconds();
+    if (!writeStudents(&suite) || !writePayments(&suite)) {
+        printf("Error: Could not write the data files in %s.\n", suite.dir);
+        return 1;
+    }
+    addResult(&suite, "generate", (long)suite.students + suite.payments, monotonicSeconds() - start, 1);
+    if (suite.generateOnly) {
+        printf("Data written to %s.\n", suite.dir);
+        return 0;
+    }
+
+    storeInit(&suite.store);
+    approvalQueueInit(&suite.queue);
+    duesColumnsInit(&suite.columns);
+    suite.lookups = suite.students > 1000000 ? suite.students : 1000000;
+    suite.approvedRolls = malloc(sizeof(int) * (size_t)suite.students);
+    if (suite.approvedRolls == NULL) {
+        printf("Error: Out of memory.\n");
+        return 1;
+    }
+
+    bool ok = runBenchmark(&suite, "load_students", runLoadStudents)
+        && runBenchmark(&suite, "save_students", runSaveStudents)
+        && runBenchmark(&suite, "roll_lookup", runRollLookup)
+        && runBenchmark(&suite, "load_approvals", runLoadApprovals)
+        && runBenchmark(&suite, "duplicate_check", runDuplicateCheck)
+        && runBenchmark(&suite, "process_approvals", runProcessApprovals)
+        && runBenchmark(&suite, "list_all", runListAll)
+        && runBenchmark(&suite, "list_pending_by_dues", runListPendingByDues)
+        && runBenchmark(&suite, "payment_ingest", runPaymentIngest)
+        && runBenchmark(&suite, "dues_summary", runDuesSummary);
+
+    if (ok && !writeResults(&suite)) {
+        printf("Error: Could not write %s.\n", suite.output);
+        ok = false;
+    } else if (ok) {
+        printf("Results written to %s.\n", suite.output);
+    }
+
+    remove(suite.savePath);
+    remove(suite.approvalSavePath);
+    free(suite.approvedRolls);
+    duesColumnsFree(&suite.columns);
+    approvalQueueFree(&suite.queue);
+    storeFree(&suite.store);
+    return ok ? 0 : 2;
+}
@@ -0,0 +1,280 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include "certificates.h"
+#include "file_util.h"
+#include "timing.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+#define CERTIFICATE_TEXT_SIZE 1024
+#define CERTIFICATE_PATH_SIZE 512
+#define REPORT_LINE_SIZE (MAX_NAME_LENGTH + 128) // longest report line, with room to spare
+#define REPORT_BUFFER_SIZE (1 << 20)
+#define PROGRESS_INTERVAL 0.2           // seconds between progress calls
+
+// Report lines of one batch: filled by the worker that claimed it, written
+// out in batch order by the generating thread
+typedef struct {
+    char *text;
+    size_t length;
+    bool done;
+} ReportBlock;
+
+typedef struct {
+    const StudentStore *store;
+    const int *positions;       // approved records, in store order
+    int count;
+    const char *directory;
+    char issued[16];            // DD-MM-YYYY
+    int year;
+    pthread_mutex_t lock;       // guards everything below
+    pthread_cond_t blockDone;
+    int nextBatch;
+    int batchCount;
+    ReportBlock *blocks;
+    int written;
+    int failed;
+    long long bytes;
+} CertificateJob;
+
+int defaultCertificateThreads(void) {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    int cpus = (int)info.dwNumberOfProcessors;
+#else
+    int cpus = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+    return cpus < 1 ? 1 : (cpus > CERTIFICATE_MAX_THREADS ? CERTIFICATE_MAX_THREADS : cpus);
+}
+
+static int renderCertificate(const CertificateJob *job, const Student *s, char *out) {
+    char fees[MONEY_TEXT_SIZE], hostel[MONEY_TEXT_SIZE];
+    int length = snprintf(out, CERTIFICATE_TEXT_SIZE,
+        "NO DUES CERTIFICATE\n"
+        "===================\n"
+        "\n"
+        "Certificate No. : ND/%d/%d\n"
+        "Issued on       : %s\n"
+        "\n"
+        "This is to certify that %s (Roll No. %d)\n"
+        "has been granted no-dues clearance by the Accounts, Library and\n"
+        "Hostel departments.\n"
+        "\n"
+        "Fees due        : Rs. %s\n"
+        "Library books   : %d\n"
+        "Hostel due      : Rs. %s\n",
+        job->year, s->rollNumber, job->issued, storeName(job->store, s), s->rollNumber,
+        moneyText(s->feesDue, fees), s->libraryBooksDue, moneyText(s->hostelDue, hostel));
+    return length < CERTIFICATE_TEXT_SIZE ? length : CERTIFICATE_TEXT_SIZE - 1;
+}
+
+// The certificate is rendered in full first, so the file gets a single
+// unbuffered write
+static bool writeCertificate(const char *path, const char *text, int length) {
+    FILE *file = fopen(path, "wb");
+    if (file == NULL) {
+        return false;
+    }
+    setvbuf(file, NULL, _IONBF, 0);
+    bool ok = fwrite(text, 1, (size_t)length, file) == (size_t)length;
+    return (fclose(file) == 0) && ok;
+}
+
+// Claim batches of CERTIFICATE_BATCH approved students until none are
+// left: write each certificate and the batch's report lines
+static void *certificateWorker(void *arg) {
+    CertificateJob *job = arg;
+    char text[CERTIFICATE_TEXT_SIZE];
+    char path[CERTIFICATE_PATH_SIZE];
+    for (;;) {
+        pthread_mutex_lock(&job->lock);
+        int batch = job->nextBatch++;
+        pthread_mutex_unlock(&job->lock);
+        if (batch >= job->batchCount) {
+            break;
+        }
+
+        int first = batch * CERTIFICATE_BATCH;
+        int last = first + CERTIFICATE_BATCH < job->count ? first + CERTIFICATE_BATCH : job->count;
+        ReportBlock *block = &job->blocks[batch];
+        char *lines = malloc((size_t)(last - first) * REPORT_LINE_SIZE);
+        size_t length = 0;
+        int written = 0;
+        int failed = 0;
+        long long bytes = 0;
+        for (int i = first; i < last; i++) {
+            const Student *s = storeAt(job->store, job->positions[i]);
+            int size = renderCertificate(job, s, text);
+            snprintf(path, sizeof(path), "%s/%d.txt", job->directory, s->rollNumber);
+            bool ok = writeCertificate(path, text, size);
+            if (ok) {
+                written++;
+                bytes += size;
+            } else {
+                failed++;
+            }
+            if (lines != NULL) {
+                char fees[MONEY_TEXT_SIZE], hostel[MONEY_TEXT_SIZE];
+                int n = snprintf(lines + length, REPORT_LINE_SIZE, "%d,%s,%s,%d,%s,%s\n",
+                                 s->rollNumber, storeName(job->store, s), moneyText(s->feesDue, fees), s->libraryBooksDue,
+                                 moneyText(s->hostelDue, hostel), ok ? "written" : "failed");
+                length += n < REPORT_LINE_SIZE ? (size_t)n : REPORT_LINE_SIZE - 1;
+            }
+        }
+
+        pthread_mutex_lock(&job->lock);
+        block->text = lines;
+        block->length = length;
+        block->done = true;
+        job->written += written;
+        job->failed += failed;
+        job->bytes += bytes;
+        pthread_cond_broadcast(&job->blockDone);
+        pthread_mutex_unlock(&job->lock);
+    }
+    return NULL;
+}
+
+// Write a no-dues certificate (DIRECTORY/ROLL.txt) for every approved
+// student and a consolidated CERTIFICATE_REPORT_FILENAME in the same
+// directory. Workers claim batches of students; this thread writes the
+// report in store order as batches finish (through a 1 MB buffer, replaced
+// atomically) and reports progress. False when the approved records could
+// not be collected or the directory could not be created; certificates or a
+// report that could not be written are counted in `report`.
+bool generateCertificates(const StudentStore *store, const char *directory, int threads,
+                          CertificateProgress progress, void *context, CertificateReport *report) {
+    memset(report, 0, sizeof(*report));
+    double start = monotonicSeconds();
+    report->students = store->count;
+    int *positions = malloc(sizeof(int) * ((size_t)store->count + 1));
+    if (positions == NULL) {
+        return false;
+    }
+    int count = 0;
+    for (int i = 0; i < store->count; i++) {
+        if (storeAt(store, i)->approvalStatus == 1) {
+            positions[count++] = i;
+        }
+    }
+    report->approved = count;
+    report->scanSeconds = monotonicSeconds() - start;
+
+    if (strlen(directory) > CERTIFICATE_PATH_SIZE - 64 || !makeDirectory(directory)) {
+        free(positions);
+        return false;
+    }
+
+    start = monotonicSeconds();
+    CertificateJob job;
+    memset(&job, 0, sizeof(job));
+    job.store = store;
+    job.positions = positions;
+    job.count = count;
+    job.directory = directory;
+    time_t now = time(NULL);
+    struct tm *local = localtime(&now);
+    strftime(job.issued, sizeof(job.issued), "%d-%m-%Y", local);
+    job.year = local->tm_year + 1900;
+    job.batchCount = (count + CERTIFICATE_BATCH - 1) / CERTIFICATE_BATCH;
+    job.blocks = calloc((size_t)job.batchCount + 1, sizeof(ReportBlock));
+    if (job.blocks == NULL) {
+        free(positions);
+        return false;
+    }
+    pthread_mutex_init(&job.lock, NULL);
+    pthread_cond_init(&job.blockDone, NULL);
+
+    char reportPath[CERTIFICATE_PATH_SIZE];
+    char tempPath[CERTIFICATE_PATH_SIZE + 8];
+    snprintf(reportPath, sizeof(reportPath), "%s/%s", directory, CERTIFICATE_REPORT_FILENAME);
+    snprintf(tempPath, sizeof(tempPath), "%s.tmp", reportPath);
+    FILE *out = fopen(tempPath, "w");
+    bool reportOk = out != NULL;
+    if (out != NULL) {
+        setvbuf(out, NULL, _IOFBF, REPORT_BUFFER_SIZE);
+        fprintf(out, "# No-dues clearance report, issued %s\n", job.issued);
+        fprintf(out, "# %d of %d students approved\n", count, store->count);
+        fprintf(out, "roll,name,fees_due,books_due,hostel_due,certificate\n");
+    }
+
+    if (threads < 1) {
+        threads = 1;
+    }
+    if (threads > CERTIFICATE_MAX_THREADS) {
+        threads = CERTIFICATE_MAX_THREADS;
+    }
+    if (threads > job.batchCount) {
+        threads = job.batchCount > 0 ? job.batchCount : 1;
+    }
+    report->threads = threads;
+    pthread_t workers[CERTIFICATE_MAX_THREADS];
+    int started = 0;
+    for (int t = 0; t < threads; t++) {
+        if (pthread_create(&workers[t], NULL, certificateWorker, &job) != 0) {
+            break;
+        }
+        started++;
+    }
+    if (started == 0) {
+        certificateWorker(&job); // could not spawn: do it all here
+        report->threads = 1;
+    }
+
+    double lastProgress = 0;
+    for (int b = 0; b < job.batchCount; b++) {
+        pthread_mutex_lock(&job.lock);
+        while (!job.blocks[b].done) {
+            pthread_cond_wait(&job.blockDone, &job.lock);
+        }
+        int done = job.written + job.failed;
+        pthread_mutex_unlock(&job.lock);
+
+        ReportBlock *block = &job.blocks[b];
+        if (block->text == NULL) {
+            reportOk = false;
+        } else if (out != NULL && fwrite(block->text, 1, block->length, out) != block->length) {
+            reportOk = false;
+        }
+        free(block->text);
+        block->text = NULL;
+
+        double elapsed = monotonicSeconds() - start;
+        if (progress != NULL && (elapsed - lastProgress >= PROGRESS_INTERVAL || b == job.batchCount - 1)) {
+            progress(done, count, elapsed, context);
+            lastProgress = elapsed;
+        }
+    }
+    for (int t = 0; t < started; t++) {
+        pthread_join(workers[t], NULL);
+    }
+
+    if (out != NULL) {
+        fprintf(out, "# %d certificates written, %d failed\n", job.written, job.failed);
+        reportOk = flushAndSync(out) && reportOk;
+        reportOk = (fclose(out) == 0) && reportOk;
+        if (!reportOk || !replaceFileAtomically(tempPath, reportPath)) {
+            remove(tempPath);
+            reportOk = false;
+        }
+    }
+    report->reportWritten = reportOk;
+    report->written = job.written;
+    report->failed = job.failed;
+    report->bytes = job.bytes;
+    report->writeSeconds = monotonicSeconds() - start;
+
+    pthread_cond_destroy(&job.blockDone);
+    pthread_mutex_destroy(&job.lock);
+    free(job.blocks);
+    free(positions);
+    return true;
+}
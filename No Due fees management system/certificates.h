@@ -0,0 +1,32 @@
+#ifndef CERTIFICATES_H
+#define CERTIFICATES_H
+
+#include <stdbool.h>
+#include "student_store.h"
+
+#define CERTIFICATE_DIR "certificates"
+#define CERTIFICATE_REPORT_FILENAME "clearance_report.txt"
+#define CERTIFICATE_MAX_THREADS 64
+#define CERTIFICATE_BATCH 256   // certificates a worker claims at a time
+
+// Called on the generating thread as certificates complete
+typedef void (*CertificateProgress)(int written, int total, double seconds, void *context);
+
+// Outcome of one generation run
+typedef struct {
+    int students;           // records scanned
+    int approved;           // certificates due (approvalStatus == 1)
+    int written;
+    int failed;             // certificate files that could not be written
+    int threads;
+    long long bytes;        // certificate bytes written
+    bool reportWritten;
+    double scanSeconds;
+    double writeSeconds;    // certificates and report
+} CertificateReport;
+
+bool generateCertificates(const StudentStore *store, const char *directory, int threads,
+                          CertificateProgress progress, void *context, CertificateReport *report);
+int defaultCertificateThreads(void);
+
+#endif
@@ -0,0 +1,191 @@
+#include <stdio.h>
+#include <string.h>
+#include "clearance.h"
+#include "file_util.h"
+
+static const char *departmentNames[DEPARTMENT_COUNT] = { "accounts", "library", "hostel" };
+static const char *departmentFiles[DEPARTMENT_COUNT] = {
+    "clearance_accounts.txt", "clearance_library.txt", "clearance_hostel.txt"
+};
+
+void clearanceInit(ClearanceBoard *board) {
+    for (int d = 0; d < DEPARTMENT_COUNT; d++) {
+        approvalQueueInit(&board->queues[d]);
+        board->queueDirty[d] = false;
+    }
+    rollMapInit(&board->cleared);
+    board->clearedDirty = false;
+}
+
+void clearanceFree(ClearanceBoard *board) {
+    for (int d = 0; d < DEPARTMENT_COUNT; d++) {
+        approvalQueueFree(&board->queues[d]);
+    }
+    rollMapFree(&board->cleared);
+    clearanceInit(board);
+}
+
+const char *departmentName(Department department) {
+    return departmentNames[department];
+}
+
+const char *departmentFilename(Department department) {
+    return departmentFiles[department];
+}
+
+bool departmentFromName(const char *name, Department *out) {
+    for (int d = 0; d < DEPARTMENT_COUNT; d++) {
+        if (strcmp(name, departmentNames[d]) == 0) {
+            *out = (Department)d;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Whether the department has anything to check for this student: accounts
+// only sees students with fees due, the library those with books out, the
+// hostel office those with hostel dues
+bool departmentOwed(Department department, const Student *s) {
+    switch (department) {
+        case DEPARTMENT_ACCOUNTS:
+            return s->feesDue > 0;
+        case DEPARTMENT_LIBRARY:
+            return s->libraryBooksDue > 0;
+        case DEPARTMENT_HOSTEL:
+            return s->hostelDue > 0;
+        default:
+            return false;
+    }
+}
+
+// Read CLEARANCE_FILENAME ("roll,mask" lines) and every department queue.
+// Missing files mean nothing is open; false only when out of memory.
+bool clearanceLoad(ClearanceBoard *board) {
+    for (int d = 0; d < DEPARTMENT_COUNT; d++) {
+        approvalQueueLoad(&board->queues[d], departmentFiles[d]);
+    }
+    FILE *file = fopen(CLEARANCE_FILENAME, "r");
+    if (file == NULL) {
+        return true;
+    }
+    char line[64];
+    bool ok = true;
+    while (ok && fgets(line, sizeof(line), file) != NULL) {
+        int rollNumber;
+        int mask;
+        if (sscanf(line, "%d,%d", &rollNumber, &mask) == 2 && mask >= 0 && mask < CLEARANCE_ALL) {
+            ok = rollMapPut(&board->cleared, rollNumber, mask);
+        }
+    }
+    fclose(file);
+    return ok;
+}
+
+bool clearanceSaveQueue(ClearanceBoard *board, Department department) {
+    if (!board->queueDirty[department]) {
+        return true;
+    }
+    if (!approvalQueueSave(&board->queues[department], departmentFiles[department])) {
+        return false;
+    }
+    board->queueDirty[department] = false;
+    return true;
+}
+
+// Rewrite CLEARANCE_FILENAME (temp file + atomic rename) if it changed
+bool clearanceSaveStatus(ClearanceBoard *board) {
+    if (!board->clearedDirty) {
+        return true;
+    }
+    char tempPath[64];
+    snprintf(tempPath, sizeof(tempPath), "%s.tmp", CLEARANCE_FILENAME);
+    FILE *file = fopen(tempPath, "w");
+    if (file == NULL) {
+        return false;
+    }
+    for (unsigned int i = 0; i < board->cleared.capacity; i++) {
+        const RollMapSlot *slot = &board->cleared.slots[i];
+        if (slot->value >= 0) {
+            fprintf(file, "%d,%d\n", slot->key, slot->value);
+        }
+    }
+    bool ok = flushAndSync(file);
+    ok = (fclose(file) == 0) && ok;
+    if (!ok || !replaceFileAtomically(tempPath, CLEARANCE_FILENAME)) {
+        remove(tempPath);
+        return false;
+    }
+    board->clearedDirty = false;
+    return true;
+}
+
+// Write every file that changed; false if any of them could not be written
+bool clearanceSave(ClearanceBoard *board) {
+    bool ok = clearanceSaveStatus(board);
+    for (int d = 0; d < DEPARTMENT_COUNT; d++) {
+        ok = clearanceSaveQueue(board, (Department)d) && ok;
+    }
+    return ok;
+}
+
+// Open an application: clear the departments the student owes nothing and
+// queue it (under `name`) with the rest. Returns the departments cleared so far
+// (CLEARANCE_ALL when none has anything to check), or -1 when out of memory.
+// Applying again restarts the clearance.
+int clearanceSubmit(ClearanceBoard *board, const Student *s, const char *name) {
+    int mask = 0;
+    for (int d = 0; d < DEPARTMENT_COUNT; d++) {
+        if (!departmentOwed((Department)d, s)) {
+            mask |= 1 << d;
+        } else if (!approvalQueueContains(&board->queues[d], s->rollNumber)) {
+            if (!approvalQueuePush(&board->queues[d], s->rollNumber, name)) {
+                return -1;
+            }
+            board->queueDirty[d] = true;
+        }
+    }
+    board->clearedDirty = true;
+    if (mask == CLEARANCE_ALL) {
+        rollMapRemove(&board->cleared, s->rollNumber);
+        return mask;
+    }
+    return rollMapPut(&board->cleared, s->rollNumber, mask) ? mask : -1;
+}
+
+// Departments that have cleared an open application; -1 when the roll has
+// none open
+int clearanceOf(const ClearanceBoard *board, int rollNumber) {
+    return rollMapGet(&board->cleared, rollNumber);
+}
+
+// Record one department's sign-off. Returns the departments cleared now
+// (the application is closed when that is CLEARANCE_ALL), or -1 when the
+// roll has no open application.
+int clearanceMark(ClearanceBoard *board, int rollNumber, Department department) {
+    int mask = rollMapGet(&board->cleared, rollNumber);
+    if (mask < 0) {
+        return -1;
+    }
+    mask |= 1 << department;
+    board->clearedDirty = true;
+    if (mask == CLEARANCE_ALL) {
+        rollMapRemove(&board->cleared, rollNumber);
+    } else {
+        rollMapPut(&board->cleared, rollNumber, mask);
+    }
+    return mask;
+}
+
+// Close an application without approval (a department rejected it, or the
+// request was decided outside the departments)
+void clearanceWithdraw(ClearanceBoard *board, int rollNumber) {
+    for (int d = 0; d < DEPARTMENT_COUNT; d++) {
+        if (approvalQueueRemove(&board->queues[d], rollNumber)) {
+            board->queueDirty[d] = true;
+        }
+    }
+    if (rollMapRemove(&board->cleared, rollNumber)) {
+        board->clearedDirty = true;
+    }
+}
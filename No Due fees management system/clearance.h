@@ -0,0 +1,52 @@
+#ifndef CLEARANCE_H
+#define CLEARANCE_H
+
+#include <stdbool.h>
+#include "student_store.h"
+#include "approval_queue.h"
+#include "roll_map.h"
+
+#define CLEARANCE_FILENAME "clearance.txt"
+#define CLEARANCE_ALL ((1 << DEPARTMENT_COUNT) - 1)
+
+// Departments that must each sign off before a no-dues certificate
+typedef enum {
+    DEPARTMENT_ACCOUNTS = 0,    // fees
+    DEPARTMENT_LIBRARY,         // library books
+    DEPARTMENT_HOSTEL,          // hostel dues
+    DEPARTMENT_COUNT
+} Department;
+
+// Per-department clearance of open applications. An application has an
+// entry in `cleared` (one bit per department that signed off) and sits in
+// the queue of every department still to decide. A department the student
+// owes nothing is cleared when the application is made. The entry goes
+// away when the last department clears (the caller then approves the
+// student) or any department rejects.
+//
+// Not thread-safe: the server guards each queue and `cleared` separately.
+typedef struct {
+    ApprovalQueue queues[DEPARTMENT_COUNT];
+    RollMap cleared;                    // rollNumber -> bitmask of cleared departments
+    bool queueDirty[DEPARTMENT_COUNT];  // queue file needs rewriting
+    bool clearedDirty;                  // CLEARANCE_FILENAME needs rewriting
+} ClearanceBoard;
+
+void clearanceInit(ClearanceBoard *board);
+void clearanceFree(ClearanceBoard *board);
+bool clearanceLoad(ClearanceBoard *board);
+bool clearanceSaveQueue(ClearanceBoard *board, Department department);
+bool clearanceSaveStatus(ClearanceBoard *board);
+bool clearanceSave(ClearanceBoard *board);
+
+const char *departmentName(Department department);
+const char *departmentFilename(Department department);
+bool departmentFromName(const char *name, Department *out);
+bool departmentOwed(Department department, const Student *s);
+
+int clearanceSubmit(ClearanceBoard *board, const Student *s, const char *name);
+int clearanceOf(const ClearanceBoard *board, int rollNumber);
+int clearanceMark(ClearanceBoard *board, int rollNumber, Department department);
+void clearanceWithdraw(ClearanceBoard *board, int rollNumber);
+
+#endif
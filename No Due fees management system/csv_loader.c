@@ -0,0 +1,201 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "csv_loader.h"
+#include "file_util.h"
+#include "timing.h"
+
+// Parse an optionally signed integer; advances *p past the digits
+bool csvParseInt(const char **p, const char *end, int *out) {
+    const char *s = *p;
+    while (s < end && *s == ' ') {
+        s++;
+    }
+    bool negative = false;
+    if (s < end && (*s == '-' || *s == '+')) {
+        negative = (*s == '-');
+        s++;
+    }
+    if (s == end || *s < '0' || *s > '9') {
+        return false;
+    }
+    long long value = 0;
+    while (s < end && *s >= '0' && *s <= '9') {
+        value = value * 10 + (*s - '0');
+        if (value > 2147483647LL) {
+            return false;
+        }
+        s++;
+    }
+    *out = (int)(negative ? -value : value);
+    *p = s;
+    return true;
+}
+
+static bool expectComma(const char **p, const char *end) {
+    if (*p < end && **p == ',') {
+        (*p)++;
+        return true;
+    }
+    return false;
+}
+
+// Parse one line (without its newline): roll,name,fees,books,hostel,approval.
+// The name is interned into the store's arena once the whole line parsed.
+// On failure *error names the offending field.
+bool parseStudentLine(const char *line, const char *end, StudentStore *store, Student *out, const char **error) {
+    const char *p = line;
+
+    if (!csvParseInt(&p, end, &out->rollNumber) || !expectComma(&p, end)) {
+        *error = "bad roll number";
+        return false;
+    }
+
+    const char *nameStart = p;
+    while (p < end && *p != ',') {
+        p++;
+    }
+    size_t nameLength = (size_t)(p - nameStart);
+    if (nameLength == 0 || nameLength >= MAX_NAME_LENGTH) {
+        *error = nameLength == 0 ? "empty name" : "name too long";
+        return false;
+    }
+    if (!expectComma(&p, end)) {
+        *error = "missing fields after name";
+        return false;
+    }
+
+    if (!moneyParse(&p, end, &out->feesDue) || !expectComma(&p, end)) {
+        *error = "bad fees due";
+        return false;
+    }
+    if (!csvParseInt(&p, end, &out->libraryBooksDue) || !expectComma(&p, end)) {
+        *error = "bad library books due";
+        return false;
+    }
+    if (!moneyParse(&p, end, &out->hostelDue) || !expectComma(&p, end)) {
+        *error = "bad hostel due";
+        return false;
+    }
+    if (!csvParseInt(&p, end, &out->approvalStatus)) {
+        *error = "bad approval status";
+        return false;
+    }
+
+    // Allow trailing blanks (and a CR from Windows line endings)
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\r')) {
+        p++;
+    }
+    if (p != end) {
+        *error = "unexpected trailing data";
+        return false;
+    }
+    out->name = storeInternName(store, nameStart, nameLength);
+    if (out->name == NAME_NONE) {
+        *error = "out of memory";
+        return false;
+    }
+    return true;
+}
+
+// Write every record as a CSV line via a temp file and atomic rename
+bool saveStudentsToCsv(const char *path, const StudentStore *store) {
+    char tempPath[512];
+    snprintf(tempPath, sizeof(tempPath), "%s.tmp", path);
+
+    FILE *file = fopen(tempPath, "w");
+    if (file == NULL) {
+        return false;
+    }
+    // Large stdio buffer: one write syscall per 1 MB instead of per line
+    setvbuf(file, NULL, _IOFBF, 1 << 20);
+
+    char fees[MONEY_TEXT_SIZE];
+    char hostel[MONEY_TEXT_SIZE];
+    for (int i = 0; i < store->count; i++) {
+        const Student *s = storeAt(store, i);
+        moneyFormat(s->feesDue, fees);
+        moneyFormat(s->hostelDue, hostel);
+        fprintf(file, "%d,%s,%s,%d,%s,%d\n",
+               s->rollNumber,
+               storeName(store, s),
+               fees,
+               s->libraryBooksDue,
+               hostel,
+               s->approvalStatus);
+    }
+
+    bool ok = flushAndSync(file);
+    ok = (fclose(file) == 0) && ok;
+    if (!ok || !replaceFileAtomically(tempPath, path)) {
+        remove(tempPath);
+        return false;
+    }
+    return true;
+}
+
+// Bulk-load a student CSV file into the store. Malformed lines are reported
+// with their line numbers and skipped; loading continues with the next line.
+bool loadStudentsFromCsv(const char *path, StudentStore *store, CsvLoadStats *stats) {
+    memset(stats, 0, sizeof(*stats));
+    double start = monotonicSeconds();
+
+    FileView view;
+    if (!fileViewOpen(path, &view)) {
+        return false;
+    }
+    stats->bytes = view.size;
+
+    // Typical lines are ~30 bytes; reserve up front to avoid regrowth
+    storeReserve(store, store->count + (int)(view.size / 28) + 1);
+
+    const char *p = view.data;
+    const char *end = view.data + view.size;
+    long lineNumber = 0;
+    Student record;
+
+    while (p < end) {
+        const char *lineEnd = memchr(p, '\n', (size_t)(end - p));
+        if (lineEnd == NULL) {
+            lineEnd = end;
+        }
+        lineNumber++;
+
+        // Skip blank lines silently
+        const char *q = p;
+        while (q < lineEnd && (*q == ' ' || *q == '\t' || *q == '\r')) {
+            q++;
+        }
+        if (q < lineEnd) {
+            const char *error;
+            stats->lines++;
+            if (!parseStudentLine(p, lineEnd, store, &record, &error)) {
+                if (stats->malformed < CSV_MAX_REPORTED_ERRORS) {
+                    printf("Warning: %s line %ld: %s.\n", path, lineNumber, error);
+                }
+                stats->malformed++;
+            } else if (storeAdd(store, &record) != NULL) {
+                stats->loaded++;
+            } else if (storeFindByRoll(store, record.rollNumber) != NULL) {
+                if (stats->duplicates < CSV_MAX_REPORTED_ERRORS) {
+                    printf("Warning: %s line %ld: duplicate roll number %d skipped.\n",
+                           path, lineNumber, record.rollNumber);
+                }
+                stats->duplicates++;
+            } else {
+                printf("Error: Out of memory while loading %s.\n", path);
+                break;
+            }
+        }
+        p = lineEnd + 1;
+    }
+
+    fileViewClose(&view);
+
+    if (stats->malformed > CSV_MAX_REPORTED_ERRORS) {
+        printf("Warning: %d malformed lines in total (only the first %d shown).\n",
+               stats->malformed, CSV_MAX_REPORTED_ERRORS);
+    }
+    stats->seconds = monotonicSeconds() - start;
+    return true;
+}
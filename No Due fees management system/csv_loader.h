@@ -0,0 +1,28 @@
+#ifndef CSV_LOADER_H
+#define CSV_LOADER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "student_store.h"
+
+#define STUDENT_FILENAME "student.txt"
+
+// Malformed lines beyond this many are counted but not printed
+#define CSV_MAX_REPORTED_ERRORS 20
+
+// Summary of one bulk load
+typedef struct {
+    long lines;             // non-empty lines seen
+    int loaded;             // records added to the store
+    int malformed;          // lines rejected by the parser
+    int duplicates;         // lines skipped because the roll already existed
+    size_t bytes;           // file size
+    double seconds;         // wall time for map + parse + insert
+} CsvLoadStats;
+
+bool loadStudentsFromCsv(const char *path, StudentStore *store, CsvLoadStats *stats);
+bool saveStudentsToCsv(const char *path, const StudentStore *store);
+bool csvParseInt(const char **p, const char *end, int *out);
+bool parseStudentLine(const char *line, const char *end, StudentStore *store, Student *out, const char **error);
+
+#endif
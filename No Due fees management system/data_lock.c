@@ -0,0 +1,129 @@
+#include <stdio.h>
+#include <string.h>
+#include "data_lock.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// Create the lock file if needed; it is never deleted, so every process
+// locks the same file
+bool dataLockOpen(DataLock *lock, const char *path) {
+    lock->held = false;
+    lock->exclusive = false;
+#ifdef _WIN32
+    HANDLE handle = CreateFileA(path, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE,
+                                NULL, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    lock->handle = handle == INVALID_HANDLE_VALUE ? NULL : handle;
+    return lock->handle != NULL;
+#else
+    lock->fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    return lock->fd >= 0;
+#endif
+}
+
+void dataLockClose(DataLock *lock) {
+    if (lock->held) {
+        dataLockRelease(lock, NULL);
+    }
+#ifdef _WIN32
+    if (lock->handle != NULL) {
+        CloseHandle(lock->handle);
+        lock->handle = NULL;
+    }
+#else
+    if (lock->fd >= 0) {
+        close(lock->fd);
+        lock->fd = -1;
+    }
+#endif
+}
+
+static bool readGenerations(DataLock *lock, DataGenerations *out) {
+    memset(out, 0, sizeof(*out));
+#ifdef _WIN32
+    OVERLAPPED at;
+    memset(&at, 0, sizeof(at));
+    DWORD got = 0;
+    return ReadFile(lock->handle, out, sizeof(*out), &got, &at) || GetLastError() == ERROR_HANDLE_EOF;
+#else
+    // A new (empty) lock file reads as all-zero counters
+    return pread(lock->fd, out, sizeof(*out), 0) >= 0;
+#endif
+}
+
+static bool writeGenerations(DataLock *lock, const DataGenerations *generations) {
+#ifdef _WIN32
+    OVERLAPPED at;
+    memset(&at, 0, sizeof(at));
+    DWORD written = 0;
+    return WriteFile(lock->handle, generations, sizeof(*generations), &written, &at)
+        && written == sizeof(*generations);
+#else
+    return pwrite(lock->fd, generations, sizeof(*generations), 0) == (ssize_t)sizeof(*generations);
+#endif
+}
+
+// Take the lock, shared or exclusive (waiting for other processes when
+// `wait` is set), and read the current change counters. False when busy or
+// on error.
+bool dataLockAcquire(DataLock *lock, bool exclusive, bool wait, DataGenerations *current) {
+#ifdef _WIN32
+    if (lock->handle == NULL) {
+        return false;
+    }
+    OVERLAPPED at;
+    memset(&at, 0, sizeof(at));
+    DWORD flags = (exclusive ? LOCKFILE_EXCLUSIVE_LOCK : 0) | (wait ? 0 : LOCKFILE_FAIL_IMMEDIATELY);
+    if (!LockFileEx(lock->handle, flags, 0, 1, 0, &at)) {
+        return false;
+    }
+#else
+    if (lock->fd < 0) {
+        return false;
+    }
+    struct flock region;
+    memset(&region, 0, sizeof(region));
+    region.l_type = exclusive ? F_WRLCK : F_RDLCK;
+    region.l_whence = SEEK_SET;
+    int result;
+    do {
+        result = fcntl(lock->fd, wait ? F_SETLKW : F_SETLK, &region);
+    } while (result != 0 && errno == EINTR && wait);
+    if (result != 0) {
+        return false;
+    }
+#endif
+    lock->held = true;
+    lock->exclusive = exclusive;
+    if (!readGenerations(lock, current)) {
+        dataLockRelease(lock, NULL);
+        return false;
+    }
+    return true;
+}
+
+// Publish updated counters (NULL = nothing changed; only an exclusive
+// holder may change them) and let others in
+bool dataLockRelease(DataLock *lock, const DataGenerations *updated) {
+    if (!lock->held) {
+        return false;
+    }
+    bool ok = updated == NULL || !lock->exclusive || writeGenerations(lock, updated);
+    lock->held = false;
+#ifdef _WIN32
+    OVERLAPPED at;
+    memset(&at, 0, sizeof(at));
+    return UnlockFileEx(lock->handle, 0, 1, 0, &at) && ok;
+#else
+    struct flock region;
+    memset(&region, 0, sizeof(region));
+    region.l_type = F_UNLCK;
+    region.l_whence = SEEK_SET;
+    return fcntl(lock->fd, F_SETLK, &region) == 0 && ok;
+#endif
+}
@@ -0,0 +1,39 @@
+#ifndef DATA_LOCK_H
+#define DATA_LOCK_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define DATA_LOCK_FILENAME "student.lock"
+
+// Change counters stored in the lock file. Each process remembers the
+// values it last saw; a counter that moved means another process rewrote
+// that file and the in-memory copy must be reloaded.
+typedef struct {
+    uint64_t students;      // base file rewritten (journal compacted)
+    uint64_t approvals;     // approval_list.txt appended or rewritten
+    uint64_t payments;      // payment checkpoint saved
+    uint64_t clearance;     // department queues or clearance.txt rewritten
+} DataGenerations;
+
+// Advisory lock on the data files across processes (fcntl record lock on
+// POSIX, LockFileEx on Windows): shared while a session reads them, so any
+// number of readers run together, and exclusive while one changes them.
+// The lock is per process: threads of one process must coordinate among
+// themselves.
+typedef struct {
+#ifdef _WIN32
+    void *handle;
+#else
+    int fd;
+#endif
+    bool held;
+    bool exclusive;
+} DataLock;
+
+bool dataLockOpen(DataLock *lock, const char *path);
+void dataLockClose(DataLock *lock);
+bool dataLockAcquire(DataLock *lock, bool exclusive, bool wait, DataGenerations *current);
+bool dataLockRelease(DataLock *lock, const DataGenerations *updated);
+
+#endif
@@ -0,0 +1,167 @@
+#include <stdlib.h>
+#include "dues_columns.h"
+
+void duesColumnsInit(DuesColumns *columns) {
+    columns->rollNumbers = NULL;
+    columns->feesDue = NULL;
+    columns->hostelDue = NULL;
+    columns->booksDue = NULL;
+    columns->approved = NULL;
+    columns->count = 0;
+    columns->capacity = 0;
+    columns->built = false;
+}
+
+void duesColumnsFree(DuesColumns *columns) {
+    free(columns->rollNumbers);
+    free(columns->feesDue);
+    free(columns->hostelDue);
+    free(columns->booksDue);
+    free(columns->approved);
+    duesColumnsInit(columns);
+}
+
+// Grow every column to hold at least `needed` rows
+static bool reserveColumns(DuesColumns *columns, int needed) {
+    if (needed <= columns->capacity) {
+        return true;
+    }
+    int capacity = columns->capacity ? columns->capacity : 1024;
+    while (capacity < needed) {
+        capacity *= 2;
+    }
+    int *rollNumbers = realloc(columns->rollNumbers, sizeof(int) * capacity);
+    if (rollNumbers != NULL) {
+        columns->rollNumbers = rollNumbers;
+    }
+    Money *feesDue = realloc(columns->feesDue, sizeof(Money) * capacity);
+    if (feesDue != NULL) {
+        columns->feesDue = feesDue;
+    }
+    Money *hostelDue = realloc(columns->hostelDue, sizeof(Money) * capacity);
+    if (hostelDue != NULL) {
+        columns->hostelDue = hostelDue;
+    }
+    int32_t *booksDue = realloc(columns->booksDue, sizeof(int32_t) * capacity);
+    if (booksDue != NULL) {
+        columns->booksDue = booksDue;
+    }
+    uint8_t *approved = realloc(columns->approved, capacity);
+    if (approved != NULL) {
+        columns->approved = approved;
+    }
+    if (rollNumbers == NULL || feesDue == NULL || hostelDue == NULL || booksDue == NULL || approved == NULL) {
+        return false;
+    }
+    columns->capacity = capacity;
+    return true;
+}
+
+static void setRow(DuesColumns *columns, int i, const Student *s) {
+    columns->rollNumbers[i] = s->rollNumber;
+    columns->feesDue[i] = s->feesDue;
+    columns->hostelDue[i] = s->hostelDue;
+    columns->booksDue[i] = s->libraryBooksDue;
+    columns->approved[i] = s->approvalStatus != 0;
+}
+
+// Bring the columns up to date with the store: a full rebuild when stale,
+// otherwise just the records appended since the last sync
+bool duesColumnsSync(DuesColumns *columns, const StudentStore *store) {
+    if (!columns->built || columns->count > store->count) {
+        columns->count = 0;
+    }
+    if (!reserveColumns(columns, store->count)) {
+        columns->built = false;
+        return false;
+    }
+    for (int i = columns->count; i < store->count; i++) {
+        setRow(columns, i, storeAt(store, i));
+    }
+    columns->count = store->count;
+    columns->built = true;
+    return true;
+}
+
+// Copy one changed (or newly added) record into the columns
+void duesColumnsUpdate(DuesColumns *columns, const StudentStore *store, int rollNumber) {
+    if (!columns->built) {
+        return; // rebuilt in full on the next sync anyway
+    }
+    int position = rollMapGet(&store->index, rollNumber);
+    if (position < 0) {
+        columns->built = false;
+    } else if (position < columns->count) {
+        setRow(columns, position, storeAt(store, position));
+    } else {
+        duesColumnsSync(columns, store);
+    }
+}
+
+static void clearTotals(DuesTotals *totals) {
+    totals->students = 0;
+    totals->owing = 0;
+    totals->feesDue = 0;
+    totals->hostelDue = 0;
+    totals->booksDue = 0;
+}
+
+// One pass over the columns with no branches: each sum is kept for all
+// students and for approved ones (masked by the status column), and the
+// pending totals are the difference. "Owes anything" is the sign bit of the
+// negated dues, since SSE2 has no 64-bit compare; with that, gcc -O3
+// vectorizes the loop.
+void duesSummarize(const DuesColumns *columns, DuesSummary *summary) {
+    const Money *restrict feesDue = columns->feesDue;
+    const Money *restrict hostelDue = columns->hostelDue;
+    const int32_t *restrict booksDue = columns->booksDue;
+    const uint8_t *restrict approved = columns->approved;
+    int count = columns->count;
+
+    int64_t fees = 0, hostel = 0, books = 0, owing = 0;
+    int64_t approvedCount = 0, approvedFees = 0, approvedHostel = 0, approvedBooks = 0, approvedOwing = 0;
+    for (int i = 0; i < count; i++) {
+        int64_t fee = feesDue[i];
+        int64_t host = hostelDue[i];
+        int64_t book = booksDue[i];
+        int64_t mask = -(int64_t)approved[i];
+        int64_t owes = (int64_t)((-(uint64_t)fee | -(uint64_t)host | -(uint64_t)book) >> 63);
+        fees += fee;
+        hostel += host;
+        books += book;
+        owing += owes;
+        approvedCount -= mask;
+        approvedFees += fee & mask;
+        approvedHostel += host & mask;
+        approvedBooks += book & mask;
+        approvedOwing += owes & mask;
+    }
+
+    summary->approved.students = approvedCount;
+    summary->approved.owing = approvedOwing;
+    summary->approved.feesDue = approvedFees;
+    summary->approved.hostelDue = approvedHostel;
+    summary->approved.booksDue = approvedBooks;
+    summary->pending.students = count - approvedCount;
+    summary->pending.owing = owing - approvedOwing;
+    summary->pending.feesDue = fees - approvedFees;
+    summary->pending.hostelDue = hostel - approvedHostel;
+    summary->pending.booksDue = books - approvedBooks;
+}
+
+// The same summary straight from the records (reference and fallback)
+void duesSummarizeRecords(const StudentStore *store, DuesSummary *summary) {
+    clearTotals(&summary->pending);
+    clearTotals(&summary->approved);
+    for (int i = 0; i < store->count; i++) {
+        const Student *s = storeAt(store, i);
+        DuesTotals *totals = s->approvalStatus ? &summary->approved : &summary->pending;
+        totals->students++;
+        totals->feesDue += s->feesDue;
+        totals->hostelDue += s->hostelDue;
+        totals->booksDue += s->libraryBooksDue;
+        if (s->feesDue > 0 || s->hostelDue > 0 || s->libraryBooksDue > 0) {
+            totals->owing++;
+        }
+    }
+}
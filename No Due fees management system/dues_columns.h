@@ -0,0 +1,45 @@
+#ifndef DUES_COLUMNS_H
+#define DUES_COLUMNS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "student_store.h"
+
+// The numeric fields of every record, one array per field, in store order.
+// Aggregates scan only the columns they need instead of dragging each
+// 32-byte record through the cache. A copy, not the source of
+// truth: the owner patches it on each change or marks it stale.
+typedef struct {
+    int *rollNumbers;
+    Money *feesDue;
+    Money *hostelDue;
+    int32_t *booksDue;
+    uint8_t *approved;          // 1 = Approved, 0 = Pending
+    int count;                  // records [0, count) are mirrored
+    int capacity;
+    bool built;                 // false: rebuild before the next use
+} DuesColumns;
+
+// Totals for one approval status
+typedef struct {
+    long students;
+    long owing;                 // students with any fees, hostel or books due
+    Money feesDue;
+    Money hostelDue;
+    long booksDue;
+} DuesTotals;
+
+// Dues summary broken down by approval status
+typedef struct {
+    DuesTotals pending;
+    DuesTotals approved;
+} DuesSummary;
+
+void duesColumnsInit(DuesColumns *columns);
+void duesColumnsFree(DuesColumns *columns);
+bool duesColumnsSync(DuesColumns *columns, const StudentStore *store);
+void duesColumnsUpdate(DuesColumns *columns, const StudentStore *store, int rollNumber);
+void duesSummarize(const DuesColumns *columns, DuesSummary *summary);
+void duesSummarizeRecords(const StudentStore *store, DuesSummary *summary);
+
+#endif
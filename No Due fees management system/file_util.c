@@ -0,0 +1,167 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include "file_util.h"
+
+#ifdef _WIN32
+#include <direct.h>
+#include <io.h>
+#include <windows.h>
+#define FILE_VIEW_READ_BLOCK (1 << 20)
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+// Push buffered data to the OS and ask it to reach the disk
+bool flushAndSync(FILE *file) {
+    return fflush(file) == 0 && syncFile(file);
+}
+
+// Ask the OS to put already-flushed data on disk
+bool syncFile(FILE *file) {
+#ifdef _WIN32
+    return _commit(_fileno(file)) == 0;
+#else
+    return fsync(fileno(file)) == 0;
+#endif
+}
+
+// Move a fully written temp file over the target in one step, so readers
+// see either the old file or the new one, never a half-written mix
+bool replaceFileAtomically(const char *tempPath, const char *path) {
+#ifdef _WIN32
+    return MoveFileExA(tempPath, path, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    return rename(tempPath, path) == 0;
+#endif
+}
+
+// Cut an open file back to `size` bytes (drops a torn tail)
+bool truncateFile(FILE *file, long size) {
+    if (fflush(file) != 0) {
+        return false;
+    }
+#ifdef _WIN32
+    return _chsize(_fileno(file), size) == 0;
+#else
+    return ftruncate(fileno(file), (off_t)size) == 0;
+#endif
+}
+
+bool fileExists(const char *path) {
+#ifdef _WIN32
+    return _access(path, 0) == 0;
+#else
+    return access(path, F_OK) == 0;
+#endif
+}
+
+// Create a directory; true if it exists afterwards
+bool makeDirectory(const char *path) {
+#ifdef _WIN32
+    return _mkdir(path) == 0 || errno == EEXIST;
+#else
+    return mkdir(path, 0755) == 0 || errno == EEXIST;
+#endif
+}
+
+// Make `path` the working directory, so the data files are found there
+bool changeDirectory(const char *path) {
+#ifdef _WIN32
+    return _chdir(path) == 0;
+#else
+    return chdir(path) == 0;
+#endif
+}
+
+// Copy the working directory into `out`; false if it does not fit
+bool workingDirectory(char *out, size_t size) {
+#ifdef _WIN32
+    return _getcwd(out, (int)size) != NULL;
+#else
+    return getcwd(out, size) != NULL;
+#endif
+}
+
+// Name `path` from `directory` unless it is already absolute, so it still
+// means the same file after changeDirectory; false if it does not fit
+bool joinPath(const char *directory, const char *path, char *out, size_t size) {
+#ifdef _WIN32
+    bool absolute = path[0] == '\\' || path[0] == '/' || (path[0] != '\0' && path[1] == ':');
+#else
+    bool absolute = path[0] == '/';
+#endif
+    int length = absolute ? snprintf(out, size, "%s", path) : snprintf(out, size, "%s/%s", directory, path);
+    return length >= 0 && (size_t)length < size;
+}
+
+// Read-only view of a whole file: mapped on POSIX, read in blocks on Windows
+bool fileViewOpen(const char *path, FileView *view) {
+    view->data = NULL;
+    view->size = 0;
+    view->owned = NULL;
+    view->mapped = false;
+#ifdef _WIN32
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) {
+        return false;
+    }
+    size_t capacity = FILE_VIEW_READ_BLOCK;
+    char *buffer = malloc(capacity);
+    size_t got;
+    while (buffer != NULL && (got = fread(buffer + view->size, 1, capacity - view->size, file)) > 0) {
+        view->size += got;
+        if (view->size == capacity) {
+            capacity *= 2;
+            char *grown = realloc(buffer, capacity);
+            if (grown == NULL) {
+                free(buffer);
+            }
+            buffer = grown;
+        }
+    }
+    fclose(file);
+    if (buffer == NULL) {
+        return false;
+    }
+    view->data = buffer;
+    view->owned = buffer;
+    return true;
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return false;
+    }
+    view->size = (size_t)st.st_size;
+    if (view->size > 0) {
+        void *map = mmap(NULL, view->size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (map == MAP_FAILED) {
+            close(fd);
+            return false;
+        }
+        madvise(map, view->size, MADV_SEQUENTIAL);
+        view->data = map;
+        view->mapped = true;
+    }
+    close(fd);
+    return true;
+#endif
+}
+
+void fileViewClose(FileView *view) {
+#ifndef _WIN32
+    if (view->mapped) {
+        munmap((void *)view->data, view->size);
+    }
+#endif
+    free(view->owned);
+}
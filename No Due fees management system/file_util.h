@@ -0,0 +1,28 @@
+#ifndef FILE_UTIL_H
+#define FILE_UTIL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+// Whole-file read-only view: mapped on POSIX, read into memory on Windows
+typedef struct {
+    const char *data;
+    size_t size;
+    void *owned;        // heap buffer to free (Windows)
+    bool mapped;
+} FileView;
+
+bool flushAndSync(FILE *file);
+bool syncFile(FILE *file);
+bool replaceFileAtomically(const char *tempPath, const char *path);
+bool fileExists(const char *path);
+bool makeDirectory(const char *path);
+bool changeDirectory(const char *path);
+bool workingDirectory(char *out, size_t size);
+bool joinPath(const char *directory, const char *path, char *out, size_t size);
+bool truncateFile(FILE *file, long size);
+bool fileViewOpen(const char *path, FileView *view);
+void fileViewClose(FileView *view);
+
+#endif
@@ -0,0 +1,591 @@
+#ifdef __linux__
+#define _GNU_SOURCE     // accept4
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <ctype.h>
+#include "http_server.h"
+
+// Grow the response body and append formatted text (a failed allocation
+// leaves the body as it was)
+void httpAppend(HttpResponse *response, const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    va_list copy;
+    va_copy(copy, args);
+    int needed = vsnprintf(NULL, 0, format, copy);
+    va_end(copy);
+    if (needed < 0) {
+        va_end(args);
+        return;
+    }
+    if (response->length + (size_t)needed + 1 > response->capacity) {
+        size_t capacity = response->capacity ? response->capacity * 2 : 1024;
+        while (capacity < response->length + (size_t)needed + 1) {
+            capacity *= 2;
+        }
+        char *body = realloc(response->body, capacity);
+        if (body == NULL) {
+            va_end(args);
+            return;
+        }
+        response->body = body;
+        response->capacity = capacity;
+    }
+    vsnprintf(response->body + response->length, (size_t)needed + 1, format, args);
+    response->length += (size_t)needed;
+    va_end(args);
+}
+
+// Append text as a quoted JSON string
+void httpAppendJsonString(HttpResponse *response, const char *text) {
+    httpAppend(response, "\"");
+    for (const char *p = text; *p != '\0'; p++) {
+        unsigned char c = (unsigned char)*p;
+        if (c == '"' || c == '\\') {
+            httpAppend(response, "\\%c", c);
+        } else if (c < 0x20) {
+            httpAppend(response, "\\u%04x", c);
+        } else {
+            httpAppend(response, "%c", c);
+        }
+    }
+    httpAppend(response, "\"");
+}
+
+#ifdef __linux__
+
+#include <errno.h>
+#include <signal.h>
+#include <strings.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include "timing.h"
+
+#define HTTP_MAX_EVENTS 256
+#define HTTP_READ_BLOCK 16384
+
+// One client connection. While busy, a worker owns the request and the
+// output buffer; the event loop does not touch them until it is handed back.
+typedef struct Connection {
+    int fd;
+    char *in;
+    size_t inUsed;
+    size_t requestLength;       // bytes of `in` taken by the request being handled
+    HttpRequest request;
+    char *out;
+    size_t outUsed;
+    size_t outSent;
+    bool busy;
+    bool closeAfterWrite;
+    bool peerClosed;
+    struct Connection *next;    // job queue / done list link
+} Connection;
+
+// State shared by the event loop and the workers
+typedef struct {
+    const HttpServerConfig *config;
+    int epollFd;
+    int wakeFd;                 // eventfd: workers signal finished responses
+    pthread_mutex_t lock;
+    pthread_cond_t ready;
+    Connection *jobs;           // requests waiting for a worker (FIFO)
+    Connection *jobsTail;
+    Connection *done;           // responses waiting to be written
+    bool stopping;
+} Server;
+
+static volatile sig_atomic_t stopRequested = 0;
+
+static void onStopSignal(int signalNumber) {
+    (void)signalNumber;
+    stopRequested = 1;
+}
+
+static const char *statusText(int status) {
+    switch (status) {
+        case 200: return "OK";
+        case 201: return "Created";
+        case 400: return "Bad Request";
+        case 401: return "Unauthorized";
+        case 404: return "Not Found";
+        case 405: return "Method Not Allowed";
+        case 409: return "Conflict";
+        case 413: return "Payload Too Large";
+        case 500: return "Internal Server Error";
+        default: return "Unknown";
+    }
+}
+
+static bool headerIs(const char *line, size_t length, const char *name) {
+    size_t n = strlen(name);
+    return length > n && line[n] == ':' && strncasecmp(line, name, n) == 0;
+}
+
+static void copyHeaderValue(char *out, size_t size, const char *value, const char *end) {
+    while (value < end && (*value == ' ' || *value == '\t')) {
+        value++;
+    }
+    size_t length = (size_t)(end - value);
+    if (length >= size) {
+        length = size - 1;
+    }
+    memcpy(out, value, length);
+    out[length] = '\0';
+}
+
+enum { REQUEST_MALFORMED = -1, REQUEST_TOO_LARGE = -2 };
+
+// Parse one request from the start of conn->in. Returns 1 when complete,
+// 0 when more bytes are needed, REQUEST_MALFORMED or REQUEST_TOO_LARGE.
+static int parseRequest(Connection *conn) {
+    const char *data = conn->in;
+    const char *headerEnd = NULL;
+    for (size_t i = 3; i < conn->inUsed; i++) {
+        if (data[i] == '\n' && data[i - 1] == '\r' && data[i - 2] == '\n' && data[i - 3] == '\r') {
+            headerEnd = data + i + 1;
+            break;
+        }
+    }
+    if (headerEnd == NULL) {
+        return conn->inUsed >= HTTP_MAX_REQUEST ? REQUEST_TOO_LARGE : 0;
+    }
+
+    HttpRequest *request = &conn->request;
+    memset(request, 0, sizeof(*request));
+    const char *lineEnd = memchr(data, '\r', (size_t)(headerEnd - data));
+    const char *space = memchr(data, ' ', (size_t)(lineEnd - data));
+    if (space == NULL || space - data >= (long)sizeof(request->method)) {
+        return REQUEST_MALFORMED;
+    }
+    memcpy(request->method, data, (size_t)(space - data));
+    const char *target = space + 1;
+    const char *targetEnd = memchr(target, ' ', (size_t)(lineEnd - target));
+    if (targetEnd == NULL) {
+        return REQUEST_MALFORMED;
+    }
+    const char *queryStart = memchr(target, '?', (size_t)(targetEnd - target));
+    const char *pathEnd = queryStart != NULL ? queryStart : targetEnd;
+    if (pathEnd - target >= (long)sizeof(request->path)) {
+        return REQUEST_MALFORMED;
+    }
+    memcpy(request->path, target, (size_t)(pathEnd - target));
+    if (queryStart != NULL) {
+        copyHeaderValue(request->query, sizeof(request->query), queryStart + 1, targetEnd);
+    }
+    request->keepAlive = strncmp(targetEnd + 1, "HTTP/1.1", 8) == 0;
+
+    // Anything that cannot fit in the input buffer is rejected before the
+    // header and body lengths are added, so the sum cannot wrap
+    size_t headerLength = (size_t)(headerEnd - data);
+    if (headerLength > HTTP_MAX_REQUEST) {
+        return REQUEST_TOO_LARGE;
+    }
+    size_t contentLength = 0;
+    for (const char *line = lineEnd + 2; line < headerEnd - 2; ) {
+        const char *end = memchr(line, '\r', (size_t)(headerEnd - line));
+        size_t length = (size_t)(end - line);
+        const char *value = memchr(line, ':', length);
+        if (value != NULL) {
+            value++;
+            if (headerIs(line, length, "Content-Length")) {
+                char digits[32];
+                copyHeaderValue(digits, sizeof(digits), value, end);
+                size_t count = strspn(digits, "0123456789");
+                if (count == 0 || count > 9 || digits[count + strspn(digits + count, " \t")] != '\0') {
+                    return REQUEST_MALFORMED;
+                }
+                contentLength = strtoul(digits, NULL, 10);
+                if (contentLength > HTTP_MAX_REQUEST - headerLength) {
+                    return REQUEST_TOO_LARGE;
+                }
+            } else if (headerIs(line, length, "Connection")) {
+                char option[32];
+                copyHeaderValue(option, sizeof(option), value, end);
+                if (strcasecmp(option, "close") == 0) {
+                    request->keepAlive = false;
+                } else if (strcasecmp(option, "keep-alive") == 0) {
+                    request->keepAlive = true;
+                }
+            } else if (headerIs(line, length, "Authorization")) {
+                copyHeaderValue(request->authorization, sizeof(request->authorization), value, end);
+            }
+        }
+        line = end + 2;
+    }
+
+    size_t total = headerLength + contentLength;
+    if (conn->inUsed < total) {
+        return 0;
+    }
+    request->body = headerEnd;
+    request->bodyLength = contentLength;
+    conn->requestLength = total;
+    return 1;
+}
+
+// Serialize status line, headers and body into conn->out
+static void writeResponse(Connection *conn, const HttpResponse *response, bool keepAlive) {
+    char header[256];
+    int headerLength = snprintf(header, sizeof(header),
+        "HTTP/1.1 %d %s\r\nContent-Type: application/json\r\nContent-Length: %zu\r\nConnection: %s\r\n\r\n",
+        response->status, statusText(response->status), response->length, keepAlive ? "keep-alive" : "close");
+    size_t needed = (size_t)headerLength + response->length;
+    char *out = realloc(conn->out, needed);
+    if (out == NULL) {
+        conn->outUsed = 0;
+        conn->closeAfterWrite = true;
+        return;
+    }
+    conn->out = out;
+    memcpy(out, header, (size_t)headerLength);
+    if (response->length > 0) {
+        memcpy(out + headerLength, response->body, response->length);
+    }
+    conn->outUsed = needed;
+    conn->outSent = 0;
+    conn->closeAfterWrite = !keepAlive;
+}
+
+static void *workerMain(void *arg) {
+    Server *server = arg;
+    HttpResponse response = { 0, NULL, 0, 0 };
+    for (;;) {
+        pthread_mutex_lock(&server->lock);
+        while (server->jobs == NULL && !server->stopping) {
+            pthread_cond_wait(&server->ready, &server->lock);
+        }
+        if (server->jobs == NULL) {
+            pthread_mutex_unlock(&server->lock);
+            break;
+        }
+        Connection *conn = server->jobs;
+        server->jobs = conn->next;
+        if (server->jobs == NULL) {
+            server->jobsTail = NULL;
+        }
+        pthread_mutex_unlock(&server->lock);
+
+        response.status = 200;
+        response.length = 0;
+        httpAppend(&response, "");
+        server->config->handler(server->config->context, &conn->request, &response);
+        writeResponse(conn, &response, conn->request.keepAlive);
+
+        // Drop the handled request, keeping any pipelined bytes after it
+        memmove(conn->in, conn->in + conn->requestLength, conn->inUsed - conn->requestLength);
+        conn->inUsed -= conn->requestLength;
+        conn->requestLength = 0;
+
+        pthread_mutex_lock(&server->lock);
+        conn->next = server->done;
+        server->done = conn;
+        pthread_mutex_unlock(&server->lock);
+        uint64_t one = 1;
+        if (write(server->wakeFd, &one, sizeof(one)) < 0) {
+            // the loop also polls the done list on its one-second timeout
+        }
+    }
+    free(response.body);
+    return NULL;
+}
+
+static void closeConnection(Server *server, Connection *conn) {
+    epoll_ctl(server->epollFd, EPOLL_CTL_DEL, conn->fd, NULL);
+    close(conn->fd);
+    free(conn->in);
+    free(conn->out);
+    free(conn);
+}
+
+static void watch(Server *server, Connection *conn, uint32_t events) {
+    struct epoll_event event;
+    event.events = events;
+    event.data.ptr = conn;
+    epoll_ctl(server->epollFd, EPOLL_CTL_MOD, conn->fd, &event);
+}
+
+static void queueJob(Server *server, Connection *conn) {
+    conn->busy = true;
+    conn->next = NULL;
+    watch(server, conn, EPOLLRDHUP);
+    pthread_mutex_lock(&server->lock);
+    if (server->jobsTail != NULL) {
+        server->jobsTail->next = conn;
+    } else {
+        server->jobs = conn;
+    }
+    server->jobsTail = conn;
+    pthread_cond_signal(&server->ready);
+    pthread_mutex_unlock(&server->lock);
+}
+
+// Hand a complete request to the workers, or answer a malformed one
+static void dispatch(Server *server, Connection *conn) {
+    int parsed = parseRequest(conn);
+    if (parsed > 0) {
+        queueJob(server, conn);
+    } else if (parsed < 0) {
+        bool tooLarge = parsed == REQUEST_TOO_LARGE;
+        HttpResponse response = { tooLarge ? 413 : 400, NULL, 0, 0 };
+        httpAppend(&response, tooLarge ? "{\"error\":\"request too large\"}" : "{\"error\":\"bad request\"}");
+        writeResponse(conn, &response, false);
+        free(response.body);
+        conn->inUsed = 0;
+        watch(server, conn, EPOLLOUT);
+    }
+}
+
+// Send what we can; returns false once the connection is finished with
+static bool flushOutput(Server *server, Connection *conn) {
+    while (conn->outSent < conn->outUsed) {
+        ssize_t sent = send(conn->fd, conn->out + conn->outSent, conn->outUsed - conn->outSent, MSG_NOSIGNAL);
+        if (sent < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                watch(server, conn, EPOLLOUT);
+                return true;
+            }
+            return false;
+        }
+        conn->outSent += (size_t)sent;
+    }
+    conn->outUsed = 0;
+    conn->outSent = 0;
+    if (conn->closeAfterWrite || conn->peerClosed) {
+        return false;
+    }
+    watch(server, conn, EPOLLIN | EPOLLRDHUP);
+    dispatch(server, conn); // a pipelined request may already be buffered
+    return true;
+}
+
+static void readInput(Server *server, Connection *conn) {
+    for (;;) {
+        if (conn->inUsed > HTTP_MAX_REQUEST) {
+            break; // parseRequest reports the oversized request
+        }
+        char *in = realloc(conn->in, conn->inUsed + HTTP_READ_BLOCK);
+        if (in == NULL) {
+            closeConnection(server, conn);
+            return;
+        }
+        conn->in = in;
+        ssize_t got = recv(conn->fd, conn->in + conn->inUsed, HTTP_READ_BLOCK, 0);
+        if (got > 0) {
+            conn->inUsed += (size_t)got;
+            continue;
+        }
+        if (got == 0) {
+            conn->peerClosed = true; // still answer a request sent before the close
+            break;
+        }
+        if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+            closeConnection(server, conn);
+            return;
+        }
+        break;
+    }
+    dispatch(server, conn);
+    if (conn->peerClosed && !conn->busy && conn->outUsed == 0) {
+        closeConnection(server, conn);
+    }
+}
+
+static void acceptClients(Server *server, int listenFd) {
+    for (;;) {
+        int fd = accept4(listenFd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            return;
+        }
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        Connection *conn = calloc(1, sizeof(Connection));
+        if (conn == NULL) {
+            close(fd);
+            continue;
+        }
+        conn->fd = fd;
+        struct epoll_event event;
+        event.events = EPOLLIN | EPOLLRDHUP;
+        event.data.ptr = conn;
+        if (epoll_ctl(server->epollFd, EPOLL_CTL_ADD, fd, &event) != 0) {
+            close(fd);
+            free(conn);
+        }
+    }
+}
+
+// Write out responses the workers have finished
+static void collectDone(Server *server) {
+    uint64_t count;
+    if (read(server->wakeFd, &count, sizeof(count)) < 0) {
+        // nothing pending; the list is checked anyway
+    }
+    pthread_mutex_lock(&server->lock);
+    Connection *conn = server->done;
+    server->done = NULL;
+    pthread_mutex_unlock(&server->lock);
+    while (conn != NULL) {
+        Connection *next = conn->next;
+        conn->busy = false;
+        if (!flushOutput(server, conn)) {
+            closeConnection(server, conn);
+        }
+        conn = next;
+    }
+}
+
+static int openListener(int port) {
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return -1;
+    }
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons((uint16_t)port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (bind(fd, (struct sockaddr *)&address, sizeof(address)) != 0 || listen(fd, SOMAXCONN) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// Workers spend much of their time waiting on locks and fsync, so run
+// more of them than there are CPUs
+int httpDefaultWorkers(void) {
+    int workers = 2 * (int)sysconf(_SC_NPROCESSORS_ONLN);
+    return workers < 4 ? 4 : (workers > HTTP_MAX_WORKERS ? HTTP_MAX_WORKERS : workers);
+}
+
+// Serve until SIGINT or SIGTERM. One thread runs the epoll loop (accept,
+// read, parse, write); complete requests go to a pool of worker threads.
+bool httpServe(const HttpServerConfig *config) {
+    Server server;
+    memset(&server, 0, sizeof(server));
+    server.config = config;
+
+    int listenFd = openListener(config->port);
+    if (listenFd < 0) {
+        printf("Error: Could not listen on 127.0.0.1:%d (%s).\n", config->port, strerror(errno));
+        return false;
+    }
+    server.epollFd = epoll_create1(EPOLL_CLOEXEC);
+    server.wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (server.epollFd < 0 || server.wakeFd < 0) {
+        printf("Error: Could not set up the event loop.\n");
+        close(listenFd);
+        return false;
+    }
+    pthread_mutex_init(&server.lock, NULL);
+    pthread_cond_init(&server.ready, NULL);
+
+    // The listener and the wake-up eventfd carry sentinel pointers so their
+    // events can be told apart from connections
+    static int listenTag, wakeTag;
+    struct epoll_event event;
+    event.events = EPOLLIN;
+    event.data.ptr = &listenTag;
+    epoll_ctl(server.epollFd, EPOLL_CTL_ADD, listenFd, &event);
+    event.data.ptr = &wakeTag;
+    epoll_ctl(server.epollFd, EPOLL_CTL_ADD, server.wakeFd, &event);
+
+    int workerCount = config->workers < 1 ? 1 : (config->workers > HTTP_MAX_WORKERS ? HTTP_MAX_WORKERS : config->workers);
+    pthread_t workers[HTTP_MAX_WORKERS];
+    int started = 0;
+    while (started < workerCount && pthread_create(&workers[started], NULL, workerMain, &server) == 0) {
+        started++;
+    }
+
+    stopRequested = 0;
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = onStopSignal;
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+
+    struct epoll_event events[HTTP_MAX_EVENTS];
+    double lastTick = monotonicSeconds();
+    while (!stopRequested && started > 0) {
+        int count = epoll_wait(server.epollFd, events, HTTP_MAX_EVENTS, 1000);
+        for (int i = 0; i < count; i++) {
+            void *tag = events[i].data.ptr;
+            if (tag == &listenTag) {
+                acceptClients(&server, listenFd);
+            } else if (tag == &wakeTag) {
+                collectDone(&server);
+            } else {
+                Connection *conn = tag;
+                uint32_t flags = events[i].events;
+                if (conn->busy) {
+                    // Peer hung up mid-request: stop watching it and close it
+                    // once the worker hands it back
+                    conn->peerClosed = true;
+                    epoll_ctl(server.epollFd, EPOLL_CTL_DEL, conn->fd, NULL);
+                } else if (flags & (EPOLLHUP | EPOLLERR)) {
+                    closeConnection(&server, conn);
+                } else if (flags & EPOLLOUT) {
+                    if (!flushOutput(&server, conn)) {
+                        closeConnection(&server, conn);
+                    }
+                } else if (flags & (EPOLLIN | EPOLLRDHUP)) {
+                    readInput(&server, conn);
+                }
+            }
+        }
+        double now = monotonicSeconds();
+        if (now - lastTick >= 1.0) {
+            lastTick = now;
+            collectDone(&server);
+            if (config->tick != NULL) {
+                config->tick(config->context);
+            }
+        }
+    }
+
+    // Let the workers finish queued requests, then stop them
+    pthread_mutex_lock(&server.lock);
+    server.stopping = true;
+    pthread_cond_broadcast(&server.ready);
+    pthread_mutex_unlock(&server.lock);
+    for (int i = 0; i < started; i++) {
+        pthread_join(workers[i], NULL);
+    }
+    collectDone(&server);
+
+    signal(SIGINT, SIG_DFL);
+    signal(SIGTERM, SIG_DFL);
+    close(listenFd);
+    close(server.wakeFd);
+    close(server.epollFd); // open keep-alive connections are closed at exit
+    pthread_mutex_destroy(&server.lock);
+    pthread_cond_destroy(&server.ready);
+    return started > 0;
+}
+
+#else
+
+int httpDefaultWorkers(void) {
+    return 1;
+}
+
+bool httpServe(const HttpServerConfig *config) {
+    (void)config;
+    printf("Error: Server mode needs Linux (epoll).\n");
+    return false;
+}
+
+#endif
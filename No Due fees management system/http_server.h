@@ -0,0 +1,46 @@
+#ifndef HTTP_SERVER_H
+#define HTTP_SERVER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#define HTTP_DEFAULT_PORT 8080
+#define HTTP_MAX_REQUEST (64 * 1024)    // request line + headers + body
+#define HTTP_MAX_WORKERS 64
+
+// One parsed request; body points into the connection's buffer
+typedef struct {
+    char method[8];
+    char path[256];             // without the query string
+    char query[256];            // text after '?', may be empty
+    char authorization[128];    // Authorization header value, may be empty
+    const char *body;
+    size_t bodyLength;
+    bool keepAlive;
+} HttpRequest;
+
+// Response under construction; the body is JSON text
+typedef struct {
+    int status;
+    char *body;
+    size_t length;
+    size_t capacity;
+} HttpResponse;
+
+typedef void (*HttpHandler)(void *context, const HttpRequest *request, HttpResponse *response);
+typedef void (*HttpTick)(void *context);
+
+typedef struct {
+    int port;                   // bound on 127.0.0.1 only
+    int workers;                // threads running the handler
+    HttpHandler handler;        // called on worker threads, concurrently
+    HttpTick tick;              // called about once a second on the event loop thread; may be NULL
+    void *context;
+} HttpServerConfig;
+
+int httpDefaultWorkers(void);
+bool httpServe(const HttpServerConfig *config);
+void httpAppend(HttpResponse *response, const char *format, ...);
+void httpAppendJsonString(HttpResponse *response, const char *text);
+
+#endif
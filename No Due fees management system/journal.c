@@ -0,0 +1,406 @@
+#include <stdio.h>
+#include <string.h>
+#include "journal.h"
+#include "snapshot.h"
+#include "file_util.h"
+
+#define JOURNAL_CHECKSUM_SEED 0x4A524E4CULL
+
+// Entry layouts of version-1, -2 and -3 journals
+typedef struct {
+    uint32_t op;
+    StudentV1 record;
+    uint64_t checksum;
+} JournalEntryV1;
+
+typedef struct {
+    uint32_t op;
+    StudentV2 record;
+    uint64_t checksum;
+} JournalEntryV2;
+
+typedef struct {
+    uint32_t op;
+    int32_t rollNumber;
+    Money feesDue;
+    Money hostelDue;
+    int32_t libraryBooksDue;
+    int32_t approvalStatus;
+    char name[MAX_NAME_LENGTH];
+    uint64_t checksum;
+} JournalEntryV3;
+
+static uint64_t entryChecksum(const JournalEntry *entry, const char *name) {
+    uint64_t hash = snapshotChecksum(JOURNAL_CHECKSUM_SEED, entry, offsetof(JournalEntry, checksum));
+    return snapshotChecksum(hash, name, entry->nameLength);
+}
+
+static void makeHeader(JournalHeader *header) {
+    memset(header, 0, sizeof(*header));
+    memcpy(header->magic, JOURNAL_MAGIC, sizeof(header->magic));
+    header->version = JOURNAL_VERSION;
+    header->entrySize = sizeof(JournalEntry);
+}
+
+// Only JOURNAL_ADD_STUDENT keeps `name`; it must outlive writeEntry()
+static void fillEntry(JournalEntry *entry, JournalOp op, const Student *record, const char *name) {
+    memset(entry, 0, sizeof(*entry));
+    entry->op = (uint32_t)op;
+    entry->rollNumber = record->rollNumber;
+    entry->feesDue = record->feesDue;
+    entry->hostelDue = record->hostelDue;
+    entry->libraryBooksDue = record->libraryBooksDue;
+    entry->approvalStatus = record->approvalStatus;
+    if (op == JOURNAL_ADD_STUDENT && name != NULL) {
+        entry->nameLength = (uint32_t)strnlen(name, MAX_NAME_LENGTH - 1);
+    }
+    entry->checksum = entryChecksum(entry, name);
+}
+
+static bool writeEntry(FILE *file, const JournalEntry *entry, const char *name) {
+    return fwrite(entry, sizeof(*entry), 1, file) == 1
+        && (entry->nameLength == 0 || fwrite(name, 1, entry->nameLength, file) == entry->nameLength);
+}
+
+// Read the next intact entry and its name (NUL-terminated into a buffer of
+// MAX_NAME_LENGTH). Returns the bytes it took, or 0 at the end of the
+// entries or at a torn or corrupt one.
+static long readEntry(FILE *file, JournalEntry *entry, char *name) {
+    if (fread(entry, sizeof(*entry), 1, file) != 1 || entry->nameLength >= MAX_NAME_LENGTH
+            || (entry->nameLength > 0 && fread(name, 1, entry->nameLength, file) != entry->nameLength)
+            || entry->checksum != entryChecksum(entry, name)) {
+        return 0;
+    }
+    name[entry->nameLength] = '\0';
+    return (long)(sizeof(*entry) + entry->nameLength);
+}
+
+// Apply one replayed mutation to the in-memory store
+static void applyEntry(StudentStore *store, const JournalEntry *entry, const char *name) {
+    Student *s = storeFindByRoll(store, entry->rollNumber);
+    if (entry->op == JOURNAL_ADD_STUDENT) {
+        Student record;
+        record.rollNumber = entry->rollNumber;
+        record.name = storeInternName(store, name, entry->nameLength);
+        record.feesDue = entry->feesDue;
+        record.hostelDue = entry->hostelDue;
+        record.libraryBooksDue = entry->libraryBooksDue;
+        record.approvalStatus = entry->approvalStatus;
+        if (s == NULL) {
+            storeAdd(store, &record);
+        } else {
+            if (record.name == NAME_NONE) {
+                record.name = s->name;
+            }
+            *s = record;
+        }
+        return;
+    }
+    if (s == NULL) {
+        return;
+    }
+    switch (entry->op) {
+        case JOURNAL_SET_FEES:
+            s->feesDue = entry->feesDue;
+            break;
+        case JOURNAL_SET_BOOKS:
+            s->libraryBooksDue = entry->libraryBooksDue;
+            break;
+        case JOURNAL_SET_HOSTEL:
+            s->hostelDue = entry->hostelDue;
+            break;
+        case JOURNAL_SET_APPROVAL:
+            s->approvalStatus = entry->approvalStatus;
+            break;
+    }
+}
+
+// Open (or create) the journal for appending. Call after journalReplay().
+bool journalOpen(Journal *journal, const char *path) {
+    journal->file = NULL;
+    journal->entryCount = 0;
+    journal->position = (long)sizeof(JournalHeader);
+    journal->unsynced = 0;
+
+    FILE *file = fopen(path, "r+b");
+    if (file == NULL) {
+        file = fopen(path, "w+b");
+    }
+    if (file == NULL) {
+        return false;
+    }
+
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    if (size < (long)sizeof(JournalHeader)) {
+        // New or header-less file: start it over
+        JournalHeader header;
+        makeHeader(&header);
+        if (!truncateFile(file, 0) || fseek(file, 0, SEEK_SET) != 0
+                || fwrite(&header, sizeof(header), 1, file) != 1 || !flushAndSync(file)) {
+            fclose(file);
+            return false;
+        }
+    } else {
+        // Entries vary in length, so count them
+        JournalEntry entry;
+        char name[MAX_NAME_LENGTH];
+        fseek(file, (long)sizeof(JournalHeader), SEEK_SET);
+        while (readEntry(file, &entry, name) > 0) {
+            journal->entryCount++;
+        }
+        fseek(file, 0, SEEK_END);
+        journal->position = size;
+    }
+
+    journal->file = file;
+    return true;
+}
+
+void journalClose(Journal *journal) {
+    if (journal->file != NULL) {
+        journalCommit(journal);
+        fclose(journal->file);
+        journal->file = NULL;
+    }
+}
+
+// Read one intact entry of an older journal: its op, the record's values
+// and its name (into a buffer of MAX_NAME_LENGTH)
+static bool readLegacyEntry(FILE *file, uint32_t version, uint32_t *op, Student *record, char *name) {
+    if (version == 3) {
+        JournalEntryV3 old;
+        if (fread(&old, sizeof(old), 1, file) != 1
+                || old.checksum != snapshotChecksum(JOURNAL_CHECKSUM_SEED, &old, offsetof(JournalEntryV3, checksum))) {
+            return false;
+        }
+        *op = old.op;
+        record->rollNumber = old.rollNumber;
+        record->feesDue = old.feesDue;
+        record->hostelDue = old.hostelDue;
+        record->libraryBooksDue = old.libraryBooksDue;
+        record->approvalStatus = old.approvalStatus;
+        snprintf(name, MAX_NAME_LENGTH, "%.*s", MAX_NAME_LENGTH - 1, old.name);
+        return true;
+    }
+    StudentV2 converted;
+    if (version == 1) {
+        JournalEntryV1 old;
+        if (fread(&old, sizeof(old), 1, file) != 1
+                || old.checksum != snapshotChecksum(JOURNAL_CHECKSUM_SEED, &old, offsetof(JournalEntryV1, checksum))
+                || !studentFromV1(&old.record, &converted)) {
+            return false;
+        }
+        *op = old.op;
+    } else {
+        JournalEntryV2 old;
+        if (fread(&old, sizeof(old), 1, file) != 1
+                || old.checksum != snapshotChecksum(JOURNAL_CHECKSUM_SEED, &old, offsetof(JournalEntryV2, checksum))) {
+            return false;
+        }
+        *op = old.op;
+        converted = old.record;
+    }
+    record->rollNumber = converted.rollNumber;
+    record->feesDue = converted.feesDue;
+    record->hostelDue = converted.hostelDue;
+    record->libraryBooksDue = converted.libraryBooksDue;
+    record->approvalStatus = converted.approvalStatus;
+    snprintf(name, MAX_NAME_LENGTH, "%.*s", LEGACY_NAME_LENGTH, converted.name);
+    return true;
+}
+
+// Replay a version-1/2/3 journal and rewrite it in the current format (temp
+// file + atomic rename), so appends that follow use the new layout
+static long upgradeJournal(FILE *file, const char *path, uint32_t version, StudentStore *store) {
+    char tempPath[512];
+    snprintf(tempPath, sizeof(tempPath), "%s.tmp", path);
+    FILE *out = fopen(tempPath, "wb");
+    if (out == NULL) {
+        return -1;
+    }
+    JournalHeader header;
+    makeHeader(&header);
+    bool ok = fwrite(&header, sizeof(header), 1, out) == 1;
+
+    long applied = 0;
+    uint32_t op;
+    Student record;
+    char name[MAX_NAME_LENGTH];
+    while (ok && readLegacyEntry(file, version, &op, &record, name)) {
+        JournalEntry entry;
+        fillEntry(&entry, (JournalOp)op, &record, name);
+        applyEntry(store, &entry, name);
+        ok = writeEntry(out, &entry, name);
+        applied++;
+    }
+    ok = flushAndSync(out) && ok;
+    ok = fclose(out) == 0 && ok;
+    fclose(file);
+    if (!ok || !replaceFileAtomically(tempPath, path)) {
+        remove(tempPath);
+        return -1;
+    }
+    printf("Converted %s from version %u (%s).\n", path, version,
+           version == 1 ? "dues are now kept in paise"
+           : version == 2 ? "names are now spelled out" : "only new students carry a name");
+    return applied;
+}
+
+// Re-apply every intact entry on top of the freshly loaded base data.
+// A torn or corrupt tail (crash mid-append) is reported and cut off.
+// Returns the number of entries applied, or -1 if the journal is unusable.
+long journalReplay(const char *path, StudentStore *store) {
+    FILE *file = fopen(path, "r+b");
+    if (file == NULL) {
+        return 0;
+    }
+
+    JournalHeader header, expected, legacy1, legacy2, legacy3;
+    makeHeader(&expected);
+    legacy1 = expected;
+    legacy1.version = 1;
+    legacy1.entrySize = sizeof(JournalEntryV1);
+    legacy2 = expected;
+    legacy2.version = 2;
+    legacy2.entrySize = sizeof(JournalEntryV2);
+    legacy3 = expected;
+    legacy3.version = 3;
+    legacy3.entrySize = sizeof(JournalEntryV3);
+    size_t got = fread(&header, 1, sizeof(header), file);
+    if (got == 0) {
+        fclose(file);
+        return 0;
+    }
+    if (got == sizeof(header) && memcmp(&header, &legacy1, sizeof(header)) == 0) {
+        return upgradeJournal(file, path, 1, store);
+    }
+    if (got == sizeof(header) && memcmp(&header, &legacy2, sizeof(header)) == 0) {
+        return upgradeJournal(file, path, 2, store);
+    }
+    if (got == sizeof(header) && memcmp(&header, &legacy3, sizeof(header)) == 0) {
+        return upgradeJournal(file, path, 3, store);
+    }
+    if (got != sizeof(header) || memcmp(&header, &expected, sizeof(header)) != 0) {
+        printf("Error: %s is not a compatible journal; it was not replayed.\n", path);
+        fclose(file);
+        return -1;
+    }
+
+    long applied = 0;
+    long goodEnd = (long)sizeof(header);
+    JournalEntry entry;
+    char name[MAX_NAME_LENGTH];
+    long length;
+    while ((length = readEntry(file, &entry, name)) > 0) {
+        applyEntry(store, &entry, name);
+        applied++;
+        goodEnd += length;
+    }
+
+    fseek(file, 0, SEEK_END);
+    if (ftell(file) != goodEnd) {
+        printf("Warning: Discarding incomplete journal tail after %ld entries.\n", applied);
+        truncateFile(file, goodEnd);
+    }
+    fclose(file);
+    return applied;
+}
+
+// Apply entries other processes appended since this one last read or wrote
+// the journal, and cut off a torn entry left by a process that crashed
+// mid-append so new entries are not written after it. Call with the data
+// lock held, shared or exclusive: only exclusive holders append, so readers
+// all stop at the same torn entry and cut it at the same place. Returns
+// entries applied, or -1 if the journal shrank (it was compacted elsewhere
+// and the base file must be reloaded).
+long journalCatchUp(Journal *journal, StudentStore *store) {
+    if (journal->file == NULL) {
+        return 0;
+    }
+    if (fflush(journal->file) != 0 || fseek(journal->file, 0, SEEK_END) != 0) {
+        return -1;
+    }
+    long size = ftell(journal->file);
+    if (size < journal->position || fseek(journal->file, journal->position, SEEK_SET) != 0) {
+        return -1;
+    }
+
+    long applied = 0;
+    JournalEntry entry;
+    char name[MAX_NAME_LENGTH];
+    long length;
+    while ((length = readEntry(journal->file, &entry, name)) > 0 && journal->position + length <= size) {
+        applyEntry(store, &entry, name);
+        applied++;
+        journal->entryCount++;
+        journal->position += length;
+    }
+    if (journal->position < size && !truncateFile(journal->file, journal->position)) {
+        return -1;
+    }
+    if (fseek(journal->file, journal->position, SEEK_SET) != 0) {
+        return -1;
+    }
+    return applied;
+}
+
+// Buffer one mutation; an fsync is forced every JOURNAL_SYNC_BATCH entries.
+// `name` (the record's name) is only needed for JOURNAL_ADD_STUDENT.
+bool journalAppend(Journal *journal, JournalOp op, const Student *record, const char *name) {
+    if (journal->file == NULL) {
+        return false;
+    }
+    JournalEntry entry;
+    fillEntry(&entry, op, record, name);
+    if (!writeEntry(journal->file, &entry, name)) {
+        return false;
+    }
+    journal->entryCount++;
+    journal->position += (long)(sizeof(entry) + entry.nameLength);
+    if (++journal->unsynced >= JOURNAL_SYNC_BATCH) {
+        return journalCommit(journal);
+    }
+    return true;
+}
+
+// Make every appended entry durable with a single fsync
+bool journalCommit(Journal *journal) {
+    if (journal->file == NULL || journal->unsynced == 0) {
+        return true;
+    }
+    journal->unsynced = 0;
+    return flushAndSync(journal->file);
+}
+
+// Group commit, step one: hand buffered entries to the OS (call with the
+// journal locked). Step two, journalSync, can then run without the lock and
+// one fsync covers every writer that flushed before it.
+bool journalFlush(Journal *journal) {
+    if (journal->file == NULL) {
+        return false;
+    }
+    journal->unsynced = 0;
+    return fflush(journal->file) == 0;
+}
+
+bool journalSync(Journal *journal) {
+    return journal->file != NULL && syncFile(journal->file);
+}
+
+// Empty the journal after its entries were folded into a new base file
+bool journalReset(Journal *journal) {
+    if (journal->file == NULL) {
+        return false;
+    }
+    journal->unsynced = 0;
+    journal->entryCount = 0;
+    journal->position = (long)sizeof(JournalHeader);
+    return truncateFile(journal->file, (long)sizeof(JournalHeader))
+        && fseek(journal->file, 0, SEEK_END) == 0
+        && flushAndSync(journal->file);
+}
+
+bool journalNeedsCompaction(const Journal *journal) {
+    return journal->entryCount >= JOURNAL_COMPACT_THRESHOLD;
+}
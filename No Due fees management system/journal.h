@@ -0,0 +1,66 @@
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "student_store.h"
+
+#define JOURNAL_FILENAME "student.journal"
+#define JOURNAL_MAGIC "NODUEJNL"
+#define JOURNAL_VERSION 4                // 1 = dues as float (StudentV1), 2 = StudentV2 records, 3 = name in every entry
+#define JOURNAL_SYNC_BATCH 256          // appends buffered before a forced fsync
+#define JOURNAL_COMPACT_THRESHOLD 10000 // entries before the base file is rewritten
+
+// Mutation kinds; every entry sets absolute values, so replaying an entry
+// twice gives the same result (needed when a crash interrupts compaction)
+typedef enum {
+    JOURNAL_SET_FEES = 1,
+    JOURNAL_SET_BOOKS,
+    JOURNAL_SET_HOSTEL,
+    JOURNAL_SET_APPROVAL,
+    JOURNAL_ADD_STUDENT
+} JournalOp;
+
+// File header, written once when the journal is created
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t entrySize;         // size of the fixed part of an entry
+} JournalHeader;
+
+// Fixed part of an entry; SET ops use rollNumber plus the one field they
+// change. JOURNAL_ADD_STUDENT is followed by nameLength bytes of name (records
+// only hold an arena offset); the checksum covers the name too, so a torn
+// name is caught like a torn entry.
+typedef struct {
+    uint32_t op;
+    int32_t rollNumber;
+    Money feesDue;
+    Money hostelDue;
+    int32_t libraryBooksDue;
+    int32_t approvalStatus;
+    uint32_t nameLength;        // 0 except for JOURNAL_ADD_STUDENT
+    uint32_t reserved;
+    uint64_t checksum;
+} JournalEntry;
+
+typedef struct {
+    FILE *file;
+    long entryCount;        // entries in the file since the last compaction
+    long position;          // end of the entries this process has applied
+    int unsynced;           // entries written but not yet fsynced
+} Journal;
+
+bool journalOpen(Journal *journal, const char *path);
+void journalClose(Journal *journal);
+long journalReplay(const char *path, StudentStore *store);
+long journalCatchUp(Journal *journal, StudentStore *store);
+bool journalAppend(Journal *journal, JournalOp op, const Student *record, const char *name);
+bool journalCommit(Journal *journal);
+bool journalFlush(Journal *journal);
+bool journalSync(Journal *journal);
+bool journalReset(Journal *journal);
+bool journalNeedsCompaction(const Journal *journal);
+
+#endif
@@ -1,628 +1,2459 @@
-#include <stdio.h>
-#include <stdlib.h>
-#include <string.h>
-#include <ctype.h>
-#include <stdbool.h>
-#include <conio.h> 
-
-// Define limits and filenames used by the program
-#define MAX_STUDENTS 100
-#define MAX_NAME_LENGTH 50
-#define FILENAME "student.txt"
-#define APPROVAL_FILENAME "approval_list.txt"
-#define ADMIN_USERNAME "admin"
-#define ADMIN_PASSWORD "admin123"
-
-// Student record structure: one per student
-typedef struct {
-    int rollNumber;                     // unique roll number
-    char name[MAX_NAME_LENGTH];         // student name (C-string)
-    float feesDue;                      // outstanding fees amount
-    int libraryBooksDue;                // number of library books not returned
-    float hostelDue;                    // outstanding hostel dues
-    int approvalStatus;                 // 0 = Pending, 1 = Approved
-} Student;
-
-// In-memory storage for student records and count
-Student students[MAX_STUDENTS];
-int studentCount = 0;
-
-
-// Function prototypes (each function handles a specific feature)
-void loadStudentData();
-void saveAllStudents();
-void displayMainMenu();
-void studentMenu();
-void adminMenu();
-bool authenticateAdmin();
-void viewApprovalStatus();
-void applyForApproval();
-void saveApprovalRequest(int rollNumber);
-int isDuplicateApproval(int rollNumber);
-void displayAllStudents();
-void viewPendingApprovals();
-void processApprovals();
-void updateStudentRecord();
-void addNewStudent();
-int getValidIntegerInput(const char *prompt);
-float getValidFloatInput(const char *prompt);
-void clearInputBuffer();
-int isRollNumberExists(int rollNumber);
-void printHeader(const char *title);
-
-int main() {
-    // Load records from disk at startup (if available)
-    loadStudentData();
-    
-    int choice;
-    do {
-        displayMainMenu();
-        choice = getValidIntegerInput("Enter your choice: ");
-        
-        switch(choice) {
-            case 1:
-                studentMenu();   // Student-facing features
-                break;
-            case 2:
-                if (authenticateAdmin()) { // simple admin check
-                    adminMenu();
-                } else {
-                    printf("Authentication failed. Access denied.\n");
-                }
-                break;
-            case 3:
-                printf("Exiting the program. Goodbye!\n");
-                break;
-            default:
-                printf("Invalid choice. Please try again.\n");
-        }
-    } while(choice != 3);
-    
-    return 0;
-}
-
-// Load student records from the CSV file into memory
-void loadStudentData() {
-    FILE *file = fopen(FILENAME, "r");
-    if (file == NULL) {
-        // No file yet: inform user and continue with empty list
-        printf("Warning: Could not open %s file. A new one will be created.\n", FILENAME);
-        return;
-    }
-    
-    studentCount = 0;
-    // Read each line: roll,name,fees,books,hostel,approval
-    while (fscanf(file, "%d,%49[^,],%f,%d,%f,%d",
-                 &students[studentCount].rollNumber,
-                 students[studentCount].name,
-                 &students[studentCount].feesDue,
-                 &students[studentCount].libraryBooksDue,
-                 &students[studentCount].hostelDue,
-                 &students[studentCount].approvalStatus) == 6) {
-        studentCount++;
-        if (studentCount >= MAX_STUDENTS) {
-            // Prevent overflow of our in-memory array
-            printf("Warning: Maximum student capacity reached. Some records may not be loaded.\n");
-            break;
-        }
-    }
-    
-    fclose(file);
-    
-    if (studentCount == 0) {
-        printf("No student records found in %s.\n", FILENAME);
-    } else {
-        printf("Successfully loaded %d student records.\n", studentCount);
-    }
-}
-
-// Save all in-memory student records back to the CSV file (overwrite)
-void saveAllStudents() {
-    FILE *file = fopen(FILENAME, "w");
-    if (file == NULL) {
-        printf("Error: Could not open student file for writing.\n");
-        return;
-    }
-    
-    // Write each student as a CSV line
-    for (int i = 0; i < studentCount; i++) {
-        fprintf(file, "%d,%s,%.2f,%d,%.2f,%d\n",
-               students[i].rollNumber,
-               students[i].name,
-               students[i].feesDue,
-               students[i].libraryBooksDue,
-               students[i].hostelDue,
-               students[i].approvalStatus);
-    }
-    
-    fclose(file);
-}
-
-// Display the main menu with options for student and admin
-void displayMainMenu() {
-    printHeader("Student Approval Management System");
-    printf("1. Student Portal\n");
-    printf("2. Admin Portal\n");
-    printf("3. Exit\n");
-    printf("========================================\n");
-}
-
-// Menu for student-specific actions
-void studentMenu() {
-    int choice;
-    do {
-        printHeader("Student Portal");
-        printf("1. View Approval Status\n");
-        printf("2. Apply for Approval\n");
-        printf("3. Back to Main Menu\n");
-        choice = getValidIntegerInput("Enter your choice: ");
-        
-        switch(choice) {
-            case 1:
-                viewApprovalStatus();
-                break;
-            case 2:
-                applyForApproval();
-                break;
-            case 3:
-                printf("Returning to main menu...\n");
-                break;
-            default:
-                printf("Invalid choice. Please try again.\n");
-        }
-    } while(choice != 3);
-}
-
-// Menu for admin-specific actions
-void adminMenu() {
-    int choice;
-    do {
-        printHeader("Admin Portal");
-        printf("1. View All Students\n");
-        printf("2. View Pending Approvals\n");
-        printf("3. Process Approvals\n");
-        printf("4. Update Student Record\n");
-        printf("5. Add New Student\n");
-        printf("6. Back to Main Menu\n");
-        choice = getValidIntegerInput("Enter your choice: ");
-        
-        switch(choice) {
-            case 1:
-                displayAllStudents();
-                break;
-            case 2:
-                viewPendingApprovals();
-                break;
-            case 3:
-                processApprovals();
-                break;
-            case 4:
-                updateStudentRecord();
-                break;
-            case 5:
-                addNewStudent();
-                break;
-            case 6:
-                printf("Returning to main menu...\n");
-                break;
-            default:
-                printf("Invalid choice. Please try again.\n");
-        }
-    } while(choice != 6);
-}
-
-// Simple admin authentication reading username and password (password masked)
-bool authenticateAdmin() {
-    char username[50];
-    char password[50];
-    
-    printHeader("Admin Login");
-    printf("Username: ");
-    scanf("%49s", username);
-    clearInputBuffer(); // flush leftover newline after scanf
-    
-    printf("Password: ");
-    
-    // Read password using getch and display '*' for each character
-    int i = 0;
-    char ch;
-    while ((ch = getch()) != '\r' && ch != '\n' && i < 49) {
-        password[i++] = ch;
-        printf("*");
-    }
-    password[i] = '\0';
-    printf("\n");
-    
-    // Compare with stored admin credentials
-    return (strcmp(username, ADMIN_USERNAME) == 0 && 
-            strcmp(password, ADMIN_PASSWORD) == 0);
-}
-
-// Show details and approval status for a given roll number
-void viewApprovalStatus() {
-    int rollNumber = getValidIntegerInput("Enter your roll number: ");
-    
-    int found = 0;
-    for (int i = 0; i < studentCount; i++) {
-        if (students[i].rollNumber == rollNumber) {
-            found = 1;
-            printHeader("Student Details");
-            printf("Roll Number: %d\n", students[i].rollNumber);
-            printf("Name: %s\n", students[i].name);
-            printf("Fees Due: %.2f\n", students[i].feesDue);
-            printf("Library Books Due: %d\n", students[i].libraryBooksDue);
-            printf("Hostel Due: %.2f\n", students[i].hostelDue);
-            printf("Approval Status: %s\n", students[i].approvalStatus ? "Approved" : "Pending");
-            break;
-        }
-    }
-    
-    if (!found) {
-        printf("Student with roll number %d not found.\n", rollNumber);
-    }
-}
-
-// Student applies for approval: check eligibility and prevent duplicates
-void applyForApproval() {
-    displayAllStudents(); // show records so student can find their roll
-    
-    int rollNumber = getValidIntegerInput("\nEnter your roll number to apply for approval: ");
-    
-    int found = 0;
-    int canApply = 0;
-    for (int i = 0; i < studentCount; i++) {
-        if (students[i].rollNumber == rollNumber) {
-            found = 1;
-            if (students[i].approvalStatus == 0) {
-                canApply = 1;
-                // Inform student they are eligible to submit a request
-                printf("\n%s (Roll No: %d), you are eligible to apply for approval.\n", 
-                      students[i].name, students[i].rollNumber);
-                
-                // Prevent duplicate entries in approval file
-                if (isDuplicateApproval(rollNumber)) {
-                    printf("You have already applied for approval. Duplicate applications are not allowed.\n");
-                    return;
-                }
-                
-                saveApprovalRequest(rollNumber); // append request to approval file
-                printf("Your approval request has been submitted successfully.\n");
-            } else {
-                printf("Your approval has already been granted. No need to apply again.\n");
-            }
-            break;
-        }
-    }
-    
-    if (!found) {
-        printf("Student with roll number %d not found.\n", rollNumber);
-    } else if (!canApply) {
-        printf("You are not eligible to apply for approval or your status is already approved.\n");
-    }
-}
-
-// Append an approval request to APPROVAL_FILENAME
-void saveApprovalRequest(int rollNumber) {
-    FILE *file = fopen(APPROVAL_FILENAME, "a");
-    if (file == NULL) {
-        printf("Error: Could not open approval file for writing.\n");
-        return;
-    }
-    
-    // Write roll and name for admin processing later
-    for (int i = 0; i < studentCount; i++) {
-        if (students[i].rollNumber == rollNumber) {
-            fprintf(file, "%d,%s\n", rollNumber, students[i].name);
-            break;
-        }
-    }
-    
-    fclose(file);
-}
-
-// Check if a roll number already exists in the pending approval file
-int isDuplicateApproval(int rollNumber) {
-    FILE *file = fopen(APPROVAL_FILENAME, "r");
-    if (file == NULL) {
-        return 0; // no file => no duplicates
-    }
-    
-    int existingRoll;
-    char name[MAX_NAME_LENGTH];
-    while (fscanf(file, "%d,%49[^\n]", &existingRoll, name) == 2) {
-        if (existingRoll == rollNumber) {
-            fclose(file);
-            return 1;
-        }
-    }
-    
-    fclose(file);
-    return 0;
-}
-
-// Display all students in a tabular form (simple console layout)
-void displayAllStudents() {
-    printHeader("All Student Records");
-    printf("Roll No\tName\t\tFees Due\tBooks Due\tHostel Due\tApproval Status\n");
-    printf("-------\t----\t\t--------\t---------\t---------\t---------------\n");
-    
-    for (int i = 0; i < studentCount; i++) {
-        printf("%d\t%-12s\t%.2f\t\t%d\t\t%.2f\t\t%s\n", 
-              students[i].rollNumber,
-              students[i].name,
-              students[i].feesDue,
-              students[i].libraryBooksDue,
-              students[i].hostelDue,
-              students[i].approvalStatus ? "Approved" : "Pending");
-    }
-}
-
-// List pending approvals by reading the approval file
-void viewPendingApprovals() {
-    FILE *file = fopen(APPROVAL_FILENAME, "r");
-    if (file == NULL) {
-        printf("No pending approval requests found.\n");
-        return;
-    }
-    
-    printHeader("Pending Approval Requests");
-    printf("Roll No\tName\n");
-    printf("-------\t----\n");
-    
-    int rollNumber;
-    char name[MAX_NAME_LENGTH];
-    int count = 0;
-    
-    // For each request, show only if student still exists and is pending
-    while (fscanf(file, "%d,%49[^\n]", &rollNumber, name) == 2) {
-        for (int i = 0; i < studentCount; i++) {
-            if (students[i].rollNumber == rollNumber && students[i].approvalStatus == 0) {
-                printf("%d\t%s\n", rollNumber, name);
-                count++;
-                break;
-            }
-        }
-    }
-    
-    fclose(file);
-    
-    if (count == 0) {
-        printf("No pending approval requests found.\n");
-    }
-}
-
-// Admin processing of approval requests: approve/reject/skip each entry
-void processApprovals() {
-    viewPendingApprovals();
-    
-    // Use a temporary file to keep skipped requests
-    FILE *tempFile = fopen("temp_approval.txt", "w");
-    FILE *approvalFile = fopen(APPROVAL_FILENAME, "r");
-    
-    if (approvalFile == NULL) {
-        printf("No approval requests to process.\n");
-        return;
-    }
-    
-    int rollNumber;
-    char name[MAX_NAME_LENGTH];
-    int processed = 0;
-    
-    while (fscanf(approvalFile, "%d,%49[^\n]", &rollNumber, name) == 2) {
-        int found = 0;
-        for (int i = 0; i < studentCount; i++) {
-            if (students[i].rollNumber == rollNumber) {
-                found = 1;
-                printHeader("Processing Approval");
-                printf("Student: %s (Roll No: %d)\n", students[i].name, rollNumber);
-                printf("Current status: %s\n", students[i].approvalStatus ? "Approved" : "Pending");
-                printf("Fees Due: %.2f\n", students[i].feesDue);
-                printf("Library Books Due: %d\n", students[i].libraryBooksDue);
-                printf("Hostel Due: %.2f\n", students[i].hostelDue);
-                
-                int decision;
-                do {
-                    printf("\n1. Approve\n2. Reject\n3. Skip\nEnter decision: ");
-                    decision = getValidIntegerInput("");
-                } while (decision < 1 || decision > 3);
-                
-                if (decision == 1) {
-                    // Mark approved in memory; will be saved to disk later
-                    students[i].approvalStatus = 1;
-                    processed++;
-                    printf("Approved successfully.\n");
-                } else if (decision == 2) {
-                    // Rejected: do nothing to student status (removes request)
-                    printf("Application rejected.\n");
-                } else {
-                    // Skip: preserve request by writing it to the temp file
-                    fprintf(tempFile, "%d,%s\n", rollNumber, name);
-                }
-                break;
-            }
-        }
-        
-        if (!found) {
-            // Invalid request for a non-existing student: inform and drop it
-            printf("Student with roll number %d not found in records. Removing invalid request.\n", rollNumber);
-        }
-    }
-    
-    fclose(approvalFile);
-    fclose(tempFile);
-    
-    // Replace old approval file with the temp file that contains skipped requests
-    remove(APPROVAL_FILENAME);
-    rename("temp_approval.txt", APPROVAL_FILENAME);
-    
-    // Save any changes made to student statuses
-    saveAllStudents();
-    
-    printf("\nProcessing complete. %d applications were approved.\n", processed);
-}
-
-// Update an existing student's numeric fields or approval flag
-void updateStudentRecord() {
-    displayAllStudents();
-    
-    int rollNumber = getValidIntegerInput("\nEnter roll number to update: ");
-    int found = -1;
-    
-    for (int i = 0; i < studentCount; i++) {
-        if (students[i].rollNumber == rollNumber) {
-            found = i;
-            break;
-        }
-    }
-    
-    if (found == -1) {
-        printf("Student with roll number %d not found.\n", rollNumber);
-        return;
-    }
-    
-    printHeader("Update Student Record");
-    printf("Current details for %s (Roll No: %d):\n", students[found].name, rollNumber);
-    printf("1. Fees Due: %.2f\n", students[found].feesDue);
-    printf("2. Library Books Due: %d\n", students[found].libraryBooksDue);
-    printf("3. Hostel Due: %.2f\n", students[found].hostelDue);
-    printf("4. Approval Status: %s\n", students[found].approvalStatus ? "Approved" : "Pending");
-    printf("0. Cancel Update\n");
-    
-    int choice;
-    do {
-        choice = getValidIntegerInput("\nSelect field to update (0-4): ");
-    } while (choice < 0 || choice > 4);
-    
-    if (choice == 0) {
-        printf("Update cancelled.\n");
-        return;
-    }
-    
-    switch(choice) {
-        case 1:
-            students[found].feesDue = getValidFloatInput("Enter new fees due: ");
-            break;
-        case 2:
-            students[found].libraryBooksDue = getValidIntegerInput("Enter new library books due: ");
-            break;
-        case 3:
-            students[found].hostelDue = getValidFloatInput("Enter new hostel due: ");
-            break;
-        case 4:
-            students[found].approvalStatus = getValidIntegerInput("Enter new approval status (1=Approved, 0=Pending): ");
-            break;
-    }
-    
-    saveAllStudents(); // persist changes to disk
-    printf("Record updated successfully.\n");
-}
-
-// Add a new student: ensure unique roll number and collect fields
-void addNewStudent() {
-    if (studentCount >= MAX_STUDENTS) {
-        printf("Maximum student capacity reached. Cannot add more students.\n");
-        return;
-    }
-
-    printHeader("Add New Student");
-    
-    int rollNumber;
-    do {
-        rollNumber = getValidIntegerInput("Enter roll number: ");
-        if (isRollNumberExists(rollNumber)) {
-            printf("Error: Roll number already exists. Please enter a unique roll number.\n");
-        }
-    } while (isRollNumberExists(rollNumber));
-    
-    Student newStudent;
-    newStudent.rollNumber = rollNumber;
-    
-    // Read full line for student name (may contain spaces)
-    printf("Enter student name: ");
-    fgets(newStudent.name, MAX_NAME_LENGTH, stdin);
-    newStudent.name[strcspn(newStudent.name, "\n")] = '\0'; 
-    
-    newStudent.feesDue = getValidFloatInput("Enter fees due: ");
-    newStudent.libraryBooksDue = getValidIntegerInput("Enter number of library books due: ");
-    newStudent.hostelDue = getValidFloatInput("Enter hostel due: ");
-    newStudent.approvalStatus = getValidIntegerInput("Enter approval status (1=Approved, 0=Pending): ");
-    
-    // Add to in-memory array
-    students[studentCount++] = newStudent;
-    
-    // Append new student to the student file for persistence
-    FILE *file = fopen(FILENAME, "a");
-    if (file == NULL) {
-        printf("Error: Could not open student file for writing.\n");
-        return;
-    }
-    
-    fprintf(file, "%d,%s,%.2f,%d,%.2f,%d\n",
-           newStudent.rollNumber,
-           newStudent.name,
-           newStudent.feesDue,
-           newStudent.libraryBooksDue,
-           newStudent.hostelDue,
-           newStudent.approvalStatus);
-    
-    fclose(file);
-    
-    printf("Student added successfully!\n");
-}
-
-// Check in-memory roll numbers for duplicates
-int isRollNumberExists(int rollNumber) {
-    for (int i = 0; i < studentCount; i++) {
-        if (students[i].rollNumber == rollNumber) {
-            return 1;
-        }
-    }
-    return 0;
-}
-
-// Get a validated integer from the user (re-prompts until valid)
-int getValidIntegerInput(const char *prompt) {
-    int value;
-    char buffer[100];
-    
-    while (1) {
-        printf("%s", prompt);
-        fgets(buffer, sizeof(buffer), stdin);
-        
-        if (sscanf(buffer, "%d", &value) == 1) {
-            return value;
-        }
-        
-        printf("Invalid input. Please enter a valid integer.\n");
-    }
-}
-
-// Get a validated floating-point number from the user
-float getValidFloatInput(const char *prompt) {
-    float value;
-    char buffer[100];
-    
-    while (1) {
-        printf("%s", prompt);
-        fgets(buffer, sizeof(buffer), stdin);
-        
-        if (sscanf(buffer, "%f", &value) == 1) {
-            return value;
-        }
-        
-        printf("Invalid input. Please enter a valid number.\n");
-    }
-}
-
-// Flush leftover characters in stdin (used after scanf)
-void clearInputBuffer() {
-    int c;
-    while ((c = getchar()) != '\n' && c != EOF);
-}
-
-// Simple header printer to separate sections visually
-void printHeader(const char *title) {
-    printf("\n========================================\n");
-    printf("%s\n", title);
-    printf("========================================\n");
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <stdbool.h>
+#include <time.h>
+#ifdef _WIN32
+#include <conio.h> 
+#else
+#include <termios.h>
+#include <unistd.h>
+#endif
+#include "student_store.h"
+#include "csv_loader.h"
+#include "snapshot.h"
+#include "journal.h"
+#include "audit_log.h"
+#include "approval_queue.h"
+#include "clearance.h"
+#include "batch.h"
+#include "roster_import.h"
+#include "shards.h"
+#include "certificates.h"
+#include "auto_approval.h"
+#include "approval_priority.h"
+#include "payment_ingest.h"
+#include "student_list.h"
+#include "name_index.h"
+#include "dues_columns.h"
+#include "report_query.h"
+#include "http_server.h"
+#include "portal_api.h"
+#include "data_lock.h"
+#include "file_util.h"
+#include "metrics.h"
+#include "timing.h"
+
+// Define filenames used by the program
+#define FILENAME STUDENT_FILENAME
+#define ADMIN_USERNAME "admin"
+#define ADMIN_PASSWORD "admin123"
+#define LIST_PAGE_SIZE 20
+#define METRICS_FILENAME "metrics.txt"
+
+// In-memory storage for student records (growable, indexed by roll number)
+StudentStore studentStore;
+
+// Binary snapshot backing the store when running with --snapshot
+Snapshot studentSnapshot;
+
+// Append-only log of record changes made since the base file was written
+Journal studentJournal;
+
+// Who approved, rejected or changed what, and when (AUDIT_FILENAME)
+AuditLog auditLog;
+
+// Pending approval requests, loaded once from APPROVAL_FILENAME
+ApprovalQueue approvalQueue;
+
+// Per-department clearance of open applications (CLEARANCE_FILENAME and
+// one queue file per department)
+ClearanceBoard clearanceBoard;
+
+// Name search index over studentStore (built on first use)
+NameIndex nameIndex;
+
+// Numeric fields of studentStore in columns, for the dues summary (built on
+// first use, patched as records change)
+DuesColumns duesColumns;
+
+// Cross-process lock on the data files, and the change counters as of this
+// session's last look (plus its own changes, published on release)
+DataLock dataLock;
+DataGenerations dataGenerations;
+
+// How much of PAYMENT_FILENAME has been reconciled, and the payments applied
+PaymentCheckpoint paymentCheckpoint;
+
+// Command-line options
+bool timingMode = false;        // --timing: report load throughput
+bool useSnapshot = false;       // --snapshot: keep the database in SNAPSHOT_FILENAME
+bool verifySnapshot = false;    // --verify-snapshot: check the data checksum at startup
+int snapshotCommand = 0;        // 1 = --import-csv, 2 = --export-csv
+const char *batchFile = NULL;   // --batch FILE: apply operations and exit
+const char *rosterFile = NULL;  // --import-roster FILE: merge a registrar roster and exit
+bool dryRun = false;            // --dry-run: report what --import-roster would change
+const char *certificateDir = NULL; // --certificates [DIR]: write no-dues certificates and exit
+int serverPort = 0;             // --serve [PORT]: answer HTTP requests instead of menus
+int serverWorkers = 0;          // --workers N: request threads (0 = default)
+const char *dataDirectory = NULL;  // --data-dir DIR: work on the data files in DIR
+const char *shardDirectory = NULL; // --shards [DIR]: campus overview over DIR/shards.txt
+const char *queryText = NULL;   // --query TEXT: run one report query and exit
+
+// Directory of the campus opened from the overview (becomes dataDirectory)
+char openedCampus[SHARD_PATH_SIZE];
+
+// Where the program was started; file names given on the command line are
+// relative to it even after moving into the data directory
+char launchDirectory[SHARD_PATH_SIZE];
+char batchPath[SHARD_PATH_SIZE];
+char rosterPath[SHARD_PATH_SIZE];
+
+// Function prototypes (each function handles a specific feature)
+bool parseCommandLine(int argc, char *argv[]);
+bool resolveCommandLinePaths();
+void printUsage(const char *program);
+void loadStudentData();
+bool loadStudentSnapshot();
+void loadStudentCsv();
+void replayStudentJournal();
+void openAuditLog();
+void loadApprovalQueue();
+void loadClearance();
+void saveApprovalQueue();
+void saveClearance();
+void loadPaymentCheckpoint();
+void finishInterruptedReconciliation();
+bool lockDataFiles(bool exclusive, DataGenerations *current);
+void beginDataAccess(bool exclusive);
+void endDataAccess();
+void refreshData();
+void reloadStudentData();
+bool saveAllStudents();
+void logStudentChange(JournalOp op, const Student *s);
+bool commitStudentChanges();
+int runSnapshotCommand();
+int runBatchMode();
+int runImportMode();
+int runCertificateMode();
+int runServerMode();
+int runQueryMode();
+int runShardMode();
+void showShardLoad(const ShardSet *shards, double seconds);
+void findShardStudent(const ShardSet *shards);
+void showShardPending(ShardSet *shards);
+void showShardDues(ShardSet *shards);
+bool openCampus(const ShardSet *shards);
+void displayMainMenu();
+void studentMenu();
+void adminMenu();
+bool authenticateAdmin();
+void viewApprovalStatus();
+void applyForApproval();
+void submitApplication(Student *s);
+void saveApprovalRequest(int rollNumber);
+int isDuplicateApproval(int rollNumber);
+void displayAllStudents();
+void showStudentList(const char *title, const ListResult *result);
+int promptRollNumber(const char *prompt);
+Student *findStudent(int rollNumber);
+bool searchStudentsByName(const char *name, ListResult *result);
+void viewPendingApprovals();
+void processApprovals();
+void printWaitTimes(WaitTimes *waits);
+void viewDepartmentQueue(Department department);
+void processDepartmentClearance();
+Student *clearanceWaiting(Department department, int rollNumber, int *cleared);
+void completeClearance(Student *s);
+void printClearance(int rollNumber);
+void autoProcessApprovals();
+void showDuesSummary();
+void printDuesRow(const char *label, int64_t pending, int64_t approved, bool amount);
+void reportQuery();
+bool runReportQuery(const char *text, bool interactive);
+bool generateNoDuesCertificates(const char *directory);
+void printCertificateProgress(int written, int total, double seconds, void *context);
+void applyPaymentHistory();
+bool finishPaymentReconciliation();
+void updateStudentRecord();
+void addNewStudent();
+bool insertStudent(Student *newStudent, const char *name);
+int getValidIntegerInput(const char *prompt);
+Money getValidMoneyInput(const char *prompt);
+void clearInputBuffer();
+int isRollNumberExists(int rollNumber);
+void printHeader(const char *title);
+void showMetrics();
+void showStudentHistory();
+void formatAuditValue(AuditAction action, int64_t value, char *out, size_t size);
+void writeMetrics();
+#ifndef _WIN32
+int getch();
+#endif
+
+int main(int argc, char *argv[]) {
+    if (!parseCommandLine(argc, argv)) {
+        printUsage(argv[0]);
+        return 1;
+    }
+    if (shardDirectory != NULL) {
+        int status = runShardMode();
+        if (status >= 0) {
+            return status;
+        }
+    }
+    if (dataDirectory != NULL && !resolveCommandLinePaths()) {
+        printf("Error: Could not resolve the file names on the command line.\n");
+        return 1;
+    }
+    if (dataDirectory != NULL && !changeDirectory(dataDirectory)) {
+        printf("Error: Could not change to data directory %s.\n", dataDirectory);
+        return 1;
+    }
+
+    storeInit(&studentStore);
+    approvalQueueInit(&approvalQueue);
+    clearanceInit(&clearanceBoard);
+    paymentCheckpointInit(&paymentCheckpoint);
+    nameIndexInit(&nameIndex);
+    duesColumnsInit(&duesColumns);
+
+    // Other sessions may share the data files: hold the lock while loading
+    if (!dataLockOpen(&dataLock, DATA_LOCK_FILENAME)) {
+        printf("Warning: Could not open %s. Other sessions may overwrite this one's changes.\n", DATA_LOCK_FILENAME);
+    }
+    lockDataFiles(true, &dataGenerations);
+
+    if (snapshotCommand != 0) {
+        return runSnapshotCommand();
+    }
+
+    // Load records from disk at startup (if available)
+    loadStudentData();
+    openAuditLog();
+    loadApprovalQueue();
+    loadClearance();
+    loadPaymentCheckpoint();
+    
+    // Batch and server runs keep the lock until they finish
+    if (batchFile != NULL) {
+        return runBatchMode();
+    }
+    if (rosterFile != NULL) {
+        return runImportMode();
+    }
+    if (certificateDir != NULL) {
+        return runCertificateMode();
+    }
+    if (serverPort != 0) {
+        return runServerMode();
+    }
+    if (queryText != NULL) {
+        return runQueryMode();
+    }
+    endDataAccess();
+    
+    int choice;
+    do {
+        displayMainMenu();
+        choice = getValidIntegerInput("Enter your choice: ");
+        
+        switch(choice) {
+            case 1:
+                studentMenu();   // Student-facing features
+                break;
+            case 2:
+                if (authenticateAdmin()) { // simple admin check
+                    adminMenu();
+                } else {
+                    printf("Authentication failed. Access denied.\n");
+                }
+                break;
+            case 3:
+                printf("Exiting the program. Goodbye!\n");
+                break;
+            default:
+                printf("Invalid choice. Please try again.\n");
+        }
+    } while(choice != 3);
+    
+    // Fold the journal into the base file before leaving
+    beginDataAccess(true);
+    if (studentJournal.entryCount > 0) {
+        saveAllStudents();
+    }
+    journalClose(&studentJournal);
+    auditClose(&auditLog);
+    endDataAccess();
+    writeMetrics();
+    dataLockClose(&dataLock);
+    paymentCheckpointFree(&paymentCheckpoint);
+    nameIndexFree(&nameIndex);
+    duesColumnsFree(&duesColumns);
+    clearanceFree(&clearanceBoard);
+    approvalQueueFree(&approvalQueue);
+    storeFree(&studentStore);
+    snapshotClose(&studentSnapshot);
+    return 0;
+}
+
+// Handle command-line switches; returns false on an unknown option
+bool parseCommandLine(int argc, char *argv[]) {
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--timing") == 0) {
+            timingMode = true;
+        } else if (strcmp(argv[i], "--snapshot") == 0) {
+            useSnapshot = true;
+        } else if (strcmp(argv[i], "--verify-snapshot") == 0) {
+            verifySnapshot = true;
+        } else if (strcmp(argv[i], "--import-csv") == 0) {
+            snapshotCommand = 1;
+        } else if (strcmp(argv[i], "--export-csv") == 0) {
+            snapshotCommand = 2;
+        } else if (strcmp(argv[i], "--batch") == 0 && i + 1 < argc) {
+            batchFile = argv[++i];
+        } else if (strcmp(argv[i], "--import-roster") == 0 && i + 1 < argc) {
+            rosterFile = argv[++i];
+        } else if (strcmp(argv[i], "--dry-run") == 0) {
+            dryRun = true;
+        } else if (strcmp(argv[i], "--certificates") == 0) {
+            certificateDir = CERTIFICATE_DIR;
+            if (i + 1 < argc && argv[i + 1][0] != '-') {
+                certificateDir = argv[++i];
+            }
+        } else if (strcmp(argv[i], "--serve") == 0) {
+            serverPort = HTTP_DEFAULT_PORT;
+            if (i + 1 < argc && isdigit((unsigned char)argv[i + 1][0])) {
+                serverPort = atoi(argv[++i]);
+            }
+            if (serverPort <= 0 || serverPort > 65535) {
+                printf("Invalid port: %d\n", serverPort);
+                return false;
+            }
+        } else if (strcmp(argv[i], "--query") == 0 && i + 1 < argc) {
+            queryText = argv[++i];
+        } else if (strcmp(argv[i], "--data-dir") == 0 && i + 1 < argc) {
+            dataDirectory = argv[++i];
+        } else if (strcmp(argv[i], "--shards") == 0) {
+            shardDirectory = ".";
+            if (i + 1 < argc && argv[i + 1][0] != '-') {
+                shardDirectory = argv[++i];
+            }
+        } else if (strcmp(argv[i], "--workers") == 0 && i + 1 < argc) {
+            serverWorkers = atoi(argv[++i]);
+            if (serverWorkers <= 0 || serverWorkers > HTTP_MAX_WORKERS) {
+                printf("Invalid worker count: %s\n", argv[i]);
+                return false;
+            }
+        } else {
+            printf("Unknown option: %s\n", argv[i]);
+            return false;
+        }
+    }
+    return true;
+}
+
+// Pin --batch, --import-roster and --query ... into to the launch directory
+// before --data-dir moves the working directory
+bool resolveCommandLinePaths() {
+    if (!workingDirectory(launchDirectory, sizeof(launchDirectory))) {
+        return false;
+    }
+    if (batchFile != NULL) {
+        if (!joinPath(launchDirectory, batchFile, batchPath, sizeof(batchPath))) {
+            return false;
+        }
+        batchFile = batchPath;
+    }
+    if (rosterFile != NULL) {
+        if (!joinPath(launchDirectory, rosterFile, rosterPath, sizeof(rosterPath))) {
+            return false;
+        }
+        rosterFile = rosterPath;
+    }
+    return true;
+}
+
+void printUsage(const char *program) {
+    printf("Usage: %s [options]\n", program);
+    printf("  --timing           Print file load throughput at startup\n");
+    printf("  --snapshot         Use the binary snapshot %s as the database\n", SNAPSHOT_FILENAME);
+    printf("  --verify-snapshot  Check the snapshot data checksum when loading\n");
+    printf("  --import-csv       Convert %s into %s and exit\n", FILENAME, SNAPSHOT_FILENAME);
+    printf("  --export-csv       Convert %s back into %s and exit\n", SNAPSHOT_FILENAME, FILENAME);
+    printf("  --batch FILE       Apply operations from FILE without prompts and exit\n");
+    printf("  --import-roster FILE  Merge a roster CSV (roll,name,fees,books,hostel) and exit\n");
+    printf("  --dry-run          With --import-roster: only write the changes to %s\n", ROSTER_DIFF_FILENAME);
+    printf("  --certificates [DIR]  Write certificates for approved students to DIR (default %s) and exit\n", CERTIFICATE_DIR);
+    printf("  --serve [PORT]     Serve the portals as JSON over HTTP on 127.0.0.1 (default %d)\n", HTTP_DEFAULT_PORT);
+    printf("  --workers N        Request worker threads for --serve (default: twice the CPUs, at least 4)\n");
+    printf("  --query TEXT       Run one report query (see Report Query in the admin menu) and exit\n");
+    printf("  --data-dir DIR     Use the data files in DIR instead of the current directory\n");
+    printf("  --shards [DIR]     Overview of every campus listed in DIR/%s (default .)\n", SHARD_MANIFEST_FILENAME);
+}
+
+// Non-interactive mode: apply a command file, then persist everything once
+int runBatchMode() {
+    BatchReport report;
+    if (!runBatchFile(batchFile, &studentStore, &approvalQueue, &clearanceBoard, &auditLog, stdout, &report)) {
+        printf("Error: Could not open batch file %s.\n", batchFile);
+        return 1;
+    }
+    
+    double start = monotonicSeconds();
+    if (report.studentsChanged) {
+        saveAllStudents();
+    }
+    if (report.queueChanged) {
+        saveApprovalQueue();
+    }
+    saveClearance();
+    double saveSeconds = monotonicSeconds() - start;
+    
+    printf("\nBatch complete: %d operations, %d applied, %d failed.\n",
+           report.operations, report.applied, report.failed);
+    printf("Applied in %.3f s (%.0f ops/s), saved in %.3f s.\n", report.seconds,
+           report.seconds > 0 ? report.operations / report.seconds : 0.0, saveSeconds);
+    
+    journalClose(&studentJournal);
+    auditClose(&auditLog);
+    endDataAccess();
+    writeMetrics();
+    dataLockClose(&dataLock);
+    paymentCheckpointFree(&paymentCheckpoint);
+    clearanceFree(&clearanceBoard);
+    approvalQueueFree(&approvalQueue);
+    storeFree(&studentStore);
+    snapshotClose(&studentSnapshot);
+    return report.failed > 0 ? 2 : 0;
+}
+
+// Roster import: merge an external roster into the store in one pass, list
+// every change in ROSTER_DIFF_FILENAME, then persist everything once
+int runImportMode() {
+    if (!fileExists(rosterFile)) {
+        printf("Error: Could not open roster %s.\n", rosterFile);
+        return 1;
+    }
+    FILE *diff = fopen(ROSTER_DIFF_FILENAME, "w");
+    if (diff == NULL) {
+        printf("Warning: Could not create %s. Changes will not be listed.\n", ROSTER_DIFF_FILENAME);
+    } else {
+        setvbuf(diff, NULL, _IOFBF, 1 << 20);
+    }
+    
+    RosterReport report;
+    bool imported = rosterImport(rosterFile, &studentStore, &auditLog, dryRun, diff, &report);
+    if (diff != NULL) {
+        fclose(diff);
+    }
+    if (!imported) {
+        printf("Error: Could not import %s (out of memory). Records already merged are saved.\n", rosterFile);
+    }
+    
+    double saveSeconds = 0;
+    if (report.inserted + report.updated > 0 && !dryRun) {
+        double start = monotonicSeconds();
+        saveAllStudents();
+        saveSeconds = monotonicSeconds() - start;
+    }
+    
+    printf("\n%s %s: %ld lines, %d new, %d updated, %d unchanged, %d conflicts, %d malformed.\n",
+           dryRun ? "Dry run of" : "Imported", rosterFile, report.lines, report.inserted,
+           report.updated, report.unchanged, report.conflicts, report.malformed);
+    if (report.inserted + report.updated + report.conflicts + report.malformed > 0 && diff != NULL) {
+        printf("Changes are listed in %s.\n", ROSTER_DIFF_FILENAME);
+    }
+    printf("Merged in %.3f s (%.0f rows/s)", report.parseSeconds,
+           report.parseSeconds > 0 ? report.lines / report.parseSeconds : 0.0);
+    if (!dryRun) {
+        printf(", applied in %.3f s, saved in %.3f s", report.applySeconds, saveSeconds);
+    }
+    printf(".\n");
+    
+    journalClose(&studentJournal);
+    auditClose(&auditLog);
+    endDataAccess();
+    writeMetrics();
+    dataLockClose(&dataLock);
+    paymentCheckpointFree(&paymentCheckpoint);
+    clearanceFree(&clearanceBoard);
+    approvalQueueFree(&approvalQueue);
+    storeFree(&studentStore);
+    snapshotClose(&studentSnapshot);
+    if (!imported) {
+        return 1;
+    }
+    return report.conflicts > 0 || report.malformed > 0 ? 2 : 0;
+}
+
+// Certificate mode: write every approved student's certificate and the
+// clearance report, then exit without changing any data file
+int runCertificateMode() {
+    bool ok = generateNoDuesCertificates(certificateDir);
+    
+    journalClose(&studentJournal);
+    auditClose(&auditLog);
+    endDataAccess();
+    writeMetrics();
+    dataLockClose(&dataLock);
+    paymentCheckpointFree(&paymentCheckpoint);
+    clearanceFree(&clearanceBoard);
+    approvalQueueFree(&approvalQueue);
+    storeFree(&studentStore);
+    snapshotClose(&studentSnapshot);
+    return ok ? 0 : 1;
+}
+
+// Run the --query report and exit
+int runQueryMode() {
+    bool ok = runReportQuery(queryText, false);
+    
+    journalClose(&studentJournal);
+    auditClose(&auditLog);
+    endDataAccess();
+    writeMetrics();
+    dataLockClose(&dataLock);
+    paymentCheckpointFree(&paymentCheckpoint);
+    duesColumnsFree(&duesColumns);
+    clearanceFree(&clearanceBoard);
+    approvalQueueFree(&approvalQueue);
+    storeFree(&studentStore);
+    snapshotClose(&studentSnapshot);
+    return ok ? 0 : 1;
+}
+
+// Server mode: answer the portal operations over HTTP until Ctrl+C, then
+// persist everything the way the interactive session does on exit
+int runServerMode() {
+    PortalApi api;
+    if (!portalApiInit(&api, &studentStore, &approvalQueue, &clearanceBoard, &studentJournal, &auditLog, APPROVAL_FILENAME,
+                       ADMIN_USERNAME, ADMIN_PASSWORD, saveAllStudents)) {
+        printf("Error: Could not start the server.\n");
+        return 1;
+    }
+    if (studentJournal.file == NULL) {
+        printf("Warning: No journal; changes are only saved when the server stops.\n");
+    }
+    
+    HttpServerConfig config;
+    config.port = serverPort;
+    config.workers = serverWorkers > 0 ? serverWorkers : httpDefaultWorkers();
+    config.handler = portalApiHandle;
+    config.tick = portalApiTick;
+    config.context = &api;
+    
+    printf("Serving on http://127.0.0.1:%d (%d workers). Press Ctrl+C to stop.\n", config.port, config.workers);
+    printf("Console sessions wait until the server stops.\n");
+    fflush(stdout);
+    bool served = httpServe(&config);
+    
+    if (studentJournal.entryCount > 0 || studentJournal.file == NULL) {
+        saveAllStudents();
+    }
+    if (api.queueDirty && !approvalQueueSave(&approvalQueue, APPROVAL_FILENAME)) {
+        printf("Error: Could not update %s.\n", APPROVAL_FILENAME);
+    }
+    saveClearance();
+    printf("Server stopped.\n");
+    
+    // Requests may have touched everything: have other sessions reload
+    dataGenerations.approvals++;
+    dataGenerations.students++;
+    dataGenerations.clearance++;
+    portalApiFree(&api);
+    journalClose(&studentJournal);
+    auditClose(&auditLog);
+    endDataAccess();
+    writeMetrics();
+    dataLockClose(&dataLock);
+    paymentCheckpointFree(&paymentCheckpoint);
+    nameIndexFree(&nameIndex);
+    clearanceFree(&clearanceBoard);
+    approvalQueueFree(&approvalQueue);
+    storeFree(&studentStore);
+    snapshotClose(&studentSnapshot);
+    return served ? 0 : 1;
+}
+
+// One-shot conversions between the CSV interchange file and the snapshot
+int runSnapshotCommand() {
+    if (snapshotCommand == 1) {
+        CsvLoadStats stats;
+        if (!loadStudentsFromCsv(FILENAME, &studentStore, &stats)) {
+            printf("Error: Could not open %s.\n", FILENAME);
+            return 1;
+        }
+        if (!snapshotWrite(SNAPSHOT_FILENAME, &studentStore)) {
+            return 1;
+        }
+        printf("Imported %d records from %s into %s.\n", studentStore.count, FILENAME, SNAPSHOT_FILENAME);
+    } else {
+        if (!snapshotLoad(SNAPSHOT_FILENAME, &studentSnapshot, &studentStore, true)) {
+            printf("Error: Could not load %s.\n", SNAPSHOT_FILENAME);
+            return 1;
+        }
+        // Include changes not yet compacted into the snapshot
+        journalReplay(JOURNAL_FILENAME, &studentStore);
+        if (!saveStudentsToCsv(FILENAME, &studentStore)) {
+            printf("Error: Could not write %s.\n", FILENAME);
+            return 1;
+        }
+        printf("Exported %d records from %s into %s.\n", studentStore.count, SNAPSHOT_FILENAME, FILENAME);
+    }
+    dataGenerations.students++;
+    endDataAccess();
+    dataLockClose(&dataLock);
+    storeFree(&studentStore);
+    snapshotClose(&studentSnapshot);
+    return 0;
+}
+
+// Map the binary snapshot straight into the store; false if unusable
+bool loadStudentSnapshot() {
+    if (!fileExists(SNAPSHOT_FILENAME)) {
+        return false;
+    }
+    double start = monotonicSeconds();
+    if (!snapshotLoad(SNAPSHOT_FILENAME, &studentSnapshot, &studentStore, verifySnapshot)) {
+        return false;
+    }
+    if (timingMode) {
+        printf("Mapped snapshot %s (%.2f MB) in %.3f s.\n", SNAPSHOT_FILENAME,
+               studentSnapshot.size / (1024.0 * 1024.0), monotonicSeconds() - start);
+    }
+    printf("Successfully loaded %d student records.\n", studentStore.count);
+    return true;
+}
+
+// Load the base file (CSV or snapshot), then recover journaled changes
+void loadStudentData() {
+    METRIC_START(start);
+    if (!useSnapshot || !loadStudentSnapshot()) {
+        loadStudentCsv();
+    }
+    replayStudentJournal();
+    METRIC_STOP(METRIC_LOAD_STUDENTS, start);
+    METRIC_COUNT(METRIC_RECORDS_LOADED, studentStore.count);
+}
+
+// Load student records from the CSV file into memory
+void loadStudentCsv() {
+    if (useSnapshot) {
+        printf("Building %s from %s.\n", SNAPSHOT_FILENAME, FILENAME);
+    }
+    
+    storeClear(&studentStore);
+    
+    // Bulk parse: roll,name,fees,books,hostel,approval per line
+    CsvLoadStats stats;
+    if (!loadStudentsFromCsv(FILENAME, &studentStore, &stats)) {
+        // No file yet: inform user and continue with empty list
+        printf("Warning: Could not open %s file. A new one will be created.\n", FILENAME);
+        return;
+    }
+    
+    if (timingMode) {
+        double megabytes = stats.bytes / (1024.0 * 1024.0);
+        printf("Parsed %ld lines (%.2f MB) in %.3f s: %.1f MB/s, %d malformed, %d duplicates.\n",
+               stats.lines, megabytes, stats.seconds,
+               stats.seconds > 0 ? megabytes / stats.seconds : 0.0,
+               stats.malformed, stats.duplicates);
+    }
+    
+    if (studentStore.count == 0) {
+        printf("No student records found in %s.\n", FILENAME);
+    } else {
+        printf("Successfully loaded %d student records.\n", studentStore.count);
+    }
+    
+    // First run in snapshot mode: seed the snapshot from the CSV file
+    if (useSnapshot) {
+        snapshotWrite(SNAPSHOT_FILENAME, &studentStore);
+    }
+}
+
+// Crash recovery: re-apply changes logged after the base file was written
+void replayStudentJournal() {
+    long applied = journalReplay(JOURNAL_FILENAME, &studentStore);
+    if (applied < 0) {
+        // Keep the unreadable journal for inspection and start a fresh one
+        char asidePath[64];
+        snprintf(asidePath, sizeof(asidePath), "%s.bad", JOURNAL_FILENAME);
+        rename(JOURNAL_FILENAME, asidePath);
+        printf("Warning: Moved unreadable journal to %s.\n", asidePath);
+    } else if (applied > 0) {
+        printf("Recovered %ld unsaved changes from %s.\n", applied, JOURNAL_FILENAME);
+        METRIC_COUNT(METRIC_JOURNAL_REPLAYED, applied);
+    }
+    
+    if (!journalOpen(&studentJournal, JOURNAL_FILENAME)) {
+        printf("Warning: Could not open %s. Every change will rewrite the student file.\n", JOURNAL_FILENAME);
+    }
+}
+
+// Open the audit log; without it the program still runs, unaudited
+void openAuditLog() {
+    if (!auditOpen(&auditLog, AUDIT_FILENAME, AUDIT_INDEX_FILENAME)) {
+        printf("Warning: Could not open %s. Approvals and changes will not be audited.\n", AUDIT_FILENAME);
+    }
+}
+
+// Read the pending approval requests into memory (once per run)
+void loadApprovalQueue() {
+    int duplicates = approvalQueueLoad(&approvalQueue, APPROVAL_FILENAME);
+    if (duplicates > 0) {
+        printf("Warning: Ignored %d duplicate approval requests in %s.\n", duplicates, APPROVAL_FILENAME);
+    }
+}
+
+// Read the department queues and the clearance of open applications
+void loadClearance() {
+    if (!clearanceLoad(&clearanceBoard)) {
+        printf("Error: Out of memory. Department clearance is not available.\n");
+    }
+}
+
+// Rewrite APPROVAL_FILENAME from the queue and tell other sessions
+void saveApprovalQueue() {
+    if (approvalQueueSave(&approvalQueue, APPROVAL_FILENAME)) {
+        dataGenerations.approvals++;
+    } else {
+        printf("Error: Could not update %s.\n", APPROVAL_FILENAME);
+    }
+}
+
+// Rewrite whichever clearance files changed and tell other sessions
+void saveClearance() {
+    bool changed = clearanceBoard.clearedDirty;
+    for (int d = 0; d < DEPARTMENT_COUNT; d++) {
+        changed |= clearanceBoard.queueDirty[d];
+    }
+    if (!changed) {
+        return;
+    }
+    if (!clearanceSave(&clearanceBoard)) {
+        printf("Error: Could not update the department clearance files.\n");
+    }
+    dataGenerations.clearance++;
+}
+
+// Read the payment reconciliation checkpoint; a run that was interrupted
+// after deciding its updates is finished here before anything else changes
+// (by the next writer when this session only holds the lock to read)
+void loadPaymentCheckpoint() {
+    if (!paymentCheckpointLoad(&paymentCheckpoint, PAYMENT_CHECKPOINT_FILENAME, PAYMENT_KEYS_FILENAME)) {
+        printf("Warning: %s is damaged. Payment history will be rescanned; payments already applied may be credited again.\n",
+               PAYMENT_CHECKPOINT_FILENAME);
+        paymentCheckpointInit(&paymentCheckpoint);
+        return;
+    }
+    if (!dataLock.held || dataLock.exclusive) {
+        finishInterruptedReconciliation();
+    }
+}
+
+// Apply the updates a reconciliation decided but did not get to commit
+void finishInterruptedReconciliation() {
+    if (paymentCheckpoint.updateCount > 0) {
+        printf("Completing an interrupted payment reconciliation (%d students)...\n", paymentCheckpoint.updateCount);
+        finishPaymentReconciliation();
+    }
+}
+
+// Take the data lock (shared or exclusive), telling the user when another
+// session holds it. False when there is no usable lock file.
+bool lockDataFiles(bool exclusive, DataGenerations *current) {
+    if (dataLockAcquire(&dataLock, exclusive, false, current)) {
+        return true;
+    }
+    if (!fileExists(DATA_LOCK_FILENAME)) {
+        return false;
+    }
+    printf("Waiting for another session to finish with the data files...\n");
+    fflush(stdout);
+    return dataLockAcquire(&dataLock, exclusive, true, current);
+}
+
+// Lock the data files, shared to read them or exclusive to change them, and
+// pick up whatever other sessions changed since this one last held the
+// lock. Pair with endDataAccess() before prompting: the lock is never held
+// while waiting for the user.
+void beginDataAccess(bool exclusive) {
+    DataGenerations current;
+    if (!lockDataFiles(exclusive, &current)) {
+        return; // no lock file: behave as a single session
+    }
+    long caughtUp = current.students == dataGenerations.students
+        ? journalCatchUp(&studentJournal, &studentStore) : -1;
+    if (caughtUp < 0) {
+        reloadStudentData();
+    } else if (caughtUp > 0) {
+        duesColumns.built = false;
+    }
+    if (current.approvals != dataGenerations.approvals) {
+        approvalQueueFree(&approvalQueue);
+        approvalQueueInit(&approvalQueue);
+        loadApprovalQueue();
+    }
+    if (current.clearance != dataGenerations.clearance) {
+        clearanceFree(&clearanceBoard);
+        loadClearance();
+    }
+    if (current.payments != dataGenerations.payments) {
+        paymentCheckpointFree(&paymentCheckpoint);
+        paymentCheckpointInit(&paymentCheckpoint);
+        loadPaymentCheckpoint();
+    }
+    dataGenerations = current;
+    if (exclusive) {
+        finishInterruptedReconciliation();
+    }
+}
+
+// Commit this action's audit entries (one write and fsync for all of
+// them), publish its changes to the counters and release the lock
+void endDataAccess() {
+    if (!auditCommit(&auditLog)) {
+        printf("Warning: Could not write to %s.\n", AUDIT_FILENAME);
+    }
+    if (dataLock.held && !dataLockRelease(&dataLock, &dataGenerations)) {
+        printf("Warning: Could not update %s.\n", DATA_LOCK_FILENAME);
+    }
+}
+
+// Catch up with other sessions before showing data; the shared lock is
+// released again straight away
+void refreshData() {
+    beginDataAccess(false);
+    endDataAccess();
+}
+
+// Another session rewrote the base file: load everything again from disk
+void reloadStudentData() {
+    printf("Reloading student data changed by another session.\n");
+    journalClose(&studentJournal);
+    nameIndexFree(&nameIndex);
+    nameIndexInit(&nameIndex);
+    duesColumns.built = false;
+    storeFree(&studentStore);
+    snapshotClose(&studentSnapshot);
+    storeInit(&studentStore);
+    loadStudentData();
+}
+
+// Compaction: write all in-memory records to a fresh base file (CSV or
+// snapshot, via temp file + atomic rename), then empty the journal
+bool saveAllStudents() {
+    METRIC_START(start);
+    journalCommit(&studentJournal);
+    
+    bool saved;
+    if (useSnapshot) {
+        saved = snapshotWrite(SNAPSHOT_FILENAME, &studentStore);
+    } else {
+        // Write each student as a CSV line
+        saved = saveStudentsToCsv(FILENAME, &studentStore);
+        if (!saved) {
+            printf("Error: Could not open student file for writing.\n");
+        }
+    }
+    
+    // Only drop journal entries once the new base file is safely in place
+    if (saved && studentJournal.file != NULL) {
+        journalReset(&studentJournal);
+    }
+    if (saved) {
+        dataGenerations.students++;
+        METRIC_COUNT(METRIC_RECORDS_SAVED, studentStore.count);
+    }
+    METRIC_STOP(METRIC_SAVE_STUDENTS, start);
+    return saved;
+}
+
+// Record one change to a student in the journal (made durable on commit)
+void logStudentChange(JournalOp op, const Student *s) {
+    if (!journalAppend(&studentJournal, op, s, storeName(&studentStore, s))) {
+        printf("Warning: Could not write to %s.\n", JOURNAL_FILENAME);
+    }
+    duesColumnsUpdate(&duesColumns, &studentStore, s->rollNumber);
+}
+
+// Make logged changes durable: one fsync for the whole batch, and a
+// compaction once the journal has grown past its threshold
+bool commitStudentChanges() {
+    if (studentJournal.file == NULL || !journalCommit(&studentJournal)) {
+        return saveAllStudents(); // no usable journal: fall back to a full rewrite
+    }
+    if (journalNeedsCompaction(&studentJournal)) {
+        saveAllStudents(); // the journal already holds the changes
+    }
+    return true;
+}
+
+// Campus overview: load every shard of the manifest in parallel and answer
+// cross-campus queries, read-only. Returns the exit status, or -1 when a
+// campus was opened (openedCampus) and the usual menus should run on it.
+int runShardMode() {
+    ShardSet shards;
+    shardSetInit(&shards);
+    int errorLine;
+    const char *error;
+    if (!shardSetOpen(&shards, shardDirectory, &errorLine, &error)) {
+        if (errorLine > 0) {
+            printf("Error: %s/%s line %d: %s.\n", shardDirectory, SHARD_MANIFEST_FILENAME, errorLine, error);
+        } else {
+            printf("Error: %s/%s: %s.\n", shardDirectory, SHARD_MANIFEST_FILENAME, error);
+        }
+        return 1;
+    }
+    double start = monotonicSeconds();
+    shardSetLoad(&shards, shards.count);
+    showShardLoad(&shards, monotonicSeconds() - start);
+    if (!authenticateAdmin()) {
+        printf("Authentication failed. Access denied.\n");
+        shardSetFree(&shards);
+        return 1;
+    }
+
+    bool opened = false;
+    int choice;
+    do {
+        printHeader("Campus Overview");
+        printf("1. Find Student\n");
+        printf("2. Pending Approvals (All Campuses)\n");
+        printf("3. Dues Summary (All Campuses)\n");
+        printf("4. Reload All Campuses\n");
+        printf("5. Open a Campus\n");
+        printf("6. Exit\n");
+        choice = getValidIntegerInput("Enter your choice: ");
+        
+        switch(choice) {
+            case 1:
+                findShardStudent(&shards);
+                break;
+            case 2:
+                showShardPending(&shards);
+                break;
+            case 3:
+                showShardDues(&shards);
+                break;
+            case 4:
+                start = monotonicSeconds();
+                shardSetLoad(&shards, shards.count);
+                showShardLoad(&shards, monotonicSeconds() - start);
+                break;
+            case 5:
+                opened = openCampus(&shards);
+                break;
+            case 6:
+                printf("Exiting the program. Goodbye!\n");
+                break;
+            default:
+                printf("Invalid choice. Please try again.\n");
+        }
+    } while(choice != 6 && !opened);
+    
+    shardSetFree(&shards);
+    return opened ? -1 : 0;
+}
+
+// One line per campus: range, records, pending requests and load time
+void showShardLoad(const ShardSet *shards, double seconds) {
+    printHeader("Campuses");
+    printf("%-3s %-16s %-23s %9s %8s %8s\n", "#", "Campus", "Roll range", "Students", "Pending", "Load (s)");
+    int students = 0;
+    for (int i = 0; i < shards->count; i++) {
+        const Shard *shard = &shards->shards[i];
+        char range[32];
+        snprintf(range, sizeof(range), "%d-%d", shard->firstRoll, shard->lastRoll);
+        printf("%-3d %-16s %-23s %9d %8d %8.3f\n", i + 1, shard->name, range, shard->store.count,
+               shard->queue.pending, shard->loadSeconds);
+        students += shard->store.count;
+        if (!shard->loaded) {
+            printf("    Warning: No student records loaded from %s/%s.\n", shard->directory, FILENAME);
+        }
+        if (shard->replayed < 0) {
+            printf("    Warning: %s/%s is unreadable; open the campus to recover it.\n", shard->directory, JOURNAL_FILENAME);
+        } else if (shard->replayed > 0) {
+            printf("    Included %ld unsaved changes from %s.\n", shard->replayed, JOURNAL_FILENAME);
+        }
+        if (shard->misplaced > 0) {
+            printf("    Warning: %d records have roll numbers outside this campus's range.\n", shard->misplaced);
+        }
+    }
+    printf("%d campuses, %d students, loaded in %.3f s.\n", shards->count, students, seconds);
+}
+
+// Look a roll number up in the campus whose range holds it
+void findShardStudent(const ShardSet *shards) {
+    int rollNumber = getValidIntegerInput("Enter roll number: ");
+    int index;
+    const Student *s = shardFindByRoll(shards, rollNumber, &index);
+    if (index < 0) {
+        printf("No campus holds roll number %d.\n", rollNumber);
+        return;
+    }
+    const Shard *shard = &shards->shards[index];
+    if (s == NULL) {
+        printf("Student not found in %s.\n", shard->name);
+        return;
+    }
+    char fees[MONEY_TEXT_SIZE], hostel[MONEY_TEXT_SIZE];
+    printf("Campus: %s\n", shard->name);
+    printf("Name: %s\n", storeName(&shard->store, s));
+    printf("Fees Due: %s\n", moneyText(s->feesDue, fees));
+    printf("Library Books Due: %d\n", s->libraryBooksDue);
+    printf("Hostel Due: %s\n", moneyText(s->hostelDue, hostel));
+    printf("Approval Status: %s\n", s->approvalStatus ? "Approved" : "Pending");
+    if (approvalQueueContains(&shard->queue, rollNumber)) {
+        printf("Approval request: waiting in the %s queue\n", shard->name);
+    }
+}
+
+// Pending requests of every campus, gathered concurrently
+void showShardPending(ShardSet *shards) {
+    ShardPendingList list;
+    double start = monotonicSeconds();
+    if (!shardCollectPending(shards, shards->count, &list)) {
+        printf("Error: Out of memory. Pending approvals are not available.\n");
+        return;
+    }
+    double seconds = monotonicSeconds() - start;
+    if (list.count == 0) {
+        printf("No pending approval requests found.\n");
+        return;
+    }
+    
+    printHeader("Pending Approval Requests (All Campuses)");
+    printf("%-16s %-10s %16s %6s  %s\n", "Campus", "Roll No", "Fees + hostel", "Books", "Name");
+    for (int i = 0; i < list.count; i++) {
+        const ShardPending *item = &list.items[i];
+        char due[MONEY_TEXT_SIZE];
+        printf("%-16s %-10d %16s %6d  %s\n", shards->shards[item->shard].name, item->rollNumber,
+               moneyText(item->due, due), item->booksDue, item->name);
+    }
+    printf("%d pending requests across %d campuses.\n", list.count, shards->count);
+    if (timingMode) {
+        printf("Collected in %.6f s\n", seconds);
+    }
+    shardPendingFree(&list);
+}
+
+// Dues summary per campus and in total, the campuses summed concurrently
+void showShardDues(ShardSet *shards) {
+    DuesSummary perShard[SHARD_MAX];
+    DuesSummary total;
+    double start = monotonicSeconds();
+    if (!shardSummarizeDues(shards, shards->count, perShard, &total)) {
+        printf("Error: Out of memory. Dues summary is not available.\n");
+        return;
+    }
+    double seconds = monotonicSeconds() - start;
+    
+    printHeader("Dues Summary (All Campuses)");
+    printf("%-16s %9s %9s %8s %16s %8s\n", "Campus", "Students", "Pending", "Owing", "Fees + hostel", "Books");
+    for (int i = 0; i < shards->count; i++) {
+        const DuesTotals *p = &perShard[i].pending;
+        const DuesTotals *a = &perShard[i].approved;
+        char due[MONEY_TEXT_SIZE];
+        printf("%-16s %9ld %9ld %8ld %16s %8ld\n", shards->shards[i].name, p->students + a->students,
+               p->students, p->owing + a->owing,
+               moneyText(p->feesDue + p->hostelDue + a->feesDue + a->hostelDue, due), p->booksDue + a->booksDue);
+    }
+    
+    const DuesTotals *p = &total.pending;
+    const DuesTotals *a = &total.approved;
+    printf("\n%-20s %16s %16s %16s\n", "All campuses", "Pending", "Approved", "Total");
+    printDuesRow("Students", p->students, a->students, false);
+    printDuesRow("Owing anything", p->owing, a->owing, false);
+    printDuesRow("Fees due", p->feesDue, a->feesDue, true);
+    printDuesRow("Hostel due", p->hostelDue, a->hostelDue, true);
+    printDuesRow("Fees + hostel due", p->feesDue + p->hostelDue, a->feesDue + a->hostelDue, true);
+    printDuesRow("Library books due", p->booksDue, a->booksDue, false);
+    if (timingMode) {
+        printf("Summed %d campuses in %.6f s\n", shards->count, seconds);
+    }
+}
+
+// Pick a campus (by number, or by a roll number in its range) to run the
+// student and admin portals on
+bool openCampus(const ShardSet *shards) {
+    for (int i = 0; i < shards->count; i++) {
+        printf("%d. %s (%d-%d)\n", i + 1, shards->shards[i].name, shards->shards[i].firstRoll, shards->shards[i].lastRoll);
+    }
+    int choice = getValidIntegerInput("Enter campus number (0 to find it by roll number): ");
+    int index = choice - 1;
+    if (choice == 0) {
+        int rollNumber = getValidIntegerInput("Enter roll number: ");
+        index = shardRoute(shards, rollNumber);
+    }
+    if (index < 0 || index >= shards->count) {
+        printf("No such campus.\n");
+        return false;
+    }
+    snprintf(openedCampus, sizeof(openedCampus), "%s", shards->shards[index].directory);
+    dataDirectory = openedCampus;
+    printf("Opening %s (%s).\n", shards->shards[index].name, openedCampus);
+    return true;
+}
+
+// Display the main menu with options for student and admin
+void displayMainMenu() {
+    printHeader("Student Approval Management System");
+    printf("1. Student Portal\n");
+    printf("2. Admin Portal\n");
+    printf("3. Exit\n");
+    printf("========================================\n");
+}
+
+// Menu for student-specific actions
+void studentMenu() {
+    int choice;
+    do {
+        printHeader("Student Portal");
+        printf("1. View Approval Status\n");
+        printf("2. Apply for Approval\n");
+        printf("3. Back to Main Menu\n");
+        choice = getValidIntegerInput("Enter your choice: ");
+        
+        // Each action takes the data lock itself, only between its prompts
+        switch(choice) {
+            case 1:
+                viewApprovalStatus();
+                break;
+            case 2:
+                applyForApproval();
+                break;
+            case 3:
+                printf("Returning to main menu...\n");
+                break;
+            default:
+                printf("Invalid choice. Please try again.\n");
+        }
+    } while(choice != 3);
+}
+
+// Menu for admin-specific actions
+void adminMenu() {
+    int choice;
+    do {
+        printHeader("Admin Portal");
+        printf("1. View All Students\n");
+        printf("2. View Pending Approvals\n");
+        printf("3. Process Approvals\n");
+        printf("4. Update Student Record\n");
+        printf("5. Add New Student\n");
+        printf("6. Auto-Process Approvals\n");
+        printf("7. Apply Payment History\n");
+        printf("8. Dues Summary\n");
+        printf("9. Metrics\n");
+        printf("10. Student History\n");
+        printf("11. Department Clearance\n");
+        printf("12. Generate Certificates\n");
+        printf("13. Report Query\n");
+        printf("14. Back to Main Menu\n");
+        choice = getValidIntegerInput("Enter your choice: ");
+        
+        // Actions that prompt take the data lock themselves, only between
+        // prompts; the others hold it just while they run (shared to read)
+        switch(choice) {
+            case 1:
+                displayAllStudents();
+                break;
+            case 2:
+                refreshData();
+                viewPendingApprovals();
+                break;
+            case 3:
+                processApprovals();
+                break;
+            case 4:
+                updateStudentRecord();
+                break;
+            case 5:
+                addNewStudent();
+                break;
+            case 6:
+                beginDataAccess(true);
+                autoProcessApprovals();
+                endDataAccess();
+                break;
+            case 7:
+                beginDataAccess(true);
+                applyPaymentHistory();
+                endDataAccess();
+                break;
+            case 8:
+                refreshData();
+                showDuesSummary();
+                break;
+            case 9:
+                showMetrics();
+                break;
+            case 10:
+                showStudentHistory();
+                break;
+            case 11:
+                processDepartmentClearance();
+                break;
+            case 12:
+                refreshData();
+                generateNoDuesCertificates(CERTIFICATE_DIR);
+                break;
+            case 13:
+                reportQuery();
+                break;
+            case 14:
+                printf("Returning to main menu...\n");
+                break;
+            default:
+                printf("Invalid choice. Please try again.\n");
+        }
+    } while(choice != 14);
+}
+
+// Simple admin authentication reading username and password (password masked)
+bool authenticateAdmin() {
+    char username[50];
+    char password[50];
+    
+    printHeader("Admin Login");
+    printf("Username: ");
+    scanf("%49s", username);
+    clearInputBuffer(); // flush leftover newline after scanf
+    
+    printf("Password: ");
+    
+    // Read password using getch and display '*' for each character
+    int i = 0;
+    char ch;
+    while ((ch = getch()) != '\r' && ch != '\n' && i < 49) {
+        password[i++] = ch;
+        printf("*");
+    }
+    password[i] = '\0';
+    printf("\n");
+    
+    // Compare with stored admin credentials
+    return (strcmp(username, ADMIN_USERNAME) == 0 && 
+            strcmp(password, ADMIN_PASSWORD) == 0);
+}
+
+#ifndef _WIN32
+// Read one key without echo (conio's getch); plain getchar when not a terminal
+int getch() {
+    struct termios saved;
+    if (!isatty(STDIN_FILENO) || tcgetattr(STDIN_FILENO, &saved) != 0) {
+        return getchar();
+    }
+    struct termios raw = saved;
+    raw.c_lflag &= ~(ICANON | ECHO);
+    tcsetattr(STDIN_FILENO, TCSANOW, &raw);
+    int ch = getchar();
+    tcsetattr(STDIN_FILENO, TCSANOW, &saved);
+    return ch;
+}
+#endif
+
+// Show details and approval status for a given roll number
+void viewApprovalStatus() {
+    int rollNumber = promptRollNumber("Enter your roll number (0 to search by name): ");
+    if (rollNumber == 0) {
+        return;
+    }
+    refreshData();
+    Student *s = findStudent(rollNumber);
+    if (s == NULL) {
+        return;
+    }
+    
+    char amount[MONEY_TEXT_SIZE];
+    printHeader("Student Details");
+    printf("Roll Number: %d\n", s->rollNumber);
+    printf("Name: %s\n", storeName(&studentStore, s));
+    printf("Fees Due: %s\n", moneyText(s->feesDue, amount));
+    printf("Library Books Due: %d\n", s->libraryBooksDue);
+    printf("Hostel Due: %s\n", moneyText(s->hostelDue, amount));
+    printf("Approval Status: %s\n", s->approvalStatus ? "Approved" : "Pending");
+    printClearance(s->rollNumber);
+}
+
+// Which departments have signed off an open application (nothing when
+// there is none)
+void printClearance(int rollNumber) {
+    int cleared = clearanceOf(&clearanceBoard, rollNumber);
+    if (cleared < 0) {
+        return;
+    }
+    printf("Clearance:");
+    for (int d = 0; d < DEPARTMENT_COUNT; d++) {
+        printf(" %s %s%s", departmentName((Department)d), (cleared & (1 << d)) ? "cleared" : "pending",
+               d + 1 < DEPARTMENT_COUNT ? "," : "\n");
+    }
+}
+
+// Student applies for approval, decided under the exclusive data lock
+void applyForApproval() {
+    int rollNumber = promptRollNumber("\nEnter your roll number to apply for approval (0 to search by name): ");
+    if (rollNumber == 0) {
+        return;
+    }
+    beginDataAccess(true);
+    Student *s = findStudent(rollNumber);
+    if (s != NULL) {
+        submitApplication(s);
+    }
+    endDataAccess();
+}
+
+// Check eligibility and prevent duplicates, then queue the request
+void submitApplication(Student *s) {
+    int rollNumber = s->rollNumber;
+    
+    if (s->approvalStatus != 0) {
+        printf("Your approval has already been granted. No need to apply again.\n");
+        printf("You are not eligible to apply for approval or your status is already approved.\n");
+        return;
+    }
+    
+    // Inform student they are eligible to submit a request
+    printf("\n%s (Roll No: %d), you are eligible to apply for approval.\n", 
+          storeName(&studentStore, s), s->rollNumber);
+    
+    // Prevent duplicate entries in approval file
+    if (isDuplicateApproval(rollNumber)) {
+        printf("You have already applied for approval. Duplicate applications are not allowed.\n");
+        return;
+    }
+    
+    saveApprovalRequest(rollNumber); // append request to approval file
+    if (s->approvalStatus != 0) {
+        printf("Nothing is due to any department. Your approval has been granted.\n");
+        return;
+    }
+    printf("Your approval request has been submitted successfully.\n");
+    printClearance(rollNumber);
+}
+
+// Queue an approval request and append it to APPROVAL_FILENAME
+void saveApprovalRequest(int rollNumber) {
+    METRIC_START(start);
+    Student *s = storeFindByRoll(&studentStore, rollNumber);
+    if (s == NULL || !approvalQueuePush(&approvalQueue, rollNumber, storeName(&studentStore, s))) {
+        return;
+    }
+    
+    FILE *file = fopen(APPROVAL_FILENAME, "a");
+    if (file == NULL) {
+        printf("Error: Could not open approval file for writing.\n");
+        return;
+    }
+    
+    // Write roll, name and submit time for admin processing later
+    approvalRequestWrite(file, &approvalQueue, approvalQueueFind(&approvalQueue, rollNumber));
+    
+    fclose(file);
+    dataGenerations.approvals++;
+    auditRecord(&auditLog, rollNumber, AUDIT_APPLIED, 0, 0, STUDENT_ACTOR);
+    METRIC_STOP(METRIC_SAVE_APPROVAL, start);
+    METRIC_COUNT(METRIC_REQUESTS_QUEUED, 1);
+    
+    // Route the request to the departments the student owes anything;
+    // when there are none it is approved on the spot
+    int cleared = clearanceSubmit(&clearanceBoard, s, storeName(&studentStore, s));
+    if (cleared == CLEARANCE_ALL) {
+        completeClearance(s);
+        commitStudentChanges();
+        if (!approvalQueueSave(&approvalQueue, APPROVAL_FILENAME)) {
+            printf("Error: Could not update %s.\n", APPROVAL_FILENAME);
+        }
+    } else if (cleared < 0) {
+        printf("Error: Out of memory. The request was not sent to the departments.\n");
+    }
+    saveClearance();
+}
+
+// Check if a roll number already has a pending approval request
+int isDuplicateApproval(int rollNumber) {
+    METRIC_START(start);
+    int duplicate = approvalQueueContains(&approvalQueue, rollNumber);
+    METRIC_STOP(METRIC_DUPLICATE_CHECK, start);
+    if (duplicate) {
+        METRIC_COUNT(METRIC_DUPLICATES_FOUND, 1);
+    }
+    return duplicate;
+}
+
+// Browse student records: pick a filter and sort order, then page through
+void displayAllStudents() {
+    ListQuery query;
+    listQueryDefaults(&query);
+    
+    printHeader("List Students");
+    printf("1. All Students\n");
+    printf("2. Pending Approval Only\n");
+    printf("3. Total Dues Above an Amount\n");
+    printf("4. Library Books Due\n");
+    printf("5. Name Starts With...\n");
+    int filter;
+    do {
+        filter = getValidIntegerInput("Select filter (1-5): ");
+    } while (filter < 1 || filter > 5);
+    
+    switch(filter) {
+        case 2:
+            query.pendingOnly = true;
+            break;
+        case 3:
+            query.minDues = getValidMoneyInput("Show students with total dues above: ");
+            break;
+        case 4:
+            query.booksDueOnly = true;
+            break;
+        case 5:
+            printf("Enter the start of the name: ");
+            fgets(query.namePrefix, MAX_NAME_LENGTH, stdin);
+            query.namePrefix[strcspn(query.namePrefix, "\n")] = '\0';
+            break;
+    }
+    
+    printf("Sort by: 1. Roll Number  2. Name  3. Total Dues (highest first)\n");
+    int sort;
+    do {
+        sort = getValidIntegerInput("Select sort order (1-3): ");
+    } while (sort < 1 || sort > 3);
+    query.sort = sort == 2 ? LIST_SORT_NAME : (sort == 3 ? LIST_SORT_DUES : LIST_SORT_ROLL);
+    
+    refreshData();
+    ListResult result;
+    if (!listSelect(&studentStore, &query, &result)) {
+        printf("Error: Out of memory. Could not list students.\n");
+        return;
+    }
+    showStudentList("Student Records", &result);
+    listResultFree(&result);
+}
+
+// Name lookup: names with a word starting with the text first, then names
+// containing it anywhere, then names spelled close to it
+bool searchStudentsByName(const char *name, ListResult *result) {
+    static const NameSearchMode modes[] = { NAME_SEARCH_PREFIX, NAME_SEARCH_SUBSTRING, NAME_SEARCH_FUZZY };
+    for (int i = 0; i < 3; i++) {
+        if (!nameIndexSearch(&nameIndex, &studentStore, name, modes[i], result)) {
+            return false;
+        }
+        if (result->count > 0) {
+            if (modes[i] == NAME_SEARCH_FUZZY) {
+                printf("No exact match for \"%s\". Showing similar names.\n", name);
+            }
+            return true;
+        }
+    }
+    return true;
+}
+
+// Print a listing in pages of LIST_PAGE_SIZE rows (simple console layout)
+void showStudentList(const char *title, const ListResult *result) {
+    printHeader(title);
+    if (result->count == 0) {
+        printf("No matching students.\n");
+        return;
+    }
+    
+    int pages = listPageCount(result, LIST_PAGE_SIZE);
+    int page = 1;
+    while (page >= 1 && page <= pages) {
+        printf("Roll No\tName\t\tFees Due\tBooks Due\tHostel Due\tApproval Status\n");
+        printf("-------\t----\t\t--------\t---------\t---------\t---------------\n");
+        listWriteRows(stdout, result, (page - 1) * LIST_PAGE_SIZE, LIST_PAGE_SIZE);
+        if (pages == 1) {
+            break;
+        }
+        printf("Page %d of %d (%d students).\n", page, pages, result->count);
+        page = getValidIntegerInput("Enter page number (0 to stop): ");
+    }
+}
+
+// Ask for a roll number; entering 0 searches by name first. Returns 0
+// when no student was picked.
+int promptRollNumber(const char *prompt) {
+    int rollNumber = getValidIntegerInput(prompt);
+    
+    if (rollNumber == 0) {
+        char name[MAX_NAME_LENGTH];
+        printf("Enter the name (or part of it): ");
+        fgets(name, MAX_NAME_LENGTH, stdin);
+        name[strcspn(name, "\n")] = '\0';
+        
+        refreshData();
+        ListResult result;
+        if (!searchStudentsByName(name, &result)) {
+            printf("Error: Out of memory. Could not search students.\n");
+            return 0;
+        }
+        showStudentList("Matching Students", &result);
+        int matches = result.count;
+        listResultFree(&result);
+        if (matches == 0) {
+            return 0;
+        }
+        rollNumber = getValidIntegerInput("\nEnter roll number: ");
+    }
+    return rollNumber;
+}
+
+// Find a student by roll number. Records may move when a session catches
+// up, so look the student up again after each beginDataAccess().
+Student *findStudent(int rollNumber) {
+    Student *s = storeFindByRoll(&studentStore, rollNumber);
+    if (s == NULL) {
+        printf("Student with roll number %d not found.\n", rollNumber);
+    }
+    return s;
+}
+
+// List pending requests in the order processApprovals() decides them
+void viewPendingApprovals() {
+    if (approvalQueue.pending == 0) {
+        printf("No pending approval requests found.\n");
+        return;
+    }
+    
+    PriorityPolicy policy;
+    PriorityHeap heap;
+    priorityPolicyLoad(&policy, PRIORITY_RULES_FILENAME);
+    if (!priorityHeapBuild(&heap, &policy, &approvalQueue, &studentStore)) {
+        printf("Error: Out of memory.\n");
+        return;
+    }
+    
+    printHeader("Pending Approval Requests");
+    printf("Roll No\tWaiting\t\tPriority\tName\n");
+    printf("-------\t-------\t\t--------\t----\n");
+    
+    int count = 0;
+    int64_t now = (int64_t)time(NULL);
+    PriorityEntry entry;
+    
+    // For each request, show only if student still exists and is pending
+    while (priorityHeapPop(&heap, &entry)) {
+        Student *s = storeFindByRoll(&studentStore, entry.rollNumber);
+        const ApprovalRequest *request = approvalQueueFind(&approvalQueue, entry.rollNumber);
+        if (s != NULL && s->approvalStatus == 0 && request != NULL) {
+            char waited[32] = "unknown";
+            if (entry.submitted > 0) {
+                formatWait(now - entry.submitted, waited, sizeof(waited));
+                printf("%d\t%-8s\t%8lld\t%s\n", entry.rollNumber, waited,
+                       (long long)priorityAt(&policy, &entry, now), approvalRequestName(&approvalQueue, request));
+            } else {
+                printf("%d\t%-8s\t%8s\t%s\n", entry.rollNumber, waited, "-",
+                       approvalRequestName(&approvalQueue, request));
+            }
+            count++;
+        }
+    }
+    priorityHeapFree(&heap);
+    
+    if (count == 0) {
+        printf("No pending approval requests found.\n");
+    }
+}
+
+// Admin processing of approval requests: approve/reject/skip each entry,
+// highest priority first (see PRIORITY_RULES_FILENAME). Each decision is
+// applied and saved under the exclusive data lock on its own, so other
+// sessions keep working while the admin thinks.
+void processApprovals() {
+    refreshData();
+    viewPendingApprovals();
+    
+    if (approvalQueue.pending == 0) {
+        printf("No approval requests to process.\n");
+        return;
+    }
+    
+    PriorityPolicy policy;
+    PriorityHeap heap;
+    priorityPolicyLoad(&policy, PRIORITY_RULES_FILENAME);
+    if (!priorityHeapBuild(&heap, &policy, &approvalQueue, &studentStore)) {
+        printf("Error: Out of memory.\n");
+        return;
+    }
+    
+    int processed = 0;
+    WaitTimes waits;
+    waitTimesInit(&waits);
+    
+    // Visit each request queued at the start at most once; decided ones
+    // leave the queue, skipped ones stay where they were
+    PriorityEntry entry;
+    while (priorityHeapPop(&heap, &entry)) {
+        int rollNumber = entry.rollNumber;
+        const ApprovalRequest *request = approvalQueueFind(&approvalQueue, rollNumber);
+        if (request == NULL) {
+            continue;
+        }
+        Student *s = storeFindByRoll(&studentStore, rollNumber);
+        if (s == NULL) {
+            // Invalid request for a non-existing student: inform and drop it
+            printf("Student with roll number %d not found in records. Removing invalid request.\n", rollNumber);
+            beginDataAccess(true);
+            if (storeFindByRoll(&studentStore, rollNumber) == NULL && approvalQueueRemove(&approvalQueue, rollNumber)) {
+                saveApprovalQueue();
+            }
+            endDataAccess();
+            continue;
+        }
+        
+        printHeader("Processing Approval");
+        printf("Student: %s (Roll No: %d)\n", storeName(&studentStore, s), rollNumber);
+        printf("Current status: %s\n", s->approvalStatus ? "Approved" : "Pending");
+        char amount[MONEY_TEXT_SIZE];
+        printf("Fees Due: %s\n", moneyText(s->feesDue, amount));
+        printf("Library Books Due: %d\n", s->libraryBooksDue);
+        printf("Hostel Due: %s\n", moneyText(s->hostelDue, amount));
+        if (request->submitted > 0) {
+            char waited[32];
+            printf("Waiting: %s\n", formatWait((int64_t)time(NULL) - request->submitted, waited, sizeof(waited)));
+        }
+        
+        int decision;
+        do {
+            printf("\n1. Approve\n2. Reject\n3. Skip\n4. Stop processing\nEnter decision: ");
+            decision = getValidIntegerInput("");
+        } while (decision < 1 || decision > 4);
+        if (decision == 4) {
+            break;
+        }
+        
+        // Timed from here: the admin's think time above is not the program's
+        beginDataAccess(true);
+        METRIC_START(start);
+        s = storeFindByRoll(&studentStore, rollNumber);
+        request = approvalQueueFind(&approvalQueue, rollNumber);
+        if (s == NULL || request == NULL) {
+            printf("Another session has already decided this request.\n");
+            endDataAccess();
+            continue;
+        }
+        if (decision != 3) {
+            if (!waitTimesAdd(&waits, request->submitted, (int64_t)time(NULL))) {
+                printf("Warning: Out of memory. This decision is left out of the wait times.\n");
+            }
+            approvalQueueRemove(&approvalQueue, rollNumber);
+        }
+        
+        if (decision == 1) {
+            // Make the approval durable before its request leaves the queue
+            auditRecord(&auditLog, rollNumber, AUDIT_APPROVED, s->approvalStatus, 1, ADMIN_USERNAME);
+            s->approvalStatus = 1;
+            logStudentChange(JOURNAL_SET_APPROVAL, s);
+            commitStudentChanges();
+            clearanceWithdraw(&clearanceBoard, rollNumber); // decided over the departments' heads
+            processed++;
+            METRIC_COUNT(METRIC_REQUESTS_APPROVED, 1);
+            printf("Approved successfully.\n");
+        } else if (decision == 2) {
+            // Rejected: do nothing to student status (removes request)
+            auditRecord(&auditLog, rollNumber, AUDIT_REJECTED, s->approvalStatus, s->approvalStatus, ADMIN_USERNAME);
+            clearanceWithdraw(&clearanceBoard, rollNumber);
+            METRIC_COUNT(METRIC_REQUESTS_REJECTED, 1);
+            printf("Application rejected.\n");
+        } else {
+            // Skip: the request keeps its place and submit time
+            auditRecord(&auditLog, rollNumber, AUDIT_SKIPPED, s->approvalStatus, s->approvalStatus, ADMIN_USERNAME);
+            METRIC_COUNT(METRIC_REQUESTS_SKIPPED, 1);
+        }
+        if (decision != 3) {
+            saveApprovalQueue();
+            saveClearance();
+        }
+        METRIC_STOP(METRIC_PROCESS_APPROVALS, start);
+        endDataAccess();
+    }
+    
+    printf("\nProcessing complete. %d applications were approved.\n", processed);
+    printWaitTimes(&waits);
+    priorityHeapFree(&heap);
+    waitTimesFree(&waits);
+}
+
+// Time-to-decision percentiles of one processing session
+void printWaitTimes(WaitTimes *waits) {
+    if (waits->count > 0) {
+        char p50[32], p95[32], p99[32], longest[32];
+        printf("Time to decision over %d requests: p50 %s, p95 %s, p99 %s, longest %s\n", waits->count,
+               formatWait(waitTimesPercentile(waits, 0.50), p50, sizeof(p50)),
+               formatWait(waitTimesPercentile(waits, 0.95), p95, sizeof(p95)),
+               formatWait(waitTimesPercentile(waits, 0.99), p99, sizeof(p99)),
+               formatWait(waitTimesPercentile(waits, 1.0), longest, sizeof(longest)));
+    }
+    if (waits->unstamped > 0) {
+        printf("%d decided requests predate submit times and are not included.\n", waits->unstamped);
+    }
+}
+
+// List one department's queue with the due it checks and which other
+// departments have already cleared each student
+void viewDepartmentQueue(Department department) {
+    ApprovalQueue *queue = &clearanceBoard.queues[department];
+    printHeader("Department Queue");
+    printf("Department: %s (%d waiting)\n", departmentName(department), queue->pending);
+    if (queue->pending == 0) {
+        return;
+    }
+    printf("Roll No\tName\t\tFees Due\tBooks Due\tHostel Due\tCleared By\n");
+    printf("-------\t----\t\t--------\t---------\t---------\t----------\n");
+    
+    int cursor = 0;
+    const ApprovalRequest *request;
+    while ((request = approvalQueueNext(queue, &cursor)) != NULL) {
+        const Student *s = storeFindByRoll(&studentStore, request->rollNumber);
+        int cleared = clearanceOf(&clearanceBoard, request->rollNumber);
+        if (s == NULL || cleared < 0) {
+            continue; // closed application, dropped when processed
+        }
+        char fees[MONEY_TEXT_SIZE], hostel[MONEY_TEXT_SIZE];
+        printf("%d\t%s\t\t%s\t\t%d\t\t%s\t\t", s->rollNumber, storeName(&studentStore, s),
+               moneyText(s->feesDue, fees), s->libraryBooksDue, moneyText(s->hostelDue, hostel));
+        bool any = false;
+        for (int d = 0; d < DEPARTMENT_COUNT; d++) {
+            if (cleared & (1 << d)) {
+                printf("%s%s", any ? "," : "", departmentName((Department)d));
+                any = true;
+            }
+        }
+        printf("%s\n", any ? "" : "-");
+    }
+}
+
+// One department works through its own queue: clear, reject or skip each
+// student. Only that department's queue is touched, so departments never
+// wait on each other's backlog. The student is approved the moment the
+// last department clears. Each decision takes the exclusive data lock on
+// its own, so departments at other terminals clear students meanwhile.
+void processDepartmentClearance() {
+    refreshData();
+    printHeader("Department Clearance");
+    for (int d = 0; d < DEPARTMENT_COUNT; d++) {
+        printf("%d. %s (%d waiting)\n", d + 1, departmentName((Department)d), clearanceBoard.queues[d].pending);
+    }
+    int choice;
+    do {
+        choice = getValidIntegerInput("Select department: ");
+    } while (choice < 1 || choice > DEPARTMENT_COUNT);
+    Department department = (Department)(choice - 1);
+    const char *actor = departmentName(department);
+    ApprovalQueue *queue = &clearanceBoard.queues[department];
+    
+    refreshData();
+    viewDepartmentQueue(department);
+    if (queue->pending == 0) {
+        printf("No students waiting for %s clearance.\n", actor);
+        return;
+    }
+    
+    // Visit the students waiting now, oldest first; skipped ones keep their place
+    int toVisit = 0;
+    int *rolls = malloc(sizeof(int) * (size_t)queue->pending);
+    if (rolls == NULL) {
+        printf("Error: Out of memory.\n");
+        return;
+    }
+    int cursor = 0;
+    const ApprovalRequest *request;
+    while ((request = approvalQueueNext(queue, &cursor)) != NULL) {
+        rolls[toVisit++] = request->rollNumber;
+    }
+    
+    int cleared = 0;
+    int completed = 0;
+    for (int i = 0; i < toVisit; i++) {
+        int rollNumber = rolls[i];
+        int before;
+        Student *s = clearanceWaiting(department, rollNumber, &before);
+        if (s == NULL) {
+            // Application closed or decided elsewhere: drop it from this queue
+            beginDataAccess(true);
+            if (clearanceWaiting(department, rollNumber, &before) == NULL && approvalQueueRemove(queue, rollNumber)) {
+                clearanceBoard.queueDirty[department] = true;
+                saveClearance();
+            }
+            endDataAccess();
+            continue;
+        }
+        
+        printHeader("Processing Clearance");
+        printf("Student: %s (Roll No: %d)\n", storeName(&studentStore, s), rollNumber);
+        char amount[MONEY_TEXT_SIZE];
+        if (department == DEPARTMENT_ACCOUNTS) {
+            printf("Fees Due: %s\n", moneyText(s->feesDue, amount));
+        } else if (department == DEPARTMENT_LIBRARY) {
+            printf("Library Books Due: %d\n", s->libraryBooksDue);
+        } else {
+            printf("Hostel Due: %s\n", moneyText(s->hostelDue, amount));
+        }
+        printClearance(rollNumber);
+        
+        int decision;
+        do {
+            printf("\n1. Clear\n2. Reject\n3. Skip\nEnter decision: ");
+            decision = getValidIntegerInput("");
+        } while (decision < 1 || decision > 3);
+        if (decision == 3) {
+            continue;
+        }
+        
+        beginDataAccess(true);
+        s = clearanceWaiting(department, rollNumber, &before);
+        if (s == NULL) {
+            printf("Another session has already decided this application.\n");
+        } else if (decision == 1) {
+            approvalQueueRemove(queue, rollNumber);
+            clearanceBoard.queueDirty[department] = true;
+            int after = clearanceMark(&clearanceBoard, rollNumber, department);
+            auditRecord(&auditLog, rollNumber, AUDIT_CLEARED, before, after, actor);
+            cleared++;
+            if (after == CLEARANCE_ALL) {
+                completeClearance(s);
+                commitStudentChanges();
+                saveApprovalQueue();
+                completed++;
+                printf("Cleared. All departments have cleared %s: approved.\n", storeName(&studentStore, s));
+            } else {
+                printf("Cleared.\n");
+            }
+        } else {
+            // A rejection by any department closes the whole application
+            clearanceWithdraw(&clearanceBoard, rollNumber);
+            approvalQueueRemove(&approvalQueue, rollNumber);
+            auditRecord(&auditLog, rollNumber, AUDIT_REJECTED, s->approvalStatus, s->approvalStatus, actor);
+            saveApprovalQueue();
+            printf("Application rejected by %s.\n", actor);
+        }
+        saveClearance();
+        endDataAccess();
+    }
+    free(rolls);
+    
+    printf("\n%s: %d cleared, %d students fully approved.\n", actor, cleared, completed);
+}
+
+// The student whose application still waits for `department` (with the
+// departments that cleared it so far), or NULL when the application was
+// closed or decided elsewhere
+Student *clearanceWaiting(Department department, int rollNumber, int *cleared) {
+    Student *s = storeFindByRoll(&studentStore, rollNumber);
+    *cleared = clearanceOf(&clearanceBoard, rollNumber);
+    if (s == NULL || s->approvalStatus != 0 || *cleared < 0 || (*cleared & (1 << department))
+            || !approvalQueueContains(&approvalQueue, rollNumber)
+            || !approvalQueueContains(&clearanceBoard.queues[department], rollNumber)) {
+        return NULL;
+    }
+    return s;
+}
+
+// Every department has cleared the student: approve them (journaled, the
+// caller commits) and take the request off the approval queue (the caller
+// rewrites the file)
+void completeClearance(Student *s) {
+    auditRecord(&auditLog, s->rollNumber, AUDIT_APPROVED, s->approvalStatus, 1, CLEARANCE_ACTOR);
+    s->approvalStatus = 1;
+    logStudentChange(JOURNAL_SET_APPROVAL, s);
+    approvalQueueRemove(&approvalQueue, s->rollNumber);
+    METRIC_COUNT(METRIC_REQUESTS_APPROVED, 1);
+}
+
+// Resolve queued requests automatically using the rules in AUTO_RULES_FILENAME;
+// only the requests the rules cannot decide are left for manual review
+void autoProcessApprovals() {
+    AutoRules rules;
+    if (!autoRulesLoad(&rules, AUTO_RULES_FILENAME)) {
+        printf("%s not found. Using default rules (approve only when nothing is due).\n", AUTO_RULES_FILENAME);
+    }
+    
+    if (approvalQueue.pending == 0) {
+        printf("No approval requests to process.\n");
+        return;
+    }
+    
+    AutoReport report;
+    bool processed = autoProcessQueue(&rules, &studentStore, &approvalQueue, &clearanceBoard, &studentJournal,
+                                      &auditLog, &report);
+    duesColumns.built = false;
+    if (!processed) {
+        printf("Error: Out of memory. Approvals were not processed.\n");
+        return;
+    }
+    
+    // Persist approvals first, then the shortened queues
+    commitStudentChanges();
+    saveApprovalQueue();
+    saveClearance();
+    
+    printHeader("Auto-Clearance Summary");
+    printf("Requests examined: %d\n", report.examined);
+    printf("Auto-approved: %d\n", report.approved);
+    printf("Auto-rejected: %d\n", report.rejected);
+    printf("Left for manual review: %d\n", report.manual);
+    if (report.invalid > 0) {
+        printf("Invalid requests removed: %d\n", report.invalid);
+    }
+    printf("Rule pass: %.6f s, total: %.6f s\n", report.evaluateSeconds, report.totalSeconds);
+}
+
+// Outstanding dues by approval status, summed over the dues columns
+void showDuesSummary() {
+    if (!duesColumnsSync(&duesColumns, &studentStore)) {
+        printf("Error: Out of memory. Dues summary is not available.\n");
+        return;
+    }
+    
+    DuesSummary summary;
+    double start = monotonicSeconds();
+    duesSummarize(&duesColumns, &summary);
+    double seconds = monotonicSeconds() - start;
+    
+    const DuesTotals *p = &summary.pending;
+    const DuesTotals *a = &summary.approved;
+    printHeader("Dues Summary");
+    printf("%-20s %16s %16s %16s\n", "", "Pending", "Approved", "Total");
+    printDuesRow("Students", p->students, a->students, false);
+    printDuesRow("Owing anything", p->owing, a->owing, false);
+    printDuesRow("Fees due", p->feesDue, a->feesDue, true);
+    printDuesRow("Hostel due", p->hostelDue, a->hostelDue, true);
+    printDuesRow("Fees + hostel due", p->feesDue + p->hostelDue, a->feesDue + a->hostelDue, true);
+    printDuesRow("Library books due", p->booksDue, a->booksDue, false);
+    if (timingMode) {
+        printf("Summed %d records in %.6f s\n", duesColumns.count, seconds);
+    }
+}
+
+// One line of the dues summary: pending, approved and their total
+void printDuesRow(const char *label, int64_t pending, int64_t approved, bool amount) {
+    if (amount) {
+        char p[MONEY_TEXT_SIZE], a[MONEY_TEXT_SIZE], t[MONEY_TEXT_SIZE];
+        printf("%-20s %16s %16s %16s\n", label, moneyText(pending, p), moneyText(approved, a),
+               moneyText(pending + approved, t));
+    } else {
+        printf("%-20s %16lld %16lld %16lld\n", label, (long long)pending, (long long)approved,
+               (long long)(pending + approved));
+    }
+}
+
+// Prompt for a report query and run it
+void reportQuery() {
+    char text[QUERY_TEXT_SIZE];
+    printHeader("Report Query");
+    printf("count | sum FIELD[, FIELD...] | top N by FIELD [asc] | list | csv [into \"FILE\"]\n");
+    printf("  [where TEST [and|or TEST]...]  fields: roll fees hostel dues books status name\n");
+    printf("e.g. top 10 by dues where pending and books > 2\n");
+    printf("Query: ");
+    if (fgets(text, sizeof(text), stdin) == NULL) {
+        return;
+    }
+    text[strcspn(text, "\n")] = '\0';
+    refreshData();
+    runReportQuery(text, true);
+}
+
+// Compile and run one report query over the dues columns and print the
+// result; interactive runs page through listed rows
+bool runReportQuery(const char *text, bool interactive) {
+    Query query;
+    int errorPosition;
+    const char *error;
+    if (!queryCompile(&query, text, &errorPosition, &error)) {
+        printf("Error: %s\n", error);
+        printf("  %s\n  %*s^\n", text, errorPosition, "");
+        return false;
+    }
+    // --query names its file from where the program was started
+    if (!interactive && query.output[0] != '\0' && launchDirectory[0] != '\0') {
+        char path[QUERY_PATH_SIZE];
+        if (!joinPath(launchDirectory, query.output, path, sizeof(path))) {
+            printf("Error: File name too long: %s\n", query.output);
+            return false;
+        }
+        strcpy(query.output, path);
+    }
+    if (!duesColumnsSync(&duesColumns, &studentStore)) {
+        printf("Error: Out of memory. Report queries are not available.\n");
+        return false;
+    }
+    
+    QueryResult result;
+    if (!queryRun(&query, &duesColumns, &studentStore, &result)) {
+        printf("Error: Out of memory.\n");
+        return false;
+    }
+    bool ok = true;
+    switch (query.action) {
+        case QUERY_COUNT:
+            printf("%ld students\n", result.matched);
+            break;
+        case QUERY_SUM:
+            printf("%ld students\n", result.matched);
+            for (int k = 0; k < query.sumCount; k++) {
+                char amount[MONEY_TEXT_SIZE];
+                if (query.sums[k] == QUERY_FIELD_BOOKS) {
+                    printf("%-8s %16lld\n", queryFieldName(query.sums[k]), (long long)result.sums[k]);
+                } else {
+                    printf("%-8s %16s\n", queryFieldName(query.sums[k]), moneyText(result.sums[k], amount));
+                }
+            }
+            break;
+        case QUERY_CSV:
+            if (query.output[0] != '\0') {
+                FILE *out = fopen(query.output, "w");
+                ok = out != NULL && queryWriteCsv(out, &result.rows);
+                if (out != NULL && fclose(out) != 0) {
+                    ok = false;
+                }
+                if (ok) {
+                    printf("Wrote %d students to %s\n", result.rows.count, query.output);
+                } else {
+                    printf("Error: Could not write %s.\n", query.output);
+                }
+            } else {
+                ok = queryWriteCsv(stdout, &result.rows);
+            }
+            break;
+        default:
+            if (interactive) {
+                showStudentList("Query Result", &result.rows);
+            } else {
+                printf("Roll No\tName\t\tFees Due\tBooks Due\tHostel Due\tApproval Status\n");
+                listWriteRows(stdout, &result.rows, 0, result.rows.count);
+            }
+            if (query.action == QUERY_LIST || result.rows.count > 0) {
+                printf("%ld students matched\n", result.matched);
+            }
+            break;
+    }
+    if (timingMode) {
+        printf("Queried %d records in %.6f s\n", duesColumns.count, result.seconds);
+    }
+    queryResultFree(&result);
+    return ok;
+}
+
+// Write a no-dues certificate for every approved student, plus the
+// consolidated clearance report, into `directory` on all cores
+bool generateNoDuesCertificates(const char *directory) {
+    CertificateReport report;
+    printHeader("Generate Certificates");
+    if (!generateCertificates(&studentStore, directory, defaultCertificateThreads(),
+                              printCertificateProgress, NULL, &report)) {
+        printf("Error: Could not create %s (or out of memory).\n", directory);
+        return false;
+    }
+    if (report.approved == 0) {
+        printf("No approved students: no certificates written.\n");
+    } else {
+        printf("\n%d certificates written to %s/ (%d of %d students approved).\n",
+               report.written, directory, report.approved, report.students);
+        printf("Written in %.3f s on %d threads (%.0f certificates/s, %.1f MB).\n", report.writeSeconds,
+               report.threads, report.writeSeconds > 0 ? report.written / report.writeSeconds : 0.0,
+               report.bytes / 1048576.0);
+    }
+    if (report.failed > 0) {
+        printf("Error: %d certificates could not be written.\n", report.failed);
+    }
+    if (report.reportWritten) {
+        printf("Clearance report: %s/%s\n", directory, CERTIFICATE_REPORT_FILENAME);
+    } else {
+        printf("Error: Could not write %s/%s.\n", directory, CERTIFICATE_REPORT_FILENAME);
+    }
+    return report.failed == 0 && report.reportWritten;
+}
+
+void printCertificateProgress(int written, int total, double seconds, void *context) {
+    (void)context;
+    printf("\r  %d of %d certificates (%.0f/s)", written, total, seconds > 0 ? written / seconds : 0.0);
+    fflush(stdout);
+}
+
+// Reconcile PAYMENT_FILENAME: parse only the lines appended since the last
+// run (in parallel), skip payments whose key was already applied, and take
+// the per-roll totals off each student's dues in one pass
+void applyPaymentHistory() {
+    PaymentTotals totals;
+    PaymentIngestStats stats;
+    paymentTotalsInit(&totals);
+    
+    if (!ingestPayments(PAYMENT_FILENAME, defaultPaymentThreads(), &paymentCheckpoint,
+                        &paymentCheckpoint.keys, &totals, &stats)) {
+        printf("Error: Could not read %s.\n", PAYMENT_FILENAME);
+        paymentTotalsFree(&totals);
+        loadPaymentCheckpoint(); // drop any keys claimed by the failed run
+        return;
+    }
+    if (stats.rescanned) {
+        printf("Warning: %s changed before the last checkpoint. Rescanned it; applied payments are skipped by key.\n",
+               PAYMENT_FILENAME);
+    }
+    
+    PaymentPlan plan;
+    PaymentApplyReport report;
+    if (!planPaymentTotals(&totals, &studentStore, &plan, &report)) {
+        printf("Error: Out of memory. Payments were not applied.\n");
+        paymentTotalsFree(&totals);
+        loadPaymentCheckpoint();
+        return;
+    }
+    
+    // Record the decision (keys, new offset, resulting dues) durably before
+    // touching the records, so a crash can neither lose nor repeat it
+    paymentCheckpoint.offset = stats.endOffset;
+    paymentCheckpoint.lines = stats.endLines;
+    paymentCheckpoint.tailHash = stats.endTailHash;
+    paymentCheckpoint.updates = plan.items;
+    paymentCheckpoint.updateCount = plan.count;
+    dataGenerations.payments++;
+    if (!paymentKeysAppend(&paymentCheckpoint.keys, PAYMENT_KEYS_FILENAME)
+            || !paymentCheckpointSave(&paymentCheckpoint, PAYMENT_CHECKPOINT_FILENAME)) {
+        printf("Error: Could not write %s. Payments were not applied.\n", PAYMENT_CHECKPOINT_FILENAME);
+        paymentTotalsFree(&totals);
+        loadPaymentCheckpoint();
+        return;
+    }
+    finishPaymentReconciliation();
+    
+    printHeader("Payment History Summary");
+    printf("New payments applied: %ld of %ld new lines (%ld malformed)\n", stats.payments, stats.lines, stats.malformed);
+    if (stats.duplicates > 0) {
+        printf("Duplicate payments skipped: %ld\n", stats.duplicates);
+    }
+    if (stats.undatedPayments > 0) {
+        printf("Payments without a date: %ld\n", stats.undatedPayments);
+    }
+    printf("Students updated: %d\n", report.studentsUpdated);
+    char amount[MONEY_TEXT_SIZE];
+    printf("Amount applied: %s\n", moneyText(report.applied, amount));
+    if (report.overpaid > 0) {
+        printf("Overpaid (dues already cleared): %s\n", moneyText(report.overpaid, amount));
+    }
+    if (report.unknownRolls > 0) {
+        printf("Warning: %d roll numbers in %s are not in the database.\n", report.unknownRolls, PAYMENT_FILENAME);
+    }
+    if (timingMode) {
+        printf("Scanned %zu bytes from offset %llu. Parse: %.6f s on %d threads, merge: %.6f s\n",
+               stats.bytes, (unsigned long long)stats.startOffset, stats.parseSeconds, stats.threads, stats.mergeSeconds);
+    }
+    paymentTotalsFree(&totals);
+}
+
+// Apply the updates recorded in the checkpoint, commit them to the journal
+// and then clear them from the checkpoint
+bool finishPaymentReconciliation() {
+    for (int i = 0; i < paymentCheckpoint.updateCount; i++) {
+        const PaymentUpdate *update = &paymentCheckpoint.updates[i];
+        const Student *s = storeFindByRoll(&studentStore, update->rollNumber);
+        if (s == NULL) {
+            continue;
+        }
+        Student after = *s;
+        after.feesDue = update->feesDue;
+        after.hostelDue = update->hostelDue;
+        auditRecordChanges(&auditLog, s, &after, PAYMENT_ACTOR);
+    }
+    applyPaymentUpdates(paymentCheckpoint.updates, paymentCheckpoint.updateCount, &studentStore, &studentJournal);
+    duesColumns.built = false;
+    if (!commitStudentChanges()) {
+        printf("Error: Could not save payment updates. They will be applied again at next start.\n");
+        return false;
+    }
+    free(paymentCheckpoint.updates);
+    paymentCheckpoint.updates = NULL;
+    paymentCheckpoint.updateCount = 0;
+    dataGenerations.payments++;
+    if (!paymentCheckpointSave(&paymentCheckpoint, PAYMENT_CHECKPOINT_FILENAME)) {
+        printf("Warning: Could not update %s.\n", PAYMENT_CHECKPOINT_FILENAME);
+    }
+    return true;
+}
+
+// Update an existing student's numeric fields or approval flag. The new
+// value is asked for first; the exclusive lock is taken only to apply it.
+void updateStudentRecord() {
+    int rollNumber = promptRollNumber("\nEnter roll number to update (0 to search by name): ");
+    if (rollNumber == 0) {
+        return;
+    }
+    refreshData();
+    Student *s = findStudent(rollNumber);
+    if (s == NULL) {
+        return;
+    }
+    
+    char amount[MONEY_TEXT_SIZE];
+    printHeader("Update Student Record");
+    printf("Current details for %s (Roll No: %d):\n", storeName(&studentStore, s), rollNumber);
+    printf("1. Fees Due: %s\n", moneyText(s->feesDue, amount));
+    printf("2. Library Books Due: %d\n", s->libraryBooksDue);
+    printf("3. Hostel Due: %s\n", moneyText(s->hostelDue, amount));
+    printf("4. Approval Status: %s\n", s->approvalStatus ? "Approved" : "Pending");
+    printf("0. Cancel Update\n");
+    
+    int choice;
+    do {
+        choice = getValidIntegerInput("\nSelect field to update (0-4): ");
+    } while (choice < 0 || choice > 4);
+    
+    if (choice == 0) {
+        printf("Update cancelled.\n");
+        return;
+    }
+    
+    Money money = 0;
+    int number = 0;
+    switch(choice) {
+        case 1:
+            money = getValidMoneyInput("Enter new fees due: ");
+            break;
+        case 2:
+            number = getValidIntegerInput("Enter new library books due: ");
+            break;
+        case 3:
+            money = getValidMoneyInput("Enter new hostel due: ");
+            break;
+        case 4:
+            number = getValidIntegerInput("Enter new approval status (1=Approved, 0=Pending): ");
+            break;
+    }
+    
+    beginDataAccess(true);
+    s = findStudent(rollNumber);
+    if (s != NULL) {
+        Student before = *s;
+        switch(choice) {
+            case 1:
+                s->feesDue = money;
+                logStudentChange(JOURNAL_SET_FEES, s);
+                break;
+            case 2:
+                s->libraryBooksDue = number;
+                logStudentChange(JOURNAL_SET_BOOKS, s);
+                break;
+            case 3:
+                s->hostelDue = money;
+                logStudentChange(JOURNAL_SET_HOSTEL, s);
+                break;
+            case 4:
+                s->approvalStatus = number;
+                logStudentChange(JOURNAL_SET_APPROVAL, s);
+                break;
+        }
+        auditRecordChanges(&auditLog, &before, s, ADMIN_USERNAME);
+        
+        commitStudentChanges(); // persist the change via the journal
+        printf("Record updated successfully.\n");
+    }
+    endDataAccess();
+}
+
+// Add a new student: ensure unique roll number and collect fields
+void addNewStudent() {
+    printHeader("Add New Student");
+    refreshData();
+    
+    int rollNumber;
+    do {
+        rollNumber = getValidIntegerInput("Enter roll number: ");
+        if (isRollNumberExists(rollNumber)) {
+            printf("Error: Roll number already exists. Please enter a unique roll number.\n");
+        }
+    } while (isRollNumberExists(rollNumber));
+    
+    Student newStudent;
+    newStudent.rollNumber = rollNumber;
+    
+    // Read full line for student name (may contain spaces); names are
+    // stored whole, so an overlong one is asked for again
+    char name[MAX_NAME_LENGTH + 1];
+    for (;;) {
+        printf("Enter student name: ");
+        if (fgets(name, sizeof(name), stdin) == NULL) {
+            name[0] = '\0';
+            break;
+        }
+        size_t length = strcspn(name, "\n");
+        if (name[length] == '\n' || length < MAX_NAME_LENGTH) {
+            name[length] = '\0';
+            break;
+        }
+        int c;
+        while ((c = getchar()) != '\n' && c != EOF) {
+        }
+        printf("Error: Name is too long (at most %d characters).\n", MAX_NAME_LENGTH - 1);
+    }
+    
+    newStudent.feesDue = getValidMoneyInput("Enter fees due: ");
+    newStudent.libraryBooksDue = getValidIntegerInput("Enter number of library books due: ");
+    newStudent.hostelDue = getValidMoneyInput("Enter hostel due: ");
+    newStudent.approvalStatus = getValidIntegerInput("Enter approval status (1=Approved, 0=Pending): ");
+    
+    // Another session may have taken the roll number meanwhile
+    beginDataAccess(true);
+    if (isRollNumberExists(rollNumber)) {
+        printf("Error: Roll number already exists. Please enter a unique roll number.\n");
+    } else if (insertStudent(&newStudent, name)) {
+        printf("Student added successfully!\n");
+    }
+    endDataAccess();
+}
+
+// Add the record to the in-memory store, then journal and audit it
+bool insertStudent(Student *newStudent, const char *name) {
+    newStudent->name = storeInternName(&studentStore, name, strlen(name));
+    if (newStudent->name == NAME_NONE || storeAdd(&studentStore, newStudent) == NULL) {
+        printf("Error: Out of memory. Student could not be added.\n");
+        return false;
+    }
+    
+    // Journal the new record for persistence
+    logStudentChange(JOURNAL_ADD_STUDENT, newStudent);
+    auditRecord(&auditLog, newStudent->rollNumber, AUDIT_ADDED, 0, newStudent->feesDue + newStudent->hostelDue,
+                ADMIN_USERNAME);
+    return commitStudentChanges();
+}
+
+// Check in-memory roll numbers for duplicates
+int isRollNumberExists(int rollNumber) {
+    return storeFindByRoll(&studentStore, rollNumber) != NULL;
+}
+
+// Get a validated integer from the user (re-prompts until valid)
+int getValidIntegerInput(const char *prompt) {
+    int value;
+    char buffer[100];
+    
+    while (1) {
+        printf("%s", prompt);
+        fgets(buffer, sizeof(buffer), stdin);
+        
+        if (sscanf(buffer, "%d", &value) == 1) {
+            return value;
+        }
+        
+        printf("Invalid input. Please enter a valid integer.\n");
+    }
+}
+
+// Get a validated amount like 1500 or 1500.25 from the user (exact, in paise)
+Money getValidMoneyInput(const char *prompt) {
+    Money value;
+    char buffer[100];
+    
+    while (1) {
+        printf("%s", prompt);
+        fgets(buffer, sizeof(buffer), stdin);
+        
+        if (moneyParseText(buffer, &value)) {
+            return value;
+        }
+        
+        printf("Invalid input. Please enter a valid amount.\n");
+    }
+}
+
+// Flush leftover characters in stdin (used after scanf)
+void clearInputBuffer() {
+    int c;
+    while ((c = getchar()) != '\n' && c != EOF);
+}
+
+// Operation latencies and counters gathered since startup
+void showMetrics() {
+    printHeader("Metrics");
+#ifdef NO_METRICS
+    printf("Metrics are not compiled into this build (built with -DNO_METRICS).\n");
+#else
+    metricsPrint(stdout);
+#endif
+}
+
+// Every audited event for one student, oldest first, read by following the
+// roll's chain of entries back from its newest one
+void showStudentHistory() {
+    int rollNumber = promptRollNumber("\nEnter roll number (0 to search by name): ");
+    if (rollNumber == 0) {
+        return;
+    }
+    
+    // Read under the shared lock so no other session is appending meanwhile
+    beginDataAccess(false);
+    Student *s = findStudent(rollNumber);
+    AuditEntry *entries = NULL;
+    int count = 0;
+    double start = monotonicSeconds();
+    bool read = s != NULL && auditHistory(&auditLog, rollNumber, &entries, &count);
+    double seconds = monotonicSeconds() - start;
+    endDataAccess();
+    if (s == NULL) {
+        return;
+    }
+    if (!read) {
+        printf("Error: Could not read %s.\n", AUDIT_FILENAME);
+        return;
+    }
+    
+    printHeader("Student History");
+    printf("%s (Roll No: %d)\n", storeName(&studentStore, s), s->rollNumber);
+    if (count == 0) {
+        printf("No audited events for this student.\n");
+    } else {
+        printf("%-19s  %-9s  %-15s  %14s  %14s\n", "When", "Event", "By", "Old", "New");
+    }
+    for (int i = 0; i < count; i++) {
+        const AuditEntry *e = &entries[i];
+        time_t when = (time_t)e->timestamp;
+        char whenText[32];
+        char oldText[MONEY_TEXT_SIZE];
+        char newText[MONEY_TEXT_SIZE];
+        strftime(whenText, sizeof(whenText), "%Y-%m-%d %H:%M:%S", localtime(&when));
+        formatAuditValue(e->action, e->oldValue, oldText, sizeof(oldText));
+        formatAuditValue(e->action, e->newValue, newText, sizeof(newText));
+        printf("%-19s  %-9s  %-15s  %14s  %14s\n", whenText, auditActionName(e->action), e->actor, oldText, newText);
+    }
+    if (timingMode) {
+        printf("Read %d entries in %.6f s\n", count, seconds);
+    }
+    free(entries);
+}
+
+// Old/new value of an audit entry as shown in the history
+void formatAuditValue(AuditAction action, int64_t value, char *out, size_t size) {
+    switch(action) {
+        case AUDIT_SET_FEES:
+        case AUDIT_SET_HOSTEL:
+        case AUDIT_ADDED:
+            moneyText(value, out);
+            break;
+        case AUDIT_SET_BOOKS:
+            snprintf(out, size, "%lld", (long long)value);
+            break;
+        case AUDIT_APPLIED:
+            snprintf(out, size, "-");
+            break;
+        case AUDIT_CLEARED: {
+            int departments = 0;
+            for (int d = 0; d < DEPARTMENT_COUNT; d++) {
+                departments += (value >> d) & 1;
+            }
+            snprintf(out, size, "%d of %d", departments, DEPARTMENT_COUNT);
+            break;
+        }
+        default:
+            snprintf(out, size, "%s", value ? "Approved" : "Pending");
+    }
+}
+
+// Dump this run's metrics to METRICS_FILENAME on the way out
+void writeMetrics() {
+#ifndef NO_METRICS
+    if (!metricsWriteFile(METRICS_FILENAME)) {
+        printf("Warning: Could not write %s.\n", METRICS_FILENAME);
+    }
+#endif
+}
+
+// Simple header printer to separate sections visually
+void printHeader(const char *title) {
+    printf("\n========================================\n");
+    printf("%s\n", title);
+    printf("========================================\n");
 }
\ No newline at end of file
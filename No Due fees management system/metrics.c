@@ -0,0 +1,124 @@
+#include "metrics.h"
+
+#ifndef NO_METRICS
+
+#include <time.h>
+#include "file_util.h"
+
+static const char *operationNames[METRIC_OPERATION_COUNT] = {
+    "load_students", "save_students", "save_approval", "duplicate_check", "process_approvals"
+};
+
+static const char *counterNames[METRIC_COUNTER_COUNT] = {
+    "records_loaded", "journal_entries_replayed", "records_saved", "requests_queued",
+    "duplicate_requests", "requests_approved", "requests_rejected", "requests_skipped"
+};
+
+static MetricHistogram operations[METRIC_OPERATION_COUNT];
+static uint64_t counters[METRIC_COUNTER_COUNT];
+
+// Number of significant bits: 0 for 0, 1 for 1, 10 for 512..1023, ...
+static int bucketOf(uint64_t nanos) {
+    int bits = 0;
+    while (nanos != 0 && bits < METRIC_BUCKETS - 1) {
+        nanos >>= 1;
+        bits++;
+    }
+    return bits;
+}
+
+void metricsRecord(MetricOperation operation, uint64_t nanos) {
+    MetricHistogram *h = &operations[operation];
+    if (h->count == 0 || nanos < h->minNanos) {
+        h->minNanos = nanos;
+    }
+    if (nanos > h->maxNanos) {
+        h->maxNanos = nanos;
+    }
+    h->count++;
+    h->totalNanos += nanos;
+    h->buckets[bucketOf(nanos)]++;
+}
+
+void metricsCount(MetricCounter counter, uint64_t amount) {
+    counters[counter] += amount;
+}
+
+// Upper bound of the bucket holding the given fraction of the samples,
+// capped at the largest sample seen
+uint64_t metricsPercentile(const MetricHistogram *histogram, double fraction) {
+    if (histogram->count == 0) {
+        return 0;
+    }
+    uint64_t rank = (uint64_t)(fraction * (double)histogram->count + 0.5);
+    if (rank < 1) {
+        rank = 1;
+    }
+    uint64_t seen = 0;
+    for (int b = 0; b < METRIC_BUCKETS; b++) {
+        seen += histogram->buckets[b];
+        if (seen >= rank) {
+            uint64_t bound = b == 0 ? 0 : ((uint64_t)1 << b) - 1;
+            return bound < histogram->maxNanos ? bound : histogram->maxNanos;
+        }
+    }
+    return histogram->maxNanos;
+}
+
+// Operations as a table in microseconds, then the counters
+void metricsPrint(FILE *out) {
+    fprintf(out, "%-18s %8s %11s %10s %10s %10s %10s %10s\n",
+            "Operation", "Calls", "Total ms", "Mean us", "p50 us", "p95 us", "p99 us", "Max us");
+    for (int i = 0; i < METRIC_OPERATION_COUNT; i++) {
+        const MetricHistogram *h = &operations[i];
+        fprintf(out, "%-18s %8llu %11.3f %10.1f %10.1f %10.1f %10.1f %10.1f\n",
+                operationNames[i], (unsigned long long)h->count, h->totalNanos / 1e6,
+                h->count > 0 ? h->totalNanos / 1e3 / (double)h->count : 0.0,
+                metricsPercentile(h, 0.50) / 1e3, metricsPercentile(h, 0.95) / 1e3,
+                metricsPercentile(h, 0.99) / 1e3, h->maxNanos / 1e3);
+    }
+    fprintf(out, "\n");
+    for (int i = 0; i < METRIC_COUNTER_COUNT; i++) {
+        fprintf(out, "%-26s %12llu\n", counterNames[i], (unsigned long long)counters[i]);
+    }
+}
+
+// "name value" lines: per operation its totals, percentiles and non-empty
+// buckets (bucket_le_N counts samples of at most N ns), then the counters
+bool metricsWriteFile(const char *path) {
+    char tempPath[512];
+    snprintf(tempPath, sizeof(tempPath), "%s.tmp", path);
+    FILE *file = fopen(tempPath, "w");
+    if (file == NULL) {
+        return false;
+    }
+    fprintf(file, "# written_at %lld\n", (long long)time(NULL));
+    for (int i = 0; i < METRIC_OPERATION_COUNT; i++) {
+        const MetricHistogram *h = &operations[i];
+        const char *name = operationNames[i];
+        fprintf(file, "%s.count %llu\n", name, (unsigned long long)h->count);
+        fprintf(file, "%s.total_ns %llu\n", name, (unsigned long long)h->totalNanos);
+        fprintf(file, "%s.min_ns %llu\n", name, (unsigned long long)h->minNanos);
+        fprintf(file, "%s.max_ns %llu\n", name, (unsigned long long)h->maxNanos);
+        fprintf(file, "%s.p50_ns %llu\n", name, (unsigned long long)metricsPercentile(h, 0.50));
+        fprintf(file, "%s.p95_ns %llu\n", name, (unsigned long long)metricsPercentile(h, 0.95));
+        fprintf(file, "%s.p99_ns %llu\n", name, (unsigned long long)metricsPercentile(h, 0.99));
+        for (int b = 0; b < METRIC_BUCKETS; b++) {
+            if (h->buckets[b] > 0) {
+                unsigned long long bound = b == 0 ? 0 : (1ULL << b) - 1;
+                fprintf(file, "%s.bucket_le_%llu %llu\n", name, bound, (unsigned long long)h->buckets[b]);
+            }
+        }
+    }
+    for (int i = 0; i < METRIC_COUNTER_COUNT; i++) {
+        fprintf(file, "%s %llu\n", counterNames[i], (unsigned long long)counters[i]);
+    }
+    bool ok = fclose(file) == 0;
+    if (!ok || !replaceFileAtomically(tempPath, path)) {
+        remove(tempPath);
+        return false;
+    }
+    return true;
+}
+
+#endif
@@ -0,0 +1,65 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "timing.h"
+
+// Per-operation call counts and latency histograms plus event counters,
+// kept in memory and shown on request or written to a file. Build with
+// -DNO_METRICS to compile every probe out; the macros then expand to nothing.
+// Recording is not synchronized: probes run on one thread at a time.
+
+#define METRIC_BUCKETS 48       // bucket b counts latencies of b significant bits (ns)
+
+typedef enum {
+    METRIC_LOAD_STUDENTS,       // loadStudentData: base file + journal replay
+    METRIC_SAVE_STUDENTS,       // saveAllStudents: compaction into a new base file
+    METRIC_SAVE_APPROVAL,       // saveApprovalRequest: queue + append to the list
+    METRIC_DUPLICATE_CHECK,     // isDuplicateApproval
+    METRIC_PROCESS_APPROVALS,   // processApprovals, once the decisions are made
+    METRIC_OPERATION_COUNT
+} MetricOperation;
+
+typedef enum {
+    METRIC_RECORDS_LOADED,
+    METRIC_JOURNAL_REPLAYED,
+    METRIC_RECORDS_SAVED,
+    METRIC_REQUESTS_QUEUED,
+    METRIC_DUPLICATES_FOUND,
+    METRIC_REQUESTS_APPROVED,
+    METRIC_REQUESTS_REJECTED,
+    METRIC_REQUESTS_SKIPPED,
+    METRIC_COUNTER_COUNT
+} MetricCounter;
+
+typedef struct {
+    uint64_t count;
+    uint64_t totalNanos;
+    uint64_t minNanos;
+    uint64_t maxNanos;
+    uint64_t buckets[METRIC_BUCKETS];
+} MetricHistogram;
+
+#ifndef NO_METRICS
+
+void metricsRecord(MetricOperation operation, uint64_t nanos);
+void metricsCount(MetricCounter counter, uint64_t amount);
+uint64_t metricsPercentile(const MetricHistogram *histogram, double fraction);
+void metricsPrint(FILE *out);
+bool metricsWriteFile(const char *path);
+
+#define METRIC_START(name) uint64_t name = monotonicNanos()
+#define METRIC_STOP(operation, name) metricsRecord(operation, monotonicNanos() - (name))
+#define METRIC_COUNT(counter, amount) metricsCount(counter, (uint64_t)(amount))
+
+#else
+
+#define METRIC_START(name)
+#define METRIC_STOP(operation, name)
+#define METRIC_COUNT(counter, amount)
+
+#endif
+
+#endif
@@ -0,0 +1,112 @@
+#include <string.h>
+#include "money.h"
+
+// Largest whole-unit part that still fits once scaled
+#define MONEY_MAX_UNITS (INT64_MAX / MONEY_SCALE - 1)
+
+// Parse a plain decimal like 1500, 1500.5 or -1500.25 (no exponent);
+// advances *p past it. Digits beyond the paisa are rounded half away from
+// zero. False on no digits or overflow.
+bool moneyParse(const char **p, const char *end, Money *out) {
+    const char *s = *p;
+    while (s < end && *s == ' ') {
+        s++;
+    }
+    bool negative = false;
+    if (s < end && (*s == '-' || *s == '+')) {
+        negative = (*s == '-');
+        s++;
+    }
+    bool digits = false;
+    int64_t units = 0;
+    while (s < end && *s >= '0' && *s <= '9') {
+        int digit = *s - '0';
+        if (units > (MONEY_MAX_UNITS - digit) / 10) {
+            return false;
+        }
+        units = units * 10 + digit;
+        digits = true;
+        s++;
+    }
+    int64_t fraction = 0;
+    if (s < end && *s == '.') {
+        s++;
+        int place = 0;
+        while (s < end && *s >= '0' && *s <= '9') {
+            if (place < 2) {
+                fraction = fraction * 10 + (*s - '0');
+            } else if (place == 2 && *s >= '5') {
+                fraction++; // round on the first dropped digit
+            }
+            place++;
+            digits = true;
+            s++;
+        }
+        if (place == 1) {
+            fraction *= 10;
+        }
+    }
+    if (!digits) {
+        return false;
+    }
+    Money value = units * MONEY_SCALE + fraction;
+    *out = negative ? -value : value;
+    *p = s;
+    return true;
+}
+
+// Whole-string parse; surrounding blanks (and a trailing newline) allowed
+bool moneyParseText(const char *text, Money *out) {
+    const char *end = text + strlen(text);
+    if (!moneyParse(&text, end, out)) {
+        return false;
+    }
+    while (text < end && (*text == ' ' || *text == '\t' || *text == '\r' || *text == '\n')) {
+        text++;
+    }
+    return text == end;
+}
+
+// Write the amount as text with two decimals ("-1500.05"); returns the length
+int moneyFormat(Money amount, char *out) {
+    char digits[24];
+    int n = 0;
+    // Work with the negative magnitude so INT64_MIN needs no special case
+    int64_t v = amount < 0 ? amount : -amount;
+    do {
+        digits[n++] = (char)('0' - v % 10);
+        v /= 10;
+    } while (v < 0 || n < 3);
+
+    int length = 0;
+    if (amount < 0) {
+        out[length++] = '-';
+    }
+    while (n > 2) {
+        out[length++] = digits[--n];
+    }
+    out[length++] = '.';
+    out[length++] = digits[1];
+    out[length++] = digits[0];
+    out[length] = '\0';
+    return length;
+}
+
+// moneyFormat for use inside printf: returns `out`
+const char *moneyText(Money amount, char *out) {
+    moneyFormat(amount, out);
+    return out;
+}
+
+// Nearest amount to a floating-point value (old float records, JSON
+// numbers). False for NaN, infinities and values too large to hold: only
+// values strictly inside +-MONEY_MAX_UNITS are scaled, so the cast stays
+// in range.
+bool moneyFromDouble(double value, Money *out) {
+    if (!(value > -(double)MONEY_MAX_UNITS && value < (double)MONEY_MAX_UNITS)) {
+        return false;
+    }
+    double scaled = value * MONEY_SCALE;
+    *out = (Money)(scaled < 0 ? scaled - 0.5 : scaled + 0.5);
+    return true;
+}
@@ -0,0 +1,20 @@
+#ifndef MONEY_H
+#define MONEY_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define MONEY_SCALE 100             // minor units (paise) per rupee
+#define MONEY_TEXT_SIZE 24          // longest formatted amount plus the NUL
+
+// An amount in minor units. Sums and differences are exact, and parsing
+// then formatting gives back the same two-decimal text.
+typedef int64_t Money;
+
+bool moneyParse(const char **p, const char *end, Money *out);
+bool moneyParseText(const char *text, Money *out);
+int moneyFormat(Money amount, char *out);
+const char *moneyText(Money amount, char *out);
+bool moneyFromDouble(double value, Money *out);
+
+#endif
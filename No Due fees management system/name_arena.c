@@ -0,0 +1,196 @@
+#include <stdlib.h>
+#include <string.h>
+#include "name_arena.h"
+
+#define NAME_TABLE_MIN_CAPACITY 64
+
+void nameArenaInit(NameArena *arena) {
+    arena->blocks = NULL;
+    arena->blockCount = 0;
+    arena->blockCapacity = 0;
+    arena->borrowedBlocks = 0;
+    arena->used = 0;
+    arena->table = NULL;
+    arena->tableCapacity = 0;
+    arena->tableCount = 0;
+    arena->tableStale = false;
+}
+
+void nameArenaFree(NameArena *arena) {
+    for (int i = arena->borrowedBlocks; i < arena->blockCount; i++) {
+        free(arena->blocks[i]);
+    }
+    free(arena->blocks);
+    free(arena->table);
+    nameArenaInit(arena);
+}
+
+// FNV-1a over the name's bytes
+static uint32_t nameHash(const char *name, size_t length) {
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < length; i++) {
+        h = (h ^ (unsigned char)name[i]) * 16777619u;
+    }
+    return h;
+}
+
+// Append a zeroed block; the zero tail marks where a block's names end
+static bool addBlock(NameArena *arena) {
+    if (arena->blockCount == arena->blockCapacity) {
+        int capacity = arena->blockCapacity ? arena->blockCapacity * 2 : 8;
+        char **blocks = realloc(arena->blocks, sizeof(char *) * (size_t)capacity);
+        if (blocks == NULL) {
+            return false;
+        }
+        arena->blocks = blocks;
+        arena->blockCapacity = capacity;
+    }
+    char *block = calloc(1, NAME_BLOCK_SIZE);
+    if (block == NULL) {
+        return false;
+    }
+    arena->blocks[arena->blockCount++] = block;
+    return true;
+}
+
+// Slot holding `name`, or the empty slot where it belongs
+static uint32_t *findSlot(const NameArena *arena, const char *name, size_t length, uint32_t hash) {
+    uint32_t mask = arena->tableCapacity - 1;
+    uint32_t pos = hash & mask;
+    for (;;) {
+        uint32_t *slot = &arena->table[pos];
+        if (*slot == 0) {
+            return slot;
+        }
+        const char *stored = nameArenaGet(arena, *slot - 1);
+        if (memcmp(stored, name, length) == 0 && stored[length] == '\0') {
+            return slot;
+        }
+        pos = (pos + 1) & mask;
+    }
+}
+
+// Keep the table at most half full
+static bool growTable(NameArena *arena) {
+    if ((arena->tableCount + 1) * 2 <= arena->tableCapacity) {
+        return true;
+    }
+    uint32_t capacity = arena->tableCapacity ? arena->tableCapacity * 2 : NAME_TABLE_MIN_CAPACITY;
+    uint32_t *old = arena->table;
+    uint32_t oldCapacity = arena->tableCapacity;
+    arena->table = calloc(capacity, sizeof(uint32_t));
+    if (arena->table == NULL) {
+        arena->table = old;
+        return false;
+    }
+    arena->tableCapacity = capacity;
+    for (uint32_t i = 0; i < oldCapacity; i++) {
+        if (old[i] != 0) {
+            const char *name = nameArenaGet(arena, old[i] - 1);
+            size_t length = strlen(name);
+            *findSlot(arena, name, length, nameHash(name, length)) = old[i];
+        }
+    }
+    free(old);
+    return true;
+}
+
+// Index names that were attached rather than interned: walk each block's
+// names up to its zero tail
+static bool indexAttachedNames(NameArena *arena) {
+    for (int b = 0; b < arena->blockCount; b++) {
+        const char *block = arena->blocks[b];
+        uint32_t base = (uint32_t)b << NAME_BLOCK_SHIFT;
+        uint32_t end = arena->used - base < NAME_BLOCK_SIZE ? arena->used - base : NAME_BLOCK_SIZE;
+        uint32_t pos = b == 0 ? 1 : 0;
+        while (pos < end && block[pos] != '\0') {
+            size_t length = strlen(block + pos);
+            if (!growTable(arena)) {
+                return false;
+            }
+            uint32_t *slot = findSlot(arena, block + pos, length, nameHash(block + pos, length));
+            if (*slot == 0) {
+                *slot = base + pos + 1;
+                arena->tableCount++;
+            }
+            pos += (uint32_t)length + 1;
+        }
+    }
+    arena->tableStale = false;
+    return true;
+}
+
+// Offset of `name` (length bytes, no NUL needed), storing it if it is new;
+// NAME_NONE when out of memory or longer than a block
+uint32_t nameArenaIntern(NameArena *arena, const char *name, size_t length) {
+    if (length >= NAME_BLOCK_SIZE) {
+        return NAME_NONE;
+    }
+    if (arena->blockCount == 0) {
+        if (!addBlock(arena)) {
+            return NAME_NONE;
+        }
+        arena->used = 1; // offset 0: the empty name
+    }
+    if (length == 0) {
+        return 0;
+    }
+    if ((arena->tableStale && !indexAttachedNames(arena)) || !growTable(arena)) {
+        return NAME_NONE;
+    }
+    uint32_t *slot = findSlot(arena, name, length, nameHash(name, length));
+    if (*slot != 0) {
+        return *slot - 1;
+    }
+
+    uint32_t offset = arena->used;
+    if ((offset & NAME_BLOCK_MASK) + length + 1 > NAME_BLOCK_SIZE || (offset >> NAME_BLOCK_SHIFT) >= (uint32_t)arena->blockCount) {
+        offset = (uint32_t)arena->blockCount << NAME_BLOCK_SHIFT;
+        if (offset > UINT32_MAX - NAME_BLOCK_SIZE || !addBlock(arena)) {
+            return NAME_NONE;
+        }
+    }
+    char *text = arena->blocks[offset >> NAME_BLOCK_SHIFT] + (offset & NAME_BLOCK_MASK);
+    memcpy(text, name, length);
+    text[length] = '\0';
+    arena->used = offset + (uint32_t)length + 1;
+    *slot = offset + 1;
+    arena->tableCount++;
+    return offset;
+}
+
+// Serve names straight from external memory (e.g. a mapped snapshot) laid
+// out exactly as the arena's blocks, `size` being its used offset. Full
+// blocks are borrowed; the trailing partial block is copied so names can
+// still be added. The caller keeps the memory alive until nameArenaFree().
+bool nameArenaAttach(NameArena *arena, char *data, uint32_t size) {
+    if (arena->blockCount != 0) {
+        return false;
+    }
+    uint32_t fullBlocks = size >> NAME_BLOCK_SHIFT;
+    uint32_t remainder = size & NAME_BLOCK_MASK;
+    arena->blocks = malloc(sizeof(char *) * ((size_t)fullBlocks + 8));
+    if (arena->blocks == NULL) {
+        return false;
+    }
+    arena->blockCapacity = (int)fullBlocks + 8;
+    for (uint32_t i = 0; i < fullBlocks; i++) {
+        arena->blocks[i] = data + (size_t)i * NAME_BLOCK_SIZE;
+    }
+    arena->blockCount = (int)fullBlocks;
+    arena->borrowedBlocks = (int)fullBlocks;
+    if (remainder > 0) {
+        if (!addBlock(arena)) {
+            return false;
+        }
+        memcpy(arena->blocks[fullBlocks], data + (size_t)fullBlocks * NAME_BLOCK_SIZE, remainder);
+    }
+    arena->used = size;
+    arena->tableStale = size > 0;
+    return true;
+}
+
+// Bytes the arena holds: blocks (borrowed ones included) plus the table
+size_t nameArenaMemory(const NameArena *arena) {
+    return (size_t)arena->blockCount * NAME_BLOCK_SIZE + (size_t)arena->tableCapacity * sizeof(uint32_t);
+}
@@ -0,0 +1,44 @@
+#ifndef NAME_ARENA_H
+#define NAME_ARENA_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Names are packed into blocks of NAME_BLOCK_SIZE bytes and referred to by
+// offset (block << NAME_BLOCK_SHIFT | position in the block)
+#define NAME_BLOCK_SHIFT 16
+#define NAME_BLOCK_SIZE (1u << NAME_BLOCK_SHIFT)
+#define NAME_BLOCK_MASK (NAME_BLOCK_SIZE - 1)
+#define NAME_NONE UINT32_MAX    // returned when a name could not be stored
+
+// Interned string arena: every distinct name is stored once, NUL-terminated,
+// and never spans two blocks. Blocks never move, so a name pointer stays
+// valid while the arena grows. Offset 0 is the empty name. Names are only
+// added, never removed; replacing one leaves the old text behind until the
+// owner is rebuilt.
+//
+// Not thread-safe: readers may share an arena nobody is adding to.
+typedef struct {
+    char **blocks;
+    int blockCount;
+    int blockCapacity;
+    int borrowedBlocks;     // leading blocks that point into external memory
+    uint32_t used;          // offset where the next name goes
+    uint32_t *table;        // open addressing: name offset + 1, 0 = empty slot
+    uint32_t tableCapacity; // 0 or a power of two
+    uint32_t tableCount;
+    bool tableStale;        // attached names are not in the table yet
+} NameArena;
+
+void nameArenaInit(NameArena *arena);
+void nameArenaFree(NameArena *arena);
+uint32_t nameArenaIntern(NameArena *arena, const char *name, size_t length);
+bool nameArenaAttach(NameArena *arena, char *data, uint32_t size);
+size_t nameArenaMemory(const NameArena *arena);
+
+static inline const char *nameArenaGet(const NameArena *arena, uint32_t offset) {
+    return arena->blocks[offset >> NAME_BLOCK_SHIFT] + (offset & NAME_BLOCK_MASK);
+}
+
+#endif
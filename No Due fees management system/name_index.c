@@ -0,0 +1,670 @@
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "name_index.h"
+
+#define MAX_NAME_WORDS (MAX_NAME_LENGTH / 2)
+#define WORD_TABLE_MIN_SLOTS 1024
+
+typedef struct {
+    int start;
+    int length;
+} WordSpan;
+
+// Record position found by a search, with its fuzzy distance (0 otherwise)
+typedef struct {
+    int position;
+    int distance;
+} NameHit;
+
+// Growable int list used while searching
+typedef struct {
+    int *items;
+    int count;
+    int capacity;
+} IntList;
+
+// Distinct-word table used while building
+typedef struct {
+    char *text;
+    int textUsed;
+    int textCapacity;
+    int *offsets;
+    int *lengths;
+    int count;
+    int capacity;
+    int *slots;             // hash slot -> word id, -1 = empty
+    int slotCount;
+} WordTable;
+
+typedef struct {
+    const char *word;
+    int id;
+} SortedWord;
+
+// Lowercase a name and split it into words (runs of letters and digits)
+static int splitWords(const char *name, char *lower, WordSpan *words) {
+    int length = 0;
+    while (length < MAX_NAME_LENGTH - 1 && name[length] != '\0') {
+        lower[length] = (char)tolower((unsigned char)name[length]);
+        length++;
+    }
+    lower[length] = '\0';
+
+    int count = 0;
+    int i = 0;
+    while (i < length) {
+        while (i < length && !isalnum((unsigned char)lower[i])) {
+            i++;
+        }
+        int start = i;
+        while (i < length && isalnum((unsigned char)lower[i])) {
+            i++;
+        }
+        if (i > start && count < MAX_NAME_WORDS) {
+            words[count].start = start;
+            words[count].length = i - start;
+            count++;
+        }
+    }
+    return count;
+}
+
+static bool intListPush(IntList *list, int value) {
+    if (list->count == list->capacity) {
+        int newCapacity = list->capacity ? list->capacity * 2 : 256;
+        int *items = realloc(list->items, sizeof(int) * newCapacity);
+        if (items == NULL) {
+            return false;
+        }
+        list->items = items;
+        list->capacity = newCapacity;
+    }
+    list->items[list->count++] = value;
+    return true;
+}
+
+static uint32_t hashWord(const char *word, int length) {
+    uint32_t hash = 2166136261u;
+    for (int i = 0; i < length; i++) {
+        hash = (hash ^ (unsigned char)word[i]) * 16777619u;
+    }
+    return hash;
+}
+
+static bool growWordSlots(WordTable *table) {
+    int slotCount = table->slotCount ? table->slotCount * 2 : WORD_TABLE_MIN_SLOTS;
+    int *slots = malloc(sizeof(int) * slotCount);
+    if (slots == NULL) {
+        return false;
+    }
+    memset(slots, -1, sizeof(int) * slotCount);
+    for (int id = 0; id < table->count; id++) {
+        uint32_t pos = hashWord(table->text + table->offsets[id], table->lengths[id]) & (slotCount - 1);
+        while (slots[pos] != -1) {
+            pos = (pos + 1) & (slotCount - 1);
+        }
+        slots[pos] = id;
+    }
+    free(table->slots);
+    table->slots = slots;
+    table->slotCount = slotCount;
+    return true;
+}
+
+// Id of a word, adding it to the table if new; -1 when out of memory
+static int wordIdFor(WordTable *table, const char *word, int length) {
+    if ((table->count + 1) * 2 > table->slotCount && !growWordSlots(table)) {
+        return -1;
+    }
+    uint32_t mask = (uint32_t)table->slotCount - 1;
+    uint32_t pos = hashWord(word, length) & mask;
+    while (table->slots[pos] != -1) {
+        int id = table->slots[pos];
+        if (table->lengths[id] == length && memcmp(table->text + table->offsets[id], word, length) == 0) {
+            return id;
+        }
+        pos = (pos + 1) & mask;
+    }
+
+    if (table->count == table->capacity) {
+        int newCapacity = table->capacity ? table->capacity * 2 : 1024;
+        int *offsets = realloc(table->offsets, sizeof(int) * newCapacity);
+        if (offsets == NULL) {
+            return -1;
+        }
+        table->offsets = offsets;
+        int *lengths = realloc(table->lengths, sizeof(int) * newCapacity);
+        if (lengths == NULL) {
+            return -1;
+        }
+        table->lengths = lengths;
+        table->capacity = newCapacity;
+    }
+    if (table->textUsed + length + 1 > table->textCapacity) {
+        int newCapacity = table->textCapacity ? table->textCapacity * 2 : 16384;
+        while (newCapacity < table->textUsed + length + 1) {
+            newCapacity *= 2;
+        }
+        char *text = realloc(table->text, newCapacity);
+        if (text == NULL) {
+            return -1;
+        }
+        table->text = text;
+        table->textCapacity = newCapacity;
+    }
+    int id = table->count++;
+    table->offsets[id] = table->textUsed;
+    table->lengths[id] = length;
+    memcpy(table->text + table->textUsed, word, length);
+    table->text[table->textUsed + length] = '\0';
+    table->textUsed += length + 1;
+    table->slots[pos] = id;
+    return id;
+}
+
+static int compareSortedWords(const void *a, const void *b) {
+    return strcmp(((const SortedWord *)a)->word, ((const SortedWord *)b)->word);
+}
+
+static int compareUint64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+static int compareInt(const void *a, const void *b) {
+    int x = *(const int *)a;
+    int y = *(const int *)b;
+    return (x > y) - (x < y);
+}
+
+// One bit per letter (digits share the remaining bits)
+static uint32_t letterMask(const char *word, int length) {
+    uint32_t mask = 0;
+    for (int i = 0; i < length; i++) {
+        unsigned char c = (unsigned char)word[i];
+        mask |= 1u << (c >= 'a' && c <= 'z' ? c - 'a' : 26 + c % 6);
+    }
+    return mask;
+}
+
+static int bitCount(uint32_t mask) {
+    int count = 0;
+    for (; mask != 0; mask &= mask - 1) {
+        count++;
+    }
+    return count;
+}
+
+static uint32_t trigramAt(const char *word) {
+    return ((uint32_t)(unsigned char)word[0] << 16) | ((uint32_t)(unsigned char)word[1] << 8)
+        | (unsigned char)word[2];
+}
+
+void nameIndexInit(NameIndex *index) {
+    memset(index, 0, sizeof(*index));
+}
+
+void nameIndexFree(NameIndex *index) {
+    free(index->text);
+    free(index->wordOffsets);
+    free(index->wordLengths);
+    free(index->wordLetters);
+    free(index->postingStarts);
+    free(index->postings);
+    free(index->trigrams);
+    free(index->trigramStarts);
+    free(index->trigramWords);
+    nameIndexInit(index);
+}
+
+// Trigram -> word ids, built over the (small) distinct-word dictionary
+static bool buildTrigrams(NameIndex *index) {
+    size_t pairCount = 0;
+    for (int w = 0; w < index->wordCount; w++) {
+        size_t length = strlen(index->text + index->wordOffsets[w]);
+        pairCount += length >= 3 ? length - 2 : 0;
+    }
+    uint64_t *pairs = malloc(sizeof(uint64_t) * (pairCount ? pairCount : 1));
+    if (pairs == NULL) {
+        return false;
+    }
+    size_t used = 0;
+    for (int w = 0; w < index->wordCount; w++) {
+        const char *word = index->text + index->wordOffsets[w];
+        int length = (int)strlen(word);
+        for (int j = 0; j + 3 <= length; j++) {
+            pairs[used++] = ((uint64_t)trigramAt(word + j) << 32) | (uint32_t)w;
+        }
+    }
+    qsort(pairs, used, sizeof(uint64_t), compareUint64);
+
+    index->trigrams = malloc(sizeof(uint32_t) * (used ? used : 1));
+    index->trigramStarts = malloc(sizeof(int) * (used + 1));
+    index->trigramWords = malloc(sizeof(int) * (used ? used : 1));
+    if (index->trigrams == NULL || index->trigramStarts == NULL || index->trigramWords == NULL) {
+        free(pairs);
+        return false;
+    }
+    int words = 0;
+    index->trigramCount = 0;
+    for (size_t i = 0; i < used; i++) {
+        if (i > 0 && pairs[i] == pairs[i - 1]) {
+            continue; // same trigram twice in one word
+        }
+        uint32_t trigram = (uint32_t)(pairs[i] >> 32);
+        if (index->trigramCount == 0 || index->trigrams[index->trigramCount - 1] != trigram) {
+            index->trigrams[index->trigramCount] = trigram;
+            index->trigramStarts[index->trigramCount] = words;
+            index->trigramCount++;
+        }
+        index->trigramWords[words++] = (int)(uint32_t)pairs[i];
+    }
+    index->trigramStarts[index->trigramCount] = words;
+    free(pairs);
+    return true;
+}
+
+// Build the index over every record currently in the store
+bool nameIndexBuild(NameIndex *index, const StudentStore *store) {
+    nameIndexFree(index);
+
+    WordTable table;
+    memset(&table, 0, sizeof(table));
+    IntList pairWords = { NULL, 0, 0 };
+    IntList pairRecords = { NULL, 0, 0 };
+    SortedWord *sorted = NULL;
+    int *rank = NULL;
+    bool ok = true;
+
+    // Distinct words and (word, record) pairs, in record order
+    for (int i = 0; i < store->count && ok; i++) {
+        char lower[MAX_NAME_LENGTH];
+        WordSpan words[MAX_NAME_WORDS];
+        int wordCount = splitWords(storeName(store, storeAt(store, i)), lower, words);
+        int firstPair = pairWords.count;
+        for (int w = 0; w < wordCount && ok; w++) {
+            int id = wordIdFor(&table, lower + words[w].start, words[w].length);
+            ok = id >= 0;
+            bool repeated = false;
+            for (int p = firstPair; ok && p < pairWords.count; p++) {
+                repeated |= pairWords.items[p] == id;
+            }
+            if (ok && !repeated) {
+                ok = intListPush(&pairWords, id) && intListPush(&pairRecords, i);
+            }
+        }
+    }
+
+    // Number the words in sorted order
+    if (ok) {
+        sorted = malloc(sizeof(SortedWord) * (table.count ? table.count : 1));
+        rank = malloc(sizeof(int) * (table.count ? table.count : 1));
+        index->wordOffsets = malloc(sizeof(int) * (table.count ? table.count : 1));
+        index->wordLengths = malloc(table.count ? table.count : 1);
+        index->wordLetters = malloc(sizeof(uint32_t) * (table.count ? table.count : 1));
+        index->postingStarts = calloc((size_t)table.count + 1, sizeof(int));
+        index->postings = malloc(sizeof(int) * (pairWords.count ? pairWords.count : 1));
+        ok = sorted != NULL && rank != NULL && index->wordOffsets != NULL
+            && index->wordLengths != NULL && index->wordLetters != NULL
+            && index->postingStarts != NULL && index->postings != NULL;
+    }
+    if (ok) {
+        for (int id = 0; id < table.count; id++) {
+            sorted[id].word = table.text + table.offsets[id];
+            sorted[id].id = id;
+        }
+        qsort(sorted, table.count, sizeof(SortedWord), compareSortedWords);
+        for (int s = 0; s < table.count; s++) {
+            rank[sorted[s].id] = s;
+            index->wordOffsets[s] = table.offsets[sorted[s].id];
+            index->wordLengths[s] = (unsigned char)table.lengths[sorted[s].id];
+            index->wordLetters[s] = letterMask(sorted[s].word, table.lengths[sorted[s].id]);
+        }
+        index->wordCount = table.count;
+        index->text = table.text;
+        table.text = NULL;
+
+        // Postings grouped by word (counting sort keeps records ascending)
+        for (int p = 0; p < pairWords.count; p++) {
+            index->postingStarts[rank[pairWords.items[p]] + 1]++;
+        }
+        for (int w = 0; w < index->wordCount; w++) {
+            index->postingStarts[w + 1] += index->postingStarts[w];
+        }
+        int *fill = rank; // reuse: next free posting per word
+        for (int p = 0; p < pairWords.count; p++) {
+            pairWords.items[p] = rank[pairWords.items[p]];
+        }
+        memcpy(fill, index->postingStarts, sizeof(int) * index->wordCount);
+        for (int p = 0; p < pairWords.count; p++) {
+            index->postings[fill[pairWords.items[p]]++] = pairRecords.items[p];
+        }
+        ok = buildTrigrams(index);
+    }
+
+    free(table.text);
+    free(table.offsets);
+    free(table.lengths);
+    free(table.slots);
+    free(pairWords.items);
+    free(pairRecords.items);
+    free(sorted);
+    free(rank);
+    if (!ok) {
+        nameIndexFree(index);
+        return false;
+    }
+    index->indexedCount = store->count;
+    index->built = true;
+    return true;
+}
+
+// Optimal string alignment distance (adjacent swaps count as one edit),
+// giving up with limit + 1 as soon as the distance must exceed limit
+int nameEditDistance(const char *a, int lengthA, const char *b, int lengthB, int limit) {
+    if (abs(lengthA - lengthB) > limit) {
+        return limit + 1;
+    }
+    int rows[3][MAX_NAME_LENGTH + 1];
+    int *before = rows[0];
+    int *previous = rows[1];
+    int *current = rows[2];
+    for (int j = 0; j <= lengthB; j++) {
+        previous[j] = j;
+    }
+    for (int i = 1; i <= lengthA; i++) {
+        current[0] = i;
+        int rowMin = i;
+        for (int j = 1; j <= lengthB; j++) {
+            int cost = a[i - 1] != b[j - 1];
+            int best = previous[j - 1] + cost;
+            if (previous[j] + 1 < best) {
+                best = previous[j] + 1;
+            }
+            if (current[j - 1] + 1 < best) {
+                best = current[j - 1] + 1;
+            }
+            if (i > 1 && j > 1 && a[i - 1] == b[j - 2] && a[i - 2] == b[j - 1] && before[j - 2] + 1 < best) {
+                best = before[j - 2] + 1;
+            }
+            current[j] = best;
+            if (best < rowMin) {
+                rowMin = best;
+            }
+        }
+        if (rowMin > limit) {
+            return limit + 1;
+        }
+        int *spare = before;
+        before = previous;
+        previous = current;
+        current = spare;
+    }
+    return previous[lengthB] <= limit ? previous[lengthB] : limit + 1;
+}
+
+// Edits tolerated for a query word of this length
+static int fuzzyLimit(int length) {
+    return length <= 3 ? 0 : (length <= 7 ? 1 : 2);
+}
+
+// How well a lowercase name matches the query: the fuzzy distance, 0 for
+// a prefix/substring match, or -1 for no match
+static int matchName(const char *lower, const WordSpan *words, int wordCount,
+                     const char *query, const WordSpan *queryWords, int queryCount, NameSearchMode mode) {
+    if (mode == NAME_SEARCH_SUBSTRING) {
+        return strstr(lower, query) != NULL ? 0 : -1;
+    }
+    if (mode == NAME_SEARCH_PREFIX) {
+        for (const char *hit = strstr(lower, query); hit != NULL; hit = strstr(hit + 1, query)) {
+            if (hit == lower || !isalnum((unsigned char)hit[-1])) {
+                return 0;
+            }
+        }
+        return -1;
+    }
+    int total = 0;
+    for (int q = 0; q < queryCount; q++) {
+        int limit = fuzzyLimit(queryWords[q].length);
+        int best = limit + 1;
+        for (int w = 0; w < wordCount && best > 0; w++) {
+            int d = nameEditDistance(query + queryWords[q].start, queryWords[q].length,
+                                     lower + words[w].start, words[w].length, limit);
+            if (d < best) {
+                best = d;
+            }
+        }
+        if (best > limit) {
+            return -1;
+        }
+        total += best;
+    }
+    return total;
+}
+
+// First word id (ids are in sorted order) whose first `length` characters
+// are >= piece, or > piece when pastPrefix is set
+static int lowerBound(const NameIndex *index, const char *piece, int length, bool pastPrefix) {
+    int lo = 0;
+    int hi = index->wordCount;
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        int order = strncmp(index->text + index->wordOffsets[mid], piece, length);
+        if (order < 0 || (pastPrefix && order == 0)) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+typedef enum {
+    WORD_EXACT,
+    WORD_PREFIX,
+    WORD_CONTAINS,
+    WORD_FUZZY
+} WordMatch;
+
+// Dictionary words matching one query word
+static bool findWords(const NameIndex *index, const char *piece, int length, WordMatch match, IntList *out) {
+    out->count = 0;
+    if (match == WORD_EXACT || match == WORD_PREFIX) {
+        int first = lowerBound(index, piece, length, false);
+        int last = lowerBound(index, piece, length, true);
+        for (int w = first; w < last; w++) {
+            if (match == WORD_PREFIX || index->text[index->wordOffsets[w] + length] == '\0') {
+                if (!intListPush(out, w)) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+    if (match == WORD_CONTAINS && length >= 3) {
+        // Candidates from the query's rarest trigram, then verified
+        int bestStart = 0;
+        int bestEnd = -1;
+        for (int j = 0; j + 3 <= length; j++) {
+            uint32_t trigram = trigramAt(piece + j);
+            int lo = 0;
+            int hi = index->trigramCount;
+            while (lo < hi) {
+                int mid = lo + (hi - lo) / 2;
+                if (index->trigrams[mid] < trigram) {
+                    lo = mid + 1;
+                } else {
+                    hi = mid;
+                }
+            }
+            if (lo == index->trigramCount || index->trigrams[lo] != trigram) {
+                return true; // some trigram occurs in no word
+            }
+            int start = index->trigramStarts[lo];
+            int end = index->trigramStarts[lo + 1];
+            if (bestEnd < 0 || end - start < bestEnd - bestStart) {
+                bestStart = start;
+                bestEnd = end;
+            }
+        }
+        char needle[MAX_NAME_LENGTH];
+        memcpy(needle, piece, length);
+        needle[length] = '\0';
+        for (int i = bestStart; i < bestEnd; i++) {
+            int w = index->trigramWords[i];
+            if (strstr(index->text + index->wordOffsets[w], needle) != NULL && !intListPush(out, w)) {
+                return false;
+            }
+        }
+        return true;
+    }
+    // Short substrings and fuzzy matches: check every distinct word. For
+    // fuzzy, words whose length or letter set differ by more than the
+    // allowed edits are skipped before computing the distance.
+    char needle[MAX_NAME_LENGTH];
+    memcpy(needle, piece, length);
+    needle[length] = '\0';
+    int limit = fuzzyLimit(length);
+    uint32_t letters = letterMask(piece, length);
+    for (int w = 0; w < index->wordCount; w++) {
+        const char *word = index->text + index->wordOffsets[w];
+        bool hit;
+        if (match == WORD_CONTAINS) {
+            hit = strstr(word, needle) != NULL;
+        } else {
+            int wordLength = index->wordLengths[w];
+            hit = abs(wordLength - length) <= limit
+                && bitCount(letters & ~index->wordLetters[w]) <= limit
+                && bitCount(index->wordLetters[w] & ~letters) <= limit
+                && nameEditDistance(needle, length, word, wordLength, limit) <= limit;
+        }
+        if (hit && !intListPush(out, w)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static int compareHits(const void *a, const void *b) {
+    const NameHit *x = a;
+    const NameHit *y = b;
+    if (x->distance != y->distance) {
+        return x->distance - y->distance;
+    }
+    return (x->position > y->position) - (x->position < y->position);
+}
+
+// Search names case-insensitively. Prefix and substring results are in
+// store order; fuzzy results are closest first.
+bool nameIndexSearch(NameIndex *index, const StudentStore *store, const char *query,
+                     NameSearchMode mode, ListResult *result) {
+    result->rows = NULL;
+    result->count = 0;
+    result->store = store;
+    if (!index->built || index->indexedCount > store->count
+            || store->count - index->indexedCount > NAME_INDEX_TAIL_LIMIT) {
+        if (!nameIndexBuild(index, store)) {
+            return false;
+        }
+    }
+
+    char lowerQuery[MAX_NAME_LENGTH];
+    WordSpan queryWords[MAX_NAME_WORDS];
+    int queryCount = splitWords(query, lowerQuery, queryWords);
+    if (queryCount == 0) {
+        return true;
+    }
+    if (mode != NAME_SEARCH_FUZZY) {
+        // Match the query text as typed (spaces and all), trimmed
+        char *start = lowerQuery + queryWords[0].start;
+        int length = queryWords[queryCount - 1].start + queryWords[queryCount - 1].length - queryWords[0].start;
+        memmove(lowerQuery, start, length);
+        lowerQuery[length] = '\0';
+        for (int q = queryCount - 1; q >= 0; q--) {
+            queryWords[q].start -= queryWords[0].start;
+        }
+    }
+
+    // Candidate records come from the query word matching the fewest records
+    IntList words = { NULL, 0, 0 };
+    IntList bestWords = { NULL, 0, 0 };
+    long bestPostings = -1;
+    bool ok = true;
+    for (int q = 0; q < queryCount && ok; q++) {
+        WordMatch match = WORD_FUZZY;
+        if (mode == NAME_SEARCH_PREFIX) {
+            match = q == queryCount - 1 ? WORD_PREFIX : WORD_EXACT;
+        } else if (mode == NAME_SEARCH_SUBSTRING) {
+            match = queryCount == 1 || q == 0 ? WORD_CONTAINS : (q == queryCount - 1 ? WORD_PREFIX : WORD_EXACT);
+        }
+        ok = findWords(index, lowerQuery + queryWords[q].start, queryWords[q].length, match, &words);
+        long postings = 0;
+        for (int i = 0; ok && i < words.count; i++) {
+            postings += index->postingStarts[words.items[i] + 1] - index->postingStarts[words.items[i]];
+        }
+        if (ok && (bestPostings < 0 || postings < bestPostings)) {
+            IntList swap = bestWords;
+            bestWords = words;
+            words = swap;
+            bestPostings = postings;
+        }
+    }
+
+    IntList candidates = { NULL, 0, 0 };
+    for (int i = 0; ok && i < bestWords.count; i++) {
+        int w = bestWords.items[i];
+        for (int p = index->postingStarts[w]; ok && p < index->postingStarts[w + 1]; p++) {
+            ok = intListPush(&candidates, index->postings[p]);
+        }
+    }
+    if (ok && bestWords.count > 1) {
+        qsort(candidates.items, candidates.count, sizeof(int), compareInt);
+    }
+    // Records added since the build are checked directly
+    for (int i = index->indexedCount; ok && i < store->count; i++) {
+        ok = intListPush(&candidates, i);
+    }
+
+    // A single-word prefix or substring query is answered by the index alone
+    bool verify = queryCount > 1 || mode == NAME_SEARCH_FUZZY;
+    NameHit *hits = ok && candidates.count > 0 ? malloc(sizeof(NameHit) * candidates.count) : NULL;
+    int hitCount = 0;
+    ok = ok && (candidates.count == 0 || hits != NULL);
+    for (int i = 0; ok && i < candidates.count; i++) {
+        int position = candidates.items[i];
+        if (i > 0 && position == candidates.items[i - 1]) {
+            continue;
+        }
+        int distance = 0;
+        if (verify || position >= index->indexedCount) {
+            char lower[MAX_NAME_LENGTH];
+            WordSpan nameWords[MAX_NAME_WORDS];
+            int nameCount = splitWords(storeName(store, storeAt(store, position)), lower, nameWords);
+            distance = matchName(lower, nameWords, nameCount, lowerQuery, queryWords, queryCount, mode);
+        }
+        if (distance >= 0) {
+            hits[hitCount].position = position;
+            hits[hitCount].distance = distance;
+            hitCount++;
+        }
+    }
+    if (ok && mode == NAME_SEARCH_FUZZY) {
+        qsort(hits, hitCount, sizeof(NameHit), compareHits);
+    }
+    if (ok && hitCount > 0) {
+        result->rows = malloc(sizeof(const Student *) * hitCount);
+        ok = result->rows != NULL;
+        for (int i = 0; ok && i < hitCount; i++) {
+            result->rows[i] = storeAt(store, hits[i].position);
+        }
+        result->count = ok ? hitCount : 0;
+    }
+
+    free(hits);
+    free(candidates.items);
+    free(words.items);
+    free(bestWords.items);
+    return ok;
+}
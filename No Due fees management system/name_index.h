@@ -0,0 +1,46 @@
+#ifndef NAME_INDEX_H
+#define NAME_INDEX_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "student_store.h"
+#include "student_list.h"
+
+// Records added after the last build are checked one by one; past this many
+// the index is rebuilt on the next search
+#define NAME_INDEX_TAIL_LIMIT 4096
+
+typedef enum {
+    NAME_SEARCH_PREFIX,     // a word of the name starts with the query ("sax" finds "ashish saxsena")
+    NAME_SEARCH_SUBSTRING,  // the name contains the query anywhere
+    NAME_SEARCH_FUZZY       // every query word is within a small edit distance of a name word
+} NameSearchMode;
+
+// Case-insensitive word index over Student.name: the distinct lowercase
+// words in sorted order (binary search for prefixes), the records holding
+// each word, and a trigram index over the words for substring and fuzzy
+// candidate lookups. Built lazily on the first search.
+typedef struct {
+    char *text;             // distinct words, NUL-terminated, back to back
+    int *wordOffsets;       // word id -> offset in text; ids follow sorted order
+    int wordCount;
+    unsigned char *wordLengths;
+    uint32_t *wordLetters;  // bit per letter/digit class present, for fuzzy filtering
+    int *postingStarts;     // word id -> first entry in postings (wordCount + 1 entries)
+    int *postings;          // record positions, ascending within each word
+    uint32_t *trigrams;     // distinct trigrams, ascending
+    int *trigramStarts;     // trigramCount + 1 entries
+    int *trigramWords;      // word ids containing each trigram
+    int trigramCount;
+    int indexedCount;       // records [0, indexedCount) are indexed
+    bool built;
+} NameIndex;
+
+void nameIndexInit(NameIndex *index);
+void nameIndexFree(NameIndex *index);
+bool nameIndexBuild(NameIndex *index, const StudentStore *store);
+bool nameIndexSearch(NameIndex *index, const StudentStore *store, const char *query,
+                     NameSearchMode mode, ListResult *result);
+int nameEditDistance(const char *a, int lengthA, const char *b, int lengthB, int limit);
+
+#endif
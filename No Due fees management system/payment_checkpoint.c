@@ -0,0 +1,283 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "payment_checkpoint.h"
+#include "snapshot.h"
+#include "file_util.h"
+
+#define PAYMENT_KEYS_MIN_CAPACITY 1024
+#define PAYMENT_CHECKPOINT_SEED 0x50415943ULL
+
+// On-disk header of PAYMENT_CHECKPOINT_FILENAME, followed by updateCount
+// PaymentUpdate records. The keys live in PAYMENT_KEYS_FILENAME, which is
+// only ever appended to; keyCount says how many of them are committed.
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t updateCount;
+    uint64_t offset;
+    uint64_t lines;
+    uint64_t tailHash;
+    uint64_t keyCount;
+    uint64_t checksum;              // over the header before this field and the updates
+} PaymentCheckpointHeader;
+
+static size_t keySlot(uint64_t key, size_t mask) {
+    key ^= key >> 33;
+    key *= 0xFF51AFD7ED558CCDULL;
+    key ^= key >> 33;
+    return (size_t)key & mask;
+}
+
+void paymentKeySetInit(PaymentKeySet *set) {
+    memset(set, 0, sizeof(*set));
+}
+
+void paymentKeySetFree(PaymentKeySet *set) {
+    free(set->slots);
+    free(set->unsaved);
+    paymentKeySetInit(set);
+}
+
+bool paymentKeySetContains(const PaymentKeySet *set, uint64_t key) {
+    if (set->capacity == 0) {
+        return false;
+    }
+    size_t mask = set->capacity - 1;
+    for (size_t pos = keySlot(key, mask); set->slots[pos] != 0; pos = (pos + 1) & mask) {
+        if (set->slots[pos] == key) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool growKeySet(PaymentKeySet *set) {
+    size_t newCapacity = set->capacity ? set->capacity * 2 : PAYMENT_KEYS_MIN_CAPACITY;
+    uint64_t *slots = calloc(newCapacity, sizeof(uint64_t));
+    if (slots == NULL) {
+        return false;
+    }
+    for (size_t i = 0; i < set->capacity; i++) {
+        uint64_t key = set->slots[i];
+        if (key != 0) {
+            size_t pos = keySlot(key, newCapacity - 1);
+            while (slots[pos] != 0) {
+                pos = (pos + 1) & (newCapacity - 1);
+            }
+            slots[pos] = key;
+        }
+    }
+    free(set->slots);
+    set->slots = slots;
+    set->capacity = newCapacity;
+    return true;
+}
+
+static bool insertKey(PaymentKeySet *set, uint64_t key, bool *added) {
+    *added = false;
+    if ((set->count + 1) * 10 > set->capacity * 7 && !growKeySet(set)) {
+        return false;
+    }
+    size_t mask = set->capacity - 1;
+    size_t pos = keySlot(key, mask);
+    while (set->slots[pos] != 0) {
+        if (set->slots[pos] == key) {
+            return true;
+        }
+        pos = (pos + 1) & mask;
+    }
+    set->slots[pos] = key;
+    set->count++;
+    *added = true;
+    return true;
+}
+
+// Add a key and remember it for the next paymentKeysAppend.
+// Returns 1 if added, 0 if it was already present, -1 when out of memory.
+int paymentKeySetInsert(PaymentKeySet *set, uint64_t key) {
+    if (set->unsavedCount == set->unsavedCapacity) {
+        size_t newCapacity = set->unsavedCapacity ? set->unsavedCapacity * 2 : PAYMENT_KEYS_MIN_CAPACITY;
+        uint64_t *unsaved = realloc(set->unsaved, sizeof(uint64_t) * newCapacity);
+        if (unsaved == NULL) {
+            return -1;
+        }
+        set->unsaved = unsaved;
+        set->unsavedCapacity = newCapacity;
+    }
+    bool added;
+    if (!insertKey(set, key, &added)) {
+        return -1;
+    }
+    if (added) {
+        set->unsaved[set->unsavedCount++] = key;
+    }
+    return added ? 1 : 0;
+}
+
+// Fingerprint of the log just before offset, so a rewritten or truncated
+// log is noticed without rereading everything already applied
+uint64_t paymentTailHash(const char *data, uint64_t offset) {
+    uint64_t start = offset > PAYMENT_TAIL_BYTES ? offset - PAYMENT_TAIL_BYTES : 0;
+    return snapshotChecksum(PAYMENT_CHECKPOINT_SEED, data + start, (size_t)(offset - start));
+}
+
+void paymentCheckpointInit(PaymentCheckpoint *checkpoint) {
+    checkpoint->offset = 0;
+    checkpoint->lines = 0;
+    checkpoint->tailHash = paymentTailHash(NULL, 0);
+    paymentKeySetInit(&checkpoint->keys);
+    checkpoint->updates = NULL;
+    checkpoint->updateCount = 0;
+}
+
+void paymentCheckpointFree(PaymentCheckpoint *checkpoint) {
+    paymentKeySetFree(&checkpoint->keys);
+    free(checkpoint->updates);
+    paymentCheckpointInit(checkpoint);
+}
+
+// Update layout of version-1 checkpoints
+typedef struct {
+    int rollNumber;
+    float feesDue;
+    float hostelDue;
+} PaymentUpdateV1;
+
+static uint64_t headerChecksum(const PaymentCheckpointHeader *header, const void *updates, size_t updateSize) {
+    uint64_t hash = snapshotChecksum(PAYMENT_CHECKPOINT_SEED, header, offsetof(PaymentCheckpointHeader, checksum));
+    return snapshotChecksum(hash, updates, updateSize * header->updateCount);
+}
+
+// Read the committed keys (extra keys from an interrupted run are cut off)
+static bool loadKeys(PaymentKeySet *set, const char *keysPath, uint64_t keyCount) {
+    FILE *file = fopen(keysPath, "r+b");
+    if (file == NULL) {
+        return keyCount == 0;
+    }
+    uint64_t block[1024];
+    uint64_t loaded = 0;
+    while (loaded < keyCount) {
+        size_t want = keyCount - loaded < 1024 ? (size_t)(keyCount - loaded) : 1024;
+        size_t got = fread(block, sizeof(uint64_t), want, file);
+        for (size_t i = 0; i < got; i++) {
+            bool added;
+            if (!insertKey(set, block[i], &added)) {
+                fclose(file);
+                return false;
+            }
+        }
+        loaded += got;
+        if (got < want) {
+            break;
+        }
+    }
+    bool ok = loaded == keyCount;
+    fseek(file, 0, SEEK_END);
+    if (ok && (uint64_t)ftell(file) > keyCount * sizeof(uint64_t)) {
+        ok = truncateFile(file, (long)(keyCount * sizeof(uint64_t)));
+    }
+    fclose(file);
+    return ok;
+}
+
+// Load the checkpoint and its key set. A missing checkpoint means nothing
+// has been reconciled yet; false means the files are unreadable or corrupt.
+bool paymentCheckpointLoad(PaymentCheckpoint *checkpoint, const char *path, const char *keysPath) {
+    paymentCheckpointFree(checkpoint);
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) {
+        return !fileExists(path);
+    }
+
+    PaymentCheckpointHeader header;
+    PaymentUpdate *updates = NULL;
+    void *stored = NULL;
+    bool ok = fread(&header, sizeof(header), 1, file) == 1
+        && memcmp(header.magic, PAYMENT_CHECKPOINT_MAGIC, sizeof(header.magic)) == 0
+        && (header.version == PAYMENT_CHECKPOINT_VERSION || header.version == 1);
+    size_t updateSize = ok && header.version == 1 ? sizeof(PaymentUpdateV1) : sizeof(PaymentUpdate);
+    if (ok && header.updateCount > 0) {
+        stored = malloc(updateSize * header.updateCount);
+        ok = stored != NULL && fread(stored, updateSize, header.updateCount, file) == header.updateCount;
+    }
+    fclose(file);
+    ok = ok && headerChecksum(&header, stored, updateSize) == header.checksum
+        && loadKeys(&checkpoint->keys, keysPath, header.keyCount);
+    if (ok && header.version == 1 && header.updateCount > 0) {
+        // Old float dues: convert to paise
+        updates = malloc(sizeof(PaymentUpdate) * header.updateCount);
+        const PaymentUpdateV1 *old = stored;
+        ok = updates != NULL;
+        for (uint32_t i = 0; ok && i < header.updateCount; i++) {
+            updates[i].rollNumber = old[i].rollNumber;
+            ok = moneyFromDouble(old[i].feesDue, &updates[i].feesDue)
+                && moneyFromDouble(old[i].hostelDue, &updates[i].hostelDue);
+        }
+        free(stored);
+    } else {
+        updates = stored;
+    }
+    if (!ok) {
+        free(updates);
+        paymentCheckpointFree(checkpoint);
+        return false;
+    }
+
+    checkpoint->offset = header.offset;
+    checkpoint->lines = header.lines;
+    checkpoint->tailHash = header.tailHash;
+    checkpoint->updates = updates;
+    checkpoint->updateCount = (int)header.updateCount;
+    return true;
+}
+
+// Make the keys added since the last call durable
+bool paymentKeysAppend(PaymentKeySet *set, const char *keysPath) {
+    if (set->unsavedCount == 0) {
+        return true;
+    }
+    FILE *file = fopen(keysPath, "ab");
+    if (file == NULL) {
+        return false;
+    }
+    bool ok = fwrite(set->unsaved, sizeof(uint64_t), set->unsavedCount, file) == set->unsavedCount
+        && flushAndSync(file);
+    fclose(file);
+    if (ok) {
+        set->unsavedCount = 0;
+    }
+    return ok;
+}
+
+// Atomically replace the checkpoint file (keys must already be appended)
+bool paymentCheckpointSave(const PaymentCheckpoint *checkpoint, const char *path) {
+    PaymentCheckpointHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, PAYMENT_CHECKPOINT_MAGIC, sizeof(header.magic));
+    header.version = PAYMENT_CHECKPOINT_VERSION;
+    header.updateCount = (uint32_t)checkpoint->updateCount;
+    header.offset = checkpoint->offset;
+    header.lines = checkpoint->lines;
+    header.tailHash = checkpoint->tailHash;
+    header.keyCount = checkpoint->keys.count - checkpoint->keys.unsavedCount;
+    header.checksum = headerChecksum(&header, checkpoint->updates, sizeof(PaymentUpdate));
+
+    char tempPath[512];
+    snprintf(tempPath, sizeof(tempPath), "%s.tmp", path);
+    FILE *file = fopen(tempPath, "wb");
+    if (file == NULL) {
+        return false;
+    }
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1
+        && (checkpoint->updateCount == 0
+            || fwrite(checkpoint->updates, sizeof(PaymentUpdate), checkpoint->updateCount, file)
+               == (size_t)checkpoint->updateCount)
+        && flushAndSync(file);
+    fclose(file);
+    if (!ok || !replaceFileAtomically(tempPath, path)) {
+        remove(tempPath);
+        return false;
+    }
+    return true;
+}
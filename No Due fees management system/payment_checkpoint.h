@@ -0,0 +1,55 @@
+#ifndef PAYMENT_CHECKPOINT_H
+#define PAYMENT_CHECKPOINT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "money.h"
+
+#define PAYMENT_CHECKPOINT_FILENAME "payment.checkpoint"
+#define PAYMENT_KEYS_FILENAME "payment.keys"
+#define PAYMENT_CHECKPOINT_MAGIC "NODUEPAY"
+#define PAYMENT_CHECKPOINT_VERSION 2   // 1 = dues stored as float
+#define PAYMENT_TAIL_BYTES 256      // bytes before the offset that fingerprint the log
+
+// Set of payment keys already applied (0 marks an empty slot, keys are never 0)
+typedef struct {
+    uint64_t *slots;
+    size_t capacity;
+    size_t count;
+    uint64_t *unsaved;              // keys added since the last paymentKeysAppend
+    size_t unsavedCount;
+    size_t unsavedCapacity;
+} PaymentKeySet;
+
+// Absolute dues a reconciliation run sets for one student
+typedef struct {
+    int rollNumber;
+    Money feesDue;
+    Money hostelDue;
+} PaymentUpdate;
+
+// How far payment_history.txt has been reconciled. While updates is
+// non-empty a run has been decided but not yet committed to the journal.
+typedef struct {
+    uint64_t offset;                // bytes of the log already applied
+    uint64_t lines;                 // lines before offset (for error messages)
+    uint64_t tailHash;              // hash of the PAYMENT_TAIL_BYTES before offset
+    PaymentKeySet keys;
+    PaymentUpdate *updates;
+    int updateCount;
+} PaymentCheckpoint;
+
+void paymentKeySetInit(PaymentKeySet *set);
+void paymentKeySetFree(PaymentKeySet *set);
+bool paymentKeySetContains(const PaymentKeySet *set, uint64_t key);
+int paymentKeySetInsert(PaymentKeySet *set, uint64_t key);
+uint64_t paymentTailHash(const char *data, uint64_t offset);
+
+void paymentCheckpointInit(PaymentCheckpoint *checkpoint);
+void paymentCheckpointFree(PaymentCheckpoint *checkpoint);
+bool paymentCheckpointLoad(PaymentCheckpoint *checkpoint, const char *path, const char *keysPath);
+bool paymentKeysAppend(PaymentKeySet *set, const char *keysPath);
+bool paymentCheckpointSave(const PaymentCheckpoint *checkpoint, const char *path);
+
+#endif
@@ -0,0 +1,585 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <pthread.h>
+#include "payment_ingest.h"
+#include "csv_loader.h"
+#include "file_util.h"
+#include "snapshot.h"
+#include "timing.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+// A malformed line remembered by a worker (line number relative to its chunk)
+typedef struct {
+    long line;
+    const char *reason;
+} PaymentError;
+
+// An accepted payment kept for the key check at merge time
+typedef struct {
+    uint64_t key;
+    int rollNumber;
+    PaymentCategory category;
+    Money amount;
+} PaymentEntry;
+
+// One worker's slice of the file and its private results
+typedef struct {
+    const char *begin;
+    const char *end;
+    const PaymentKeySet *seen;  // read-only while workers run; NULL = no de-duplication
+    PaymentTotals totals;
+    PaymentEntry *entries;      // accepted payments in file order (only with seen)
+    long entryCount;
+    long entryCapacity;
+    long lines;             // all lines in the chunk, blank ones included
+    long parsed;
+    long payments;
+    long malformed;
+    long undated;
+    long duplicates;
+    PaymentError errors[PAYMENT_MAX_REPORTED_ERRORS];
+    int errorCount;
+    bool outOfMemory;
+} PaymentChunk;
+
+void paymentTotalsInit(PaymentTotals *totals) {
+    totals->items = NULL;
+    totals->count = 0;
+    totals->capacity = 0;
+    rollMapInit(&totals->index);
+}
+
+void paymentTotalsFree(PaymentTotals *totals) {
+    free(totals->items);
+    rollMapFree(&totals->index);
+    paymentTotalsInit(totals);
+}
+
+// Find or create the running total for a roll number
+static PaymentTotal *totalFor(PaymentTotals *totals, int rollNumber) {
+    int pos = rollMapGet(&totals->index, rollNumber);
+    if (pos != -1) {
+        return &totals->items[pos];
+    }
+    if (totals->count == totals->capacity) {
+        int newCapacity = totals->capacity ? totals->capacity * 2 : 1024;
+        PaymentTotal *items = realloc(totals->items, sizeof(PaymentTotal) * newCapacity);
+        if (items == NULL) {
+            return NULL;
+        }
+        totals->items = items;
+        totals->capacity = newCapacity;
+    }
+    if (!rollMapPut(&totals->index, rollNumber, totals->count)) {
+        return NULL;
+    }
+    PaymentTotal *total = &totals->items[totals->count++];
+    memset(total, 0, sizeof(*total));
+    total->rollNumber = rollNumber;
+    return total;
+}
+
+static bool isLeapYear(int year) {
+    return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+}
+
+static int makeDate(int year, int month, int day) {
+    static const int daysInMonth[] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+    if (year < 100) {
+        year += 2000;
+    }
+    if (year < 1900 || year > 2100 || month < 1 || month > 12 || day < 1) {
+        return -1;
+    }
+    int maxDay = daysInMonth[month - 1] + (month == 2 && isLeapYear(year));
+    return day > maxDay ? -1 : year * 10000 + month * 100 + day;
+}
+
+// Normalize the date spellings found in the payment log to YYYYMMDD:
+//   03092025 (DDMMYYYY), 20250903 (YYYYMMDD), 8 4 2025 / 8/4/2025 / 8-4-2025
+//   (D M YYYY) and 2025-04-08 (YYYY M D). All-zero or empty dates mean
+//   "unknown" and give 0; anything else unparseable gives -1.
+int normalizePaymentDate(const char *text, size_t length) {
+    int groups[3];
+    int digits[3];
+    int groupCount = 0;
+    bool allZero = true;
+
+    size_t i = 0;
+    while (i < length) {
+        if (isdigit((unsigned char)text[i])) {
+            if (groupCount == 3) {
+                return -1;
+            }
+            int value = 0;
+            int n = 0;
+            while (i < length && isdigit((unsigned char)text[i])) {
+                if (n < 9) {
+                    value = value * 10 + (text[i] - '0');
+                }
+                allZero &= text[i] == '0';
+                n++;
+                i++;
+            }
+            groups[groupCount] = value;
+            digits[groupCount] = n;
+            groupCount++;
+        } else if (text[i] == ' ' || text[i] == '/' || text[i] == '-' || text[i] == '.') {
+            i++;
+        } else {
+            return -1;
+        }
+    }
+
+    if (groupCount == 0 || allZero) {
+        return 0;
+    }
+    if (groupCount == 1 && digits[0] == 8) {
+        int value = groups[0];
+        int tailYear = value % 10000;
+        if (tailYear >= 1900 && tailYear <= 2100) {
+            return makeDate(tailYear, (value / 10000) % 100, value / 1000000);
+        }
+        return makeDate(value / 10000, (value / 100) % 100, value % 100);
+    }
+    if (groupCount == 3) {
+        if (digits[0] == 4) {
+            return makeDate(groups[0], groups[1], groups[2]);
+        }
+        return makeDate(groups[2], groups[1], groups[0]);
+    }
+    return -1;
+}
+
+static bool equalsIgnoreCase(const char *text, size_t length, const char *word) {
+    if (strlen(word) != length) {
+        return false;
+    }
+    for (size_t i = 0; i < length; i++) {
+        if (tolower((unsigned char)text[i]) != word[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool parseCategory(const char *text, size_t length, PaymentCategory *out) {
+    while (length > 0 && isspace((unsigned char)text[length - 1])) {
+        length--;
+    }
+    while (length > 0 && isspace((unsigned char)*text)) {
+        text++;
+        length--;
+    }
+    if (equalsIgnoreCase(text, length, "both")) {
+        *out = PAYMENT_BOTH;
+    } else if (equalsIgnoreCase(text, length, "fees") || equalsIgnoreCase(text, length, "fee")) {
+        *out = PAYMENT_FEES;
+    } else if (equalsIgnoreCase(text, length, "hostel")) {
+        *out = PAYMENT_HOSTEL;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// Identity of a payment line, used to never credit the same payment twice
+uint64_t paymentKey(int rollNumber, int date, Money amount, PaymentCategory category) {
+    int64_t fields[4] = { rollNumber, date, amount, category };
+    uint64_t key = snapshotChecksum(0x5041594BULL, fields, sizeof(fields));
+    return key != 0 ? key : 1;
+}
+
+static bool rememberEntry(PaymentChunk *chunk, uint64_t key, int rollNumber, PaymentCategory category,
+                          Money amount) {
+    if (chunk->entryCount == chunk->entryCapacity) {
+        long newCapacity = chunk->entryCapacity ? chunk->entryCapacity * 2 : 1024;
+        PaymentEntry *entries = realloc(chunk->entries, sizeof(PaymentEntry) * newCapacity);
+        if (entries == NULL) {
+            return false;
+        }
+        chunk->entries = entries;
+        chunk->entryCapacity = newCapacity;
+    }
+    PaymentEntry *entry = &chunk->entries[chunk->entryCount++];
+    entry->key = key;
+    entry->rollNumber = rollNumber;
+    entry->category = category;
+    entry->amount = amount;
+    return true;
+}
+
+static void addToTotal(PaymentTotal *total, PaymentCategory category, Money amount) {
+    if (category == PAYMENT_FEES) {
+        total->fees += amount;
+    } else if (category == PAYMENT_HOSTEL) {
+        total->hostel += amount;
+    } else {
+        total->both += amount;
+    }
+}
+
+// Parse "roll,date,amount,category" and fold it into the chunk's totals.
+// Returns NULL when accepted, "" for an already-applied payment, or the
+// reason the line is malformed.
+static const char *ingestLine(PaymentChunk *chunk, const char *p, const char *end) {
+    int rollNumber;
+    if (!csvParseInt(&p, end, &rollNumber) || p == end || *p++ != ',') {
+        return "bad roll number";
+    }
+    const char *dateStart = p;
+    while (p < end && *p != ',') {
+        p++;
+    }
+    int date = normalizePaymentDate(dateStart, (size_t)(p - dateStart));
+    if (date < 0 || p == end) {
+        return "bad date";
+    }
+    p++;
+    Money amount;
+    if (!moneyParse(&p, end, &amount) || amount < 0 || p == end || *p++ != ',') {
+        return "bad amount";
+    }
+    PaymentCategory category;
+    if (!parseCategory(p, (size_t)(end - p), &category)) {
+        return "unknown category";
+    }
+
+    if (chunk->seen != NULL) {
+        uint64_t key = paymentKey(rollNumber, date, amount, category);
+        if (paymentKeySetContains(chunk->seen, key)) {
+            return "";
+        }
+        if (!rememberEntry(chunk, key, rollNumber, category, amount)) {
+            chunk->outOfMemory = true;
+            return "out of memory";
+        }
+    }
+
+    PaymentTotal *total = totalFor(&chunk->totals, rollNumber);
+    if (total == NULL) {
+        chunk->outOfMemory = true;
+        return "out of memory";
+    }
+    addToTotal(total, category, amount);
+    total->payments++;
+    if (date > total->latestDate) {
+        total->latestDate = date;
+    }
+    if (date == 0) {
+        chunk->undated++;
+    }
+    return NULL;
+}
+
+static void *ingestChunk(void *arg) {
+    PaymentChunk *chunk = arg;
+    const char *p = chunk->begin;
+    while (p < chunk->end && !chunk->outOfMemory) {
+        const char *lineEnd = memchr(p, '\n', (size_t)(chunk->end - p));
+        if (lineEnd == NULL) {
+            lineEnd = chunk->end;
+        }
+        const char *contentEnd = lineEnd;
+        if (contentEnd > p && contentEnd[-1] == '\r') {
+            contentEnd--;
+        }
+        chunk->lines++;
+        if (contentEnd > p) {
+            chunk->parsed++;
+            const char *error = ingestLine(chunk, p, contentEnd);
+            if (error == NULL) {
+                chunk->payments++;
+            } else if (*error == '\0') {
+                chunk->duplicates++;
+            } else {
+                if (chunk->errorCount < PAYMENT_MAX_REPORTED_ERRORS) {
+                    chunk->errors[chunk->errorCount].line = chunk->lines;
+                    chunk->errors[chunk->errorCount].reason = error;
+                    chunk->errorCount++;
+                }
+                chunk->malformed++;
+            }
+        }
+        p = lineEnd + 1;
+    }
+    return NULL;
+}
+
+// Fold one table into another
+static bool mergeTotals(PaymentTotals *into, const PaymentTotals *from) {
+    for (int i = 0; i < from->count; i++) {
+        const PaymentTotal *src = &from->items[i];
+        PaymentTotal *dst = totalFor(into, src->rollNumber);
+        if (dst == NULL) {
+            return false;
+        }
+        dst->fees += src->fees;
+        dst->hostel += src->hostel;
+        dst->both += src->both;
+        dst->payments += src->payments;
+        if (src->latestDate > dst->latestDate) {
+            dst->latestDate = src->latestDate;
+        }
+    }
+    return true;
+}
+
+int defaultPaymentThreads(void) {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    int cpus = (int)info.dwNumberOfProcessors;
+#else
+    int cpus = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+    return cpus < 1 ? 1 : (cpus > PAYMENT_MAX_THREADS ? PAYMENT_MAX_THREADS : cpus);
+}
+
+// Claim each accepted payment's key in file order; a key seen earlier in
+// the same run is a duplicate line and its amount is taken back out
+static bool claimKeys(PaymentChunk *chunk, PaymentKeySet *seen, PaymentTotals *totals, long *duplicates) {
+    for (long i = 0; i < chunk->entryCount; i++) {
+        const PaymentEntry *entry = &chunk->entries[i];
+        int added = paymentKeySetInsert(seen, entry->key);
+        if (added < 0) {
+            return false;
+        }
+        if (added == 0) {
+            PaymentTotal *total = totalFor(totals, entry->rollNumber);
+            if (total == NULL) {
+                return false;
+            }
+            addToTotal(total, entry->category, -entry->amount);
+            total->payments--;
+            (*duplicates)++;
+        }
+    }
+    return true;
+}
+
+// Parse the payment log in parallel chunks (split on line boundaries), each
+// worker aggregating per-roll totals privately, then merge the tables.
+//
+// With a checkpoint, parsing resumes at its offset (or restarts from the top
+// if the bytes before it changed) and stops after the last complete line, so
+// a line still being written is left for the next run. With a key set,
+// payments already in it are skipped and the new keys are added to it.
+bool ingestPayments(const char *path, int threads, const PaymentCheckpoint *resume,
+                    PaymentKeySet *seen, PaymentTotals *totals, PaymentIngestStats *stats) {
+    memset(stats, 0, sizeof(*stats));
+    FileView view;
+    if (!fileViewOpen(path, &view)) {
+        return false;
+    }
+
+    const char *begin = view.data;
+    const char *end = view.data + view.size;
+    uint64_t lineBase = 0;
+    if (resume != NULL) {
+        if (resume->offset <= view.size && paymentTailHash(view.data, resume->offset) == resume->tailHash) {
+            begin = view.data + resume->offset;
+            lineBase = resume->lines;
+        } else {
+            stats->rescanned = true;
+        }
+        while (end > begin && end[-1] != '\n') {
+            end--;
+        }
+    }
+    stats->startOffset = (uint64_t)(begin - view.data);
+    stats->endOffset = (uint64_t)(end - view.data);
+    stats->endTailHash = paymentTailHash(view.data, stats->endOffset);
+    stats->bytes = (size_t)(end - begin);
+    size_t size = stats->bytes;
+
+    if (threads < 1) {
+        threads = 1;
+    }
+    if (threads > PAYMENT_MAX_THREADS) {
+        threads = PAYMENT_MAX_THREADS;
+    }
+    // Tiny inputs are not worth a thread each
+    if ((size_t)threads > size / 4096 + 1) {
+        threads = (int)(size / 4096) + 1;
+    }
+    stats->threads = threads;
+
+    double start = monotonicSeconds();
+    PaymentChunk *chunks = calloc((size_t)threads, sizeof(PaymentChunk));
+    pthread_t *workers = malloc(sizeof(pthread_t) * threads);
+    if (chunks == NULL || workers == NULL) {
+        free(chunks);
+        free(workers);
+        fileViewClose(&view);
+        return false;
+    }
+
+    const char *cut = begin;
+    for (int t = 0; t < threads; t++) {
+        chunks[t].begin = cut;
+        if (t == threads - 1) {
+            cut = end;
+        } else {
+            cut = begin + size / threads * (t + 1);
+            if (cut < chunks[t].begin) {
+                cut = chunks[t].begin;
+            }
+            const char *newline = cut < end ? memchr(cut, '\n', (size_t)(end - cut)) : NULL;
+            cut = newline == NULL ? end : newline + 1;
+        }
+        chunks[t].end = cut;
+        chunks[t].seen = seen;
+        paymentTotalsInit(&chunks[t].totals);
+    }
+
+    // Worker 0 runs on this thread
+    int started = 1;
+    for (int t = 1; t < threads; t++) {
+        if (pthread_create(&workers[t], NULL, ingestChunk, &chunks[t]) != 0) {
+            break;
+        }
+        started++;
+    }
+    ingestChunk(&chunks[0]);
+    for (int t = 1; t < started; t++) {
+        pthread_join(workers[t], NULL);
+    }
+    for (int t = started; t < threads; t++) {
+        ingestChunk(&chunks[t]); // could not spawn: finish inline
+    }
+    stats->parseSeconds = monotonicSeconds() - start;
+
+    // Merge and report errors with file-absolute line numbers
+    start = monotonicSeconds();
+    bool ok = true;
+    long reported = 0;
+    for (int t = 0; t < threads; t++) {
+        PaymentChunk *chunk = &chunks[t];
+        for (int e = 0; e < chunk->errorCount && reported < PAYMENT_MAX_REPORTED_ERRORS; e++, reported++) {
+            printf("Warning: %s line %llu: %s.\n", path,
+                   (unsigned long long)(lineBase + chunk->errors[e].line), chunk->errors[e].reason);
+        }
+        lineBase += chunk->lines;
+        stats->lines += chunk->parsed;
+        stats->payments += chunk->payments;
+        stats->malformed += chunk->malformed;
+        stats->undatedPayments += chunk->undated;
+        stats->duplicates += chunk->duplicates;
+        ok = ok && !chunk->outOfMemory;
+        if (ok && totals->count == 0) {
+            // First table: take it over instead of copying it entry by entry
+            paymentTotalsFree(totals);
+            *totals = chunk->totals;
+            paymentTotalsInit(&chunk->totals);
+        } else {
+            ok = ok && mergeTotals(totals, &chunk->totals);
+            paymentTotalsFree(&chunk->totals);
+        }
+        if (ok && seen != NULL) {
+            long duplicates = 0;
+            ok = claimKeys(chunk, seen, totals, &duplicates);
+            stats->payments -= duplicates;
+            stats->duplicates += duplicates;
+        }
+        free(chunk->entries);
+    }
+    if (stats->malformed > reported) {
+        printf("Warning: %ld malformed payment lines in total (only the first %ld shown).\n",
+               stats->malformed, reported);
+    }
+    stats->endLines = lineBase;
+    stats->mergeSeconds = monotonicSeconds() - start;
+
+    free(chunks);
+    free(workers);
+    fileViewClose(&view);
+    return ok;
+}
+
+// Take a payment off a due; returns what is left of the payment
+static Money settle(Money *due, Money payment) {
+    if (*due <= 0 || payment <= 0) {
+        return payment;
+    }
+    if (payment >= *due) {
+        payment -= *due;
+        *due = 0;
+        return payment;
+    }
+    *due -= payment;
+    return 0;
+}
+
+// Work out each student's dues after the totals are applied (without
+// changing the store). Dues never go below zero; any excess is reported as
+// overpaid. Fees come off first for "Both" payments.
+bool planPaymentTotals(const PaymentTotals *totals, const StudentStore *store, PaymentPlan *plan,
+                       PaymentApplyReport *report) {
+    memset(report, 0, sizeof(*report));
+    plan->items = NULL;
+    plan->count = 0;
+    if (totals->count == 0) {
+        return true;
+    }
+    plan->items = malloc(sizeof(PaymentUpdate) * totals->count);
+    if (plan->items == NULL) {
+        return false;
+    }
+    for (int i = 0; i < totals->count; i++) {
+        const PaymentTotal *total = &totals->items[i];
+        const Student *s = storeFindByRoll(store, total->rollNumber);
+        if (s == NULL) {
+            report->unknownRolls++;
+            continue;
+        }
+        Money fees = s->feesDue;
+        Money hostel = s->hostelDue;
+
+        Money left = settle(&fees, total->fees);
+        left += settle(&hostel, total->hostel);
+        left += settle(&hostel, settle(&fees, total->both));
+
+        report->overpaid += left;
+        report->applied += (total->fees + total->hostel + total->both) - left;
+        if (fees != s->feesDue || hostel != s->hostelDue) {
+            PaymentUpdate *update = &plan->items[plan->count++];
+            update->rollNumber = s->rollNumber;
+            update->feesDue = fees;
+            update->hostelDue = hostel;
+        }
+    }
+    report->studentsUpdated = plan->count;
+    return true;
+}
+
+// Set the planned dues and journal them. The values are absolute, so
+// applying the same updates again after a crash changes nothing.
+int applyPaymentUpdates(const PaymentUpdate *updates, int count, StudentStore *store, Journal *journal) {
+    int changed = 0;
+    for (int i = 0; i < count; i++) {
+        Student *s = storeFindByRoll(store, updates[i].rollNumber);
+        if (s == NULL) {
+            continue;
+        }
+        bool feesChanged = s->feesDue != updates[i].feesDue;
+        bool hostelChanged = s->hostelDue != updates[i].hostelDue;
+        s->feesDue = updates[i].feesDue;
+        s->hostelDue = updates[i].hostelDue;
+        if (journal != NULL && feesChanged) {
+            journalAppend(journal, JOURNAL_SET_FEES, s, NULL);
+        }
+        if (journal != NULL && hostelChanged) {
+            journalAppend(journal, JOURNAL_SET_HOSTEL, s, NULL);
+        }
+        changed += feesChanged || hostelChanged;
+    }
+    return changed;
+}
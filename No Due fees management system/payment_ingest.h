@@ -0,0 +1,81 @@
+#ifndef PAYMENT_INGEST_H
+#define PAYMENT_INGEST_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "student_store.h"
+#include "roll_map.h"
+#include "journal.h"
+#include "payment_checkpoint.h"
+
+#define PAYMENT_FILENAME "payment_history.txt"
+#define PAYMENT_MAX_THREADS 64
+#define PAYMENT_MAX_REPORTED_ERRORS 20
+
+// What a payment line pays for
+typedef enum {
+    PAYMENT_FEES,
+    PAYMENT_HOSTEL,
+    PAYMENT_BOTH            // settles fees first, then hostel
+} PaymentCategory;
+
+// Everything one roll number paid in the ingested log
+typedef struct {
+    int rollNumber;
+    Money fees;
+    Money hostel;
+    Money both;
+    int payments;
+    int latestDate;         // YYYYMMDD, 0 if no line had a usable date
+} PaymentTotal;
+
+// Per-roll aggregation table
+typedef struct {
+    PaymentTotal *items;
+    int count;
+    int capacity;
+    RollMap index;          // rollNumber -> position in items
+} PaymentTotals;
+
+typedef struct {
+    long lines;             // non-blank lines parsed
+    long payments;          // lines accepted
+    long malformed;
+    long undatedPayments;   // accepted lines with an unknown date (e.g. 00000000)
+    long duplicates;        // lines whose payment key was already applied
+    uint64_t startOffset;   // where parsing began
+    uint64_t endOffset;     // just past the last complete line parsed
+    uint64_t endLines;      // lines before endOffset
+    uint64_t endTailHash;   // paymentTailHash at endOffset
+    bool rescanned;         // the log no longer matched the checkpoint
+    size_t bytes;
+    int threads;
+    double parseSeconds;    // parallel parse + per-thread aggregation
+    double mergeSeconds;    // combining the per-thread tables
+} PaymentIngestStats;
+
+typedef struct {
+    int studentsUpdated;
+    int unknownRolls;
+    Money applied;          // amount taken off dues
+    Money overpaid;         // amount left over after dues reached zero
+} PaymentApplyReport;
+
+// Dues changes worked out from a set of totals, not yet applied
+typedef struct {
+    PaymentUpdate *items;
+    int count;
+} PaymentPlan;
+
+void paymentTotalsInit(PaymentTotals *totals);
+void paymentTotalsFree(PaymentTotals *totals);
+int normalizePaymentDate(const char *text, size_t length);
+uint64_t paymentKey(int rollNumber, int date, Money amount, PaymentCategory category);
+bool ingestPayments(const char *path, int threads, const PaymentCheckpoint *resume,
+                    PaymentKeySet *seen, PaymentTotals *totals, PaymentIngestStats *stats);
+bool planPaymentTotals(const PaymentTotals *totals, const StudentStore *store, PaymentPlan *plan,
+                       PaymentApplyReport *report);
+int applyPaymentUpdates(const PaymentUpdate *updates, int count, StudentStore *store, Journal *journal);
+int defaultPaymentThreads(void);
+
+#endif
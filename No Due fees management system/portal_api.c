@@ -0,0 +1,625 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include "portal_api.h"
+
+static void base64Encode(const char *text, char *out, size_t size) {
+    static const char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    size_t length = strlen(text);
+    size_t used = 0;
+    for (size_t i = 0; i < length && used + 5 < size; i += 3) {
+        uint32_t block = (uint32_t)(unsigned char)text[i] << 16;
+        if (i + 1 < length) {
+            block |= (uint32_t)(unsigned char)text[i + 1] << 8;
+        }
+        if (i + 2 < length) {
+            block |= (unsigned char)text[i + 2];
+        }
+        out[used++] = alphabet[(block >> 18) & 63];
+        out[used++] = alphabet[(block >> 12) & 63];
+        out[used++] = i + 1 < length ? alphabet[(block >> 6) & 63] : '=';
+        out[used++] = i + 2 < length ? alphabet[block & 63] : '=';
+    }
+    out[used] = '\0';
+}
+
+bool portalApiInit(PortalApi *api, StudentStore *store, ApprovalQueue *queue,
+                   ClearanceBoard *clearance, Journal *journal,
+                   AuditLog *audit, const char *approvalPath, const char *adminUser, const char *adminPassword,
+                   bool (*compact)(void)) {
+    memset(api, 0, sizeof(*api));
+    api->store = store;
+    api->queue = queue;
+    api->clearance = clearance;
+    api->journal = journal;
+    api->audit = audit;
+    api->approvalPath = approvalPath;
+    api->compact = compact;
+
+    char credentials[96];
+    char encoded[96];
+    snprintf(credentials, sizeof(credentials), "%s:%s", adminUser, adminPassword);
+    base64Encode(credentials, encoded, sizeof(encoded));
+    snprintf(api->adminAuthorization, sizeof(api->adminAuthorization), "Basic %s", encoded);
+    snprintf(api->adminActor, sizeof(api->adminActor), "%s", adminUser);
+
+    if (!storeLocksInit(&api->locks)) {
+        return false;
+    }
+    pthread_mutex_init(&api->queueLock, NULL);
+    for (int d = 0; d < DEPARTMENT_COUNT; d++) {
+        pthread_mutex_init(&api->departmentLocks[d], NULL);
+    }
+    pthread_mutex_init(&api->clearanceLock, NULL);
+    pthread_mutex_init(&api->journalLock, NULL);
+    pthread_mutex_init(&api->commitLock, NULL);
+    pthread_mutex_init(&api->auditLock, NULL);
+    return true;
+}
+
+void portalApiFree(PortalApi *api) {
+    pthread_mutex_destroy(&api->auditLock);
+    pthread_mutex_destroy(&api->commitLock);
+    pthread_mutex_destroy(&api->journalLock);
+    pthread_mutex_destroy(&api->clearanceLock);
+    for (int d = 0; d < DEPARTMENT_COUNT; d++) {
+        pthread_mutex_destroy(&api->departmentLocks[d]);
+    }
+    pthread_mutex_destroy(&api->queueLock);
+    storeLocksFree(&api->locks);
+}
+
+static void sendError(HttpResponse *response, int status, const char *message) {
+    response->status = status;
+    response->length = 0;
+    httpAppend(response, "{\"error\":");
+    httpAppendJsonString(response, message);
+    httpAppend(response, "}");
+}
+
+static void appendStudent(HttpResponse *response, const StudentStore *store, const Student *s) {
+    httpAppend(response, "{\"rollNumber\":%d,\"name\":", s->rollNumber);
+    httpAppendJsonString(response, storeName(store, s));
+    char fees[MONEY_TEXT_SIZE];
+    char hostel[MONEY_TEXT_SIZE];
+    httpAppend(response, ",\"feesDue\":%s,\"libraryBooksDue\":%d,\"hostelDue\":%s,\"approvalStatus\":\"%s\"}",
+               moneyText(s->feesDue, fees), s->libraryBooksDue, moneyText(s->hostelDue, hostel),
+               s->approvalStatus ? "Approved" : "Pending");
+}
+
+// Text of the number stored under "key" in a flat JSON object; false when
+// absent or not a number
+static bool jsonNumberText(const char *body, size_t length, const char *key, char number[32]) {
+    char pattern[64];
+    int patternLength = snprintf(pattern, sizeof(pattern), "\"%s\"", key);
+    for (size_t i = 0; i + (size_t)patternLength <= length; i++) {
+        if (memcmp(body + i, pattern, (size_t)patternLength) != 0) {
+            continue;
+        }
+        size_t p = i + (size_t)patternLength;
+        while (p < length && (body[p] == ' ' || body[p] == '\t' || body[p] == '\n' || body[p] == '\r')) {
+            p++;
+        }
+        if (p >= length || body[p] != ':') {
+            continue;
+        }
+        size_t n = 0;
+        for (p++; p < length && (body[p] == ' ' || body[p] == '\t'); p++) {
+        }
+        while (p < length && n + 1 < 32 && strchr("+-.0123456789eE", body[p]) != NULL) {
+            number[n++] = body[p++];
+        }
+        number[n] = '\0';
+        return n > 0;
+    }
+    return false;
+}
+
+static bool jsonNumber(const char *body, size_t length, const char *key, double *out) {
+    char number[32];
+    char *end;
+    if (!jsonNumberText(body, length, key, number)) {
+        return false;
+    }
+    *out = strtod(number, &end);
+    return *end == '\0';
+}
+
+// Amounts are read from the digits, so 0.1 stays exactly ten paise. A
+// number too large for an amount (or inf) is present but sets *valid false.
+static bool jsonMoney(const char *body, size_t length, const char *key, Money *out, bool *valid) {
+    char number[32];
+    char *end;
+    *valid = true;
+    if (!jsonNumberText(body, length, key, number)) {
+        return false;
+    }
+    if (moneyParseText(number, out)) {
+        return true;
+    }
+    double value = strtod(number, &end); // exponent form such as 1.5e3
+    if (*end != '\0') {
+        return false;
+    }
+    *valid = moneyFromDouble(value, out);
+    return true;
+}
+
+// Integer parameter from a query string like "offset=0&limit=50"
+static int queryInt(const char *query, const char *key, int fallback) {
+    size_t keyLength = strlen(key);
+    for (const char *p = query; *p != '\0'; ) {
+        if (strncmp(p, key, keyLength) == 0 && p[keyLength] == '=') {
+            return atoi(p + keyLength + 1);
+        }
+        const char *next = strchr(p, '&');
+        if (next == NULL) {
+            break;
+        }
+        p = next + 1;
+    }
+    return fallback;
+}
+
+// "/students/12/apply" -> roll 12, action "apply" ("" when there is none)
+static bool parseRollPath(const char *path, const char *prefix, int *rollNumber, const char **action) {
+    size_t prefixLength = strlen(prefix);
+    if (strncmp(path, prefix, prefixLength) != 0) {
+        return false;
+    }
+    char *end;
+    long value = strtol(path + prefixLength, &end, 10);
+    if (end == path + prefixLength || value <= 0 || value > 2147483647L || (*end != '\0' && *end != '/')) {
+        return false;
+    }
+    *rollNumber = (int)value;
+    *action = *end == '/' ? end + 1 : "";
+    return true;
+}
+
+// Make this request's journal entries durable. Called after the record
+// lock is released: whoever gets commitLock first fsyncs for every writer
+// that had flushed by then, so concurrent writers share one fsync.
+static bool commitWrite(PortalApi *api, uint64_t ticket) {
+    bool ok = true;
+    pthread_mutex_lock(&api->commitLock);
+    if (api->syncedWrites < ticket) {
+        pthread_mutex_lock(&api->journalLock);
+        uint64_t covered = api->flushedWrites;
+        pthread_mutex_unlock(&api->journalLock);
+        ok = journalSync(api->journal);
+        if (ok) {
+            api->syncedWrites = covered;
+        }
+    }
+    pthread_mutex_unlock(&api->commitLock);
+    return ok;
+}
+
+// Journal the changed fields of a record (held under its write lock),
+// flush, and take a ticket for commitWrite
+static uint64_t logWrite(PortalApi *api, const JournalOp *ops, int opCount, const Student *s) {
+    pthread_mutex_lock(&api->journalLock);
+    for (int i = 0; i < opCount; i++) {
+        journalAppend(api->journal, ops[i], s, NULL);
+    }
+    journalFlush(api->journal);
+    uint64_t ticket = ++api->flushedWrites;
+    pthread_mutex_unlock(&api->journalLock);
+    return ticket;
+}
+
+// Audit one decision or change (called with the student's record lock held,
+// so entries for a roll keep the order the changes were made in)
+static void auditEvent(PortalApi *api, int rollNumber, AuditAction action,
+                       int64_t oldValue, int64_t newValue, const char *actor) {
+    pthread_mutex_lock(&api->auditLock);
+    auditRecord(api->audit, rollNumber, action, oldValue, newValue, actor);
+    pthread_mutex_unlock(&api->auditLock);
+}
+
+static void getStudent(PortalApi *api, int rollNumber, HttpResponse *response) {
+    storeLockRecord(&api->locks, rollNumber, false);
+    const Student *s = storeFindByRoll(api->store, rollNumber);
+    if (s == NULL) {
+        sendError(response, 404, "student not found");
+    } else {
+        appendStudent(response, api->store, s);
+    }
+    storeUnlockRecord(&api->locks, rollNumber);
+}
+
+// Every department queue plus the clearance map, for changes that span
+// departments (opening and withdrawing applications)
+static void lockClearance(PortalApi *api) {
+    for (int d = 0; d < DEPARTMENT_COUNT; d++) {
+        pthread_mutex_lock(&api->departmentLocks[d]);
+    }
+    pthread_mutex_lock(&api->clearanceLock);
+}
+
+static void unlockClearance(PortalApi *api) {
+    pthread_mutex_unlock(&api->clearanceLock);
+    for (int d = DEPARTMENT_COUNT - 1; d >= 0; d--) {
+        pthread_mutex_unlock(&api->departmentLocks[d]);
+    }
+}
+
+// Queue the request and route it to the departments the student owes
+// anything; with none it is approved straight away (hence the write lock)
+static void applyForApproval(PortalApi *api, int rollNumber, HttpResponse *response) {
+    static const JournalOp approvalOp = JOURNAL_SET_APPROVAL;
+    uint64_t ticket = 0;
+    storeLockRecord(&api->locks, rollNumber, true);
+    pthread_mutex_lock(&api->queueLock);
+    Student *s = storeFindByRoll(api->store, rollNumber);
+    if (s == NULL) {
+        sendError(response, 404, "student not found");
+    } else if (s->approvalStatus != 0) {
+        sendError(response, 409, "already approved");
+    } else if (approvalQueueContains(api->queue, rollNumber)) {
+        sendError(response, 409, "already applied");
+    } else if (!approvalQueuePush(api->queue, rollNumber, storeName(api->store, s))) {
+        sendError(response, 500, "out of memory");
+    } else {
+        // Same append the console portal does; the queue file is the record
+        FILE *file = fopen(api->approvalPath, "a");
+        if (file != NULL) {
+            approvalRequestWrite(file, api->queue, approvalQueueFind(api->queue, rollNumber));
+            fclose(file);
+        }
+        auditEvent(api, rollNumber, AUDIT_APPLIED, 0, 0, STUDENT_ACTOR);
+        lockClearance(api);
+        int cleared = clearanceSubmit(api->clearance, s, storeName(api->store, s));
+        unlockClearance(api);
+        if (cleared == CLEARANCE_ALL) {
+            approvalQueueRemove(api->queue, rollNumber);
+            api->queueDirty = true;
+            auditEvent(api, rollNumber, AUDIT_APPROVED, s->approvalStatus, 1, CLEARANCE_ACTOR);
+            s->approvalStatus = 1;
+            ticket = logWrite(api, &approvalOp, 1, s);
+        }
+        response->status = 201;
+        httpAppend(response, "{\"rollNumber\":%d,\"status\":\"%s\"}", rollNumber,
+                   cleared == CLEARANCE_ALL ? "approved" : "submitted");
+    }
+    pthread_mutex_unlock(&api->queueLock);
+    storeUnlockRecord(&api->locks, rollNumber);
+    if (ticket != 0 && !commitWrite(api, ticket)) {
+        sendError(response, 500, "could not write the journal");
+    }
+}
+
+static void listPending(PortalApi *api, const char *query, HttpResponse *response) {
+    int offset = queryInt(query, "offset", 0);
+    int limit = queryInt(query, "limit", PORTAL_PENDING_PAGE);
+    if (offset < 0) {
+        offset = 0;
+    }
+    if (limit < 0) {
+        limit = PORTAL_PENDING_PAGE;
+    }
+
+    pthread_mutex_lock(&api->queueLock);
+    httpAppend(response, "{\"total\":%d,\"items\":[", api->queue->pending);
+    int cursor = 0;
+    int index = 0;
+    int listed = 0;
+    const ApprovalRequest *request;
+    while (listed < limit && (request = approvalQueueNext(api->queue, &cursor)) != NULL) {
+        if (index++ < offset) {
+            continue;
+        }
+        httpAppend(response, "%s{\"rollNumber\":%d,\"name\":", listed > 0 ? "," : "", request->rollNumber);
+        httpAppendJsonString(response, approvalRequestName(api->queue, request));
+        httpAppend(response, "}");
+        listed++;
+    }
+    httpAppend(response, "]}");
+    pthread_mutex_unlock(&api->queueLock);
+}
+
+static void decide(PortalApi *api, int rollNumber, bool approve, HttpResponse *response) {
+    static const JournalOp approvalOp = JOURNAL_SET_APPROVAL;
+    uint64_t ticket = 0;
+    storeLockRecord(&api->locks, rollNumber, true);
+    pthread_mutex_lock(&api->queueLock);
+    Student *s = storeFindByRoll(api->store, rollNumber);
+    if (!approvalQueueContains(api->queue, rollNumber)) {
+        sendError(response, 404, "no pending request");
+    } else if (approve && s == NULL) {
+        sendError(response, 404, "student not found");
+    } else {
+        approvalQueueRemove(api->queue, rollNumber);
+        api->queueDirty = true;
+        lockClearance(api); // the decision closes the department application too
+        clearanceWithdraw(api->clearance, rollNumber);
+        unlockClearance(api);
+        int status = s != NULL ? s->approvalStatus : 0;
+        auditEvent(api, rollNumber, approve ? AUDIT_APPROVED : AUDIT_REJECTED, status, approve ? 1 : status,
+                   api->adminActor);
+        if (approve) {
+            s->approvalStatus = 1;
+            ticket = logWrite(api, &approvalOp, 1, s);
+        }
+        httpAppend(response, "{\"rollNumber\":%d,\"status\":\"%s\"}", rollNumber, approve ? "approved" : "rejected");
+    }
+    pthread_mutex_unlock(&api->queueLock);
+    storeUnlockRecord(&api->locks, rollNumber);
+    if (ticket != 0 && !commitWrite(api, ticket)) {
+        sendError(response, 500, "could not write the journal");
+    }
+}
+
+// One department's queue, oldest first
+static void listDepartment(PortalApi *api, Department department, const char *query, HttpResponse *response) {
+    int offset = queryInt(query, "offset", 0);
+    int limit = queryInt(query, "limit", PORTAL_PENDING_PAGE);
+    if (offset < 0) {
+        offset = 0;
+    }
+    if (limit < 0) {
+        limit = PORTAL_PENDING_PAGE;
+    }
+
+    const ApprovalQueue *queue = &api->clearance->queues[department];
+    pthread_mutex_lock(&api->departmentLocks[department]);
+    httpAppend(response, "{\"department\":\"%s\",\"total\":%d,\"items\":[", departmentName(department), queue->pending);
+    int cursor = 0;
+    int index = 0;
+    int listed = 0;
+    const ApprovalRequest *request;
+    while (listed < limit && (request = approvalQueueNext(queue, &cursor)) != NULL) {
+        if (index++ < offset) {
+            continue;
+        }
+        httpAppend(response, "%s{\"rollNumber\":%d,\"name\":", listed > 0 ? "," : "", request->rollNumber);
+        httpAppendJsonString(response, approvalRequestName(queue, request));
+        httpAppend(response, "}");
+        listed++;
+    }
+    httpAppend(response, "]}");
+    pthread_mutex_unlock(&api->departmentLocks[department]);
+}
+
+// A department clears or rejects one student. The record's write lock is
+// held throughout, so decisions on one student never interleave; the
+// department lock is held only to take the student off its own queue.
+static void departmentDecide(PortalApi *api, Department department, int rollNumber, bool clear,
+                             HttpResponse *response) {
+    static const JournalOp approvalOp = JOURNAL_SET_APPROVAL;
+    const char *actor = departmentName(department);
+    uint64_t ticket = 0;
+    storeLockRecord(&api->locks, rollNumber, true);
+    Student *s = storeFindByRoll(api->store, rollNumber);
+
+    pthread_mutex_lock(&api->queueLock);
+    bool open = approvalQueueContains(api->queue, rollNumber);
+    pthread_mutex_unlock(&api->queueLock);
+
+    pthread_mutex_lock(&api->departmentLocks[department]);
+    bool queued = approvalQueueRemove(&api->clearance->queues[department], rollNumber);
+    api->clearance->queueDirty[department] |= queued;
+    pthread_mutex_unlock(&api->departmentLocks[department]);
+
+    pthread_mutex_lock(&api->clearanceLock);
+    int before = clearanceOf(api->clearance, rollNumber);
+    pthread_mutex_unlock(&api->clearanceLock);
+
+    if (!queued) {
+        sendError(response, 404, "no pending request");
+    } else if (!open || s == NULL || s->approvalStatus != 0 || before < 0 || (before & (1 << department))) {
+        sendError(response, 409, "application already decided");
+    } else if (clear) {
+        pthread_mutex_lock(&api->clearanceLock);
+        int after = clearanceMark(api->clearance, rollNumber, department);
+        pthread_mutex_unlock(&api->clearanceLock);
+        auditEvent(api, rollNumber, AUDIT_CLEARED, before, after, actor);
+        if (after == CLEARANCE_ALL) {
+            pthread_mutex_lock(&api->queueLock);
+            approvalQueueRemove(api->queue, rollNumber);
+            api->queueDirty = true;
+            pthread_mutex_unlock(&api->queueLock);
+            auditEvent(api, rollNumber, AUDIT_APPROVED, s->approvalStatus, 1, CLEARANCE_ACTOR);
+            s->approvalStatus = 1;
+            ticket = logWrite(api, &approvalOp, 1, s);
+        }
+        httpAppend(response, "{\"rollNumber\":%d,\"department\":\"%s\",\"status\":\"%s\"}",
+                   rollNumber, actor, after == CLEARANCE_ALL ? "approved" : "cleared");
+    } else {
+        // Any department's rejection closes the whole application
+        lockClearance(api);
+        clearanceWithdraw(api->clearance, rollNumber);
+        unlockClearance(api);
+        pthread_mutex_lock(&api->queueLock);
+        approvalQueueRemove(api->queue, rollNumber);
+        api->queueDirty = true;
+        pthread_mutex_unlock(&api->queueLock);
+        auditEvent(api, rollNumber, AUDIT_REJECTED, s->approvalStatus, s->approvalStatus, actor);
+        httpAppend(response, "{\"rollNumber\":%d,\"department\":\"%s\",\"status\":\"rejected\"}",
+                   rollNumber, actor);
+    }
+    storeUnlockRecord(&api->locks, rollNumber);
+    if (ticket != 0 && !commitWrite(api, ticket)) {
+        sendError(response, 500, "could not write the journal");
+    }
+}
+
+// "/departments/library/12/clear" -> DEPARTMENT_LIBRARY, "/12/clear"
+static bool parseDepartmentPath(const char *path, Department *department, const char **rest) {
+    static const char prefix[] = "/departments/";
+    if (strncmp(path, prefix, sizeof(prefix) - 1) != 0) {
+        return false;
+    }
+    const char *name = path + sizeof(prefix) - 1;
+    const char *slash = strchr(name, '/');
+    char text[16];
+    if (slash == NULL || (size_t)(slash - name) >= sizeof(text)) {
+        return false;
+    }
+    memcpy(text, name, (size_t)(slash - name));
+    text[slash - name] = '\0';
+    *rest = slash;
+    return departmentFromName(text, department);
+}
+
+static void updateStudent(PortalApi *api, int rollNumber, const HttpRequest *request, HttpResponse *response) {
+    Money fees = 0, hostel = 0;
+    double books = 0, status = 0;
+    bool feesValid, hostelValid;
+    bool hasFees = jsonMoney(request->body, request->bodyLength, "feesDue", &fees, &feesValid);
+    bool hasBooks = jsonNumber(request->body, request->bodyLength, "libraryBooksDue", &books);
+    bool hasHostel = jsonMoney(request->body, request->bodyLength, "hostelDue", &hostel, &hostelValid);
+    bool hasStatus = jsonNumber(request->body, request->bodyLength, "approvalStatus", &status);
+    if (!hasFees && !hasBooks && !hasHostel && !hasStatus) {
+        sendError(response, 400, "no fields to update");
+        return;
+    }
+    // A book count must be a whole number an int holds (NaN fails the range)
+    bool badBooks = hasBooks && (!(books >= 0 && books <= INT_MAX) || (double)(int)books != books);
+    if ((hasFees && (!feesValid || fees < 0)) || badBooks || (hasHostel && (!hostelValid || hostel < 0))
+            || (hasStatus && status != 0 && status != 1)) {
+        sendError(response, 400, "invalid value");
+        return;
+    }
+
+    JournalOp ops[4];
+    int opCount = 0;
+    uint64_t ticket = 0;
+    storeLockRecord(&api->locks, rollNumber, true);
+    Student *s = storeFindByRoll(api->store, rollNumber);
+    if (s == NULL) {
+        sendError(response, 404, "student not found");
+    } else {
+        Student before = *s;
+        if (hasFees) {
+            s->feesDue = fees;
+            ops[opCount++] = JOURNAL_SET_FEES;
+        }
+        if (hasBooks) {
+            s->libraryBooksDue = (int)books;
+            ops[opCount++] = JOURNAL_SET_BOOKS;
+        }
+        if (hasHostel) {
+            s->hostelDue = hostel;
+            ops[opCount++] = JOURNAL_SET_HOSTEL;
+        }
+        if (hasStatus) {
+            s->approvalStatus = (int)status;
+            ops[opCount++] = JOURNAL_SET_APPROVAL;
+        }
+        ticket = logWrite(api, ops, opCount, s);
+        pthread_mutex_lock(&api->auditLock);
+        auditRecordChanges(api->audit, &before, s, api->adminActor);
+        pthread_mutex_unlock(&api->auditLock);
+        appendStudent(response, api->store, s);
+    }
+    storeUnlockRecord(&api->locks, rollNumber);
+    if (ticket != 0 && !commitWrite(api, ticket)) {
+        sendError(response, 500, "could not write the journal");
+    }
+}
+
+// Route one request (runs on a server worker thread)
+void portalApiHandle(void *context, const HttpRequest *request, HttpResponse *response) {
+    PortalApi *api = context;
+    bool isGet = strcmp(request->method, "GET") == 0;
+    bool isPost = strcmp(request->method, "POST") == 0;
+    int rollNumber;
+    const char *action;
+
+    if (strcmp(request->path, "/health") == 0 && isGet) {
+        storeLockShared(&api->locks);
+        pthread_mutex_lock(&api->queueLock);
+        httpAppend(response, "{\"students\":%d,\"pending\":%d}", api->store->count, api->queue->pending);
+        pthread_mutex_unlock(&api->queueLock);
+        storeUnlock(&api->locks);
+        return;
+    }
+    if (parseRollPath(request->path, "/students/", &rollNumber, &action)) {
+        if (*action == '\0' && isGet) {
+            getStudent(api, rollNumber, response);
+        } else if (strcmp(action, "apply") == 0 && isPost) {
+            applyForApproval(api, rollNumber, response);
+        } else if (*action == '\0' && isPost) {
+            if (strcmp(request->authorization, api->adminAuthorization) != 0) {
+                sendError(response, 401, "admin login required");
+            } else {
+                updateStudent(api, rollNumber, request, response);
+            }
+        } else {
+            sendError(response, 405, "unsupported method or action");
+        }
+        return;
+    }
+
+    Department department;
+    if (parseDepartmentPath(request->path, &department, &action)) {
+        if (strcmp(request->authorization, api->adminAuthorization) != 0) {
+            sendError(response, 401, "admin login required");
+        } else if (strcmp(action, "/pending") == 0 && isGet) {
+            listDepartment(api, department, request->query, response);
+        } else if (parseRollPath(action, "/", &rollNumber, &action) && isPost
+                && (strcmp(action, "clear") == 0 || strcmp(action, "reject") == 0)) {
+            departmentDecide(api, department, rollNumber, action[0] == 'c', response);
+        } else {
+            sendError(response, 405, "unsupported method or action");
+        }
+        return;
+    }
+
+    bool isPending = strcmp(request->path, "/pending") == 0;
+    bool isDecision = parseRollPath(request->path, "/pending/", &rollNumber, &action);
+    if (!isPending && !isDecision) {
+        sendError(response, 404, "no such endpoint");
+        return;
+    }
+    if (strcmp(request->authorization, api->adminAuthorization) != 0) {
+        sendError(response, 401, "admin login required");
+    } else if (isPending && isGet) {
+        listPending(api, request->query, response);
+    } else if (isDecision && isPost && (strcmp(action, "approve") == 0 || strcmp(action, "reject") == 0)) {
+        decide(api, rollNumber, action[0] == 'a', response);
+    } else {
+        sendError(response, 405, "unsupported method or action");
+    }
+}
+
+// Once a second on the event loop: rewrite the approval file and the
+// clearance files after decisions, commit the audit entries gathered since
+// the last tick, and compact the journal when it has grown large
+void portalApiTick(void *context) {
+    PortalApi *api = context;
+    pthread_mutex_lock(&api->queueLock);
+    if (api->queueDirty && approvalQueueSave(api->queue, api->approvalPath)) {
+        api->queueDirty = false;
+    }
+    pthread_mutex_unlock(&api->queueLock);
+
+    for (int d = 0; d < DEPARTMENT_COUNT; d++) {
+        pthread_mutex_lock(&api->departmentLocks[d]);
+        clearanceSaveQueue(api->clearance, (Department)d);
+        pthread_mutex_unlock(&api->departmentLocks[d]);
+    }
+    pthread_mutex_lock(&api->clearanceLock);
+    clearanceSaveStatus(api->clearance);
+    pthread_mutex_unlock(&api->clearanceLock);
+
+    pthread_mutex_lock(&api->auditLock);
+    auditCommit(api->audit);
+    pthread_mutex_unlock(&api->auditLock);
+
+    pthread_mutex_lock(&api->journalLock);
+    bool compact = journalNeedsCompaction(api->journal) && api->compact != NULL;
+    pthread_mutex_unlock(&api->journalLock);
+    if (compact) {
+        // commitLock first (same order as commitWrite) so compaction never
+        // truncates the journal under an fsync in progress
+        pthread_mutex_lock(&api->commitLock);
+        storeLockExclusive(&api->locks);
+        api->compact();
+        storeUnlock(&api->locks);
+        pthread_mutex_unlock(&api->commitLock);
+    }
+}
@@ -0,0 +1,67 @@
+#ifndef PORTAL_API_H
+#define PORTAL_API_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <pthread.h>
+#include "student_store.h"
+#include "store_locks.h"
+#include "approval_queue.h"
+#include "clearance.h"
+#include "journal.h"
+#include "audit_log.h"
+#include "http_server.h"
+
+#define PORTAL_PENDING_PAGE 50      // default page size for GET /pending
+
+// Student and admin portal operations as JSON endpoints:
+//   GET  /health                         record and queue counts
+//   GET  /students/{roll}                status lookup
+//   POST /students/{roll}/apply          apply for approval
+//   GET  /pending?offset=N&limit=N       pending requests          (admin)
+//   POST /pending/{roll}/approve         approve a request         (admin)
+//   POST /pending/{roll}/reject          reject a request          (admin)
+//   POST /students/{roll}                update {"feesDue", "libraryBooksDue",
+//                                        "hostelDue", "approvalStatus"} (admin)
+//   GET  /departments/{dept}/pending     one department's queue    (admin)
+//   POST /departments/{dept}/{roll}/clear   department sign-off    (admin)
+//   POST /departments/{dept}/{roll}/reject  department rejection   (admin)
+// Admin endpoints need HTTP Basic authentication with the admin login.
+//
+// Lookups and updates of different students run in parallel under per-shard
+// record locks, and each department's queue has its own lock, so departments
+// clear students concurrently. Lock order: commitLock, store locks,
+// queueLock, departmentLocks (in department order), clearanceLock,
+// journalLock, auditLock. Audit entries are written and fsynced together
+// once a second.
+typedef struct {
+    StudentStore *store;
+    ApprovalQueue *queue;
+    ClearanceBoard *clearance;
+    Journal *journal;
+    AuditLog *audit;                // may be NULL
+    const char *approvalPath;
+    bool (*compact)(void);          // folds the journal into the base file
+    char adminAuthorization[128];   // expected Authorization header
+    char adminActor[AUDIT_ACTOR_LENGTH]; // audit actor of admin decisions
+    StoreLocks locks;               // student records and the store's shape
+    pthread_mutex_t queueLock;      // queue, approvalPath and queueDirty
+    pthread_mutex_t departmentLocks[DEPARTMENT_COUNT]; // one clearance queue each
+    pthread_mutex_t clearanceLock;  // clearance->cleared and its file
+    pthread_mutex_t journalLock;    // journal appends and flushedWrites
+    pthread_mutex_t commitLock;     // one journal fsync at a time
+    pthread_mutex_t auditLock;      // audit log buffer and file
+    uint64_t flushedWrites;         // writes handed to the OS (under journalLock)
+    uint64_t syncedWrites;          // writes known to be on disk (under commitLock)
+    bool queueDirty;                // approvalPath needs rewriting
+} PortalApi;
+
+bool portalApiInit(PortalApi *api, StudentStore *store, ApprovalQueue *queue,
+                   ClearanceBoard *clearance, Journal *journal,
+                   AuditLog *audit, const char *approvalPath, const char *adminUser, const char *adminPassword,
+                   bool (*compact)(void));
+void portalApiFree(PortalApi *api);
+void portalApiHandle(void *context, const HttpRequest *request, HttpResponse *response);
+void portalApiTick(void *context);
+
+#endif
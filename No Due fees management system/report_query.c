@@ -0,0 +1,797 @@
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <strings.h>
+#include "report_query.h"
+#include "timing.h"
+
+// Instruction kinds
+enum {
+    OP_COMPARE,             // field <compare> value, over a dues column
+    OP_NAME_EQUALS,         // name tests are case-insensitive
+    OP_NAME_CONTAINS,
+    OP_NAME_STARTS,
+    OP_AND,
+    OP_OR,
+    OP_NOT
+};
+
+enum { CMP_EQ, CMP_NE, CMP_LT, CMP_LE, CMP_GT, CMP_GE };
+
+typedef enum { TOKEN_END, TOKEN_WORD, TOKEN_NUMBER, TOKEN_STRING, TOKEN_SYMBOL } TokenType;
+
+typedef struct {
+    TokenType type;
+    const char *start;
+    size_t length;
+} Token;
+
+typedef struct {
+    const char *text;
+    const char *p;
+    Token token;
+    Query *query;
+    const char *error;
+    const char *errorAt;
+} Parser;
+
+static const char *fieldNames[] = { "roll", "fees", "hostel", "dues", "books", "status", "name" };
+
+const char *queryFieldName(QueryField field) {
+    return fieldNames[field];
+}
+
+// ---- Compiler ----
+
+static void nextToken(Parser *parser) {
+    const char *p = parser->p;
+    while (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n') {
+        p++;
+    }
+    Token *token = &parser->token;
+    token->start = p;
+    if (*p == '\0') {
+        token->type = TOKEN_END;
+    } else if (isalpha((unsigned char)*p) || *p == '_') {
+        token->type = TOKEN_WORD;
+        while (isalnum((unsigned char)*p) || *p == '_') {
+            p++;
+        }
+    } else if (isdigit((unsigned char)*p) || (*p == '-' && isdigit((unsigned char)p[1]))) {
+        token->type = TOKEN_NUMBER;
+        p++;
+        while (isdigit((unsigned char)*p) || *p == '.') {
+            p++;
+        }
+    } else if (*p == '"') {
+        token->type = TOKEN_STRING;
+        p++;
+        while (*p != '"' && *p != '\0') {
+            p++;
+        }
+        if (*p == '"') {
+            p++;
+        } else if (parser->error == NULL) {
+            parser->error = "unterminated string";
+            parser->errorAt = token->start;
+        }
+    } else {
+        token->type = TOKEN_SYMBOL;
+        bool pair = (p[0] == '!' || p[0] == '<' || p[0] == '>') && p[1] == '=';
+        p += pair ? 2 : 1;
+    }
+    token->length = (size_t)(p - token->start);
+    parser->p = p;
+}
+
+static bool fail(Parser *parser, const char *message) {
+    if (parser->error == NULL) {
+        parser->error = message;
+        parser->errorAt = parser->token.start;
+    }
+    return false;
+}
+
+// Current token is `text` (a keyword, case-insensitive, or a symbol)
+static bool isToken(const Parser *parser, const char *text) {
+    const Token *token = &parser->token;
+    if ((token->type != TOKEN_WORD && token->type != TOKEN_SYMBOL) || strlen(text) != token->length) {
+        return false;
+    }
+    for (size_t i = 0; i < token->length; i++) {
+        if (tolower((unsigned char)token->start[i]) != text[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool accept(Parser *parser, const char *text) {
+    if (!isToken(parser, text)) {
+        return false;
+    }
+    nextToken(parser);
+    return true;
+}
+
+static bool parseField(Parser *parser, QueryField *field) {
+    for (int f = QUERY_FIELD_ROLL; f <= QUERY_FIELD_NAME; f++) {
+        if (accept(parser, fieldNames[f])) {
+            *field = (QueryField)f;
+            return true;
+        }
+    }
+    return fail(parser, "expected a field: roll, fees, hostel, dues, books, status or name");
+}
+
+static bool isNumericField(QueryField field) {
+    return field != QUERY_FIELD_STATUS && field != QUERY_FIELD_NAME;
+}
+
+static bool parseCompare(Parser *parser, int *compare) {
+    static const char *symbols[] = { "=", "!=", "<", "<=", ">", ">=" };
+    for (int c = CMP_EQ; c <= CMP_GE; c++) {
+        if (accept(parser, symbols[c])) {
+            *compare = c;
+            return true;
+        }
+    }
+    return fail(parser, "expected =, !=, <, <=, > or >=");
+}
+
+// Amounts take up to two decimals; roll numbers and book counts are whole
+static bool parseValue(Parser *parser, QueryField field, int64_t *value) {
+    const Token *token = &parser->token;
+    char text[32];
+    if (token->type != TOKEN_NUMBER || token->length >= sizeof(text)) {
+        return fail(parser, "expected a number");
+    }
+    memcpy(text, token->start, token->length);
+    text[token->length] = '\0';
+    if (field == QUERY_FIELD_ROLL || field == QUERY_FIELD_BOOKS) {
+        char *end;
+        long long number = strtoll(text, &end, 10);
+        if (*end != '\0' || number < -2147483647LL || number > 2147483647LL) {
+            return fail(parser, "expected a whole number");
+        }
+        *value = number;
+    } else {
+        Money amount;
+        if (!moneyParseText(text, &amount)) {
+            return fail(parser, "expected an amount");
+        }
+        *value = amount;
+    }
+    nextToken(parser);
+    return true;
+}
+
+static QueryInstruction *emit(Parser *parser, int op, int target) {
+    Query *query = parser->query;
+    if (query->codeLength == QUERY_MAX_INSTRUCTIONS) {
+        fail(parser, "query is too long");
+        return NULL;
+    }
+    QueryInstruction *instruction = &query->code[query->codeLength++];
+    memset(instruction, 0, sizeof(*instruction));
+    instruction->op = (uint8_t)op;
+    instruction->target = (uint8_t)target;
+    return instruction;
+}
+
+// Keep a name literal, lowercased, for the name tests
+static bool addString(Parser *parser, QueryInstruction *instruction) {
+    Query *query = parser->query;
+    const Token *token = &parser->token;
+    if (token->type != TOKEN_STRING) {
+        return fail(parser, "expected a \"quoted\" name");
+    }
+    size_t length = token->length - 2;
+    if (length >= MAX_NAME_LENGTH || query->stringsUsed + length + 1 > QUERY_TEXT_SIZE) {
+        return fail(parser, "name is too long");
+    }
+    char *text = query->strings + query->stringsUsed;
+    for (size_t i = 0; i < length; i++) {
+        text[i] = (char)tolower((unsigned char)token->start[1 + i]);
+    }
+    text[length] = '\0';
+    query->stringsUsed += (int)length + 1;
+    instruction->text = text;
+    instruction->length = length;
+    nextToken(parser);
+    return true;
+}
+
+static bool parseExpression(Parser *parser, int target);
+
+// not FACTOR | ( EXPRESSION ) | pending | approved | FIELD test
+static bool parseFactor(Parser *parser, int target) {
+    if (target >= QUERY_MAX_REGISTERS) {
+        return fail(parser, "query is nested too deeply");
+    }
+    if (target + 1 > parser->query->registers) {
+        parser->query->registers = target + 1;
+    }
+    if (accept(parser, "not")) {
+        if (!parseFactor(parser, target)) {
+            return false;
+        }
+        QueryInstruction *instruction = emit(parser, OP_NOT, target);
+        if (instruction != NULL) {
+            instruction->left = (uint8_t)target;
+        }
+        return instruction != NULL;
+    }
+    if (accept(parser, "(")) {
+        if (!parseExpression(parser, target)) {
+            return false;
+        }
+        return accept(parser, ")") || fail(parser, "expected )");
+    }
+    if (isToken(parser, "pending") || isToken(parser, "approved")) {
+        QueryInstruction *instruction = emit(parser, OP_COMPARE, target);
+        if (instruction == NULL) {
+            return false;
+        }
+        instruction->field = QUERY_FIELD_STATUS;
+        instruction->compare = CMP_EQ;
+        instruction->value = isToken(parser, "approved");
+        nextToken(parser);
+        return true;
+    }
+
+    QueryField field;
+    if (!parseField(parser, &field)) {
+        return false;
+    }
+    if (field == QUERY_FIELD_NAME) {
+        int op = accept(parser, "contains") ? OP_NAME_CONTAINS
+               : accept(parser, "starts") ? OP_NAME_STARTS
+               : accept(parser, "=") ? OP_NAME_EQUALS : -1;
+        bool negate = op < 0 && accept(parser, "!=");
+        if (negate) {
+            op = OP_NAME_EQUALS;
+        }
+        if (op < 0) {
+            return fail(parser, "expected contains, starts, = or != after name");
+        }
+        QueryInstruction *instruction = emit(parser, op, target);
+        if (instruction == NULL || !addString(parser, instruction)) {
+            return false;
+        }
+        if (negate) {
+            instruction = emit(parser, OP_NOT, target);
+            if (instruction == NULL) {
+                return false;
+            }
+            instruction->left = (uint8_t)target;
+        }
+        return true;
+    }
+
+    int compare;
+    if (!parseCompare(parser, &compare)) {
+        return false;
+    }
+    int64_t value;
+    if (field == QUERY_FIELD_STATUS) {
+        if (compare != CMP_EQ && compare != CMP_NE) {
+            return fail(parser, "status takes = or !=");
+        }
+        if (!isToken(parser, "pending") && !isToken(parser, "approved")) {
+            return fail(parser, "expected pending or approved");
+        }
+        value = isToken(parser, "approved");
+        nextToken(parser);
+    } else if (!parseValue(parser, field, &value)) {
+        return false;
+    }
+    QueryInstruction *instruction = emit(parser, OP_COMPARE, target);
+    if (instruction == NULL) {
+        return false;
+    }
+    instruction->field = (uint8_t)field;
+    instruction->compare = (uint8_t)compare;
+    instruction->value = value;
+    return true;
+}
+
+// Operands go to `target` and `target + 1`; the result ends in `target`
+static bool parseTerm(Parser *parser, int target) {
+    if (!parseFactor(parser, target)) {
+        return false;
+    }
+    while (accept(parser, "and")) {
+        if (!parseFactor(parser, target + 1)) {
+            return false;
+        }
+        QueryInstruction *instruction = emit(parser, OP_AND, target);
+        if (instruction == NULL) {
+            return false;
+        }
+        instruction->left = (uint8_t)target;
+        instruction->right = (uint8_t)(target + 1);
+    }
+    return true;
+}
+
+static bool parseExpression(Parser *parser, int target) {
+    if (!parseTerm(parser, target)) {
+        return false;
+    }
+    while (accept(parser, "or")) {
+        if (!parseTerm(parser, target + 1)) {
+            return false;
+        }
+        QueryInstruction *instruction = emit(parser, OP_OR, target);
+        if (instruction == NULL) {
+            return false;
+        }
+        instruction->left = (uint8_t)target;
+        instruction->right = (uint8_t)(target + 1);
+    }
+    return true;
+}
+
+// count | sum FIELD[, FIELD...] | top N by FIELD [asc|desc] | list | csv
+static bool parseAction(Parser *parser) {
+    Query *query = parser->query;
+    if (accept(parser, "count")) {
+        query->action = QUERY_COUNT;
+    } else if (accept(parser, "list")) {
+        query->action = QUERY_LIST;
+    } else if (accept(parser, "csv")) {
+        query->action = QUERY_CSV;
+    } else if (accept(parser, "sum")) {
+        query->action = QUERY_SUM;
+        do {
+            if (query->sumCount == QUERY_MAX_SUMS) {
+                return fail(parser, "too many sums");
+            }
+            QueryField field;
+            if (!parseField(parser, &field)) {
+                return false;
+            }
+            if (!isNumericField(field) || field == QUERY_FIELD_ROLL) {
+                return fail(parser, "only fees, hostel, dues and books can be summed");
+            }
+            query->sums[query->sumCount++] = field;
+        } while (accept(parser, ","));
+    } else if (accept(parser, "top")) {
+        query->action = QUERY_TOP;
+        int64_t limit;
+        const char *at = parser->token.start;
+        if (!parseValue(parser, QUERY_FIELD_BOOKS, &limit)) {
+            return false;
+        }
+        if (limit < 1 || limit > QUERY_MAX_TOP) {
+            fail(parser, "top takes 1 to 1000000 rows");
+            parser->errorAt = at;
+            return false;
+        }
+        query->limit = (int)limit;
+        if (!accept(parser, "by")) {
+            return fail(parser, "expected by");
+        }
+        if (!parseField(parser, &query->orderBy)) {
+            return false;
+        }
+        if (!isNumericField(query->orderBy)) {
+            return fail(parser, "top orders by roll, fees, hostel, dues or books");
+        }
+        query->ascending = accept(parser, "asc");
+        if (!query->ascending) {
+            accept(parser, "desc");
+        }
+    } else {
+        return fail(parser, "expected count, sum, top, list or csv");
+    }
+    return true;
+}
+
+// Compile `text` into `query`. On failure *error says why and
+// *errorPosition is the offset in `text` where the problem was found.
+bool queryCompile(Query *query, const char *text, int *errorPosition, const char **error) {
+    memset(query, 0, sizeof(*query));
+    Parser parser;
+    memset(&parser, 0, sizeof(parser));
+    parser.text = text;
+    parser.p = text;
+    parser.query = query;
+    nextToken(&parser);
+
+    bool ok = parseAction(&parser);
+    bool where = ok && accept(&parser, "where");
+    if (where) {
+        ok = parseExpression(&parser, 0);
+    }
+    if (ok && accept(&parser, "into")) {
+        const Token *token = &parser.token;
+        if (query->action != QUERY_CSV) {
+            ok = fail(&parser, "into is only for csv");
+        } else if (token->type != TOKEN_STRING || token->length < 3 || token->length - 2 >= QUERY_PATH_SIZE) {
+            ok = fail(&parser, "expected a \"quoted\" file name");
+        } else {
+            memcpy(query->output, token->start + 1, token->length - 2);
+            query->output[token->length - 2] = '\0';
+            nextToken(&parser);
+        }
+    }
+    if (ok && parser.token.type != TOKEN_END) {
+        ok = fail(&parser, where ? "expected and, or or the end of the query" : "expected where");
+    }
+    if (parser.error != NULL) {
+        *error = parser.error;
+        *errorPosition = (int)(parser.errorAt - text);
+        return false;
+    }
+    return ok;
+}
+
+// ---- Filter engine ----
+
+// Flag each of `count` values against `value`, with one loop per operator
+// so the compiler can vectorize each
+#define DEFINE_COMPARE(function, type)                                                      \
+    static void function(const type *column, int count, int compare, int64_t value, uint8_t *flags) { \
+        type v = (type)value;                                                               \
+        switch (compare) {                                                                  \
+            case CMP_EQ: for (int i = 0; i < count; i++) { flags[i] = column[i] == v; } break; \
+            case CMP_NE: for (int i = 0; i < count; i++) { flags[i] = column[i] != v; } break; \
+            case CMP_LT: for (int i = 0; i < count; i++) { flags[i] = column[i] < v; } break;  \
+            case CMP_LE: for (int i = 0; i < count; i++) { flags[i] = column[i] <= v; } break; \
+            case CMP_GT: for (int i = 0; i < count; i++) { flags[i] = column[i] > v; } break;  \
+            default:     for (int i = 0; i < count; i++) { flags[i] = column[i] >= v; } break; \
+        }                                                                                   \
+    }
+
+DEFINE_COMPARE(compareMoney, Money)
+DEFINE_COMPARE(compareInt, int)
+DEFINE_COMPARE(compareInt32, int32_t)
+DEFINE_COMPARE(compareByte, uint8_t)
+
+// `lower` is lowercase; the name is compared without regard to case
+static bool nameMatches(int op, const char *name, const char *lower, size_t length) {
+    if (op == OP_NAME_STARTS) {
+        return strncasecmp(name, lower, length) == 0;
+    }
+    if (op == OP_NAME_EQUALS) {
+        return strcasecmp(name, lower) == 0;
+    }
+    if (length == 0) {
+        return true;
+    }
+    for (; *name != '\0'; name++) {
+        if (tolower((unsigned char)*name) == lower[0] && strncasecmp(name, lower, length) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Scratch space for one block of rows
+typedef struct {
+    uint8_t *registers;         // QUERY_MAX_REGISTERS blocks of flags
+    Money *dues;                // fees + hostel, filled when first needed
+    bool duesReady;
+} BlockState;
+
+static uint8_t *reg(BlockState *state, int index) {
+    return state->registers + (size_t)index * QUERY_BLOCK;
+}
+
+static const Money *blockDues(BlockState *state, const DuesColumns *columns, int base, int count) {
+    if (!state->duesReady) {
+        for (int i = 0; i < count; i++) {
+            state->dues[i] = columns->feesDue[base + i] + columns->hostelDue[base + i];
+        }
+        state->duesReady = true;
+    }
+    return state->dues;
+}
+
+// Run the where clause over rows [base, base + count); flags end in register 0
+static const uint8_t *runBlock(const Query *query, const DuesColumns *columns, const StudentStore *store,
+                               BlockState *state, int base, int count) {
+    uint8_t *result = reg(state, 0);
+    if (query->codeLength == 0) {
+        memset(result, 1, (size_t)count);
+        return result;
+    }
+    state->duesReady = false;
+    for (int k = 0; k < query->codeLength; k++) {
+        const QueryInstruction *in = &query->code[k];
+        uint8_t *flags = reg(state, in->target);
+        switch (in->op) {
+            case OP_COMPARE:
+                switch (in->field) {
+                    case QUERY_FIELD_ROLL:
+                        compareInt(columns->rollNumbers + base, count, in->compare, in->value, flags);
+                        break;
+                    case QUERY_FIELD_FEES:
+                        compareMoney(columns->feesDue + base, count, in->compare, in->value, flags);
+                        break;
+                    case QUERY_FIELD_HOSTEL:
+                        compareMoney(columns->hostelDue + base, count, in->compare, in->value, flags);
+                        break;
+                    case QUERY_FIELD_DUES:
+                        compareMoney(blockDues(state, columns, base, count), count, in->compare, in->value, flags);
+                        break;
+                    case QUERY_FIELD_BOOKS:
+                        compareInt32(columns->booksDue + base, count, in->compare, in->value, flags);
+                        break;
+                    default:
+                        compareByte(columns->approved + base, count, in->compare, in->value, flags);
+                        break;
+                }
+                break;
+            case OP_NAME_EQUALS:
+            case OP_NAME_CONTAINS:
+            case OP_NAME_STARTS:
+                for (int i = 0; i < count; i++) {
+                    const char *name = storeName(store, storeAt(store, base + i));
+                    flags[i] = nameMatches(in->op, name, in->text, in->length);
+                }
+                break;
+            case OP_AND: {
+                const uint8_t *left = reg(state, in->left);
+                const uint8_t *right = reg(state, in->right);
+                for (int i = 0; i < count; i++) {
+                    flags[i] = left[i] & right[i];
+                }
+                break;
+            }
+            case OP_OR: {
+                const uint8_t *left = reg(state, in->left);
+                const uint8_t *right = reg(state, in->right);
+                for (int i = 0; i < count; i++) {
+                    flags[i] = left[i] | right[i];
+                }
+                break;
+            }
+            default: {
+                const uint8_t *left = reg(state, in->left);
+                for (int i = 0; i < count; i++) {
+                    flags[i] = left[i] ^ 1;
+                }
+                break;
+            }
+        }
+    }
+    return result;
+}
+
+// The top N ordering key of rows [base, base + count), negated for asc
+static void blockKeys(const DuesColumns *columns, QueryField field, bool ascending, int base, int count, int64_t *keys) {
+    switch (field) {
+        case QUERY_FIELD_ROLL:
+            for (int i = 0; i < count; i++) {
+                keys[i] = columns->rollNumbers[base + i];
+            }
+            break;
+        case QUERY_FIELD_FEES:
+            memcpy(keys, columns->feesDue + base, sizeof(int64_t) * (size_t)count);
+            break;
+        case QUERY_FIELD_HOSTEL:
+            memcpy(keys, columns->hostelDue + base, sizeof(int64_t) * (size_t)count);
+            break;
+        case QUERY_FIELD_DUES:
+            for (int i = 0; i < count; i++) {
+                keys[i] = columns->feesDue[base + i] + columns->hostelDue[base + i];
+            }
+            break;
+        default:
+            for (int i = 0; i < count; i++) {
+                keys[i] = columns->booksDue[base + i];
+            }
+            break;
+    }
+    if (ascending) {
+        for (int i = 0; i < count; i++) {
+            keys[i] = -keys[i];
+        }
+    }
+}
+
+// Sum of `field` over the flagged rows, branch-free
+static int64_t sumBlock(const DuesColumns *columns, QueryField field, const uint8_t *flags, int base, int count) {
+    int64_t sum = 0;
+    switch (field) {
+        case QUERY_FIELD_FEES:
+            for (int i = 0; i < count; i++) {
+                sum += columns->feesDue[base + i] * flags[i];
+            }
+            break;
+        case QUERY_FIELD_HOSTEL:
+            for (int i = 0; i < count; i++) {
+                sum += columns->hostelDue[base + i] * flags[i];
+            }
+            break;
+        case QUERY_FIELD_DUES:
+            for (int i = 0; i < count; i++) {
+                sum += (columns->feesDue[base + i] + columns->hostelDue[base + i]) * flags[i];
+            }
+            break;
+        default:
+            for (int i = 0; i < count; i++) {
+                sum += (int64_t)columns->booksDue[base + i] * flags[i];
+            }
+            break;
+    }
+    return sum;
+}
+
+// Candidate for top N: ordered by key, then earlier rows first
+typedef struct {
+    int64_t key;
+    int row;
+} TopEntry;
+
+// `a` ranks below `b`
+static bool ranksBelow(const TopEntry *a, const TopEntry *b) {
+    return a->key < b->key || (a->key == b->key && a->row > b->row);
+}
+
+// Min-heap of the best `limit` entries seen: the root is the one to drop
+static void topOffer(TopEntry *heap, int *size, int limit, TopEntry entry) {
+    int i;
+    if (*size < limit) {
+        i = (*size)++;
+        while (i > 0 && ranksBelow(&entry, &heap[(i - 1) / 2])) {
+            heap[i] = heap[(i - 1) / 2];
+            i = (i - 1) / 2;
+        }
+        heap[i] = entry;
+        return;
+    }
+    if (!ranksBelow(&heap[0], &entry)) {
+        return;
+    }
+    i = 0;
+    for (;;) {
+        int child = 2 * i + 1;
+        if (child >= *size) {
+            break;
+        }
+        if (child + 1 < *size && ranksBelow(&heap[child + 1], &heap[child])) {
+            child++;
+        }
+        if (!ranksBelow(&heap[child], &entry)) {
+            break;
+        }
+        heap[i] = heap[child];
+        i = child;
+    }
+    heap[i] = entry;
+}
+
+static int compareTop(const void *a, const void *b) {
+    const TopEntry *x = a;
+    const TopEntry *y = b;
+    return ranksBelow(x, y) ? 1 : (ranksBelow(y, x) ? -1 : 0);
+}
+
+static bool appendRow(int **rows, int *count, int *capacity, int row) {
+    if (*count == *capacity) {
+        int grown = *capacity ? *capacity * 2 : 1024;
+        int *larger = realloc(*rows, sizeof(int) * (size_t)grown);
+        if (larger == NULL) {
+            return false;
+        }
+        *rows = larger;
+        *capacity = grown;
+    }
+    (*rows)[(*count)++] = row;
+    return true;
+}
+
+// Evaluate a compiled query over the dues columns (which the caller keeps
+// in sync with `store`; names are read from the store) a block of rows at
+// a time. False when out of memory.
+bool queryRun(const Query *query, const DuesColumns *columns, const StudentStore *store, QueryResult *result) {
+    memset(result, 0, sizeof(*result));
+    result->rows.store = store;
+    double start = monotonicSeconds();
+    int total = columns->count < store->count ? columns->count : store->count;
+
+    BlockState state;
+    state.registers = malloc((size_t)QUERY_MAX_REGISTERS * QUERY_BLOCK);
+    state.dues = malloc(sizeof(Money) * QUERY_BLOCK);
+    int heapLimit = query->action == QUERY_TOP ? (query->limit < total ? query->limit : total) : 0;
+    TopEntry *heap = malloc(sizeof(TopEntry) * ((size_t)heapLimit + 1));
+    int64_t *keys = malloc(sizeof(int64_t) * QUERY_BLOCK);
+    int heapSize = 0;
+    int *rows = NULL;
+    int rowCount = 0;
+    int rowCapacity = 0;
+    bool ok = state.registers != NULL && state.dues != NULL && heap != NULL && keys != NULL;
+
+    for (int base = 0; base < total && ok; base += QUERY_BLOCK) {
+        int count = total - base < QUERY_BLOCK ? total - base : QUERY_BLOCK;
+        const uint8_t *flags = runBlock(query, columns, store, &state, base, count);
+        long matched = 0;
+        for (int i = 0; i < count; i++) {
+            matched += flags[i];
+        }
+        result->matched += matched;
+        if (matched == 0) {
+            continue;
+        }
+        switch (query->action) {
+            case QUERY_SUM:
+                for (int k = 0; k < query->sumCount; k++) {
+                    result->sums[k] += sumBlock(columns, query->sums[k], flags, base, count);
+                }
+                break;
+            case QUERY_TOP:
+                blockKeys(columns, query->orderBy, query->ascending, base, count, keys);
+                for (int i = 0; i < count; i++) {
+                    int64_t keep = -(int64_t)flags[i];
+                    keys[i] = (keys[i] & keep) | (INT64_MIN & ~keep);
+                }
+                // Once the heap is full almost every row loses to its root,
+                // so this branch is well predicted
+                for (int i = 0; i < count; i++) {
+                    if (keys[i] > (heapSize < heapLimit ? INT64_MIN : heap[0].key)) {
+                        TopEntry entry = { keys[i], base + i };
+                        topOffer(heap, &heapSize, heapLimit, entry);
+                    }
+                }
+                break;
+            case QUERY_LIST:
+            case QUERY_CSV:
+                for (int i = 0; i < count && ok; i++) {
+                    if (flags[i]) {
+                        ok = appendRow(&rows, &rowCount, &rowCapacity, base + i);
+                    }
+                }
+                break;
+            default:
+                break;
+        }
+    }
+
+    if (ok && query->action == QUERY_TOP) {
+        qsort(heap, (size_t)heapSize, sizeof(TopEntry), compareTop);
+        rowCount = 0;
+        rows = malloc(sizeof(int) * ((size_t)heapSize + 1));
+        ok = rows != NULL;
+        for (int i = 0; ok && i < heapSize; i++) {
+            rows[rowCount++] = heap[i].row;
+        }
+    }
+    if (ok && rowCount > 0) {
+        result->rows.rows = malloc(sizeof(const Student *) * (size_t)rowCount);
+        ok = result->rows.rows != NULL;
+        for (int i = 0; ok && i < rowCount; i++) {
+            result->rows.rows[i] = storeAt(store, rows[i]);
+        }
+        result->rows.count = ok ? rowCount : 0;
+    }
+    free(rows);
+    free(keys);
+    free(heap);
+    free(state.dues);
+    free(state.registers);
+    result->seconds = monotonicSeconds() - start;
+    if (!ok) {
+        queryResultFree(result);
+    }
+    return ok;
+}
+
+void queryResultFree(QueryResult *result) {
+    listResultFree(&result->rows);
+}
+
+// Matching rows as CSV with a header line; false on a write error
+bool queryWriteCsv(FILE *out, const ListResult *rows) {
+    fprintf(out, "roll,name,fees_due,books_due,hostel_due,approval_status\n");
+    for (int i = 0; i < rows->count; i++) {
+        const Student *s = rows->rows[i];
+        char fees[MONEY_TEXT_SIZE], hostel[MONEY_TEXT_SIZE];
+        fprintf(out, "%d,%s,%s,%d,%s,%d\n", s->rollNumber, storeName(rows->store, s),
+                moneyText(s->feesDue, fees), s->libraryBooksDue, moneyText(s->hostelDue, hostel), s->approvalStatus);
+    }
+    return !ferror(out);
+}
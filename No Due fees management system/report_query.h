@@ -0,0 +1,82 @@
+#ifndef REPORT_QUERY_H
+#define REPORT_QUERY_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "student_store.h"
+#include "dues_columns.h"
+#include "student_list.h"
+
+#define QUERY_MAX_INSTRUCTIONS 64
+#define QUERY_MAX_REGISTERS 8       // how deeply and/or/not may nest
+#define QUERY_MAX_SUMS 4
+#define QUERY_MAX_TOP 1000000
+#define QUERY_TEXT_SIZE 512         // name literals of one query
+#define QUERY_PATH_SIZE 256
+#define QUERY_BLOCK 1024            // rows each instruction handles per pass
+
+typedef enum {
+    QUERY_COUNT,                    // count [where ...]
+    QUERY_SUM,                      // sum FIELD[, FIELD...] [where ...]
+    QUERY_TOP,                      // top N by FIELD [asc] [where ...]
+    QUERY_LIST,                     // list [where ...]
+    QUERY_CSV                       // csv [where ...] [into "FILE"]
+} QueryAction;
+
+typedef enum {
+    QUERY_FIELD_ROLL,
+    QUERY_FIELD_FEES,
+    QUERY_FIELD_HOSTEL,
+    QUERY_FIELD_DUES,               // fees + hostel
+    QUERY_FIELD_BOOKS,
+    QUERY_FIELD_STATUS,             // 0 = pending, 1 = approved
+    QUERY_FIELD_NAME
+} QueryField;
+
+// One step of a compiled where clause. Steps run over a block of rows at a
+// time; each writes one 0/1 flag per row into register `target`, reading
+// the dues columns (comparisons), the names (name tests) or other
+// registers (and, or, not).
+typedef struct {
+    uint8_t op;
+    uint8_t field;                  // QueryField
+    uint8_t compare;
+    uint8_t target;
+    uint8_t left;
+    uint8_t right;
+    int64_t value;                  // comparison constant (paise for amounts)
+    const char *text;               // name literal, in Query.strings
+    size_t length;
+} QueryInstruction;
+
+// A compiled query: what to report and the where clause as instructions
+typedef struct {
+    QueryAction action;
+    QueryField sums[QUERY_MAX_SUMS];
+    int sumCount;
+    QueryField orderBy;             // top N by
+    bool ascending;
+    int limit;                      // top N
+    char output[QUERY_PATH_SIZE];   // csv into "FILE"; empty = caller's stream
+    QueryInstruction code[QUERY_MAX_INSTRUCTIONS];
+    int codeLength;                 // 0: no where clause, every record matches
+    int registers;
+    char strings[QUERY_TEXT_SIZE];
+    int stringsUsed;
+} Query;
+
+typedef struct {
+    long matched;
+    int64_t sums[QUERY_MAX_SUMS];   // in Query.sums order
+    ListResult rows;                // top, list and csv: matches in output order
+    double seconds;                 // filter and aggregate
+} QueryResult;
+
+bool queryCompile(Query *query, const char *text, int *errorPosition, const char **error);
+bool queryRun(const Query *query, const DuesColumns *columns, const StudentStore *store, QueryResult *result);
+void queryResultFree(QueryResult *result);
+bool queryWriteCsv(FILE *out, const ListResult *rows);
+const char *queryFieldName(QueryField field);
+
+#endif
@@ -0,0 +1,170 @@
+#include <stdlib.h>
+#include <stdint.h>
+#include "roll_map.h"
+
+#define ROLL_MAP_MIN_CAPACITY 16
+
+// Fibonacci hashing: spreads sequential roll numbers across the table
+static unsigned int rollHash(int key, unsigned int mask) {
+    uint32_t h = (uint32_t)key * 2654435769u;
+    h ^= h >> 16;
+    return h & mask;
+}
+
+static RollMapSlot *allocateSlots(unsigned int capacity) {
+    RollMapSlot *slots = malloc(sizeof(RollMapSlot) * capacity);
+    if (slots == NULL) {
+        return NULL;
+    }
+    for (unsigned int i = 0; i < capacity; i++) {
+        slots[i].value = -1;
+    }
+    return slots;
+}
+
+// Insert without growth checks (caller guarantees free space)
+static void insertSlot(RollMapSlot *slots, unsigned int mask, int key, int value) {
+    unsigned int pos = rollHash(key, mask);
+    while (slots[pos].value != -1 && slots[pos].key != key) {
+        pos = (pos + 1) & mask;
+    }
+    slots[pos].key = key;
+    slots[pos].value = value;
+}
+
+// Rehash every entry into a table of the given capacity
+static bool resize(RollMap *map, unsigned int newCapacity) {
+    RollMapSlot *slots = allocateSlots(newCapacity);
+    if (slots == NULL) {
+        return false;
+    }
+    for (unsigned int i = 0; i < map->capacity; i++) {
+        if (map->slots[i].value != -1) {
+            insertSlot(slots, newCapacity - 1, map->slots[i].key, map->slots[i].value);
+        }
+    }
+    if (!map->borrowed) {
+        free(map->slots);
+    }
+    map->slots = slots;
+    map->capacity = newCapacity;
+    map->borrowed = false;
+    return true;
+}
+
+void rollMapInit(RollMap *map) {
+    map->slots = NULL;
+    map->capacity = 0;
+    map->count = 0;
+    map->borrowed = false;
+}
+
+void rollMapFree(RollMap *map) {
+    if (!map->borrowed) {
+        free(map->slots);
+    }
+    rollMapInit(map);
+}
+
+// Use an externally owned, already populated slot table (for example the
+// index section of a mapped snapshot). The table is copied on first growth.
+void rollMapAdopt(RollMap *map, RollMapSlot *slots, unsigned int capacity, unsigned int count) {
+    rollMapFree(map);
+    map->slots = slots;
+    map->capacity = capacity;
+    map->count = count;
+    map->borrowed = true;
+}
+
+// Remove all entries but keep the allocated table
+void rollMapClear(RollMap *map) {
+    for (unsigned int i = 0; i < map->capacity; i++) {
+        map->slots[i].value = -1;
+    }
+    map->count = 0;
+}
+
+// Grow the table up front so expectedCount entries fit under the load limit
+bool rollMapReserve(RollMap *map, unsigned int expectedCount) {
+    unsigned int capacity = map->capacity ? map->capacity : ROLL_MAP_MIN_CAPACITY;
+    // Keep load factor at or below 0.7
+    while ((unsigned long long)expectedCount * 10 > (unsigned long long)capacity * 7) {
+        capacity <<= 1;
+    }
+    if (capacity == map->capacity) {
+        return true;
+    }
+    return resize(map, capacity);
+}
+
+// Look up a key; returns its value or -1 if absent
+int rollMapGet(const RollMap *map, int key) {
+    if (map->count == 0) {
+        return -1;
+    }
+    unsigned int mask = map->capacity - 1;
+    unsigned int pos = rollHash(key, mask);
+    while (map->slots[pos].value != -1) {
+        if (map->slots[pos].key == key) {
+            return map->slots[pos].value;
+        }
+        pos = (pos + 1) & mask;
+    }
+    return -1;
+}
+
+// Insert or overwrite a key; value must be non-negative
+bool rollMapPut(RollMap *map, int key, int value) {
+    if (!rollMapReserve(map, map->count + 1)) {
+        return false;
+    }
+    unsigned int mask = map->capacity - 1;
+    unsigned int pos = rollHash(key, mask);
+    while (map->slots[pos].value != -1) {
+        if (map->slots[pos].key == key) {
+            map->slots[pos].value = value;
+            return true;
+        }
+        pos = (pos + 1) & mask;
+    }
+    map->slots[pos].key = key;
+    map->slots[pos].value = value;
+    map->count++;
+    return true;
+}
+
+// Delete a key; later entries of the probe run are shifted back so lookups
+// never need tombstones. Returns false if the key was absent.
+bool rollMapRemove(RollMap *map, int key) {
+    if (map->count == 0) {
+        return false;
+    }
+    unsigned int mask = map->capacity - 1;
+    unsigned int hole = rollHash(key, mask);
+    while (map->slots[hole].value != -1 && map->slots[hole].key != key) {
+        hole = (hole + 1) & mask;
+    }
+    if (map->slots[hole].value == -1) {
+        return false;
+    }
+
+    unsigned int next = hole;
+    while (1) {
+        next = (next + 1) & mask;
+        if (map->slots[next].value == -1) {
+            break;
+        }
+        // Move the entry into the hole unless its home slot lies
+        // cyclically in (hole, next]
+        unsigned int home = rollHash(map->slots[next].key, mask);
+        bool homeInRange = hole <= next ? (home > hole && home <= next)
+                                        : (home > hole || home <= next);
+        if (!homeInRange) {
+            map->slots[hole] = map->slots[next];
+            hole = next;
+        }
+    }
+    map->slots[hole].value = -1;
+    map->count--;
+    return true;
+}
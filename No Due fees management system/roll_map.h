@@ -0,0 +1,29 @@
+#ifndef ROLL_MAP_H
+#define ROLL_MAP_H
+
+#include <stdbool.h>
+
+// Open-addressing hash map from roll number to a non-negative int value
+// (usually a record position). Linear probing, power-of-two capacity.
+typedef struct {
+    int key;        // roll number
+    int value;      // -1 marks an empty slot
+} RollMapSlot;
+
+typedef struct {
+    RollMapSlot *slots;
+    unsigned int capacity;  // always 0 or a power of two
+    unsigned int count;
+    bool borrowed;          // slots belong to someone else (e.g. a mapped file)
+} RollMap;
+
+void rollMapInit(RollMap *map);
+void rollMapFree(RollMap *map);
+void rollMapAdopt(RollMap *map, RollMapSlot *slots, unsigned int capacity, unsigned int count);
+void rollMapClear(RollMap *map);
+bool rollMapReserve(RollMap *map, unsigned int expectedCount);
+int rollMapGet(const RollMap *map, int key);
+bool rollMapPut(RollMap *map, int key, int value);
+bool rollMapRemove(RollMap *map, int key);
+
+#endif
@@ -0,0 +1,252 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "roster_import.h"
+#include "csv_loader.h"
+#include "file_util.h"
+#include "timing.h"
+
+// One parsed roster line and what it will do
+typedef struct {
+    Student record;         // roster values; approvalStatus only matters for inserts
+    const char *name;       // in the mapped roster (not NUL-terminated)
+    int nameLength;
+    long line;
+    RosterChange change;
+    const char *reason;     // why a row is a conflict
+} RosterRow;
+
+// Roster line: roll,name,fees,books,hostel[,approval]. The registrar's
+// files usually have no approval column; new students then start Pending.
+static bool parseRosterLine(const char *p, const char *end, RosterRow *row, const char **error) {
+    Student *out = &row->record;
+    if (!csvParseInt(&p, end, &out->rollNumber) || p >= end || *p++ != ',') {
+        *error = "bad roll number";
+        return false;
+    }
+    const char *nameStart = p;
+    while (p < end && *p != ',') {
+        p++;
+    }
+    size_t nameLength = (size_t)(p - nameStart);
+    if (nameLength == 0 || nameLength >= MAX_NAME_LENGTH || p >= end) {
+        *error = nameLength == 0 ? "empty name" : (p >= end ? "missing fields after name" : "name too long");
+        return false;
+    }
+    row->name = nameStart;
+    row->nameLength = (int)nameLength;
+    p++;
+    if (!moneyParse(&p, end, &out->feesDue) || p >= end || *p++ != ',') {
+        *error = "bad fees due";
+        return false;
+    }
+    if (!csvParseInt(&p, end, &out->libraryBooksDue) || p >= end || *p++ != ',') {
+        *error = "bad library books due";
+        return false;
+    }
+    if (!moneyParse(&p, end, &out->hostelDue)) {
+        *error = "bad hostel due";
+        return false;
+    }
+    out->approvalStatus = 0;
+    if (p < end && *p == ',') {
+        p++;
+        if (!csvParseInt(&p, end, &out->approvalStatus) || (out->approvalStatus != 0 && out->approvalStatus != 1)) {
+            *error = "bad approval status";
+            return false;
+        }
+    }
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\r')) {
+        p++;
+    }
+    if (p != end) {
+        *error = "unexpected trailing data";
+        return false;
+    }
+    if (out->feesDue < 0 || out->libraryBooksDue < 0 || out->hostelDue < 0) {
+        *error = "negative dues";
+        return false;
+    }
+    return true;
+}
+
+static bool sameName(const char *stored, const RosterRow *row) {
+    return strncmp(stored, row->name, (size_t)row->nameLength) == 0 && stored[row->nameLength] == '\0';
+}
+
+// Hash join of one row against the store's roll index (and against the
+// rows before it, through `seen`)
+static void classifyRow(RosterRow *row, const StudentStore *store, RollMap *seen, int index) {
+    const Student *r = &row->record;
+    if (rollMapGet(seen, r->rollNumber) >= 0) {
+        row->change = ROSTER_CONFLICT;
+        row->reason = "roll listed more than once in the roster";
+        return;
+    }
+    rollMapPut(seen, r->rollNumber, index);
+
+    const Student *s = storeFindByRoll(store, r->rollNumber);
+    if (s == NULL) {
+        row->change = ROSTER_INSERT;
+    } else if (sameName(storeName(store, s), row) && s->feesDue == r->feesDue
+            && s->libraryBooksDue == r->libraryBooksDue && s->hostelDue == r->hostelDue) {
+        row->change = ROSTER_UNCHANGED;
+    } else if (s->approvalStatus != 0 && (r->feesDue > s->feesDue || r->hostelDue > s->hostelDue
+                                          || r->libraryBooksDue > s->libraryBooksDue)) {
+        // New dues for a student already cleared: the admin has to decide
+        row->change = ROSTER_CONFLICT;
+        row->reason = "already approved but the roster shows more dues";
+    } else {
+        row->change = ROSTER_UPDATE;
+    }
+}
+
+static void writeDiffRow(FILE *diff, const RosterRow *row, const StudentStore *store) {
+    const Student *r = &row->record;
+    char before[MONEY_TEXT_SIZE], after[MONEY_TEXT_SIZE];
+    if (row->change == ROSTER_INSERT) {
+        fprintf(diff, "+ %d,%.*s,%s,%d,", r->rollNumber, row->nameLength, row->name,
+                moneyText(r->feesDue, after), r->libraryBooksDue);
+        fprintf(diff, "%s\n", moneyText(r->hostelDue, after));
+        return;
+    }
+    if (row->change == ROSTER_CONFLICT) {
+        fprintf(diff, "! %d (line %ld): %s\n", r->rollNumber, row->line, row->reason);
+        return;
+    }
+    const Student *s = storeFindByRoll(store, r->rollNumber);
+    fprintf(diff, "~ %d:", r->rollNumber);
+    if (!sameName(storeName(store, s), row)) {
+        fprintf(diff, " name '%s' -> '%.*s'", storeName(store, s), row->nameLength, row->name);
+    }
+    if (s->feesDue != r->feesDue) {
+        fprintf(diff, " fees %s -> %s", moneyText(s->feesDue, before), moneyText(r->feesDue, after));
+    }
+    if (s->libraryBooksDue != r->libraryBooksDue) {
+        fprintf(diff, " books %d -> %d", s->libraryBooksDue, r->libraryBooksDue);
+    }
+    if (s->hostelDue != r->hostelDue) {
+        fprintf(diff, " hostel %s -> %s", moneyText(s->hostelDue, before), moneyText(r->hostelDue, after));
+    }
+    fputc('\n', diff);
+}
+
+// Merge a registrar roster into the store. Every row is joined against the
+// roll index: unknown rolls are inserted, rows whose name or dues differ
+// overwrite them (approval status is kept), identical rows are skipped.
+// Conflicts are left alone: a roll listed twice (the first row wins), and
+// more dues for a student who is already approved.
+//
+// The whole roster is classified before anything changes, so a dry run
+// reports exactly what a real run would do. `diff` (may be NULL) gets one
+// line per change: "+" insert, "~" update, "!" conflict, "?" malformed.
+// Changes are made in memory only; the caller persists the store once.
+bool rosterImport(const char *path, StudentStore *store, AuditLog *audit, bool dryRun,
+                  FILE *diff, RosterReport *report) {
+    memset(report, 0, sizeof(*report));
+    double start = monotonicSeconds();
+
+    FileView view;
+    if (!fileViewOpen(path, &view)) {
+        return false;
+    }
+    int capacity = (int)(view.size / 28) + 16;
+    RosterRow *rows = malloc(sizeof(RosterRow) * (size_t)capacity);
+    RollMap seen;
+    rollMapInit(&seen);
+    if (rows == NULL || !rollMapReserve(&seen, (unsigned int)capacity)) {
+        free(rows);
+        fileViewClose(&view);
+        return false;
+    }
+
+    const char *p = view.data;
+    const char *end = view.data + view.size;
+    long lineNumber = 0;
+    int count = 0;
+    bool ok = true;
+    while (ok && p < end) {
+        const char *lineEnd = memchr(p, '\n', (size_t)(end - p));
+        if (lineEnd == NULL) {
+            lineEnd = end;
+        }
+        lineNumber++;
+        const char *q = p;
+        while (q < lineEnd && (*q == ' ' || *q == '\t' || *q == '\r')) {
+            q++;
+        }
+        // Skip blank lines and a header line ("roll,name,...")
+        bool header = report->lines == 0 && report->malformed == 0 && q < lineEnd
+            && (*q < '0' || *q > '9') && *q != '-' && *q != '+';
+        if (q < lineEnd && !header) {
+            report->lines++;
+            if (count == capacity) {
+                capacity *= 2;
+                RosterRow *grown = realloc(rows, sizeof(RosterRow) * (size_t)capacity);
+                if (grown == NULL) {
+                    ok = false;
+                    break;
+                }
+                rows = grown;
+            }
+            RosterRow *row = &rows[count];
+            const char *error;
+            if (parseRosterLine(p, lineEnd, row, &error)) {
+                row->line = lineNumber;
+                classifyRow(row, store, &seen, count);
+                count++;
+            } else {
+                report->malformed++;
+                if (diff != NULL) {
+                    fprintf(diff, "? line %ld: %s\n", lineNumber, error);
+                }
+            }
+        }
+        p = lineEnd + 1;
+    }
+    rollMapFree(&seen);
+    if (!ok) {
+        fileViewClose(&view);
+        free(rows);
+        return false;
+    }
+
+    for (int i = 0; i < count; i++) {
+        switch (rows[i].change) {
+            case ROSTER_INSERT: report->inserted++; break;
+            case ROSTER_UPDATE: report->updated++; break;
+            case ROSTER_CONFLICT: report->conflicts++; break;
+            default: report->unchanged++; break;
+        }
+        if (diff != NULL && rows[i].change != ROSTER_UNCHANGED) {
+            writeDiffRow(diff, &rows[i], store);
+        }
+    }
+    report->parseSeconds = monotonicSeconds() - start;
+
+    if (!dryRun) {
+        double applyStart = monotonicSeconds();
+        ok = storeReserve(store, store->count + report->inserted);
+        for (int i = 0; ok && i < count; i++) {
+            Student *r = &rows[i].record;
+            if (rows[i].change == ROSTER_INSERT) {
+                r->name = storeInternName(store, rows[i].name, (size_t)rows[i].nameLength);
+                ok = storeAdd(store, r) != NULL;
+                auditRecord(audit, r->rollNumber, AUDIT_ADDED, 0, r->feesDue + r->hostelDue, ROSTER_ACTOR);
+            } else if (rows[i].change == ROSTER_UPDATE) {
+                Student *s = storeFindByRoll(store, r->rollNumber);
+                Student before = *s;
+                ok = storeSetName(store, s, rows[i].name, (size_t)rows[i].nameLength);
+                s->feesDue = r->feesDue;
+                s->libraryBooksDue = r->libraryBooksDue;
+                s->hostelDue = r->hostelDue;
+                auditRecordChanges(audit, &before, s, ROSTER_ACTOR);
+            }
+        }
+        report->applied = ok;
+        report->applySeconds = monotonicSeconds() - applyStart;
+    }
+    fileViewClose(&view);
+    free(rows);
+    return ok;
+}
@@ -0,0 +1,36 @@
+#ifndef ROSTER_IMPORT_H
+#define ROSTER_IMPORT_H
+
+#include <stdbool.h>
+#include <stdio.h>
+#include "student_store.h"
+#include "audit_log.h"
+
+#define ROSTER_DIFF_FILENAME "roster_diff.txt"
+#define ROSTER_ACTOR "import"
+
+// What a roster row does to the store
+typedef enum {
+    ROSTER_UNCHANGED = 0,
+    ROSTER_INSERT,          // roll not on record: added
+    ROSTER_UPDATE,          // name or dues differ: overwritten
+    ROSTER_CONFLICT         // left alone for the admin (see rosterImport)
+} RosterChange;
+
+// Outcome of one import
+typedef struct {
+    long lines;             // data lines seen (header and blanks excluded)
+    int malformed;
+    int inserted;
+    int updated;
+    int unchanged;
+    int conflicts;
+    bool applied;           // false for a dry run
+    double parseSeconds;    // map + parse + hash join against the store
+    double applySeconds;
+} RosterReport;
+
+bool rosterImport(const char *path, StudentStore *store, AuditLog *audit, bool dryRun,
+                  FILE *diff, RosterReport *report);
+
+#endif
@@ -0,0 +1,387 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "shards.h"
+#include "csv_loader.h"
+#include "journal.h"
+#include "data_lock.h"
+#include "timing.h"
+
+#define MANIFEST_LINE_LENGTH (SHARD_PATH_SIZE + 128)
+
+typedef void (*ShardTask)(Shard *shard, int index, void *context);
+
+// Shards handed out one at a time to the worker threads
+typedef struct {
+    ShardSet *set;
+    ShardTask task;
+    void *context;
+    pthread_mutex_t lock;
+    int next;
+} ShardRun;
+
+void shardSetInit(ShardSet *set) {
+    set->shards = NULL;
+    set->count = 0;
+}
+
+void shardSetFree(ShardSet *set) {
+    for (int i = 0; i < set->count; i++) {
+        Shard *shard = &set->shards[i];
+        duesColumnsFree(&shard->columns);
+        approvalQueueFree(&shard->queue);
+        storeFree(&shard->store);
+    }
+    free(set->shards);
+    shardSetInit(set);
+}
+
+// Next comma-separated field of `line` (trimmed), or NULL if there is none
+static char *nextField(char **line) {
+    if (*line == NULL) {
+        return NULL;
+    }
+    char *field = *line;
+    char *comma = strchr(field, ',');
+    if (comma != NULL) {
+        *comma = '\0';
+        *line = comma + 1;
+    } else {
+        *line = NULL;
+    }
+    while (*field == ' ' || *field == '\t') {
+        field++;
+    }
+    size_t length = strlen(field);
+    while (length > 0 && (field[length - 1] == ' ' || field[length - 1] == '\t')) {
+        field[--length] = '\0';
+    }
+    return field;
+}
+
+static bool parseRoll(const char *text, int *out) {
+    char *end;
+    long value = strtol(text, &end, 10);
+    if (end == text || *end != '\0' || value < 0 || value > 2147483647L) {
+        return false;
+    }
+    *out = (int)value;
+    return true;
+}
+
+static bool isAbsolutePath(const char *path) {
+    return path[0] == '/' || path[0] == '\\' || (path[0] != '\0' && path[1] == ':');
+}
+
+static int compareFirstRoll(const void *a, const void *b) {
+    const Shard *x = a;
+    const Shard *y = b;
+    return (x->firstRoll > y->firstRoll) - (x->firstRoll < y->firstRoll);
+}
+
+// Read DATA_DIRECTORY/shards.txt: one NAME,DIRECTORY,FIRST_ROLL,LAST_ROLL
+// line per shard ('#' starts a comment). Directories are relative to the
+// data directory unless absolute; roll ranges may not overlap. On failure
+// *errorLine is the offending line (0: the file itself) and *error says why.
+bool shardSetOpen(ShardSet *set, const char *dataDirectory, int *errorLine, const char **error) {
+    char path[SHARD_PATH_SIZE];
+    snprintf(path, sizeof(path), "%s/%s", dataDirectory, SHARD_MANIFEST_FILENAME);
+    *errorLine = 0;
+    FILE *file = fopen(path, "r");
+    if (file == NULL) {
+        *error = "could not open the manifest";
+        return false;
+    }
+    set->shards = calloc(SHARD_MAX, sizeof(Shard));
+    if (set->shards == NULL) {
+        fclose(file);
+        *error = "out of memory";
+        return false;
+    }
+
+    char line[MANIFEST_LINE_LENGTH];
+    int lineNumber = 0;
+    *error = NULL;
+    while (*error == NULL && fgets(line, sizeof(line), file) != NULL) {
+        lineNumber++;
+        line[strcspn(line, "\r\n#")] = '\0';
+        char *rest = line;
+        char *name = nextField(&rest);
+        if (name[0] == '\0' && rest == NULL) {
+            continue; // blank or comment
+        }
+        char *directory = nextField(&rest);
+        char *first = nextField(&rest);
+        char *last = nextField(&rest);
+        if (last == NULL || rest != NULL) {
+            *error = "expected NAME,DIRECTORY,FIRST_ROLL,LAST_ROLL";
+            break;
+        }
+        if (set->count == SHARD_MAX) {
+            *error = "too many shards";
+            break;
+        }
+        Shard *shard = &set->shards[set->count];
+        if (name[0] == '\0' || strlen(name) >= SHARD_NAME_LENGTH) {
+            *error = "name is empty or too long";
+        } else if (directory[0] == '\0' || strlen(dataDirectory) + strlen(directory) + 64 > SHARD_PATH_SIZE) {
+            *error = "directory is empty or too long";
+        } else if (!parseRoll(first, &shard->firstRoll) || !parseRoll(last, &shard->lastRoll)
+                   || shard->firstRoll > shard->lastRoll) {
+            *error = "invalid roll range";
+        }
+        for (int i = 0; i < set->count && *error == NULL; i++) {
+            const Shard *other = &set->shards[i];
+            if (shard->firstRoll <= other->lastRoll && other->firstRoll <= shard->lastRoll) {
+                *error = "roll range overlaps an earlier shard";
+            }
+        }
+        if (*error != NULL) {
+            break;
+        }
+        snprintf(shard->name, sizeof(shard->name), "%s", name);
+        if (isAbsolutePath(directory)) {
+            snprintf(shard->directory, sizeof(shard->directory), "%s", directory);
+        } else {
+            snprintf(shard->directory, sizeof(shard->directory), "%s/%s", dataDirectory, directory);
+        }
+        storeInit(&shard->store);
+        approvalQueueInit(&shard->queue);
+        duesColumnsInit(&shard->columns);
+        set->count++;
+    }
+    fclose(file);
+    if (*error == NULL && set->count == 0) {
+        *error = "no shards listed";
+        lineNumber = 0;
+    }
+    if (*error != NULL) {
+        *errorLine = lineNumber;
+        shardSetFree(set);
+        return false;
+    }
+    qsort(set->shards, set->count, sizeof(Shard), compareFirstRoll);
+    return true;
+}
+
+static void *shardWorker(void *arg) {
+    ShardRun *run = arg;
+    for (;;) {
+        pthread_mutex_lock(&run->lock);
+        int index = run->next++;
+        pthread_mutex_unlock(&run->lock);
+        if (index >= run->set->count) {
+            return NULL;
+        }
+        run->task(&run->set->shards[index], index, run->context);
+    }
+}
+
+// Run `task` on every shard, `threads` shards at a time. Each task touches
+// only its own shard and its own slot of the context.
+static void runOnShards(ShardSet *set, int threads, ShardTask task, void *context) {
+    ShardRun run;
+    run.set = set;
+    run.task = task;
+    run.context = context;
+    run.next = 0;
+    pthread_mutex_init(&run.lock, NULL);
+    if (threads > set->count) {
+        threads = set->count;
+    }
+    if (threads > SHARD_MAX) {
+        threads = SHARD_MAX;
+    }
+    pthread_t workers[SHARD_MAX];
+    int started = 0;
+    for (int t = 1; t < threads; t++) {
+        if (pthread_create(&workers[started], NULL, shardWorker, &run) != 0) {
+            break;
+        }
+        started++;
+    }
+    shardWorker(&run); // this thread takes its share too
+    for (int t = 0; t < started; t++) {
+        pthread_join(workers[t], NULL);
+    }
+    pthread_mutex_destroy(&run.lock);
+}
+
+// Load one shard the way a session in its directory would: the base file,
+// then the journal on top, holding the shard's data lock (shared) meanwhile
+static void loadShard(Shard *shard, int index, void *context) {
+    (void)index;
+    (void)context;
+    double start = monotonicSeconds();
+    char path[SHARD_PATH_SIZE + 32];
+    DataLock lock;
+    DataGenerations generations;
+    snprintf(path, sizeof(path), "%s/%s", shard->directory, DATA_LOCK_FILENAME);
+    bool locked = dataLockOpen(&lock, path) && dataLockAcquire(&lock, false, true, &generations);
+
+    CsvLoadStats stats;
+    snprintf(path, sizeof(path), "%s/%s", shard->directory, STUDENT_FILENAME);
+    shard->loaded = loadStudentsFromCsv(path, &shard->store, &stats);
+    snprintf(path, sizeof(path), "%s/%s", shard->directory, JOURNAL_FILENAME);
+    shard->replayed = journalReplay(path, &shard->store);
+    snprintf(path, sizeof(path), "%s/%s", shard->directory, APPROVAL_FILENAME);
+    approvalQueueLoad(&shard->queue, path);
+
+    if (locked) {
+        dataLockRelease(&lock, NULL);
+    }
+    dataLockClose(&lock);
+
+    shard->misplaced = 0;
+    for (int i = 0; i < shard->store.count; i++) {
+        int roll = storeAt(&shard->store, i)->rollNumber;
+        shard->misplaced += roll < shard->firstRoll || roll > shard->lastRoll;
+    }
+    shard->columns.built = false;
+    shard->loadSeconds = monotonicSeconds() - start;
+}
+
+// Load (or reload) every shard, `threads` at a time. Per-shard outcomes are
+// left in the shards: loaded, replayed, misplaced.
+void shardSetLoad(ShardSet *set, int threads) {
+    for (int i = 0; i < set->count; i++) {
+        Shard *shard = &set->shards[i];
+        approvalQueueFree(&shard->queue);
+        approvalQueueInit(&shard->queue);
+        storeClear(&shard->store);
+    }
+    runOnShards(set, threads, loadShard, NULL);
+}
+
+// Shard whose roll range holds `rollNumber`, or -1
+int shardRoute(const ShardSet *set, int rollNumber) {
+    int low = 0;
+    int high = set->count - 1;
+    while (low <= high) {
+        int mid = low + (high - low) / 2;
+        const Shard *shard = &set->shards[mid];
+        if (rollNumber < shard->firstRoll) {
+            high = mid - 1;
+        } else if (rollNumber > shard->lastRoll) {
+            low = mid + 1;
+        } else {
+            return mid;
+        }
+    }
+    return -1;
+}
+
+// Record for `rollNumber` in the shard that owns it; *shard is that shard
+// (-1 when no range holds the roll)
+Student *shardFindByRoll(const ShardSet *set, int rollNumber, int *shard) {
+    *shard = shardRoute(set, rollNumber);
+    return *shard < 0 ? NULL : storeFindByRoll(&set->shards[*shard].store, rollNumber);
+}
+
+typedef struct {
+    DuesSummary *perShard;
+    bool *failed;
+} DuesJob;
+
+static void summarizeShard(Shard *shard, int index, void *context) {
+    DuesJob *job = context;
+    job->failed[index] = !duesColumnsSync(&shard->columns, &shard->store);
+    if (!job->failed[index]) {
+        duesSummarize(&shard->columns, &job->perShard[index]);
+    }
+}
+
+static void addTotals(DuesTotals *sum, const DuesTotals *part) {
+    sum->students += part->students;
+    sum->owing += part->owing;
+    sum->feesDue += part->feesDue;
+    sum->hostelDue += part->hostelDue;
+    sum->booksDue += part->booksDue;
+}
+
+// Dues summary of each shard (perShard, one per shard) and of all of them,
+// the shards summed concurrently over their dues columns. False if a
+// shard's columns could not be built.
+bool shardSummarizeDues(ShardSet *set, int threads, DuesSummary *perShard, DuesSummary *total) {
+    bool failed[SHARD_MAX] = { false };
+    DuesJob job = { perShard, failed };
+    memset(perShard, 0, sizeof(DuesSummary) * (size_t)set->count);
+    runOnShards(set, threads, summarizeShard, &job);
+
+    memset(total, 0, sizeof(*total));
+    bool ok = true;
+    for (int i = 0; i < set->count; i++) {
+        ok = ok && !failed[i];
+        addTotals(&total->pending, &perShard[i].pending);
+        addTotals(&total->approved, &perShard[i].approved);
+    }
+    return ok;
+}
+
+typedef struct {
+    ShardPendingList *parts;
+    bool *failed;
+} PendingJob;
+
+// The shard's live requests whose student is still pending, in queue order
+static void collectShard(Shard *shard, int index, void *context) {
+    PendingJob *job = context;
+    ShardPendingList *part = &job->parts[index];
+    part->items = malloc(sizeof(ShardPending) * ((size_t)shard->queue.pending + 1));
+    part->count = 0;
+    job->failed[index] = part->items == NULL;
+    if (part->items == NULL) {
+        return;
+    }
+    int cursor = 0;
+    const ApprovalRequest *request;
+    while ((request = approvalQueueNext(&shard->queue, &cursor)) != NULL) {
+        const Student *s = storeFindByRoll(&shard->store, request->rollNumber);
+        if (s == NULL || s->approvalStatus != 0) {
+            continue;
+        }
+        ShardPending *item = &part->items[part->count++];
+        item->shard = index;
+        item->rollNumber = s->rollNumber;
+        item->name = storeName(&shard->store, s);
+        item->due = s->feesDue + s->hostelDue;
+        item->booksDue = s->libraryBooksDue;
+    }
+}
+
+// Pending requests of every shard, gathered concurrently and merged in
+// shard (roll range) order, each shard's in its own queue order
+bool shardCollectPending(ShardSet *set, int threads, ShardPendingList *list) {
+    ShardPendingList parts[SHARD_MAX];
+    bool failed[SHARD_MAX] = { false };
+    PendingJob job = { parts, failed };
+    runOnShards(set, threads, collectShard, &job);
+
+    list->items = NULL;
+    list->count = 0;
+    bool ok = true;
+    size_t total = 0;
+    for (int i = 0; i < set->count; i++) {
+        ok = ok && !failed[i];
+        total += (size_t)parts[i].count;
+    }
+    if (ok) {
+        list->items = malloc(sizeof(ShardPending) * (total + 1));
+        ok = list->items != NULL;
+    }
+    for (int i = 0; i < set->count; i++) {
+        if (ok) {
+            memcpy(list->items + list->count, parts[i].items, sizeof(ShardPending) * (size_t)parts[i].count);
+            list->count += parts[i].count;
+        }
+        free(parts[i].items);
+    }
+    return ok;
+}
+
+void shardPendingFree(ShardPendingList *list) {
+    free(list->items);
+    list->items = NULL;
+    list->count = 0;
+}
@@ -0,0 +1,60 @@
+#ifndef SHARDS_H
+#define SHARDS_H
+
+#include <stdbool.h>
+#include "student_store.h"
+#include "approval_queue.h"
+#include "dues_columns.h"
+
+#define SHARD_MANIFEST_FILENAME "shards.txt"
+#define SHARD_MAX 64
+#define SHARD_NAME_LENGTH 32
+#define SHARD_PATH_SIZE 512
+
+// One campus or roll range: a directory with its own student.txt,
+// student.journal and approval_list.txt, owning rolls [firstRoll, lastRoll]
+typedef struct {
+    char name[SHARD_NAME_LENGTH];
+    char directory[SHARD_PATH_SIZE];
+    int firstRoll;
+    int lastRoll;
+    StudentStore store;
+    ApprovalQueue queue;
+    DuesColumns columns;
+    bool loaded;                // student file read (false: missing or out of memory)
+    long replayed;              // journal entries applied; -1 = unreadable journal
+    int misplaced;              // records outside the shard's roll range
+    double loadSeconds;
+} Shard;
+
+// Every shard listed in a data directory's manifest, in roll order
+typedef struct {
+    Shard *shards;
+    int count;
+} ShardSet;
+
+// A pending request found by a cross-shard query
+typedef struct {
+    int shard;                  // index in ShardSet.shards
+    int rollNumber;
+    const char *name;           // in the shard's store
+    Money due;                  // fees + hostel
+    int booksDue;
+} ShardPending;
+
+typedef struct {
+    ShardPending *items;
+    int count;
+} ShardPendingList;
+
+void shardSetInit(ShardSet *set);
+void shardSetFree(ShardSet *set);
+bool shardSetOpen(ShardSet *set, const char *dataDirectory, int *errorLine, const char **error);
+void shardSetLoad(ShardSet *set, int threads);
+int shardRoute(const ShardSet *set, int rollNumber);
+Student *shardFindByRoll(const ShardSet *set, int rollNumber, int *shard);
+bool shardSummarizeDues(ShardSet *set, int threads, DuesSummary *perShard, DuesSummary *total);
+bool shardCollectPending(ShardSet *set, int threads, ShardPendingList *list);
+void shardPendingFree(ShardPendingList *list);
+
+#endif
@@ -0,0 +1,291 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include "snapshot.h"
+#include "file_util.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#define CHECKSUM_SEED 0x9E3779B97F4A7C15ULL
+
+// Word-at-a-time mixing checksum; cheap enough to run over the whole file
+uint64_t snapshotChecksum(uint64_t hash, const void *data, size_t length) {
+    const unsigned char *p = data;
+    while (length >= 8) {
+        uint64_t word;
+        memcpy(&word, p, 8);
+        hash = (hash ^ word) * 0x100000001B3ULL;
+        hash ^= hash >> 29;
+        p += 8;
+        length -= 8;
+    }
+    while (length > 0) {
+        hash = (hash ^ *p++) * 0x100000001B3ULL;
+        length--;
+    }
+    return hash;
+}
+
+static uint64_t headerChecksum(const SnapshotHeader *header) {
+    return snapshotChecksum(CHECKSUM_SEED, header, offsetof(SnapshotHeader, headerChecksum));
+}
+
+// Write the store to `path` via a temp file and atomic rename
+bool snapshotWrite(const char *path, const StudentStore *store) {
+    char tempPath[512];
+    snprintf(tempPath, sizeof(tempPath), "%s.tmp", path);
+
+    FILE *file = fopen(tempPath, "wb");
+    if (file == NULL) {
+        printf("Error: Could not create snapshot file %s.\n", tempPath);
+        return false;
+    }
+
+    SnapshotHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = SNAPSHOT_VERSION;
+    header.recordSize = sizeof(Student);
+    header.recordCount = (uint32_t)store->count;
+    header.indexCapacity = store->index.capacity;
+    header.recordsOffset = sizeof(SnapshotHeader);
+    header.indexOffset = header.recordsOffset + (uint64_t)store->count * sizeof(Student);
+    header.fileSize = header.indexOffset + (uint64_t)store->index.capacity * sizeof(RollMapSlot)
+        + store->names.used;
+
+    // Placeholder header; rewritten once the checksum is known
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+
+    uint64_t checksum = CHECKSUM_SEED;
+    for (int first = 0; ok && first < store->count; first += STORE_CHUNK_SIZE) {
+        int n = store->count - first < STORE_CHUNK_SIZE ? store->count - first : STORE_CHUNK_SIZE;
+        const Student *chunk = storeAt(store, first);
+        checksum = snapshotChecksum(checksum, chunk, sizeof(Student) * n);
+        ok = fwrite(chunk, sizeof(Student), (size_t)n, file) == (size_t)n;
+    }
+    if (ok && store->index.capacity > 0) {
+        checksum = snapshotChecksum(checksum, store->index.slots, sizeof(RollMapSlot) * store->index.capacity);
+        ok = fwrite(store->index.slots, sizeof(RollMapSlot), store->index.capacity, file) == store->index.capacity;
+    }
+    // Whole blocks (zero tails included) keep every name at its arena offset
+    for (int b = 0; ok && b < store->names.blockCount; b++) {
+        uint32_t base = (uint32_t)b << NAME_BLOCK_SHIFT;
+        if (base >= store->names.used) {
+            break;
+        }
+        size_t n = store->names.used - base < NAME_BLOCK_SIZE ? store->names.used - base : NAME_BLOCK_SIZE;
+        checksum = snapshotChecksum(checksum, store->names.blocks[b], n);
+        ok = fwrite(store->names.blocks[b], 1, n, file) == n;
+    }
+
+    header.dataChecksum = checksum;
+    header.headerChecksum = headerChecksum(&header);
+    ok = ok && fseek(file, 0, SEEK_SET) == 0
+            && fwrite(&header, sizeof(header), 1, file) == 1
+            && flushAndSync(file);
+    ok = (fclose(file) == 0) && ok;
+
+    if (!ok || !replaceFileAtomically(tempPath, path)) {
+        printf("Error: Could not write snapshot file %s.\n", path);
+        remove(tempPath);
+        return false;
+    }
+    return true;
+}
+
+// Bring the file into memory: a private writable mapping on POSIX (edits
+// stay in memory), a heap copy elsewhere
+static bool mapSnapshotFile(const char *path, Snapshot *snapshot) {
+    snapshot->base = NULL;
+    snapshot->size = 0;
+    snapshot->mapped = false;
+#ifdef _WIN32
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) {
+        return false;
+    }
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    if (size <= 0 || (snapshot->base = malloc((size_t)size)) == NULL
+            || fread(snapshot->base, 1, (size_t)size, file) != (size_t)size) {
+        free(snapshot->base);
+        snapshot->base = NULL;
+        fclose(file);
+        return false;
+    }
+    snapshot->size = (size_t)size;
+    fclose(file);
+    return true;
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        close(fd);
+        return false;
+    }
+    void *map = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        return false;
+    }
+    snapshot->base = map;
+    snapshot->size = (size_t)st.st_size;
+    snapshot->mapped = true;
+    return true;
+#endif
+}
+
+void snapshotClose(Snapshot *snapshot) {
+    if (snapshot->base == NULL) {
+        return;
+    }
+#ifndef _WIN32
+    if (snapshot->mapped) {
+        munmap(snapshot->base, snapshot->size);
+    } else {
+        free(snapshot->base);
+    }
+#else
+    free(snapshot->base);
+#endif
+    snapshot->base = NULL;
+    snapshot->size = 0;
+}
+
+// The index and names of a current-version file are used in place, so a
+// bad slot or name offset would send lookups outside the mapping: every
+// slot must point at a record with its roll number, and every name must
+// start inside the names section and end in the same block.
+static const char *checkIndexAndNames(const SnapshotHeader *header, const Student *records,
+                                      const RollMapSlot *slots, const char *names, uint32_t namesSize) {
+    uint32_t capacity = header->indexCapacity;
+    if ((capacity & (capacity - 1)) != 0 || (capacity == 0 && header->recordCount > 0)
+            || (capacity > 0 && header->recordCount >= capacity)) {
+        return "index size is not a power of two above the record count";
+    }
+    uint32_t used = 0;
+    for (uint32_t i = 0; i < capacity; i++) {
+        if (slots[i].value == -1) {
+            continue;
+        }
+        if (slots[i].value < 0 || (uint32_t)slots[i].value >= header->recordCount
+                || records[slots[i].value].rollNumber != slots[i].key) {
+            return "bad roll index slot";
+        }
+        used++;
+    }
+    if (used != header->recordCount) {
+        return "roll index does not cover every record";
+    }
+    for (uint32_t i = 0; i < header->recordCount; i++) {
+        uint32_t offset = records[i].name;
+        uint32_t blockEnd = (offset | NAME_BLOCK_MASK) + 1;
+        uint32_t end = blockEnd != 0 && blockEnd < namesSize ? blockEnd : namesSize;
+        if (offset >= namesSize || memchr(names + offset, '\0', end - offset) == NULL) {
+            return "bad name offset in a record";
+        }
+    }
+    return NULL;
+}
+
+// Validate the header and lay the store over the mapped records. The full
+// data checksum touches every page, so it is only checked when asked for;
+// snapshots are always replaced atomically, which rules out torn files.
+bool snapshotLoad(const char *path, Snapshot *snapshot, StudentStore *store, bool verifyData) {
+    if (!mapSnapshotFile(path, snapshot)) {
+        return false;
+    }
+
+    const char *problem = NULL;
+    SnapshotHeader header;
+    size_t recordSize = 0;
+    uint64_t namesOffset = 0;
+    if (snapshot->size < sizeof(header)) {
+        problem = "file too small";
+    } else {
+        memcpy(&header, snapshot->base, sizeof(header));
+        recordSize = header.version == 1 ? sizeof(StudentV1)
+                   : header.version == 2 ? sizeof(StudentV2) : sizeof(Student);
+        namesOffset = header.indexOffset + (uint64_t)header.indexCapacity * sizeof(RollMapSlot);
+        if (memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic)) != 0) {
+            problem = "not a student snapshot";
+        } else if (header.headerChecksum != headerChecksum(&header)) {
+            problem = "header checksum mismatch";
+        } else if (header.version < 1 || header.version > SNAPSHOT_VERSION || header.recordSize != recordSize) {
+            problem = "written by an incompatible version";
+        } else if (header.fileSize != snapshot->size || header.recordCount > INT_MAX
+                || header.recordsOffset != sizeof(SnapshotHeader)
+                || header.indexOffset != header.recordsOffset + (uint64_t)header.recordCount * recordSize
+                || namesOffset > header.fileSize || header.fileSize - namesOffset > UINT32_MAX
+                || (header.version < SNAPSHOT_VERSION && header.fileSize != namesOffset)) {
+            problem = "truncated or inconsistent sections";
+        } else if (verifyData) {
+            uint64_t checksum = snapshotChecksum(CHECKSUM_SEED,
+                                                 (char *)snapshot->base + header.recordsOffset,
+                                                 snapshot->size - header.recordsOffset);
+            if (checksum != header.dataChecksum) {
+                problem = "data checksum mismatch";
+            }
+        }
+    }
+
+    if (problem == NULL && header.version < SNAPSHOT_VERSION) {
+        // Old layout: copy the records out converted; the next compaction
+        // writes the file in the current version
+        const char *old = (const char *)snapshot->base + header.recordsOffset;
+        if (!storeReserve(store, (int)header.recordCount)) {
+            problem = "out of memory";
+        }
+        for (uint32_t i = 0; problem == NULL && i < header.recordCount; i++) {
+            StudentV2 converted;
+            if (header.version == 1) {
+                StudentV1 v1;
+                memcpy(&v1, old + (size_t)i * recordSize, sizeof(v1));
+                if (!studentFromV1(&v1, &converted)) {
+                    problem = "bad amount in a record";
+                    break;
+                }
+            } else {
+                memcpy(&converted, old + (size_t)i * recordSize, sizeof(converted));
+            }
+            if (storeAddLegacy(store, &converted) == NULL && storeFindByRoll(store, converted.rollNumber) == NULL) {
+                problem = "out of memory";
+            }
+        }
+        if (problem == NULL) {
+            printf("Converted %s from version %u (%s).\n", path, header.version,
+                   header.version == 1 ? "dues are now kept in paise" : "names are now kept in an arena");
+            snapshotClose(snapshot);
+            return true;
+        }
+    } else if (problem == NULL) {
+        Student *records = (Student *)((char *)snapshot->base + header.recordsOffset);
+        RollMapSlot *slots = (RollMapSlot *)((char *)snapshot->base + header.indexOffset);
+        char *names = (char *)snapshot->base + namesOffset;
+        uint32_t namesSize = (uint32_t)(header.fileSize - namesOffset);
+        problem = checkIndexAndNames(&header, records, slots, names, namesSize);
+        if (problem == NULL && !storeAttach(store, records, (int)header.recordCount, slots, header.indexCapacity,
+                                            names, namesSize)) {
+            problem = "could not attach records";
+        }
+    }
+
+    if (problem != NULL) {
+        printf("Error: Snapshot %s rejected: %s.\n", path, problem);
+        // Drop whatever was converted or borrowed before the mapping goes
+        storeFree(store);
+        snapshotClose(snapshot);
+        return false;
+    }
+    return true;
+}
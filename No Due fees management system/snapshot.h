@@ -0,0 +1,44 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "student_store.h"
+
+#define SNAPSHOT_FILENAME "student.snap"
+#define SNAPSHOT_MAGIC "NODUESNP"
+#define SNAPSHOT_VERSION 3          // 1 = dues as float (StudentV1), 2 = names inline (StudentV2)
+
+// On-disk layout (native byte order):
+//   [header, 64 bytes][records: recordCount * recordSize][roll index slots][names]
+// The index section is a RollMap slot table and the names section the name
+// arena's blocks as they are in memory (runs to the end of the file), so a
+// mapped snapshot can be searched and printed without building anything at
+// startup. Versions 1 and 2 have no names section.
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t recordSize;        // sizeof(Student) of the writer
+    uint32_t recordCount;
+    uint32_t indexCapacity;     // RollMap slots (power of two)
+    uint64_t recordsOffset;
+    uint64_t indexOffset;
+    uint64_t fileSize;
+    uint64_t dataChecksum;      // over the records, index and names sections
+    uint64_t headerChecksum;    // over every header field above
+} SnapshotHeader;
+
+// A snapshot held in memory: mapped copy-on-write where available
+typedef struct {
+    void *base;
+    size_t size;
+    bool mapped;
+} Snapshot;
+
+bool snapshotWrite(const char *path, const StudentStore *store);
+bool snapshotLoad(const char *path, Snapshot *snapshot, StudentStore *store, bool verifyData);
+void snapshotClose(Snapshot *snapshot);
+uint64_t snapshotChecksum(uint64_t hash, const void *data, size_t length);
+
+#endif
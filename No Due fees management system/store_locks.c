@@ -0,0 +1,59 @@
+#include "store_locks.h"
+
+static pthread_rwlock_t *shardFor(StoreLocks *locks, int rollNumber) {
+    // Consecutive roll numbers land in different shards
+    unsigned int hash = (unsigned int)rollNumber * 2654435761u;
+    return &locks->shards[(hash >> 16) & (STORE_LOCK_SHARDS - 1)];
+}
+
+bool storeLocksInit(StoreLocks *locks) {
+    if (pthread_rwlock_init(&locks->structure, NULL) != 0) {
+        return false;
+    }
+    for (int i = 0; i < STORE_LOCK_SHARDS; i++) {
+        if (pthread_rwlock_init(&locks->shards[i], NULL) != 0) {
+            while (i-- > 0) {
+                pthread_rwlock_destroy(&locks->shards[i]);
+            }
+            pthread_rwlock_destroy(&locks->structure);
+            return false;
+        }
+    }
+    return true;
+}
+
+void storeLocksFree(StoreLocks *locks) {
+    for (int i = 0; i < STORE_LOCK_SHARDS; i++) {
+        pthread_rwlock_destroy(&locks->shards[i]);
+    }
+    pthread_rwlock_destroy(&locks->structure);
+}
+
+// Lock one record for reading or for changing its fields
+void storeLockRecord(StoreLocks *locks, int rollNumber, bool write) {
+    pthread_rwlock_rdlock(&locks->structure);
+    if (write) {
+        pthread_rwlock_wrlock(shardFor(locks, rollNumber));
+    } else {
+        pthread_rwlock_rdlock(shardFor(locks, rollNumber));
+    }
+}
+
+void storeUnlockRecord(StoreLocks *locks, int rollNumber) {
+    pthread_rwlock_unlock(shardFor(locks, rollNumber));
+    pthread_rwlock_unlock(&locks->structure);
+}
+
+// Whole-store read (counts, scans that tolerate concurrent field updates)
+void storeLockShared(StoreLocks *locks) {
+    pthread_rwlock_rdlock(&locks->structure);
+}
+
+// Whole-store write: no record lock can be held while this is
+void storeLockExclusive(StoreLocks *locks) {
+    pthread_rwlock_wrlock(&locks->structure);
+}
+
+void storeUnlock(StoreLocks *locks) {
+    pthread_rwlock_unlock(&locks->structure);
+}
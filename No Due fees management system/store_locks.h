@@ -0,0 +1,29 @@
+#ifndef STORE_LOCKS_H
+#define STORE_LOCKS_H
+
+#include <stdbool.h>
+#include <pthread.h>
+
+#define STORE_LOCK_SHARDS 64        // power of two
+
+// Thread-level locking for a shared StudentStore. Records are striped over
+// STORE_LOCK_SHARDS reader/writer locks by roll number, so lookups never
+// wait for each other and updates only contend within one shard. Changes
+// to the store's shape (adding records, reloading, compaction) take the
+// structure lock exclusively; per-record access holds it shared.
+//
+// Lock order: structure, then one shard.
+typedef struct {
+    pthread_rwlock_t structure;
+    pthread_rwlock_t shards[STORE_LOCK_SHARDS];
+} StoreLocks;
+
+bool storeLocksInit(StoreLocks *locks);
+void storeLocksFree(StoreLocks *locks);
+void storeLockRecord(StoreLocks *locks, int rollNumber, bool write);
+void storeUnlockRecord(StoreLocks *locks, int rollNumber);
+void storeLockShared(StoreLocks *locks);
+void storeLockExclusive(StoreLocks *locks);
+void storeUnlock(StoreLocks *locks);
+
+#endif
@@ -0,0 +1,216 @@
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "student_list.h"
+
+void listQueryDefaults(ListQuery *query) {
+    query->pendingOnly = false;
+    query->booksDueOnly = false;
+    query->minDues = -1;
+    query->namePrefix[0] = '\0';
+    query->sort = LIST_SORT_ROLL;
+}
+
+static bool hasPrefixIgnoreCase(const char *name, const char *prefix) {
+    for (; *prefix != '\0'; name++, prefix++) {
+        if (tolower((unsigned char)*name) != tolower((unsigned char)*prefix)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool listMatches(const StudentStore *store, const ListQuery *query, const Student *s) {
+    return (!query->pendingOnly || s->approvalStatus == 0)
+        && (!query->booksDueOnly || s->libraryBooksDue > 0)
+        && (query->minDues < 0 || s->feesDue + s->hostelDue > query->minDues)
+        && (query->namePrefix[0] == '\0' || hasPrefixIgnoreCase(storeName(store, s), query->namePrefix));
+}
+
+static int compareRoll(const void *a, const void *b) {
+    int x = (*(const Student *const *)a)->rollNumber;
+    int y = (*(const Student *const *)b)->rollNumber;
+    return (x > y) - (x < y);
+}
+
+// Row paired with its name while sorting by name
+typedef struct {
+    const char *name;
+    const Student *student;
+} NamedRow;
+
+static int compareName(const void *a, const void *b) {
+    const NamedRow *x = a;
+    const NamedRow *y = b;
+    int order = strcmp(x->name, y->name);
+    if (order != 0) {
+        return order;
+    }
+    return (x->student->rollNumber > y->student->rollNumber) - (x->student->rollNumber < y->student->rollNumber);
+}
+
+// Names are in the store's arena, so pair each row with its name first
+static bool sortByName(const StudentStore *store, ListResult *result) {
+    NamedRow *named = malloc(sizeof(NamedRow) * ((size_t)result->count + 1));
+    if (named == NULL) {
+        return false;
+    }
+    for (int i = 0; i < result->count; i++) {
+        named[i].name = storeName(store, result->rows[i]);
+        named[i].student = result->rows[i];
+    }
+    qsort(named, result->count, sizeof(NamedRow), compareName);
+    for (int i = 0; i < result->count; i++) {
+        result->rows[i] = named[i].student;
+    }
+    free(named);
+    return true;
+}
+
+static int compareDues(const void *a, const void *b) {
+    const Student *x = *(const Student *const *)a;
+    const Student *y = *(const Student *const *)b;
+    Money dx = x->feesDue + x->hostelDue;
+    Money dy = y->feesDue + y->hostelDue;
+    if (dx != dy) {
+        return dx < dy ? 1 : -1;
+    }
+    return compareRoll(a, b);
+}
+
+// Collect the matching records and sort them for display
+bool listSelect(const StudentStore *store, const ListQuery *query, ListResult *result) {
+    result->rows = NULL;
+    result->count = 0;
+    result->store = store;
+    if (store->count == 0) {
+        return true;
+    }
+    result->rows = malloc(sizeof(const Student *) * store->count);
+    if (result->rows == NULL) {
+        return false;
+    }
+    for (int i = 0; i < store->count; i++) {
+        const Student *s = storeAt(store, i);
+        if (listMatches(store, query, s)) {
+            result->rows[result->count++] = s;
+        }
+    }
+    switch (query->sort) {
+        case LIST_SORT_NAME:
+            if (!sortByName(store, result)) {
+                listResultFree(result);
+                return false;
+            }
+            break;
+        case LIST_SORT_DUES:
+            qsort(result->rows, result->count, sizeof(const Student *), compareDues);
+            break;
+        default:
+            qsort(result->rows, result->count, sizeof(const Student *), compareRoll);
+    }
+    return true;
+}
+
+void listResultFree(ListResult *result) {
+    free(result->rows);
+    result->rows = NULL;
+    result->count = 0;
+}
+
+int listPageCount(const ListResult *result, int pageSize) {
+    if (pageSize <= 0) {
+        return result->count > 0 ? 1 : 0;
+    }
+    return (result->count + pageSize - 1) / pageSize;
+}
+
+// Output buffer shared by one listWriteRows call
+typedef struct {
+    FILE *out;
+    char *data;
+    size_t used;
+} ListBuffer;
+
+static void flushBuffer(ListBuffer *buffer) {
+    fwrite(buffer->data, 1, buffer->used, buffer->out);
+    buffer->used = 0;
+}
+
+static void appendText(ListBuffer *buffer, const char *text, size_t length) {
+    memcpy(buffer->data + buffer->used, text, length);
+    buffer->used += length;
+}
+
+static void appendInt(ListBuffer *buffer, long long value) {
+    char digits[24];
+    int n = 0;
+    bool negative = value < 0;
+    unsigned long long v = negative ? 0ULL - (unsigned long long)value : (unsigned long long)value;
+    do {
+        digits[n++] = (char)('0' + v % 10);
+        v /= 10;
+    } while (v > 0);
+    if (negative) {
+        buffer->data[buffer->used++] = '-';
+    }
+    while (n > 0) {
+        buffer->data[buffer->used++] = digits[--n];
+    }
+}
+
+static void appendAmount(ListBuffer *buffer, Money amount) {
+    buffer->used += (size_t)moneyFormat(amount, buffer->data + buffer->used);
+}
+
+// Write rows [first, first + count) in the All Student Records table layout.
+// Rows are formatted straight into one large buffer that is written out in
+// blocks, instead of one printf per row.
+void listWriteRows(FILE *out, const ListResult *result, int first, int count) {
+    static const char *statusText[] = { "Pending", "Approved" };
+    // Longest row: numbers, a full name, tabs and the status text
+    const size_t maxRow = MAX_NAME_LENGTH + 160;
+
+    if (first < 0) {
+        first = 0;
+    }
+    if (count < 0 || first + count > result->count) {
+        count = result->count - first;
+    }
+    if (count <= 0) {
+        return;
+    }
+    ListBuffer buffer = { out, malloc(LIST_BUFFER_SIZE), 0 };
+    if (buffer.data == NULL) {
+        return;
+    }
+
+    fflush(out); // keep earlier printf output ahead of the table
+    for (int i = first; i < first + count; i++) {
+        const Student *s = result->rows[i];
+        if (buffer.used + maxRow > LIST_BUFFER_SIZE) {
+            flushBuffer(&buffer);
+        }
+        appendInt(&buffer, s->rollNumber);
+        appendText(&buffer, "\t", 1);
+        const char *name = storeName(result->store, s);
+        size_t nameLength = strnlen(name, MAX_NAME_LENGTH);
+        appendText(&buffer, name, nameLength);
+        for (size_t pad = nameLength; pad < 12; pad++) {
+            buffer.data[buffer.used++] = ' ';
+        }
+        appendText(&buffer, "\t", 1);
+        appendAmount(&buffer, s->feesDue);
+        appendText(&buffer, "\t\t", 2);
+        appendInt(&buffer, s->libraryBooksDue);
+        appendText(&buffer, "\t\t", 2);
+        appendAmount(&buffer, s->hostelDue);
+        appendText(&buffer, "\t\t", 2);
+        const char *status = statusText[s->approvalStatus != 0];
+        appendText(&buffer, status, strlen(status));
+        appendText(&buffer, "\n", 1);
+    }
+    flushBuffer(&buffer);
+    fflush(out);
+    free(buffer.data);
+}
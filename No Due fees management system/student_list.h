@@ -0,0 +1,40 @@
+#ifndef STUDENT_LIST_H
+#define STUDENT_LIST_H
+
+#include <stdbool.h>
+#include <stdio.h>
+#include "student_store.h"
+
+#define LIST_BUFFER_SIZE (256 * 1024)   // output is flushed in blocks of this size
+
+typedef enum {
+    LIST_SORT_ROLL,
+    LIST_SORT_NAME,
+    LIST_SORT_DUES          // fees + hostel due, highest first
+} ListSort;
+
+// Which students to list and in what order; filters combine with AND
+typedef struct {
+    bool pendingOnly;                   // approvalStatus == 0
+    bool booksDueOnly;                  // libraryBooksDue > 0
+    Money minDues;                      // fees + hostel due above this; negative = any
+    char namePrefix[MAX_NAME_LENGTH];   // case-insensitive; empty = any
+    ListSort sort;
+} ListQuery;
+
+// Matching records, in listing order. Pointers stay valid while the store
+// only grows (records never move), but not across storeClear/storeFree.
+typedef struct {
+    const Student **rows;
+    int count;
+    const StudentStore *store;          // holds the rows' names
+} ListResult;
+
+void listQueryDefaults(ListQuery *query);
+bool listMatches(const StudentStore *store, const ListQuery *query, const Student *s);
+bool listSelect(const StudentStore *store, const ListQuery *query, ListResult *result);
+void listResultFree(ListResult *result);
+int listPageCount(const ListResult *result, int pageSize);
+void listWriteRows(FILE *out, const ListResult *result, int first, int count);
+
+#endif
@@ -0,0 +1,172 @@
+#include <stdlib.h>
+#include <string.h>
+#include "student_store.h"
+
+void storeInit(StudentStore *store) {
+    store->chunks = NULL;
+    store->chunkCount = 0;
+    store->chunkCapacity = 0;
+    store->borrowedChunks = 0;
+    store->count = 0;
+    rollMapInit(&store->index);
+    nameArenaInit(&store->names);
+}
+
+// Release every chunk and the index
+void storeFree(StudentStore *store) {
+    for (int i = store->borrowedChunks; i < store->chunkCount; i++) {
+        free(store->chunks[i]);
+    }
+    free(store->chunks);
+    rollMapFree(&store->index);
+    nameArenaFree(&store->names);
+    storeInit(store);
+}
+
+// Drop all records (and names) but keep the allocated chunks for reuse
+void storeClear(StudentStore *store) {
+    store->count = 0;
+    rollMapClear(&store->index);
+    nameArenaFree(&store->names);
+}
+
+// Make sure the chunk directory has room for `needed` chunk pointers
+static bool growChunkDirectory(StudentStore *store, int needed) {
+    if (needed <= store->chunkCapacity) {
+        return true;
+    }
+    int newCapacity = store->chunkCapacity ? store->chunkCapacity : 8;
+    while (newCapacity < needed) {
+        newCapacity *= 2;
+    }
+    Student **chunks = realloc(store->chunks, sizeof(Student *) * newCapacity);
+    if (chunks == NULL) {
+        return false;
+    }
+    store->chunks = chunks;
+    store->chunkCapacity = newCapacity;
+    return true;
+}
+
+// Pre-allocate chunks and index space for expectedCount records
+bool storeReserve(StudentStore *store, int expectedCount) {
+    while (store->chunkCount * STORE_CHUNK_SIZE < expectedCount) {
+        if (!growChunkDirectory(store, store->chunkCount + 1)) {
+            return false;
+        }
+        Student *chunk = malloc(sizeof(Student) * STORE_CHUNK_SIZE);
+        if (chunk == NULL) {
+            return false;
+        }
+        store->chunks[store->chunkCount++] = chunk;
+    }
+    return rollMapReserve(&store->index, (unsigned int)expectedCount);
+}
+
+// Serve records straight from external memory (e.g. a mapped snapshot)
+// without copying them. Full chunks point into the caller's array; only the
+// trailing partial chunk is copied so the store can keep growing. The
+// index slots must have been built by RollMap for exactly these records,
+// and `names` must be the name arena the records' offsets refer to.
+// The caller keeps the memory alive until storeFree().
+bool storeAttach(StudentStore *store, Student *records, int count,
+                 RollMapSlot *indexSlots, unsigned int indexCapacity, char *names, uint32_t namesSize) {
+    if (store->count != 0 || store->chunkCount != 0) {
+        return false;
+    }
+    int fullChunks = count / STORE_CHUNK_SIZE;
+    int remainder = count % STORE_CHUNK_SIZE;
+    if (!growChunkDirectory(store, fullChunks + 1)) {
+        return false;
+    }
+    for (int i = 0; i < fullChunks; i++) {
+        store->chunks[i] = records + (size_t)i * STORE_CHUNK_SIZE;
+    }
+    store->chunkCount = fullChunks;
+    store->borrowedChunks = fullChunks;
+    if (remainder > 0) {
+        Student *chunk = malloc(sizeof(Student) * STORE_CHUNK_SIZE);
+        if (chunk == NULL) {
+            return false;
+        }
+        memcpy(chunk, records + (size_t)fullChunks * STORE_CHUNK_SIZE, sizeof(Student) * remainder);
+        store->chunks[store->chunkCount++] = chunk;
+    }
+    if (!nameArenaAttach(&store->names, names, namesSize)) {
+        return false;
+    }
+    rollMapAdopt(&store->index, indexSlots, indexCapacity, (unsigned int)count);
+    store->count = count;
+    return true;
+}
+
+// Copy a record into the store; its name must come from storeInternName()
+// on this store. Returns NULL if the roll number is already present, the
+// name could not be stored or memory runs out.
+Student *storeAdd(StudentStore *store, const Student *student) {
+    if (rollMapGet(&store->index, student->rollNumber) != -1 || student->name == NAME_NONE) {
+        return NULL;
+    }
+    if (store->names.blockCount == 0 && nameArenaIntern(&store->names, "", 0) == NAME_NONE) {
+        return NULL;
+    }
+    if (!storeReserve(store, store->count + 1)) {
+        return NULL;
+    }
+    Student *slot = storeAt(store, store->count);
+    *slot = *student;
+    if (!rollMapPut(&store->index, student->rollNumber, store->count)) {
+        return NULL;
+    }
+    store->count++;
+    return slot;
+}
+
+// O(1) lookup by roll number; NULL if not found
+Student *storeFindByRoll(const StudentStore *store, int rollNumber) {
+    int pos = rollMapGet(&store->index, rollNumber);
+    return pos == -1 ? NULL : storeAt(store, pos);
+}
+
+// Add a record read from a version-1/2 file
+Student *storeAddLegacy(StudentStore *store, const StudentV2 *old) {
+    Student record;
+    record.rollNumber = old->rollNumber;
+    record.name = storeInternName(store, old->name, strnlen(old->name, LEGACY_NAME_LENGTH));
+    record.feesDue = old->feesDue;
+    record.hostelDue = old->hostelDue;
+    record.libraryBooksDue = old->libraryBooksDue;
+    record.approvalStatus = old->approvalStatus;
+    return storeAdd(store, &record);
+}
+
+// Arena offset for a name (length bytes, no NUL needed), to put in a
+// record; NAME_NONE if it is too long or memory runs out
+uint32_t storeInternName(StudentStore *store, const char *name, size_t length) {
+    if (length >= MAX_NAME_LENGTH) {
+        return NAME_NONE;
+    }
+    return nameArenaIntern(&store->names, name, length);
+}
+
+// Rename a record of this store; the old name stays in the arena until the
+// store is rebuilt
+bool storeSetName(StudentStore *store, Student *s, const char *name, size_t length) {
+    uint32_t offset = storeInternName(store, name, length);
+    if (offset == NAME_NONE) {
+        return false;
+    }
+    s->name = offset;
+    return true;
+}
+
+// Convert a version-1 record; float dues round to the nearest paisa.
+// False when a due is not a number or too large.
+bool studentFromV1(const StudentV1 *old, StudentV2 *out) {
+    memset(out, 0, sizeof(*out));
+    out->rollNumber = old->rollNumber;
+    memcpy(out->name, old->name, LEGACY_NAME_LENGTH);
+    out->libraryBooksDue = old->libraryBooksDue;
+    out->approvalStatus = old->approvalStatus;
+    return moneyFromDouble(old->feesDue, &out->feesDue) && moneyFromDouble(old->hostelDue, &out->hostelDue);
+}
@@ -0,0 +1,84 @@
+#ifndef STUDENT_STORE_H
+#define STUDENT_STORE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "roll_map.h"
+#include "name_arena.h"
+#include "money.h"
+
+#define MAX_NAME_LENGTH 256         // longest name accepted, plus its NUL
+#define LEGACY_NAME_LENGTH 50       // fixed name field of version-1/2 files
+
+// Records are allocated in chunks of STORE_CHUNK_SIZE; chunks never move,
+// so a Student pointer stays valid while the store keeps growing.
+#define STORE_CHUNK_SHIFT 12
+#define STORE_CHUNK_SIZE (1 << STORE_CHUNK_SHIFT)
+#define STORE_CHUNK_MASK (STORE_CHUNK_SIZE - 1)
+
+// Student record structure: one per student. The name lives in the
+// store's name arena; read it with storeName().
+typedef struct {
+    int rollNumber;                     // unique roll number
+    uint32_t name;                      // name offset in StudentStore.names
+    Money feesDue;                      // outstanding fees, in paise
+    Money hostelDue;                    // outstanding hostel dues, in paise
+    int libraryBooksDue;                // number of library books not returned
+    int approvalStatus;                 // 0 = Pending, 1 = Approved
+} Student;
+
+// Record layout of version-1 snapshots and journals (dues as float)
+typedef struct {
+    int rollNumber;
+    char name[LEGACY_NAME_LENGTH];
+    float feesDue;
+    int libraryBooksDue;
+    float hostelDue;
+    int approvalStatus;
+} StudentV1;
+
+// Record layout of version-2 snapshots and journals (name inline)
+typedef struct {
+    int rollNumber;
+    char name[LEGACY_NAME_LENGTH];
+    Money feesDue;
+    Money hostelDue;
+    int libraryBooksDue;
+    int approvalStatus;
+} StudentV2;
+
+// Growable, arena-backed student table with a roll-number hash index
+typedef struct {
+    Student **chunks;       // arena chunks, STORE_CHUNK_SIZE records each
+    int chunkCount;
+    int chunkCapacity;
+    int borrowedChunks;     // leading chunks that point into external memory
+    int count;              // number of records in use
+    RollMap index;          // rollNumber -> record position
+    NameArena names;        // every record's name, interned
+} StudentStore;
+
+void storeInit(StudentStore *store);
+void storeFree(StudentStore *store);
+void storeClear(StudentStore *store);
+bool storeReserve(StudentStore *store, int expectedCount);
+bool storeAttach(StudentStore *store, Student *records, int count,
+                 RollMapSlot *indexSlots, unsigned int indexCapacity, char *names, uint32_t namesSize);
+Student *storeAdd(StudentStore *store, const Student *student);
+Student *storeAddLegacy(StudentStore *store, const StudentV2 *old);
+Student *storeFindByRoll(const StudentStore *store, int rollNumber);
+uint32_t storeInternName(StudentStore *store, const char *name, size_t length);
+bool storeSetName(StudentStore *store, Student *s, const char *name, size_t length);
+bool studentFromV1(const StudentV1 *old, StudentV2 *out);
+
+// Record at position i (0 <= i < store->count)
+static inline Student *storeAt(const StudentStore *store, int i) {
+    return &store->chunks[i >> STORE_CHUNK_SHIFT][i & STORE_CHUNK_MASK];
+}
+
+// Name of a record held by this store
+static inline const char *storeName(const StudentStore *store, const Student *s) {
+    return nameArenaGet(&store->names, s->name);
+}
+
+#endif
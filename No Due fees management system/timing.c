@@ -0,0 +1,41 @@
+#include "timing.h"
+
+#ifdef _WIN32
+#include <windows.h>
+
+static LARGE_INTEGER frequency;
+
+double monotonicSeconds(void) {
+    LARGE_INTEGER now;
+    if (frequency.QuadPart == 0) {
+        QueryPerformanceFrequency(&frequency);
+    }
+    QueryPerformanceCounter(&now);
+    return (double)now.QuadPart / (double)frequency.QuadPart;
+}
+
+uint64_t monotonicNanos(void) {
+    LARGE_INTEGER now;
+    if (frequency.QuadPart == 0) {
+        QueryPerformanceFrequency(&frequency);
+    }
+    QueryPerformanceCounter(&now);
+    uint64_t ticks = (uint64_t)now.QuadPart;
+    uint64_t perSecond = (uint64_t)frequency.QuadPart;
+    return ticks / perSecond * 1000000000u + ticks % perSecond * 1000000000u / perSecond;
+}
+#else
+#include <time.h>
+
+double monotonicSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+uint64_t monotonicNanos(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+#endif
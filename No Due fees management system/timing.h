@@ -0,0 +1,12 @@
+#ifndef TIMING_H
+#define TIMING_H
+
+#include <stdint.h>
+
+// Seconds from an arbitrary fixed point on a monotonic clock
+double monotonicSeconds(void);
+
+// Nanoseconds on the same clock, for measuring short operations
+uint64_t monotonicNanos(void);
+
+#endif